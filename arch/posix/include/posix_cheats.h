@@ -206,6 +206,11 @@ void zephyr_app_main(void);
 #define mq_setattr(...)	zap_mq_setattr(__VA_ARGS__)
 #define mq_timedreceive(...)	zap_mq_timedreceive(__VA_ARGS__)
 #define mq_timedsend(...)	zap_mq_timedsend(__VA_ARGS__)
+#define mq_notify(...)	zap_mq_notify(__VA_ARGS__)
+#define mq_loan_np(...)	zap_mq_loan_np(__VA_ARGS__)
+#define mq_send_loan_np(...)	zap_mq_send_loan_np(__VA_ARGS__)
+#define mq_receive_loan_np(...)	zap_mq_receive_loan_np(__VA_ARGS__)
+#define mq_return_np(...)	zap_mq_return_np(__VA_ARGS__)
 
 /* File system */
 #define open		zap_open
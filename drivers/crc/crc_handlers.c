@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <syscall_handler.h>
+#include <drivers/crc.h>
+
+static inline int z_vrfy_crc_compute(const struct device *dev,
+				     enum crc_type type, uint32_t seed,
+				     const uint8_t *data, size_t len,
+				     uint32_t *result)
+{
+	uint32_t value;
+	int ret;
+
+	Z_OOPS(Z_SYSCALL_DRIVER_CRC(dev, compute));
+	Z_OOPS(Z_SYSCALL_MEMORY_READ(data, len));
+
+	ret = z_impl_crc_compute(dev, type, seed, data, len, &value);
+	if (ret == 0) {
+		Z_OOPS(z_user_to_copy(result, &value, sizeof(value)));
+	}
+
+	return ret;
+}
+#include <syscalls/crc_compute_mrsh.c>
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define DT_DRV_COMPAT st_stm32_crc
+
+#include <kernel.h>
+#include <device.h>
+#include <drivers/crc.h>
+#include <drivers/clock_control.h>
+#include <drivers/clock_control/stm32_clock_control.h>
+#include <sys/byteorder.h>
+#include <sys/util.h>
+#include <soc.h>
+#include <stm32_ll_crc.h>
+
+/*
+ * The calculation unit processes the data most significant bit first. The
+ * reflected CRCs are computed on bit reversed input bytes, from and to bit
+ * reversed values of the CRC register.
+ */
+struct crc_stm32_params {
+	uint32_t polynomial;
+	uint32_t poly_size;
+	uint8_t width;
+	bool reflected;
+};
+
+static const struct crc_stm32_params crc_stm32_params[] = {
+	[CRC_TYPE_CRC32_IEEE] = {
+		0x04c11db7, LL_CRC_POLYLENGTH_32B, 32, true,
+	},
+	[CRC_TYPE_CRC16_CCITT] = {
+		0x1021, LL_CRC_POLYLENGTH_16B, 16, true,
+	},
+	[CRC_TYPE_CRC16_ITU_T] = {
+		0x1021, LL_CRC_POLYLENGTH_16B, 16, false,
+	},
+	[CRC_TYPE_CRC8_CCITT] = {
+		0x07, LL_CRC_POLYLENGTH_8B, 8, false,
+	},
+};
+
+struct crc_stm32_config {
+	CRC_TypeDef *crc;
+	struct stm32_pclken pclken;
+};
+
+struct crc_stm32_data {
+	struct k_mutex lock;
+};
+
+#define DEV_CFG(dev) ((const struct crc_stm32_config *)(dev)->config)
+#define DEV_DATA(dev) ((struct crc_stm32_data *)(dev)->data)
+
+static inline uint32_t reflect(uint32_t value, uint8_t width)
+{
+	return __RBIT(value) >> (32U - width);
+}
+
+static int crc_stm32_compute(const struct device *dev, enum crc_type type,
+			     uint32_t seed, const uint8_t *data, size_t len,
+			     uint32_t *result)
+{
+	CRC_TypeDef *crc = DEV_CFG(dev)->crc;
+	const struct crc_stm32_params *params;
+	uint32_t mask;
+	uint32_t value;
+
+	if ((unsigned int)type >= ARRAY_SIZE(crc_stm32_params)) {
+		return -ENOTSUP;
+	}
+
+	params = &crc_stm32_params[type];
+	mask = (params->width == 32U) ? UINT32_MAX : BIT_MASK(params->width);
+
+	/* crc32_ieee_update() inverts the CRC on entry and exit */
+	value = ((type == CRC_TYPE_CRC32_IEEE) ? ~seed : seed) & mask;
+	if (params->reflected) {
+		value = reflect(value, params->width);
+	}
+
+	k_mutex_lock(&DEV_DATA(dev)->lock, K_FOREVER);
+
+	LL_CRC_SetPolynomialSize(crc, params->poly_size);
+	LL_CRC_SetPolynomialCoef(crc, params->polynomial);
+	LL_CRC_SetInputDataReverseMode(crc, params->reflected ?
+				       LL_CRC_INDATA_REVERSE_BYTE :
+				       LL_CRC_INDATA_REVERSE_NONE);
+	LL_CRC_SetOutputDataReverseMode(crc, LL_CRC_OUTDATA_REVERSE_NONE);
+	LL_CRC_SetInitialData(crc, value);
+	LL_CRC_ResetCRCCalculationUnit(crc);
+
+	/* Words are processed from their most significant byte */
+	for (; len >= 4; len -= 4, data += 4) {
+		LL_CRC_FeedData32(crc, sys_get_be32(data));
+	}
+
+	for (; len > 0; len--) {
+		LL_CRC_FeedData8(crc, *data++);
+	}
+
+	value = LL_CRC_ReadData32(crc) & mask;
+
+	k_mutex_unlock(&DEV_DATA(dev)->lock);
+
+	if (params->reflected) {
+		value = reflect(value, params->width);
+	}
+	if (type == CRC_TYPE_CRC32_IEEE) {
+		value = ~value;
+	}
+
+	*result = value;
+
+	return 0;
+}
+
+static int crc_stm32_init(const struct device *dev)
+{
+	const struct device *clk = device_get_binding(STM32_CLOCK_CONTROL_NAME);
+
+	if (clk == NULL) {
+		return -ENODEV;
+	}
+
+	if (clock_control_on(clk,
+		(clock_control_subsys_t *)&DEV_CFG(dev)->pclken) != 0) {
+		return -EIO;
+	}
+
+	k_mutex_init(&DEV_DATA(dev)->lock);
+
+	return 0;
+}
+
+static const struct crc_driver_api crc_stm32_api = {
+	.compute = crc_stm32_compute,
+};
+
+static const struct crc_stm32_config crc_stm32_config = {
+	.crc = (CRC_TypeDef *)DT_INST_REG_ADDR(0),
+	.pclken = {
+		.bus = DT_INST_CLOCKS_CELL(0, bus),
+		.enr = DT_INST_CLOCKS_CELL(0, bits),
+	},
+};
+
+static struct crc_stm32_data crc_stm32_data;
+
+DEVICE_DT_INST_DEFINE(0, crc_stm32_init, device_pm_control_nop,
+		      &crc_stm32_data, &crc_stm32_config,
+		      POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
+		      &crc_stm32_api);
@@ -1114,6 +1114,14 @@ struct bt_le_per_adv_sync_state_info {
 	bool recv_enabled;
 };
 
+/**
+ * @brief Periodic advertising sync callbacks.
+ *
+ * With CONFIG_BT_RX_ADV_THREAD the callbacks are called from the
+ * advertising report thread, except for syncs established from a
+ * periodic advertising sync transfer, whose @ref synced callback is
+ * called from the receiving thread like the other connection events.
+ */
 struct bt_le_per_adv_sync_cb {
 	/**
 	 * @brief The periodic advertising has been successfully synced.
@@ -1580,7 +1588,65 @@ struct bt_le_scan_recv_info {
 	uint8_t secondary_phy;
 };
 
-/** Listener context for (LE) scanning. */
+/** LE scan filter options. */
+enum {
+	/** Match the identity address of the advertiser. */
+	BT_LE_SCAN_FILTER_ADDR = BIT(0),
+
+	/** Match reports containing an AD structure of the given type. */
+	BT_LE_SCAN_FILTER_AD_TYPE = BIT(1),
+
+	/**
+	 * @brief Match reports listing the given UUID.
+	 *
+	 * The UUID is looked up in the service UUID lists, the service
+	 * solicitation lists and the service data of the report. 16-bit and
+	 * 32-bit UUIDs also match their 128-bit representation. Only a
+	 * prefix of the UUID is matched if
+	 * @ref bt_le_scan_filter.uuid_prefix_len is set.
+	 */
+	BT_LE_SCAN_FILTER_UUID = BIT(2),
+};
+
+/**
+ * @brief Filter for reports delivered to a scan listener.
+ *
+ * A report is delivered to the listener only if it matches all the
+ * criteria selected in @ref bt_le_scan_filter.options.
+ */
+struct bt_le_scan_filter {
+	/** Bit-field of filter options, see BT_LE_SCAN_FILTER_* */
+	uint8_t options;
+
+	/** AD type to match with BT_LE_SCAN_FILTER_AD_TYPE. */
+	uint8_t ad_type;
+
+	/** Identity address to match with BT_LE_SCAN_FILTER_ADDR. */
+	const bt_addr_le_t *addr;
+
+	/** UUID to match with BT_LE_SCAN_FILTER_UUID. */
+	const struct bt_uuid *uuid;
+
+	/**
+	 * @brief Number of leading bytes of the UUID to match.
+	 *
+	 * The UUIDs are compared in their 128-bit representation, from the
+	 * most significant byte, i.e. from the start of their textual form.
+	 * This matches all the UUIDs sharing a vendor specific prefix. Zero,
+	 * or 16 and above, match the whole UUID.
+	 */
+	uint8_t uuid_prefix_len;
+};
+
+/**
+ * @brief Listener context for (LE) scanning.
+ *
+ * With CONFIG_BT_RX_ADV_THREAD the callbacks, as well as the callback given
+ * to bt_le_scan_start(), are called from the advertising report thread.
+ * They then run concurrently with the connection, L2CAP and GATT callbacks
+ * called from the receiving thread, and must protect the data they share
+ * with them.
+ */
 struct bt_le_scan_cb {
 
 	/**
@@ -1592,9 +1658,29 @@ struct bt_le_scan_cb {
 	void (*recv)(const struct bt_le_scan_recv_info *info,
 		     struct net_buf_simple *buf);
 
+	/**
+	 * @brief Advertisement packet received callback with parsed data.
+	 *
+	 * The advertising data of each report is parsed once, and the same
+	 * AD structures are given to all listeners. The AD structures only
+	 * remain valid for the duration of the callback.
+	 *
+	 * Reports with more AD structures than
+	 * CONFIG_BT_SCAN_AD_INDEX_SIZE are only given with the first ones.
+	 *
+	 * @param info     Advertiser packet information.
+	 * @param ad       AD structures of the report.
+	 * @param ad_count Number of AD structures.
+	 */
+	void (*recv_ad)(const struct bt_le_scan_recv_info *info,
+			const struct bt_data *ad, size_t ad_count);
+
 	/** @brief The scanner has stopped scanning after scan timeout. */
 	void (*timeout)(void);
 
+	/** @brief Filter for the received reports, or NULL for all reports. */
+	const struct bt_le_scan_filter *filter;
+
 	sys_snode_t node;
 };
 
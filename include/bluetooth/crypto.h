@@ -67,6 +67,42 @@ int bt_encrypt_le(const uint8_t key[16], const uint8_t plaintext[16],
 int bt_encrypt_be(const uint8_t key[16], const uint8_t plaintext[16],
 		  uint8_t enc_data[16]);
 
+/** @brief AES key prepared for encrypting several blocks.
+ *
+ *  Holds the AES-128 key schedule, or the key itself when the controller's
+ *  hardware does the encryption, so that it is computed once for all the
+ *  blocks encrypted with the key.
+ */
+struct bt_aes_ctx {
+	/** @internal Round keys */
+	uint32_t rk[44];
+};
+
+/** @brief Prepare an AES key for encrypting big-endian blocks.
+ *
+ *  @param ctx AES key context to initialize
+ *  @param key 128 bit MS byte first key
+ *
+ *  @return Zero on success or error code otherwise.
+ */
+int bt_aes_setup_be(struct bt_aes_ctx *ctx, const uint8_t key[16]);
+
+/** @brief AES encrypt big-endian blocks.
+ *
+ *  Encrypts consecutive 16 byte blocks with a key prepared by
+ *  @ref bt_aes_setup_be, which is cheaper than calling @ref bt_encrypt_be
+ *  for each of them. The input and output buffers may be the same.
+ *
+ *  @param ctx   AES key context
+ *  @param in    MS byte first data blocks to be encrypted
+ *  @param out   MS byte first encrypted data blocks
+ *  @param count Number of blocks
+ *
+ *  @return Zero on success or error code otherwise.
+ */
+int bt_aes_encrypt_be(const struct bt_aes_ctx *ctx, const uint8_t *in,
+		      uint8_t *out, size_t count);
+
 
 /** @brief Decrypt big-endian data with AES-CCM.
  *
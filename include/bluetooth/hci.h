@@ -2610,6 +2610,43 @@ typedef bool bt_hci_vnd_evt_cb_t(struct net_buf_simple *buf);
   */
 int bt_hci_register_vnd_evt_cb(bt_hci_vnd_evt_cb_t cb);
 
+/** Classes of the HCI traffic received from the controller. */
+enum bt_hci_rx_class {
+	/** Advertising reports and periodic advertising sync events. */
+	BT_HCI_RX_ADV,
+	/** All other HCI events. */
+	BT_HCI_RX_EVT,
+	/** ACL data. */
+	BT_HCI_RX_ACL,
+	/** ISO data. */
+	BT_HCI_RX_ISO,
+
+	BT_HCI_RX_CLASSES,
+};
+
+/** Statistics of the HCI traffic received from the controller. */
+struct bt_hci_rx_stats {
+	/** Number of processed buffers. */
+	uint32_t count[BT_HCI_RX_CLASSES];
+	/** Number of buffers dropped because their queue was full. */
+	uint32_t dropped[BT_HCI_RX_CLASSES];
+	/** Sum of the queueing delays of the processed buffers, in ms. */
+	uint32_t delay_total[BT_HCI_RX_CLASSES];
+	/** Highest queueing delay of a processed buffer, in ms. */
+	uint32_t delay_max[BT_HCI_RX_CLASSES];
+};
+
+/** @brief Get the statistics of the received HCI traffic.
+ *
+ *  The queueing delay of a buffer is the time from when the HCI driver
+ *  gives it to the host until the host starts processing it.
+ *
+ *  Requires CONFIG_BT_HCI_RX_STATS.
+ *
+ *  @param stats Place to store the statistics.
+ */
+void bt_hci_rx_stats_get(struct bt_hci_rx_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,7 +31,7 @@ extern "C" {
  */
 #define BT_ISO_CHAN_SEND_RESERVE (CONFIG_BT_HCI_RESERVE + \
 				  BT_HCI_ISO_HDR_SIZE + \
-				  BT_HCI_ISO_DATA_HDR_SIZE)
+				  BT_HCI_ISO_TS_DATA_HDR_SIZE)
 
 struct bt_iso_chan;
 
@@ -118,6 +118,53 @@ struct bt_iso_chan_path {
 	uint8_t				cc[0];
 };
 
+/** @brief ISO received SDU flags */
+enum {
+	/** The SDU was received without errors. */
+	BT_ISO_FLAGS_VALID = BIT(0),
+	/** The SDU may contain errors. */
+	BT_ISO_FLAGS_ERROR = BIT(1),
+	/** Parts of the SDU were lost. */
+	BT_ISO_FLAGS_LOST = BIT(2),
+	/** The SDU has a time stamp. */
+	BT_ISO_FLAGS_TS = BIT(3),
+};
+
+/** @brief ISO received SDU information. */
+struct bt_iso_recv_info {
+	/** @brief Time stamp of the SDU in microseconds
+	 *
+	 *  Time stamp given by the controller, only valid with
+	 *  BT_ISO_FLAGS_TS.
+	 */
+	uint32_t			ts;
+	/** Packet sequence number of the SDU */
+	uint16_t			sn;
+	/** Bit-field of BT_ISO_FLAGS_* */
+	uint8_t				flags;
+};
+
+/** @brief ISO Channel statistics structure. */
+struct bt_iso_chan_stats {
+	/** Number of SDUs sent */
+	uint32_t			tx_sdus;
+	/** Number of SDUs received */
+	uint32_t			rx_sdus;
+	/** Number of SDUs received with errors */
+	uint32_t			rx_errors;
+	/** Number of SDUs lost, flagged by the controller or missing */
+	uint32_t			rx_lost;
+	/** @brief Interarrival jitter of the received SDUs in microseconds
+	 *
+	 *  Smoothed deviation of the SDU arrival times from their time
+	 *  stamps, as in RFC 3550. Without time stamps the SDUs are expected
+	 *  at every SDU interval.
+	 */
+	uint32_t			rx_jitter;
+	/** Highest deviation of an SDU arrival in microseconds */
+	uint32_t			rx_jitter_max;
+};
+
 /** @brief ISO Channel operations structure. */
 struct bt_iso_chan_ops {
 	/** @brief Channel connected callback
@@ -153,9 +200,11 @@ struct bt_iso_chan_ops {
 	/** @brief Channel recv callback
 	 *
 	 *  @param chan The channel receiving data.
+	 *  @param info Time stamp, sequence number and flags of the SDU.
 	 *  @param buf Buffer containing incoming data.
 	 */
-	void (*recv)(struct bt_iso_chan *chan, struct net_buf *buf);
+	void (*recv)(struct bt_iso_chan *chan,
+		     const struct bt_iso_recv_info *info, struct net_buf *buf);
 };
 
 /** @brief ISO Server structure. */
@@ -238,13 +287,49 @@ int bt_iso_chan_disconnect(struct bt_iso_chan *chan);
  *  Regarding to first input parameter, to get details see reference description
  *  to bt_iso_chan_connect() API above.
  *
+ *  The SDU is fragmented to the ISO MTU of the controller. Either all of
+ *  its fragments are queued, or none of them: -ENOBUFS is returned when
+ *  there are not enough fragment buffers. On error, the buffer is left to
+ *  the caller as it was given.
+ *
  *  @param chan Channel object.
  *  @param buf Buffer containing data to be sent.
  *
- *  @return Bytes sent in case of success or negative value in case of error.
+ *  @return 0 in case of success or negative value in case of error.
  */
 int bt_iso_chan_send(struct bt_iso_chan *chan, struct net_buf *buf);
 
+/** @brief Send data with a time stamp to ISO channel
+ *
+ *  Send an SDU with the given packet sequence number and time stamp, which
+ *  the controller uses to schedule the SDU. The SDUs sent afterwards with
+ *  bt_iso_chan_send() continue the sequence.
+ *
+ *  The buffer must have BT_ISO_CHAN_SEND_RESERVE bytes of headroom. As
+ *  with bt_iso_chan_send(), the buffer is left to the caller on error.
+ *
+ *  @param chan Channel object.
+ *  @param buf Buffer containing data to be sent.
+ *  @param seq_num Packet sequence number of the SDU.
+ *  @param ts Time stamp of the SDU in microseconds.
+ *
+ *  @return 0 in case of success or negative value in case of error.
+ */
+int bt_iso_chan_send_ts(struct bt_iso_chan *chan, struct net_buf *buf,
+			uint16_t seq_num, uint32_t ts);
+
+/** @brief Get ISO channel statistics
+ *
+ *  The statistics cover the current connection of the channel.
+ *
+ *  @param chan Channel object.
+ *  @param stats Place to store the statistics.
+ *
+ *  @return 0 in case of success or negative value in case of error.
+ */
+int bt_iso_chan_stats_get(struct bt_iso_chan *chan,
+			  struct bt_iso_chan_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -573,6 +573,9 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
  * (2) no UTF-8 validation is performed; and
  * (3) only integer numbers are supported (no strtod() in the minimal libc).
  *
+ * The whole document has to be in memory. Documents received in chunks can
+ * be parsed with the streaming parser instead, see json_sax_init().
+ *
  * @param json Pointer to JSON-encoded value to be parsed
  *
  * @param len Length of JSON-encoded value
@@ -711,6 +714,264 @@ int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
 int json_arr_encode(const struct json_obj_descr *descr, const void *val,
 		    json_append_bytes_t append_bytes, void *data);
 
+/**
+ * @brief Maximum nesting depth of objects and arrays supported by the
+ * streaming parser and writer.
+ */
+#define JSON_STREAM_MAX_DEPTH 32
+
+/**
+ * @brief Event reported by the streaming parser
+ *
+ * Keys of objects are reported as JSON_TOK_STRING events with @a key set,
+ * before the event of their value. As with json_obj_parse(), strings are
+ * reported without the quotes and are not unescaped, and numbers are
+ * reported as text, which can be converted with strtol() or strtoll() as
+ * needed. @a value is NUL-terminated for strings and numbers, and is only
+ * valid during the callback.
+ */
+struct json_sax_event {
+	/** JSON_TOK_OBJECT_START, JSON_TOK_OBJECT_END, JSON_TOK_LIST_START,
+	 * JSON_TOK_LIST_END, JSON_TOK_STRING, JSON_TOK_NUMBER,
+	 * JSON_TOK_TRUE, JSON_TOK_FALSE or JSON_TOK_NULL.
+	 */
+	enum json_tokens type;
+
+	/** The string is the key of the next value of an object */
+	bool key;
+
+	/** Nesting depth of the token, 0 for a top-level value */
+	uint8_t depth;
+
+	/** Text of strings and numbers, NULL for other events */
+	const char *value;
+
+	/** Length of @a value */
+	size_t value_len;
+};
+
+/**
+ * @brief Callback of the streaming parser, called for every event.
+ *
+ * @param event Parsed token
+ * @param user_data User-provided pointer
+ *
+ * @return 0 to continue parsing, or a negative number to stop it, which is
+ * returned by json_sax_feed().
+ */
+typedef int (*json_sax_cb_t)(const struct json_sax_event *event,
+			     void *user_data);
+
+/**
+ * @brief State of a streaming parser
+ *
+ * The members are private, use json_sax_init() to initialize the parser.
+ */
+struct json_sax_parser {
+	json_sax_cb_t cb;
+	void *user_data;
+	char *buf;
+	size_t buf_size;
+	size_t len;
+	uint32_t object_mask;
+	uint8_t depth;
+	uint8_t state;
+	uint8_t lex;
+	uint8_t lex_count;
+	const char *literal;
+	int error;
+};
+
+/**
+ * @brief Initialize a streaming JSON parser
+ *
+ * The streaming parser takes a JSON document in chunks of any size, as they
+ * are received, and reports its tokens through a callback. Only the token
+ * being parsed is buffered: strings and numbers, including object keys,
+ * must fit in @a buf with their terminating NUL character. Objects and
+ * arrays can be nested up to JSON_STREAM_MAX_DEPTH levels.
+ *
+ * @param parser Parser to initialize
+ * @param buf Buffer for the strings and numbers split between chunks
+ * @param buf_size Size of @a buf
+ * @param cb Function called for every event
+ * @param user_data Pointer passed to @a cb
+ */
+void json_sax_init(struct json_sax_parser *parser, char *buf, size_t buf_size,
+		   json_sax_cb_t cb, void *user_data);
+
+/**
+ * @brief Feed a chunk of a JSON document to a streaming parser
+ *
+ * @param parser Parser initialized with json_sax_init()
+ * @param data Next chunk of the document
+ * @param len Length of the chunk
+ *
+ * @return 0 on success, -EINVAL if the document is malformed, -ENOMEM if a
+ * string or number does not fit in the buffer of the parser, -E2BIG if the
+ * nesting is too deep, or the error returned by the callback. Once an error
+ * is returned, it is returned by all the next calls.
+ */
+int json_sax_feed(struct json_sax_parser *parser, const char *data,
+		  size_t len);
+
+/**
+ * @brief Signal the end of the document to a streaming parser
+ *
+ * Reports the last token when it was a number, which only the end of the
+ * document terminates.
+ *
+ * @param parser Parser initialized with json_sax_init()
+ *
+ * @return 0 if a complete JSON value was parsed, -EINVAL if the document is
+ * truncated, or the error that stopped the parser.
+ */
+int json_sax_finish(struct json_sax_parser *parser);
+
+/**
+ * @brief State of a streaming JSON writer
+ *
+ * The members are private, use json_writer_init() to initialize the writer.
+ */
+struct json_writer {
+	json_append_bytes_t append_bytes;
+	void *data;
+	char *buf;
+	size_t buf_size;
+	size_t used;
+	uint32_t object_mask;
+	uint32_t first_mask;
+	uint8_t depth;
+	bool after_key;
+	bool done;
+	int error;
+};
+
+/**
+ * @brief Initialize a streaming JSON writer
+ *
+ * The writer builds a JSON document token by token, inserting the commas
+ * and colons, without recursion nor a copy of the document: its output is
+ * gathered in @a buf and handed to @a append_bytes whenever @a buf is full,
+ * and by json_writer_flush(). With no buffer, every token is handed to
+ * @a append_bytes directly.
+ *
+ * The first error is kept: the next calls do nothing and return it, so the
+ * result of the writing functions can be checked only at the end, with
+ * json_writer_flush().
+ *
+ * @param writer Writer to initialize
+ * @param buf Output buffer, or NULL
+ * @param buf_size Size of @a buf
+ * @param append_bytes Function writing the output
+ * @param data Pointer passed to @a append_bytes
+ */
+void json_writer_init(struct json_writer *writer, char *buf, size_t buf_size,
+		      json_append_bytes_t append_bytes, void *data);
+
+/**
+ * @brief Start an object
+ *
+ * @param writer Writer initialized with json_writer_init()
+ *
+ * @return 0 on success, -E2BIG if nested too deep, -EINVAL if a key is
+ * expected, or the first error of the writer.
+ */
+int json_writer_object_start(struct json_writer *writer);
+
+/**
+ * @brief End the current object
+ *
+ * @param writer Writer initialized with json_writer_init()
+ *
+ * @return 0 on success, -EINVAL if no object is open or a value is expected
+ * after a key, or the first error of the writer.
+ */
+int json_writer_object_end(struct json_writer *writer);
+
+/**
+ * @brief Start an array
+ *
+ * @param writer Writer initialized with json_writer_init()
+ *
+ * @return 0 on success, -E2BIG if nested too deep, -EINVAL if a key is
+ * expected, or the first error of the writer.
+ */
+int json_writer_array_start(struct json_writer *writer);
+
+/**
+ * @brief End the current array
+ *
+ * @param writer Writer initialized with json_writer_init()
+ *
+ * @return 0 on success, -EINVAL if no array is open, or the first error of
+ * the writer.
+ */
+int json_writer_array_end(struct json_writer *writer);
+
+/**
+ * @brief Write the key of the next value of the current object
+ *
+ * @param writer Writer initialized with json_writer_init()
+ * @param key Key, escaped by the writer
+ *
+ * @return 0 on success, -EINVAL if not in an object or a value is expected,
+ * or the first error of the writer.
+ */
+int json_writer_key(struct json_writer *writer, const char *key);
+
+/**
+ * @brief Write a string value
+ *
+ * @param writer Writer initialized with json_writer_init()
+ * @param str String, escaped by the writer
+ *
+ * @return 0 on success, -EINVAL if a key is expected, or the first error of
+ * the writer.
+ */
+int json_writer_string(struct json_writer *writer, const char *str);
+
+/**
+ * @brief Write an integer value
+ *
+ * @param writer Writer initialized with json_writer_init()
+ * @param num Number
+ *
+ * @return 0 on success, -EINVAL if a key is expected, or the first error of
+ * the writer.
+ */
+int json_writer_number(struct json_writer *writer, int64_t num);
+
+/**
+ * @brief Write a boolean value
+ *
+ * @param writer Writer initialized with json_writer_init()
+ * @param value Value
+ *
+ * @return 0 on success, -EINVAL if a key is expected, or the first error of
+ * the writer.
+ */
+int json_writer_bool(struct json_writer *writer, bool value);
+
+/**
+ * @brief Write a null value
+ *
+ * @param writer Writer initialized with json_writer_init()
+ *
+ * @return 0 on success, -EINVAL if a key is expected, or the first error of
+ * the writer.
+ */
+int json_writer_null(struct json_writer *writer);
+
+/**
+ * @brief Hand the buffered output of a writer to its output function
+ *
+ * @param writer Writer initialized with json_writer_init()
+ *
+ * @return 0 on success, or the first error of the writer.
+ */
+int json_writer_flush(struct json_writer *writer);
+
 #ifdef __cplusplus
 }
 #endif
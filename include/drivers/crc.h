@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Public API for CRC calculation units
+ */
+
+#ifndef ZEPHYR_INCLUDE_DRIVERS_CRC_H_
+#define ZEPHYR_INCLUDE_DRIVERS_CRC_H_
+
+/**
+ * @brief CRC Interface
+ * @defgroup crc_interface CRC Interface
+ * @ingroup io_interfaces
+ * @{
+ */
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <device.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief CRC computed by a calculation unit
+ *
+ * Each type gives the same result as the software implementation named
+ * below, for the same seed and data, so that a driver can be used in
+ * place of it.
+ */
+enum crc_type {
+	/** crc32_ieee_update() */
+	CRC_TYPE_CRC32_IEEE,
+	/** crc16_ccitt() */
+	CRC_TYPE_CRC16_CCITT,
+	/** crc16_itu_t() */
+	CRC_TYPE_CRC16_ITU_T,
+	/** crc8_ccitt() */
+	CRC_TYPE_CRC8_CCITT,
+};
+
+typedef int (*crc_api_compute)(const struct device *dev, enum crc_type type,
+			       uint32_t seed, const uint8_t *data, size_t len,
+			       uint32_t *result);
+
+__subsystem struct crc_driver_api {
+	crc_api_compute compute;
+};
+
+/**
+ * @brief Compute a CRC with a calculation unit
+ *
+ * The call blocks until the whole buffer has been processed, and must not
+ * be made from an ISR.
+ *
+ * @param dev CRC device.
+ * @param type CRC to compute.
+ * @param seed Initial value, or CRC of the previous block, as given to the
+ *        software implementation of @p type.
+ * @param data Input bytes for the computation.
+ * @param len Length of the input in bytes.
+ * @param result Computed CRC.
+ *
+ * @retval 0 on success.
+ * @retval -ENOTSUP if the device does not support @p type.
+ */
+__syscall int crc_compute(const struct device *dev, enum crc_type type,
+			  uint32_t seed, const uint8_t *data, size_t len,
+			  uint32_t *result);
+
+static inline int z_impl_crc_compute(const struct device *dev,
+				     enum crc_type type, uint32_t seed,
+				     const uint8_t *data, size_t len,
+				     uint32_t *result)
+{
+	const struct crc_driver_api *api =
+		(const struct crc_driver_api *)dev->api;
+
+	return api->compute(dev, type, seed, data, len, result);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#include <syscalls/crc.h>
+
+#endif /* ZEPHYR_INCLUDE_DRIVERS_CRC_H_ */
@@ -1629,6 +1629,16 @@ struct k_queue {
 	sys_sflist_t data_q;
 	struct k_spinlock lock;
 	_wait_q_t wait_q;
+#ifdef CONFIG_QUEUE_LOCKFREE_PUT
+	/* Items appended and prepended without taking the lock, stacked
+	 * until the next locked operation moves them to data_q.
+	 */
+	atomic_ptr_t staged_tail;
+	atomic_ptr_t staged_head;
+
+	/* Number of pending threads and registered poll events */
+	atomic_t waiters;
+#endif
 
 	_POLL_EVENT;
 	_OBJECT_TRACING_NEXT_PTR(k_queue)
@@ -1646,6 +1656,27 @@ struct k_queue {
 
 extern void *z_queue_node_peek(sys_sfnode_t *node, bool needs_free);
 
+#ifdef CONFIG_QUEUE_LOCKFREE_PUT
+extern void z_queue_staged_flush(struct k_queue *queue);
+
+static inline bool z_queue_staged_is_empty(struct k_queue *queue)
+{
+	return (atomic_ptr_get(&queue->staged_tail) == NULL) &&
+	       (atomic_ptr_get(&queue->staged_head) == NULL);
+}
+#else
+static inline void z_queue_staged_flush(struct k_queue *queue)
+{
+	ARG_UNUSED(queue);
+}
+
+static inline bool z_queue_staged_is_empty(struct k_queue *queue)
+{
+	ARG_UNUSED(queue);
+	return true;
+}
+#endif
+
 /**
  * INTERNAL_HIDDEN @endcond
  */
@@ -1840,6 +1871,7 @@ __syscall void *k_queue_get(struct k_queue *queue, k_timeout_t timeout);
  */
 static inline bool k_queue_remove(struct k_queue *queue, void *data)
 {
+	z_queue_staged_flush(queue);
 	return sys_sflist_find_and_remove(&queue->data_q, (sys_sfnode_t *)data);
 }
 
@@ -1861,6 +1893,7 @@ static inline bool k_queue_unique_append(struct k_queue *queue, void *data)
 {
 	sys_sfnode_t *test;
 
+	z_queue_staged_flush(queue);
 	SYS_SFLIST_FOR_EACH_NODE(&queue->data_q, test) {
 		if (test == (sys_sfnode_t *) data) {
 			return false;
@@ -1888,7 +1921,8 @@ __syscall int k_queue_is_empty(struct k_queue *queue);
 
 static inline int z_impl_k_queue_is_empty(struct k_queue *queue)
 {
-	return (int)sys_sflist_is_empty(&queue->data_q);
+	return (int)(sys_sflist_is_empty(&queue->data_q) &&
+		     z_queue_staged_is_empty(queue));
 }
 
 /**
@@ -1904,6 +1938,7 @@ __syscall void *k_queue_peek_head(struct k_queue *queue);
 
 static inline void *z_impl_k_queue_peek_head(struct k_queue *queue)
 {
+	z_queue_staged_flush(queue);
 	return z_queue_node_peek(sys_sflist_peek_head(&queue->data_q), false);
 }
 
@@ -1920,6 +1955,7 @@ __syscall void *k_queue_peek_tail(struct k_queue *queue);
 
 static inline void *z_impl_k_queue_peek_tail(struct k_queue *queue)
 {
+	z_queue_staged_flush(queue);
 	return z_queue_node_peek(sys_sflist_peek_tail(&queue->data_q), false);
 }
 
@@ -3248,6 +3284,322 @@ __syscall int k_condvar_wait(struct k_condvar *condvar, struct k_mutex *mutex,
  * @}
  */
 
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+struct k_event {
+	_wait_q_t wait_q;
+	uint32_t events;
+	_POLL_EVENT;
+};
+
+#define Z_EVENT_INITIALIZER(obj) \
+	{ \
+	.wait_q = Z_WAIT_Q_INIT(&obj.wait_q), \
+	.events = 0, \
+	_POLL_EVENT_OBJ_INIT(obj) \
+	}
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @defgroup event_apis Event APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Initialize an event object.
+ *
+ * This routine initializes an event object, prior to its first use. All
+ * events of the object are initially cleared.
+ *
+ * @param event Address of the event object.
+ *
+ * @return N/A
+ */
+__syscall void k_event_init(struct k_event *event);
+
+/**
+ * @brief Post one or more events to an event object.
+ *
+ * This routine posts one or more events to an event object. The posted
+ * events are added to the events already tracked by the object. All threads
+ * whose wait condition is satisfied by the resulting set of events are
+ * woken in a single pass over the object's wait queue.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param event Address of the event object.
+ * @param events Set of events to post to @a event.
+ *
+ * @return N/A
+ */
+__syscall void k_event_post(struct k_event *event, uint32_t events);
+
+/**
+ * @brief Set the events in an event object.
+ *
+ * This routine replaces the events tracked by an event object with
+ * @a events, then wakes all threads whose wait condition is satisfied by
+ * the new set of events.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param event Address of the event object.
+ * @param events Set of events to set in @a event.
+ *
+ * @return N/A
+ */
+__syscall void k_event_set(struct k_event *event, uint32_t events);
+
+/**
+ * @brief Clear events in an event object.
+ *
+ * This routine clears (resets) the specified events in an event object.
+ * Waiting threads are not affected.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param event Address of the event object.
+ * @param events Set of events to clear in @a event.
+ *
+ * @return N/A
+ */
+__syscall void k_event_clear(struct k_event *event, uint32_t events);
+
+/**
+ * @brief Wait for any of the specified events.
+ *
+ * This routine waits on event object @a event until any of the specified
+ * events has been delivered to the event object, or the maximum wait time
+ * @a timeout has expired.
+ *
+ * When @a clear is true, the events that satisfied the wait are cleared
+ * from the event object before this routine returns. If several threads are
+ * woken by the same delivery, each of them observes the events as they were
+ * delivered; the clearing requested by all of them is applied once they have
+ * all been woken.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param event Address of the event object.
+ * @param events Set of desired events on which to wait.
+ * @param clear If true, clear the matching events on exit.
+ * @param timeout Waiting period for the desired set of events or one of the
+ *                special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval set of matching events upon success
+ * @retval 0 if matching events were not received within the specified time
+ */
+__syscall uint32_t k_event_wait(struct k_event *event, uint32_t events,
+				bool clear, k_timeout_t timeout);
+
+/**
+ * @brief Wait for all of the specified events.
+ *
+ * This routine waits on event object @a event until all of the specified
+ * events have been delivered to the event object, or the maximum wait time
+ * @a timeout has expired.
+ *
+ * When @a clear is true, the specified events are cleared from the event
+ * object before this routine returns, with the same semantics as
+ * k_event_wait().
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param event Address of the event object.
+ * @param events Set of desired events on which to wait.
+ * @param clear If true, clear the matching events on exit.
+ * @param timeout Waiting period for the desired set of events or one of the
+ *                special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval set of matching events upon success
+ * @retval 0 if matching events were not received within the specified time
+ */
+__syscall uint32_t k_event_wait_all(struct k_event *event, uint32_t events,
+				    bool clear, k_timeout_t timeout);
+
+/**
+ * @brief Get the events currently tracked by an event object.
+ *
+ * @param event Address of the event object.
+ *
+ * @return Set of events currently tracked by @a event.
+ */
+__syscall uint32_t k_event_events_get(struct k_event *event);
+
+static inline uint32_t z_impl_k_event_events_get(struct k_event *event)
+{
+	return event->events;
+}
+
+/**
+ * @brief Statically define and initialize an event object.
+ *
+ * The event object can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct k_event <name>; @endcode
+ *
+ * @param name Name of the event object.
+ */
+#define K_EVENT_DEFINE(name)                                                   \
+	Z_STRUCT_SECTION_ITERABLE(k_event, name) =                             \
+		Z_EVENT_INITIALIZER(name)
+
+/** @} */
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+struct k_rwlock {
+	/** Reader count and flags, see kernel/rwlock.c */
+	atomic_t state;
+	_wait_q_t rd_wait_q;
+	_wait_q_t wr_wait_q;
+	struct k_thread *writer;
+	int writer_orig_prio;
+	uint8_t policy;
+};
+
+#define Z_RWLOCK_INITIALIZER(obj, rwlock_policy) \
+	{ \
+	.state = ATOMIC_INIT(0), \
+	.rd_wait_q = Z_WAIT_Q_INIT(&obj.rd_wait_q), \
+	.wr_wait_q = Z_WAIT_Q_INIT(&obj.wr_wait_q), \
+	.writer = NULL, \
+	.writer_orig_prio = 0, \
+	.policy = (rwlock_policy), \
+	}
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @defgroup rwlock_apis Reader-Writer Lock APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * Readers may take the lock whenever no writer holds it, even when writers
+ * are waiting. Best read throughput, but writers may starve.
+ */
+#define K_RWLOCK_PREFER_READER 0
+
+/**
+ * New readers wait while writers are waiting, and a releasing writer hands
+ * the lock to the next writer first. Readers may starve.
+ */
+#define K_RWLOCK_PREFER_WRITER 1
+
+/**
+ * New readers wait while writers are waiting, and a releasing writer
+ * admits all the waiting readers before the next writer, so that neither
+ * readers nor writers starve.
+ */
+#define K_RWLOCK_PHASE_FAIR 2
+
+/**
+ * @brief Initialize a reader-writer lock.
+ *
+ * This routine initializes a reader-writer lock, prior to its first use.
+ *
+ * Readers take and release the lock with a single atomic operation when
+ * it is not contended. A writer holding the lock inherits the priority of
+ * the highest priority thread waiting for it, as with mutexes.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ * @param policy K_RWLOCK_PREFER_READER, K_RWLOCK_PREFER_WRITER or
+ *               K_RWLOCK_PHASE_FAIR.
+ *
+ * @retval 0 Reader-writer lock initialized.
+ * @retval -EINVAL Invalid policy.
+ */
+__syscall int k_rwlock_init(struct k_rwlock *rwlock, unsigned int policy);
+
+/**
+ * @brief Lock a reader-writer lock for reading.
+ *
+ * Any number of threads can hold the lock for reading at the same time.
+ * A thread must not take the lock for reading again while holding it for
+ * reading, unless the policy is K_RWLOCK_PREFER_READER, since a waiting
+ * writer would block it.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ * @param timeout Waiting period to lock the reader-writer lock,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Reader-writer lock locked for reading.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EDEADLK The calling thread holds the lock for writing.
+ */
+__syscall int k_rwlock_read_lock(struct k_rwlock *rwlock,
+				 k_timeout_t timeout);
+
+/**
+ * @brief Unlock a reader-writer lock locked for reading.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ *
+ * @retval 0 Reader-writer lock unlocked.
+ * @retval -EINVAL The lock is not locked for reading.
+ */
+__syscall int k_rwlock_read_unlock(struct k_rwlock *rwlock);
+
+/**
+ * @brief Lock a reader-writer lock for writing.
+ *
+ * Only one thread can hold the lock for writing, and no thread can hold
+ * it for reading at the same time.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ * @param timeout Waiting period to lock the reader-writer lock,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Reader-writer lock locked for writing.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EDEADLK The calling thread holds the lock for writing.
+ */
+__syscall int k_rwlock_write_lock(struct k_rwlock *rwlock,
+				  k_timeout_t timeout);
+
+/**
+ * @brief Unlock a reader-writer lock locked for writing.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ *
+ * @retval 0 Reader-writer lock unlocked.
+ * @retval -EPERM The calling thread does not hold the lock for writing.
+ */
+__syscall int k_rwlock_write_unlock(struct k_rwlock *rwlock);
+
+/**
+ * @brief Statically define and initialize a reader-writer lock.
+ *
+ * The reader-writer lock can be accessed outside the module where it is
+ * defined using:
+ *
+ * @code extern struct k_rwlock <name>; @endcode
+ *
+ * @param name Name of the reader-writer lock.
+ * @param policy K_RWLOCK_PREFER_READER, K_RWLOCK_PREFER_WRITER or
+ *               K_RWLOCK_PHASE_FAIR.
+ */
+#define K_RWLOCK_DEFINE(name, policy) \
+	Z_STRUCT_SECTION_ITERABLE(k_rwlock, name) = \
+		Z_RWLOCK_INITIALIZER(name, policy)
+
+/** @} */
+
 /**
  * @cond INTERNAL_HIDDEN
  */
@@ -4401,6 +4753,9 @@ enum _poll_types_bits {
 	/* queue/FIFO/LIFO data availability */
 	_POLL_TYPE_DATA_AVAILABLE,
 
+	/* event object has events posted */
+	_POLL_TYPE_EVENT,
+
 	_POLL_NUM_TYPES
 };
 
@@ -4423,6 +4778,9 @@ enum _poll_states_bits {
 	/* queue/FIFO/LIFO wait was cancelled */
 	_POLL_STATE_CANCELLED,
 
+	/* events have been posted to an event object */
+	_POLL_STATE_EVENT_POSTED,
+
 	_POLL_NUM_STATES
 };
 
@@ -4453,6 +4811,7 @@ enum _poll_states_bits {
 #define K_POLL_TYPE_SEM_AVAILABLE Z_POLL_TYPE_BIT(_POLL_TYPE_SEM_AVAILABLE)
 #define K_POLL_TYPE_DATA_AVAILABLE Z_POLL_TYPE_BIT(_POLL_TYPE_DATA_AVAILABLE)
 #define K_POLL_TYPE_FIFO_DATA_AVAILABLE K_POLL_TYPE_DATA_AVAILABLE
+#define K_POLL_TYPE_EVENT Z_POLL_TYPE_BIT(_POLL_TYPE_EVENT)
 
 /* public - polling modes */
 enum k_poll_modes {
@@ -4469,6 +4828,7 @@ enum k_poll_modes {
 #define K_POLL_STATE_DATA_AVAILABLE Z_POLL_STATE_BIT(_POLL_STATE_DATA_AVAILABLE)
 #define K_POLL_STATE_FIFO_DATA_AVAILABLE K_POLL_STATE_DATA_AVAILABLE
 #define K_POLL_STATE_CANCELLED Z_POLL_STATE_BIT(_POLL_STATE_CANCELLED)
+#define K_POLL_STATE_EVENT_POSTED Z_POLL_STATE_BIT(_POLL_STATE_EVENT_POSTED)
 
 /* public - poll signal object */
 struct k_poll_signal {
@@ -4524,6 +4884,7 @@ struct k_poll_event {
 		struct k_sem *sem;
 		struct k_fifo *fifo;
 		struct k_queue *queue;
+		struct k_event *kevent;
 	};
 };
 
@@ -105,6 +105,17 @@ struct _thread_base {
 	uint8_t cpu_mask;
 #endif
 
+#ifdef CONFIG_RCU
+	/* RCU read-side critical section nesting count */
+	uint8_t rcu_nesting;
+
+	/* True when preempted inside an RCU read-side critical section */
+	uint8_t rcu_blocked;
+
+	/* Grace period phase blocked by this thread while rcu_blocked */
+	uint8_t rcu_phase;
+#endif
+
 	/* data returned by APIs */
 	void *swap_data;
 
@@ -239,6 +250,17 @@ struct k_thread {
 	struct z_poller poller;
 #endif
 
+#if defined(CONFIG_EVENTS)
+	/** next thread in the list of threads woken by an event post */
+	struct k_thread *next_event_link;
+
+	/** events the thread is waiting on, or the events that woke it */
+	uint32_t events;
+
+	/** options of the pending event wait */
+	uint32_t event_options;
+#endif
+
 #if defined(CONFIG_THREAD_MONITOR)
 	/** thread entry and parameters description */
 	struct __thread_entry entry;
@@ -128,6 +128,14 @@ struct _cpu {
 	/* True when _current is allowed to context switch */
 	uint8_t swap_ok;
 #endif
+
+#ifdef CONFIG_RCU
+	/* RCU grace period phase last acknowledged by this CPU */
+	uint8_t rcu_phase;
+
+	/* count of RCU quiescent states reported by this CPU */
+	atomic_t rcu_qs;
+#endif
 };
 
 typedef struct _cpu _cpu_t;
@@ -11,6 +11,7 @@
 #include <posix/time.h>
 #include <fcntl.h>
 #include "posix_types.h"
+#include "signal.h"
 #include "sys/stat.h"
 
 #ifdef __cplusplus
@@ -40,6 +41,15 @@ int mq_timedreceive(mqd_t mqdes, char *msg_ptr, size_t msg_len,
 			unsigned int *msg_prio, const struct timespec *abstime);
 int mq_timedsend(mqd_t mqdes, const char *msg_ptr, size_t msg_len,
 		 unsigned int msg_prio, const struct timespec *abstime);
+int mq_notify(mqd_t mqdes, const struct sigevent *notification);
+
+/* Zero-copy extensions */
+char *mq_loan_np(mqd_t mqdes, const struct timespec *abstime);
+int mq_send_loan_np(mqd_t mqdes, char *buf, size_t msg_len,
+		    unsigned int msg_prio);
+int mq_receive_loan_np(mqd_t mqdes, char **buf, unsigned int *msg_prio,
+		       const struct timespec *abstime);
+int mq_return_np(mqd_t mqdes, char *buf);
 
 #ifdef __cplusplus
 }
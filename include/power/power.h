@@ -303,6 +303,62 @@ void pm_notifier_register(struct pm_notifier *notifier);
  */
 int pm_notifier_unregister(struct pm_notifier *notifier);
 
+#ifdef CONFIG_PM_POLICY_GOVERNOR
+/** Wake-up source of the system timer */
+#define PM_GOVERNOR_SOURCE_TIMER 0U
+
+/** Wake-up source of interrupts not attributed to a specific source */
+#define PM_GOVERNOR_SOURCE_OTHER 1U
+
+/** State index of plain CPU idle, when no power state was entered */
+#define PM_GOVERNOR_STATE_CPU_IDLE 0xFFU
+
+/**
+ * Idle governor residency statistics of a power state
+ */
+struct pm_governor_stats {
+	/** Number of times the state was selected */
+	uint32_t entries;
+	/** Number of times the state was left before its minimum residency */
+	uint32_t early_exits;
+	/** Total time spent in the state, in microseconds */
+	uint64_t residency_us;
+};
+
+/**
+ * @brief Attribute the current wake-up to a wake-up source
+ *
+ * Called from the ISR of a periodic wake-up event (e.g. radio connection
+ * events, keyboard scans), so that the governor learns its interval and
+ * anticipates the next one. Wake-ups that are not attributed are
+ * accounted to PM_GOVERNOR_SOURCE_TIMER when they happen at the expected
+ * kernel timeout, or to PM_GOVERNOR_SOURCE_OTHER otherwise. Only the
+ * first call after a wake-up is taken into account.
+ *
+ * @param source Wake-up source, lower than
+ *               CONFIG_PM_POLICY_GOVERNOR_SOURCES.
+ */
+void pm_governor_wakeup_source(uint8_t source);
+
+/**
+ * @brief Get the idle governor residency statistics of a power state
+ *
+ * @param index Index of the state in the 'cpu-power-states' property of
+ *              cpu0, or PM_GOVERNOR_STATE_CPU_IDLE.
+ * @param stats Statistics of the state.
+ *
+ * @return 0 on success, -EINVAL if @a index is not a valid state index.
+ */
+int pm_governor_stats_get(uint8_t index, struct pm_governor_stats *stats);
+
+/**
+ * @brief Reset the idle governor wake-up history and statistics
+ */
+void pm_governor_reset(void);
+
+void z_pm_governor_idle_exit(void);
+#endif /* CONFIG_PM_POLICY_GOVERNOR */
+
 /**
  * @}
  */
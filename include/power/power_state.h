@@ -139,6 +139,13 @@ struct pm_state_info {
 	 * @note 0 means that this property is not available for this state.
 	 */
 	uint32_t min_residency_us;
+
+	/**
+	 * Worst case latency in microseconds required to exit the idle state.
+	 *
+	 * @note 0 means that this property is not available for this state.
+	 */
+	uint32_t exit_latency_us;
 };
 
 /**
@@ -156,6 +163,8 @@ struct pm_state_info {
 			cpu_power_states, i, substate_id, 0),   \
 		.min_residency_us = DT_PROP_BY_PHANDLE_IDX_OR(node_id, \
 				cpu_power_states, i, min_residency_us, 0),\
+		.exit_latency_us = DT_PROP_BY_PHANDLE_IDX_OR(node_id,  \
+				cpu_power_states, i, exit_latency_us, 0),  \
 	},
 
 /**
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Read-copy-update (RCU) synchronization
+ *
+ * RCU protects read-mostly data structures. Readers access the data inside
+ * read-side critical sections which take no lock and perform no atomic
+ * operation: entering and leaving a section only updates a nesting count
+ * in the current thread. Writers never modify data that readers may be
+ * looking at. Instead they publish an updated copy with
+ * K_RCU_ASSIGN_POINTER(), then wait for a grace period with
+ * k_rcu_synchronize() (or defer the work with k_rcu_call()) before
+ * reclaiming the old copy. A grace period ends once every read-side
+ * critical section that was in progress when it started has completed.
+ *
+ * Writers must be serialized against each other by other means, e.g. a
+ * k_mutex.
+ */
+
+#ifndef ZEPHYR_INCLUDE_RCU_H_
+#define ZEPHYR_INCLUDE_RCU_H_
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <sys/atomic.h>
+#include <sys/slist.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup rcu_apis Read-Copy-Update APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+struct k_rcu_head;
+
+/**
+ * @brief RCU callback function type.
+ *
+ * @param head The k_rcu_head passed to k_rcu_call().
+ */
+typedef void (*k_rcu_callback_t)(struct k_rcu_head *head);
+
+/**
+ * @brief Deferred RCU callback record.
+ *
+ * Embed this in objects that are reclaimed with k_rcu_call(), and use
+ * CONTAINER_OF() in the callback to retrieve the enclosing object.
+ */
+struct k_rcu_head {
+	/** PRIVATE - DO NOT TOUCH */
+	sys_snode_t node;
+
+	/** PRIVATE - DO NOT TOUCH */
+	k_rcu_callback_t func;
+};
+
+/** @cond INTERNAL_HIDDEN */
+void z_rcu_read_unlock_special(struct k_thread *thread);
+/** @endcond */
+
+/**
+ * @brief Enter an RCU read-side critical section.
+ *
+ * Read-side critical sections may be nested and the thread may be preempted
+ * while inside one, but it must not block (sleep, pend on a kernel object,
+ * etc.). Data obtained with K_RCU_DEREFERENCE() inside the section remains
+ * valid until the matching k_rcu_read_unlock().
+ *
+ * May be called from threads and ISRs. It is only available to supervisor
+ * threads.
+ */
+static inline void k_rcu_read_lock(void)
+{
+	struct k_thread *thread = k_current_get();
+
+	thread->base.rcu_nesting++;
+	compiler_barrier();
+}
+
+/**
+ * @brief Leave an RCU read-side critical section.
+ *
+ * Must be paired with k_rcu_read_lock() on the same thread.
+ */
+static inline void k_rcu_read_unlock(void)
+{
+	struct k_thread *thread = k_current_get();
+
+	__ASSERT(thread->base.rcu_nesting != 0U, "unbalanced RCU unlock");
+
+	compiler_barrier();
+	if ((--thread->base.rcu_nesting == 0U) &&
+	    unlikely(thread->base.rcu_blocked != 0U)) {
+		/* Preempted while reading: release the grace period */
+		z_rcu_read_unlock_special(thread);
+	}
+}
+
+/**
+ * @brief Publish a new version of RCU protected data.
+ *
+ * All initialization of the data pointed to by @a v is made visible to
+ * other CPUs before the pointer itself.
+ *
+ * @param p RCU protected pointer (lvalue).
+ * @param v New value of the pointer.
+ */
+#define K_RCU_ASSIGN_POINTER(p, v) do {				\
+		(void)atomic_ptr_set((atomic_ptr_t *)&(p), (void *)(v)); \
+	} while (false)
+
+/**
+ * @brief Fetch an RCU protected pointer for dereferencing.
+ *
+ * Must be used inside a read-side critical section.
+ *
+ * @param p RCU protected pointer (lvalue).
+ *
+ * @return The current value of @a p.
+ */
+#define K_RCU_DEREFERENCE(p) (*(__typeof__(p) volatile *)&(p))
+
+/**
+ * @brief Wait for an RCU grace period.
+ *
+ * Blocks the calling thread until all read-side critical sections in
+ * progress when this routine was called have completed. Must not be called
+ * from an ISR nor from inside a read-side critical section.
+ */
+void k_rcu_synchronize(void);
+
+/**
+ * @brief Invoke a callback after an RCU grace period.
+ *
+ * Queues @a func to be invoked with @a head, from the RCU callback thread,
+ * once all read-side critical sections in progress when this routine was
+ * called have completed. Typically used to free the old version of an
+ * object without blocking the writer.
+ *
+ * May be called from threads and ISRs.
+ *
+ * @param head RCU callback record embedded in the object to reclaim.
+ * @param func Callback to invoke.
+ */
+void k_rcu_call(struct k_rcu_head *head, k_rcu_callback_t func);
+
+/**
+ * @brief Wait for all queued RCU callbacks to be invoked.
+ *
+ * Blocks until every callback queued with k_rcu_call() before this routine
+ * was called has been invoked. Must not be called from an ISR nor from a
+ * read-side critical section.
+ */
+void k_rcu_barrier(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_RCU_H_ */
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief B+tree of integer keys
+ *
+ * A sorted map of integer keys (e.g. addresses, identifiers, deadlines)
+ * to pointers, designed to touch few cache lines: every node holds up to
+ * SYS_BTREE_ORDER keys in a contiguous array searched without chasing
+ * pointers, so that a lookup in a tree of thousands of elements reads
+ * two or three nodes where a red/black tree (see sys/rb.h) reads one node
+ * per level. All the values are in the leaves, which are linked together
+ * for in-order iteration.
+ *
+ * The tree is optionally intrusive: values are opaque pointers, usually
+ * to the structure containing the key, which does not need to embed any
+ * node. Tree nodes are allocated with the function given at
+ * initialization, typically from a memory slab of struct sys_btree_node
+ * blocks.
+ *
+ * Trees are not thread safe, the caller has to serialize accesses.
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_BTREE_H_
+#define ZEPHYR_INCLUDE_SYS_BTREE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup btree_apis B+tree
+ * @ingroup datastructure_apis
+ * @{
+ */
+
+/** Maximum number of keys in a node */
+#define SYS_BTREE_ORDER 16
+
+/** Maximum height of a tree, enough for more than 2^32 keys */
+#define SYS_BTREE_MAX_HEIGHT 12
+
+/**
+ * @brief B+tree node
+ *
+ * Only public so that pools of nodes can be defined, its fields are
+ * private.
+ */
+struct sys_btree_node {
+	uint16_t n_keys;
+	bool leaf;
+	uintptr_t keys[SYS_BTREE_ORDER];
+	union {
+		void *values[SYS_BTREE_ORDER];
+		struct sys_btree_node *children[SYS_BTREE_ORDER + 1];
+	};
+	struct sys_btree_node *next;
+};
+
+/**
+ * @brief Allocator of the nodes of a tree
+ *
+ * Allocates a struct sys_btree_node of @a size bytes when @a ptr is NULL,
+ * and frees @a ptr otherwise (@a size is then 0).
+ */
+typedef void *(*sys_btree_alloc_t)(void *ptr, size_t size);
+
+/** @brief B+tree */
+struct sys_btree {
+	struct sys_btree_node *root;
+	size_t count;
+	uint8_t height;
+	sys_btree_alloc_t alloc;
+};
+
+/** @brief Iterator over the elements of a tree, in key order */
+struct sys_btree_iter {
+	const struct sys_btree_node *node;
+	uint16_t idx;
+};
+
+/**
+ * @brief Initialize an empty tree
+ *
+ * @param tree Tree to initialize
+ * @param alloc Allocator of the nodes
+ */
+void sys_btree_init(struct sys_btree *tree, sys_btree_alloc_t alloc);
+
+/**
+ * @brief Remove all the elements of a tree, freeing its nodes
+ *
+ * @param tree Tree to clear
+ */
+void sys_btree_clear(struct sys_btree *tree);
+
+/**
+ * @brief Insert an element in a tree
+ *
+ * @param tree Tree
+ * @param key Key of the element
+ * @param value Value of the element, not NULL
+ *
+ * @retval 0 on success
+ * @retval -EEXIST if the key is in the tree already
+ * @retval -ENOMEM if a node could not be allocated, the tree is unchanged
+ */
+int sys_btree_insert(struct sys_btree *tree, uintptr_t key, void *value);
+
+/**
+ * @brief Look up a key in a tree
+ *
+ * @param tree Tree
+ * @param key Key
+ *
+ * @return The value of the key, or NULL if not found
+ */
+void *sys_btree_get(const struct sys_btree *tree, uintptr_t key);
+
+/**
+ * @brief Remove a key from a tree
+ *
+ * @param tree Tree
+ * @param key Key
+ *
+ * @return The value of the removed key, or NULL if not found
+ */
+void *sys_btree_remove(struct sys_btree *tree, uintptr_t key);
+
+/**
+ * @brief Load sorted elements in an empty tree
+ *
+ * The tree is built bottom-up with nodes as full as possible, which is
+ * faster than inserting the elements one by one and results in a smaller
+ * tree.
+ *
+ * @param tree Empty tree
+ * @param keys Keys, in strictly increasing order
+ * @param values Values, not NULL
+ * @param n Number of elements
+ *
+ * @retval 0 on success
+ * @retval -EINVAL if the tree is not empty or the keys are not sorted
+ * @retval -ENOMEM if a node could not be allocated, the tree is unchanged
+ */
+int sys_btree_load(struct sys_btree *tree, const uintptr_t *keys,
+		   void *const *values, size_t n);
+
+/**
+ * @brief Number of elements in a tree
+ *
+ * @param tree Tree
+ *
+ * @return The number of elements
+ */
+static inline size_t sys_btree_count(const struct sys_btree *tree)
+{
+	return tree->count;
+}
+
+/**
+ * @brief Position an iterator on the first element of a tree
+ *
+ * @param tree Tree
+ * @param it Iterator
+ */
+void sys_btree_iter_first(const struct sys_btree *tree,
+			  struct sys_btree_iter *it);
+
+/**
+ * @brief Position an iterator on the first element whose key is not less
+ * than a given key
+ *
+ * @param tree Tree
+ * @param it Iterator
+ * @param key Key
+ */
+void sys_btree_iter_seek(const struct sys_btree *tree,
+			 struct sys_btree_iter *it, uintptr_t key);
+
+/**
+ * @brief Get the element of an iterator and advance it
+ *
+ * The tree must not be modified while it is iterated over.
+ *
+ * @param it Iterator
+ * @param key Key of the element, may be NULL
+ *
+ * @return The value of the element, or NULL at the end of the tree
+ */
+static inline void *sys_btree_iter_next(struct sys_btree_iter *it,
+					uintptr_t *key)
+{
+	const struct sys_btree_node *node = it->node;
+	void *value;
+
+	if (node == NULL) {
+		return NULL;
+	}
+
+	if (key != NULL) {
+		*key = node->keys[it->idx];
+	}
+	value = node->values[it->idx];
+
+	if (++it->idx == node->n_keys) {
+		it->node = node->next;
+		it->idx = 0;
+	}
+
+	return value;
+}
+
+/**
+ * @brief Iterate over the elements of a tree in key order
+ *
+ * @param tree Tree
+ * @param it struct sys_btree_iter variable
+ * @param key uintptr_t key variable
+ * @param value Value pointer variable
+ */
+#define SYS_BTREE_FOR_EACH(tree, it, key, value) \
+	for (sys_btree_iter_first((tree), &(it)); \
+	     ((value) = sys_btree_iter_next(&(it), &(key))) != NULL;)
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_BTREE_H_ */
@@ -10,6 +10,7 @@
 #include <stdarg.h>
 #include <stddef.h>
 #include <toolchain.h>
+#include <sys/cbprintf_internal.h>
 
 #ifdef CONFIG_CBPRINTF_LIBC_SUBSTS
 #include <stdio.h>
@@ -100,6 +101,75 @@ int cbprintf(cbprintf_cb out, void *ctx, const char *format, ...);
  */
 int cbvprintf(cbprintf_cb out, void *ctx, const char *format, va_list ap);
 
+/** @brief Determine the room needed by a static package.
+ *
+ * The result is a compile time constant, an upper bound of the length of
+ * the package built by CBPRINTF_STATIC_PACKAGE() for the same arguments. It
+ * can be used to size a buffer on the stack.
+ *
+ * @param ... format string and the arguments it converts. The arguments are
+ * not evaluated.
+ */
+#define CBPRINTF_STATIC_PACKAGE_SIZE(... /* fmt, ... */) \
+	(sizeof(const char *) \
+	 COND_CODE_0(NUM_VA_ARGS_LESS_1(__VA_ARGS__), (), \
+		     (FOR_EACH(Z_CBPRINTF_ARG_MAX_SIZE, (), \
+			       GET_ARGS_LESS_N(1, __VA_ARGS__)))))
+
+/** @brief Capture the arguments of a formatted output into a package.
+ *
+ * The type of each argument is determined at compile time, so that the
+ * arguments are simply copied into the package at the call site, without
+ * looking at the format string. The package can then be stored, moved to
+ * another context or sent to the host, and rendered by cbpprintf() where
+ * and when the output is needed.
+ *
+ * Arguments are copied by value: pointers, strings for %s conversions
+ * included, must remain valid until the package is rendered, which is the
+ * case of string literals and other read-only data.
+ *
+ * @note This macro relies on _Generic and is not available from C++.
+ *
+ * @param packaged buffer of the package, NULL to only compute its length.
+ *
+ * @param inlen length of @p packaged.
+ *
+ * @param outlen int variable set to the length of the package, or to
+ * -ENOSPC if @p packaged is too small.
+ *
+ * @param ... format string and the arguments it converts, as they would be
+ * given to cbprintf(). Each argument is evaluated once.
+ */
+#define CBPRINTF_STATIC_PACKAGE(packaged, inlen, outlen, ... /* fmt, ... */) \
+	Z_CBPRINTF_STATIC_PACKAGE(packaged, inlen, outlen, __VA_ARGS__)
+
+/** @brief Generate the output of a package through a callback.
+ *
+ * The equivalent of cbprintf() for the format string and arguments
+ * captured by CBPRINTF_STATIC_PACKAGE(). The format string is parsed here,
+ * once per rendering, rather than at the call site that built the package.
+ *
+ * @note The functionality of this function is significantly reduced when
+ * @option{CONFIG_CBPRINTF_NANO} is selected.
+ *
+ * @param out the function used to emit each generated character.
+ *
+ * @param ctx context provided when invoking out
+ *
+ * @param packaged package built by CBPRINTF_STATIC_PACKAGE().
+ *
+ * @return the number of characters printed, or a negative error value
+ * returned from invoking @p out.
+ */
+int cbpprintf(cbprintf_cb out, void *ctx, const void *packaged);
+
+/* Formatter of the selected implementation, shared by cbvprintf() and
+ * cbpprintf(). The format string and the arguments are taken from @p pkg
+ * when it is not NULL, and from @p format and @p ap otherwise.
+ */
+int z_cbvprintf_impl(cbprintf_cb out, void *ctx, const char *format,
+		     va_list ap, const uint8_t *pkg);
+
 #ifdef CONFIG_CBPRINTF_LIBC_SUBSTS
 
 /** @brief fprintf using Zephyrs cbprintf infrastructure.
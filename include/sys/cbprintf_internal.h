@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_CBPRINTF_INTERNAL_H_
+#define ZEPHYR_INCLUDE_SYS_CBPRINTF_INTERNAL_H_
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/util.h>
+
+/*
+ * A package holds the format string pointer followed by the arguments,
+ * each one stored after the default argument promotions (integers smaller
+ * than int to int, float to double, arrays to pointers), at an offset from
+ * the start of the package that is aligned like the promoted type.
+ *
+ * Offsets being relative to the start of the package, and the values being
+ * copied with memcpy(), the package buffer has no alignment requirement and
+ * the renderer does not depend on the va_list layout of the ABI.
+ */
+
+/* Offset of a slot aligned to @p align bytes, at or after @p pos. */
+#define Z_CBPRINTF_ALIGN(pos, align) \
+	(((pos) + (align) - 1U) & ~((size_t)(align) - 1U))
+
+/* Size and alignment of an argument after the default argument promotions.
+ * The argument is not evaluated.
+ */
+#define Z_CBPRINTF_ARG_SIZE(arg) \
+	_Generic((arg) + 0, \
+		 float : sizeof(double), \
+		 default : sizeof((arg) + 0))
+
+#define Z_CBPRINTF_ARG_ALIGN(arg) \
+	_Generic((arg) + 0, \
+		 float : __alignof__(double), \
+		 default : __alignof__(__typeof__((arg) + 0)))
+
+/* Upper bound of the room taken by an argument, whatever its offset. */
+#define Z_CBPRINTF_ARG_MAX_SIZE(arg) \
+	+ Z_CBPRINTF_ARG_SIZE(arg) + Z_CBPRINTF_ARG_ALIGN(arg) - 1U
+
+/* Append one argument to the package being built by
+ * Z_CBPRINTF_STATIC_PACKAGE(). The argument is evaluated once. Only the
+ * size is accounted when the buffer is NULL or too small.
+ */
+#define Z_CBPRINTF_PACK_ARG(arg) do { \
+	__auto_type _v = (arg) + 0; \
+	double _d = _Generic(_v, float : _v, default : 0.0); \
+	size_t _size = Z_CBPRINTF_ARG_SIZE(arg); \
+	\
+	(void)_d; \
+	_ppos = Z_CBPRINTF_ALIGN(_ppos, Z_CBPRINTF_ARG_ALIGN(arg)); \
+	if ((_pbuf != NULL) && ((_ppos + _size) <= _plen)) { \
+		memcpy(&_pbuf[_ppos], \
+		       _Generic(_v, \
+				float : (const void *)&_d, \
+				default : (const void *)&_v), \
+		       _size); \
+	} \
+	_ppos += _size; \
+} while (false)
+
+#define Z_CBPRINTF_STATIC_PACKAGE(packaged, inlen, outlen, ...) do { \
+	uint8_t *_pbuf = (uint8_t *)(packaged); \
+	size_t _plen = (inlen); \
+	size_t _ppos = 0; \
+	\
+	FOR_EACH(Z_CBPRINTF_PACK_ARG, (;), __VA_ARGS__); \
+	(outlen) = ((_pbuf != NULL) && (_ppos > _plen)) ? \
+		   -ENOSPC : (int)_ppos; \
+} while (false)
+
+/* Fetch the next argument of @p type from a package, @p pos being the
+ * offset of the previous argument's end.
+ */
+#define Z_CBPRINTF_PKG_ARG(pkg, pos, type) ({ \
+	type _v; \
+	\
+	(pos) = Z_CBPRINTF_ALIGN(pos, __alignof__(type)); \
+	memcpy(&_v, &(pkg)[pos], sizeof(type)); \
+	(pos) += sizeof(type); \
+	_v; \
+})
+
+#endif /* ZEPHYR_INCLUDE_SYS_CBPRINTF_INTERNAL_H_ */
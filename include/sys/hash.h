@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Non-cryptographic and keyed hash functions
+ *
+ * These hash functions are meant for hash tables (see sys/hash_map.h):
+ *
+ * - sys_hash32_xxh32() is xxHash32, a fast hash of byte strings with good
+ *   distribution, for keys that are not chosen by an attacker.
+ * - sys_hash32_halfsiphash() is HalfSipHash-2-4, a keyed hash working on
+ *   32-bit words, slower than xxHash32 but resistant to hash flooding when
+ *   the key is secret: use it for tables indexed by data received from the
+ *   network.
+ * - sys_hash32_u32() mixes the bits of an integer, for tables indexed by
+ *   numbers or pointers.
+ *
+ * None of them is suitable for cryptographic purposes.
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_HASH_H_
+#define ZEPHYR_INCLUDE_SYS_HASH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup hash_apis Hash Functions
+ * @ingroup datastructure_apis
+ * @{
+ */
+
+/**
+ * @brief Compute the xxHash32 of a byte string
+ *
+ * @param data Data to hash
+ * @param len Length of @a data in bytes
+ * @param seed Seed, 0 if not needed
+ *
+ * @return The 32-bit hash, identical to the reference implementation's
+ * XXH32().
+ */
+uint32_t sys_hash32_xxh32(const void *data, size_t len, uint32_t seed);
+
+/**
+ * @brief Compute the HalfSipHash-2-4 of a byte string
+ *
+ * @param data Data to hash
+ * @param len Length of @a data in bytes
+ * @param key 64-bit secret key
+ *
+ * @return The 32-bit hash, identical to the reference implementation's
+ * halfsiphash() with a 4 bytes output.
+ */
+uint32_t sys_hash32_halfsiphash(const void *data, size_t len,
+				const uint8_t key[8]);
+
+/**
+ * @brief Hash a byte string with the default hash function
+ *
+ * @param data Data to hash
+ * @param len Length of @a data in bytes
+ *
+ * @return The 32-bit hash
+ */
+static inline uint32_t sys_hash32(const void *data, size_t len)
+{
+	return sys_hash32_xxh32(data, len, 0);
+}
+
+/**
+ * @brief Mix the bits of a 32-bit integer
+ *
+ * A bijective function, the finalizer of MurmurHash3: every bit of the
+ * input affects every bit of the output.
+ *
+ * @param x Integer to hash
+ *
+ * @return The 32-bit hash
+ */
+static inline uint32_t sys_hash32_u32(uint32_t x)
+{
+	x ^= x >> 16;
+	x *= 0x85ebca6bU;
+	x ^= x >> 13;
+	x *= 0xc2b2ae35U;
+	x ^= x >> 16;
+
+	return x;
+}
+
+/**
+ * @brief Hash a pointer
+ *
+ * @param ptr Pointer to hash
+ *
+ * @return The 32-bit hash
+ */
+static inline uint32_t sys_hash32_ptr(const void *ptr)
+{
+	uintptr_t val = (uintptr_t)ptr;
+
+#if UINTPTR_MAX > UINT32_MAX
+	val ^= val >> 32;
+#endif
+
+	return sys_hash32_u32((uint32_t)val);
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_HASH_H_ */
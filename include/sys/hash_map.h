@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Intrusive open addressing hash map
+ *
+ * The map is an array of pointers to nodes, struct sys_hash_node, that are
+ * embedded in the user's structures the same way as other intrusive data
+ * structures (e.g. struct rbnode), so that the map never allocates nodes.
+ * Collisions are resolved by linear probing with the Robin Hood heuristic:
+ * a node being inserted takes the slot of a node closer to its home slot,
+ * which keeps the probe sequences short and lets lookups of absent keys
+ * stop early. Removal shifts the following nodes back, there are no
+ * tombstones.
+ *
+ * The node stores the hash of its key, computed by the caller (see
+ * sys/hash.h), so that the map does not need to know how keys are stored
+ * and probing only calls the equality function of the map on full hash
+ * matches.
+ *
+ * A static map uses a slot array given at initialization and never
+ * allocates; it can hold up to 7/8 of its slots. A dynamic map allocates
+ * its slot array with the function given at initialization, doubling it
+ * when 3/4 of the slots are used.
+ *
+ * Maps are not thread safe, the caller has to serialize accesses.
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_HASH_MAP_H_
+#define ZEPHYR_INCLUDE_SYS_HASH_MAP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <toolchain.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup hash_map_apis Hash Map
+ * @ingroup datastructure_apis
+ * @{
+ */
+
+/** @brief Hash map node, to embed in the structures stored in a map */
+struct sys_hash_node {
+	/** Hash of the key of the node, set when inserting it */
+	uint32_t hash;
+};
+
+/**
+ * @brief Key equality predicate of a hash map
+ *
+ * @param node Node of the map, whose hash matches the hash of @a key
+ * @param key Key being looked up, as passed to the map functions
+ *
+ * @return true if the key of @a node is @a key
+ */
+typedef bool (*sys_hash_map_eq_t)(const struct sys_hash_node *node,
+				  const void *key);
+
+/**
+ * @brief Allocator of the slot array of a dynamic hash map
+ *
+ * Allocates @a size bytes, aligned for pointers, when @a ptr is NULL, and
+ * frees @a ptr otherwise (@a size is then 0).
+ */
+typedef void *(*sys_hash_map_alloc_t)(void *ptr, size_t size);
+
+/** @brief Hash map */
+struct sys_hash_map {
+	struct sys_hash_node **slots;
+	uint32_t mask;
+	uint32_t count;
+	sys_hash_map_eq_t eq;
+	sys_hash_map_alloc_t alloc;
+};
+
+/**
+ * @brief Statically define and initialize a static hash map
+ *
+ * @param name Name of the map
+ * @param n_slots Number of slots, a power of 2
+ * @param eq_fn Key equality predicate
+ */
+#define SYS_HASH_MAP_DEFINE(name, n_slots, eq_fn) \
+	BUILD_ASSERT(((n_slots) & ((n_slots) - 1)) == 0, \
+		     "number of slots must be a power of 2"); \
+	static struct sys_hash_node *_CONCAT(name, _slots)[n_slots]; \
+	struct sys_hash_map name = { \
+		.slots = _CONCAT(name, _slots), \
+		.mask = (n_slots) - 1, \
+		.eq = (eq_fn), \
+	}
+
+/**
+ * @brief Initialize a static hash map
+ *
+ * @param map Map to initialize
+ * @param slots Slot array, which the map owns until it is not used anymore
+ * @param n_slots Number of slots, a power of 2
+ * @param eq Key equality predicate
+ */
+void sys_hash_map_init(struct sys_hash_map *map, struct sys_hash_node **slots,
+		       size_t n_slots, sys_hash_map_eq_t eq);
+
+/**
+ * @brief Initialize a dynamic hash map
+ *
+ * The slot array is allocated on the first insertion.
+ *
+ * @param map Map to initialize
+ * @param eq Key equality predicate
+ * @param alloc Allocator of the slot array
+ */
+void sys_hash_map_init_dynamic(struct sys_hash_map *map, sys_hash_map_eq_t eq,
+			       sys_hash_map_alloc_t alloc);
+
+/**
+ * @brief Remove all the nodes of a map
+ *
+ * The slot array of a dynamic map is freed.
+ *
+ * @param map Map to clear
+ */
+void sys_hash_map_clear(struct sys_hash_map *map);
+
+/**
+ * @brief Insert a node in a map
+ *
+ * @param map Map
+ * @param node Node to insert, not in any map
+ * @param hash Hash of the key of the node
+ * @param key Key of the node, as passed to the equality predicate
+ *
+ * @retval 0 on success
+ * @retval -EEXIST if a node with the same key is in the map
+ * @retval -ENOMEM if a static map is full, or the slot array of a dynamic
+ * map could not be grown
+ */
+int sys_hash_map_insert(struct sys_hash_map *map, struct sys_hash_node *node,
+			uint32_t hash, const void *key);
+
+/**
+ * @brief Look up a key in a map
+ *
+ * @param map Map
+ * @param hash Hash of the key
+ * @param key Key, as passed to the equality predicate
+ *
+ * @return The node of the key, or NULL if not found
+ */
+struct sys_hash_node *sys_hash_map_get(const struct sys_hash_map *map,
+				       uint32_t hash, const void *key);
+
+/**
+ * @brief Remove a key from a map
+ *
+ * @param map Map
+ * @param hash Hash of the key
+ * @param key Key, as passed to the equality predicate
+ *
+ * @return The removed node, or NULL if not found
+ */
+struct sys_hash_node *sys_hash_map_remove(struct sys_hash_map *map,
+					  uint32_t hash, const void *key);
+
+/**
+ * @brief Remove a node from a map
+ *
+ * Unlike sys_hash_map_remove(), the equality predicate is not called.
+ *
+ * @param map Map
+ * @param node Node of the map
+ *
+ * @return true if the node was removed, false if it is not in the map
+ */
+bool sys_hash_map_remove_node(struct sys_hash_map *map,
+			      struct sys_hash_node *node);
+
+/**
+ * @brief Number of nodes in a map
+ *
+ * @param map Map
+ *
+ * @return The number of nodes
+ */
+static inline size_t sys_hash_map_count(const struct sys_hash_map *map)
+{
+	return map->count;
+}
+
+/**
+ * @brief Get the next node of a map, for iteration
+ *
+ * @param map Map
+ * @param it Iterator, 0 to get the first node
+ *
+ * @return The next node, or NULL when all nodes have been returned
+ */
+static inline struct sys_hash_node *sys_hash_map_next(
+	const struct sys_hash_map *map, size_t *it)
+{
+	if (map->slots == NULL) {
+		return NULL;
+	}
+
+	while (*it <= map->mask) {
+		struct sys_hash_node *node = map->slots[(*it)++];
+
+		if (node != NULL) {
+			return node;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Iterate over the nodes of a map, in no particular order
+ *
+ * The map must not be modified during the iteration.
+ *
+ * @param map Map
+ * @param it size_t iterator variable
+ * @param node struct sys_hash_node pointer variable
+ */
+#define SYS_HASH_MAP_FOR_EACH(map, it, node) \
+	for ((it) = 0; ((node) = sys_hash_map_next((map), &(it))) != NULL;)
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_HASH_MAP_H_ */
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file event objects library
+ *
+ * Event objects are used to signal one or more threads that a custom set of
+ * events has occurred. Threads wait on event objects until another thread or
+ * ISR posts the desired set of events to the event object. Each time events
+ * are posted to an event object, all threads waiting on that event object are
+ * processed to determine if there is a match. All threads whose wait
+ * conditions match the current set of events now belonging to the event
+ * object are awakened.
+ *
+ * Threads waiting on an event object have the option of either waking once
+ * any or all of the events it desires have been posted to the event object,
+ * and of clearing the matching events when they wake up.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <toolchain.h>
+#include <wait_q.h>
+#include <sys/dlist.h>
+#include <ksched.h>
+#include <init.h>
+#include <syscall_handler.h>
+#include <sys/__assert.h>
+
+#define K_EVENT_WAIT_ANY      0x00   /* Wait for any events */
+#define K_EVENT_WAIT_ALL      0x01   /* Wait for all events */
+#define K_EVENT_WAIT_CLEAR    0x02   /* Clear matching events on exit */
+
+/* All event objects share a single lock, in the same way semaphores and
+ * condition variables do.
+ */
+static struct k_spinlock lock;
+
+void z_impl_k_event_init(struct k_event *event)
+{
+	event->events = 0;
+	z_waitq_init(&event->wait_q);
+#if defined(CONFIG_POLL)
+	sys_dlist_init(&event->poll_events);
+#endif
+
+	z_object_init(event);
+}
+
+#ifdef CONFIG_USERSPACE
+void z_vrfy_k_event_init(struct k_event *event)
+{
+	Z_OOPS(Z_SYSCALL_OBJ_INIT(event, K_OBJ_EVENT));
+	z_impl_k_event_init(event);
+}
+#include <syscalls/k_event_init_mrsh.c>
+#endif
+
+static inline void handle_poll_events(struct k_event *event)
+{
+#ifdef CONFIG_POLL
+	z_handle_obj_poll_events(&event->poll_events,
+				 K_POLL_STATE_EVENT_POSTED);
+#else
+	ARG_UNUSED(event);
+#endif
+}
+
+/**
+ * @brief Determine which of the desired events satisfy a wait condition
+ *
+ * @return Set of matching events, or 0 if the wait condition is not met
+ */
+static uint32_t match_events(uint32_t desired, uint32_t current,
+			     uint32_t options)
+{
+	uint32_t match = current & desired;
+
+	if ((options & K_EVENT_WAIT_ALL) != 0) {
+		return (match == desired) ? match : 0;
+	}
+
+	return match;
+}
+
+static void k_event_post_internal(struct k_event *event, uint32_t events,
+				  bool accumulate)
+{
+	k_spinlock_key_t key;
+	struct k_thread *thread;
+	struct k_thread *head = NULL;
+	struct k_thread *tail = NULL;
+	uint32_t clear_events = 0;
+	uint32_t match;
+
+	key = k_spin_lock(&lock);
+
+	if (accumulate) {
+		events |= event->events;
+	}
+
+	event->events = events;
+
+	/*
+	 * Threads can not be unpended while walking the wait queue, so the
+	 * threads whose wait conditions are met are first collected into a
+	 * singly linked list (in wait queue order), and only then unpended
+	 * and readied. This way all eligible waiters are woken in a single
+	 * pass, whatever their number.
+	 */
+
+	_WAIT_Q_FOR_EACH(&event->wait_q, thread) {
+		match = match_events(thread->events, events,
+				     thread->event_options);
+		if (match == 0) {
+			continue;
+		}
+
+		/*
+		 * The thread's desired events are no longer needed once it
+		 * has been selected: record what actually woke it instead so
+		 * that it can be returned by the wait routine.
+		 */
+		thread->events = match;
+		thread->next_event_link = NULL;
+		if (tail == NULL) {
+			head = thread;
+		} else {
+			tail->next_event_link = thread;
+		}
+		tail = thread;
+
+		if ((thread->event_options & K_EVENT_WAIT_CLEAR) != 0) {
+			clear_events |= match;
+		}
+	}
+
+	for (thread = head; thread != NULL; thread = thread->next_event_link) {
+		z_unpend_thread(thread);
+		arch_thread_return_value_set(thread, 0);
+		z_ready_thread(thread);
+	}
+
+	event->events &= ~clear_events;
+
+	if (event->events != 0) {
+		handle_poll_events(event);
+	}
+
+	z_reschedule(&lock, key);
+}
+
+void z_impl_k_event_post(struct k_event *event, uint32_t events)
+{
+	k_event_post_internal(event, events, true);
+}
+
+#ifdef CONFIG_USERSPACE
+void z_vrfy_k_event_post(struct k_event *event, uint32_t events)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	z_impl_k_event_post(event, events);
+}
+#include <syscalls/k_event_post_mrsh.c>
+#endif
+
+void z_impl_k_event_set(struct k_event *event, uint32_t events)
+{
+	k_event_post_internal(event, events, false);
+}
+
+#ifdef CONFIG_USERSPACE
+void z_vrfy_k_event_set(struct k_event *event, uint32_t events)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	z_impl_k_event_set(event, events);
+}
+#include <syscalls/k_event_set_mrsh.c>
+#endif
+
+void z_impl_k_event_clear(struct k_event *event, uint32_t events)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	event->events &= ~events;
+
+	k_spin_unlock(&lock, key);
+}
+
+#ifdef CONFIG_USERSPACE
+void z_vrfy_k_event_clear(struct k_event *event, uint32_t events)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	z_impl_k_event_clear(event, events);
+}
+#include <syscalls/k_event_clear_mrsh.c>
+#endif
+
+static uint32_t k_event_wait_internal(struct k_event *event, uint32_t events,
+				      uint32_t options, k_timeout_t timeout)
+{
+	uint32_t rv = 0;
+	uint32_t match;
+	k_spinlock_key_t key;
+
+	__ASSERT(((arch_is_in_isr() == false) ||
+		  K_TIMEOUT_EQ(timeout, K_NO_WAIT)), "");
+
+	if (events == 0) {
+		return 0;
+	}
+
+	key = k_spin_lock(&lock);
+
+	match = match_events(events, event->events, options);
+	if (match != 0) {
+		if ((options & K_EVENT_WAIT_CLEAR) != 0) {
+			event->events &= ~match;
+		}
+		k_spin_unlock(&lock, key);
+		return match;
+	}
+
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		k_spin_unlock(&lock, key);
+		return 0;
+	}
+
+	/*
+	 * The desired events and wait options are stored in the thread so
+	 * that k_event_post_internal() can evaluate the wait condition. On
+	 * a successful wake up, the poster overwrites the desired events with
+	 * the set of matching events.
+	 */
+
+	_current->events = events;
+	_current->event_options = options;
+
+	if (z_pend_curr(&lock, key, &event->wait_q, timeout) == 0) {
+		rv = _current->events;
+	}
+
+	return rv;
+}
+
+uint32_t z_impl_k_event_wait(struct k_event *event, uint32_t events,
+			     bool clear, k_timeout_t timeout)
+{
+	uint32_t options = clear ? K_EVENT_WAIT_CLEAR : 0;
+
+	return k_event_wait_internal(event, events,
+				     K_EVENT_WAIT_ANY | options, timeout);
+}
+
+#ifdef CONFIG_USERSPACE
+uint32_t z_vrfy_k_event_wait(struct k_event *event, uint32_t events,
+			     bool clear, k_timeout_t timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	return z_impl_k_event_wait(event, events, clear, timeout);
+}
+#include <syscalls/k_event_wait_mrsh.c>
+#endif
+
+uint32_t z_impl_k_event_wait_all(struct k_event *event, uint32_t events,
+				 bool clear, k_timeout_t timeout)
+{
+	uint32_t options = clear ? K_EVENT_WAIT_CLEAR : 0;
+
+	return k_event_wait_internal(event, events,
+				     K_EVENT_WAIT_ALL | options, timeout);
+}
+
+#ifdef CONFIG_USERSPACE
+uint32_t z_vrfy_k_event_wait_all(struct k_event *event, uint32_t events,
+				 bool clear, k_timeout_t timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	return z_impl_k_event_wait_all(event, events, clear, timeout);
+}
+#include <syscalls/k_event_wait_all_mrsh.c>
+
+static inline uint32_t z_vrfy_k_event_events_get(struct k_event *event)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	return z_impl_k_event_events_get(event);
+}
+#include <syscalls/k_event_events_get_mrsh.c>
+#endif
@@ -107,6 +107,10 @@ void z_pm_save_idle_exit(int32_t ticks)
 	}
 #endif	/* CONFIG_PM */
 	z_clock_idle_exit();
+#ifdef CONFIG_PM_POLICY_GOVERNOR
+	/* Record the wake-up time once the kernel clock is up to date */
+	z_pm_governor_idle_exit();
+#endif
 }
 
 
@@ -164,6 +168,13 @@ void idle(void *p1, void *unused2, void *unused3)
 			continue;
 		}
 
+#ifdef CONFIG_RCU
+		/* The idle thread never runs RCU readers: every pass through
+		 * the idle loop is a quiescent state for this CPU.
+		 */
+		z_rcu_qs(_current);
+#endif
+
 #if SMP_FALLBACK
 		arch_irq_unlock(key);
 
@@ -192,6 +192,18 @@ void z_thread_mark_switched_out(void);
 
 #endif /* CONFIG_INSTRUMENT_THREAD_SWITCHING */
 
+#ifdef CONFIG_RCU
+/* Report an RCU quiescent state for the current CPU. Called with
+ * interrupts locked when a thread is switched out, and by the idle loop.
+ */
+void z_rcu_qs(struct k_thread *outgoing);
+
+/* Report an RCU quiescent state for the current CPU from the timer tick or
+ * an IPI, unless the interrupted thread is inside a critical section.
+ */
+void z_rcu_isr_qs(void);
+#endif
+
 /* Init hook for page frame management, invoked immediately upon entry of
  * main thread, before POST_KERNEL tasks
  */
@@ -184,6 +184,10 @@ static inline void z_dummy_thread_init(struct k_thread *dummy_thread)
 	dummy_thread->base.cpu_mask = -1;
 #endif
 	dummy_thread->base.user_options = K_ESSENTIAL;
+#ifdef CONFIG_RCU
+	dummy_thread->base.rcu_nesting = 0U;
+	dummy_thread->base.rcu_blocked = 0U;
+#endif
 #ifdef CONFIG_THREAD_STACK_INFO
 	dummy_thread->stack_info.start = 0U;
 	dummy_thread->stack_info.size = 0U;
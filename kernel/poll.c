@@ -78,6 +78,14 @@ static inline bool is_condition_met(struct k_poll_event *event, uint32_t *state)
 			return true;
 		}
 		break;
+#ifdef CONFIG_EVENTS
+	case K_POLL_TYPE_EVENT:
+		if (event->kevent->events != 0U) {
+			*state = K_POLL_STATE_EVENT_POSTED;
+			return true;
+		}
+		break;
+#endif
 	case K_POLL_TYPE_IGNORE:
 		break;
 	default:
@@ -129,11 +137,21 @@ static inline void register_event(struct k_poll_event *event,
 	case K_POLL_TYPE_DATA_AVAILABLE:
 		__ASSERT(event->queue != NULL, "invalid queue\n");
 		add_event(&event->queue->poll_events, event, poller);
+#ifdef CONFIG_QUEUE_LOCKFREE_PUT
+		/* Make lock-free producers take the notification path */
+		atomic_inc(&event->queue->waiters);
+#endif
 		break;
 	case K_POLL_TYPE_SIGNAL:
 		__ASSERT(event->signal != NULL, "invalid poll signal\n");
 		add_event(&event->signal->poll_events, event, poller);
 		break;
+#ifdef CONFIG_EVENTS
+	case K_POLL_TYPE_EVENT:
+		__ASSERT(event->kevent != NULL, "invalid event object\n");
+		add_event(&event->kevent->poll_events, event, poller);
+		break;
+#endif
 	case K_POLL_TYPE_IGNORE:
 		/* nothing to do */
 		break;
@@ -160,11 +178,20 @@ static inline void clear_event_registration(struct k_poll_event *event)
 	case K_POLL_TYPE_DATA_AVAILABLE:
 		__ASSERT(event->queue != NULL, "invalid queue\n");
 		remove = true;
+#ifdef CONFIG_QUEUE_LOCKFREE_PUT
+		atomic_dec(&event->queue->waiters);
+#endif
 		break;
 	case K_POLL_TYPE_SIGNAL:
 		__ASSERT(event->signal != NULL, "invalid poll signal\n");
 		remove = true;
 		break;
+#ifdef CONFIG_EVENTS
+	case K_POLL_TYPE_EVENT:
+		__ASSERT(event->kevent != NULL, "invalid event object\n");
+		remove = true;
+		break;
+#endif
 	case K_POLL_TYPE_IGNORE:
 		/* nothing to do */
 		break;
@@ -213,6 +240,16 @@ static inline int register_events(struct k_poll_event *events,
 		} else if (!just_check && poller->is_polling) {
 			register_event(&events[ii], poller);
 			events_registered += 1;
+
+			/* Data staged by a lock-free producer before it could
+			 * see the registration would not be notified.
+			 */
+			if (IS_ENABLED(CONFIG_QUEUE_LOCKFREE_PUT) &&
+			    (events[ii].type == K_POLL_TYPE_DATA_AVAILABLE) &&
+			    is_condition_met(&events[ii], &state)) {
+				set_event_ready(&events[ii], state);
+				poller->is_polling = false;
+			}
 		}
 		k_spin_unlock(&lock, key);
 	}
@@ -362,6 +399,11 @@ static inline int z_vrfy_k_poll(struct k_poll_event *events,
 		case K_POLL_TYPE_DATA_AVAILABLE:
 			Z_OOPS(Z_SYSCALL_OBJ(e->queue, K_OBJ_QUEUE));
 			break;
+#ifdef CONFIG_EVENTS
+		case K_POLL_TYPE_EVENT:
+			Z_OOPS(Z_SYSCALL_OBJ(e->kevent, K_OBJ_EVENT));
+			break;
+#endif
 		default:
 			ret = -EINVAL;
 			goto out_free;
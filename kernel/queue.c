@@ -81,6 +81,11 @@ void z_impl_k_queue_init(struct k_queue *queue)
 	sys_sflist_init(&queue->data_q);
 	queue->lock = (struct k_spinlock) {};
 	z_waitq_init(&queue->wait_q);
+#ifdef CONFIG_QUEUE_LOCKFREE_PUT
+	(void)atomic_ptr_clear(&queue->staged_tail);
+	(void)atomic_ptr_clear(&queue->staged_head);
+	(void)atomic_clear(&queue->waiters);
+#endif
 #if defined(CONFIG_POLL)
 	sys_dlist_init(&queue->poll_events);
 #endif
@@ -111,6 +116,133 @@ static inline void handle_poll_events(struct k_queue *queue, uint32_t state)
 #endif
 }
 
+#ifdef CONFIG_QUEUE_LOCKFREE_PUT
+/*
+ * Lock-free put fast path
+ *
+ * k_queue_append() and k_queue_prepend() of caller-provided items push
+ * them on one of two Treiber stacks (staged_tail and staged_head) with a
+ * single compare-and-swap, without taking the queue lock. Only pushes are
+ * lock-free: popping individual nodes from an intrusive stack with
+ * multiple consumers is subject to ABA. Instead, any operation done under
+ * the queue lock first detaches both stacks with an atomic exchange and
+ * splices them at their end of data_q, preserving the put order.
+ *
+ * To avoid lost wake-ups, consumers about to pend (and pollers about to
+ * wait) increment the waiters count before checking the stacks one last
+ * time, while producers check the count after pushing. Whenever it is
+ * non-zero, the producer takes the lock to hand the items over.
+ */
+
+static sys_sfnode_t *staged_reverse(sys_sfnode_t *node)
+{
+	sys_sfnode_t *prev = NULL;
+
+	while (node != NULL) {
+		sys_sfnode_t *next = (sys_sfnode_t *)node->next_and_flags;
+
+		node->next_and_flags = (unative_t)prev;
+		prev = node;
+		node = next;
+	}
+
+	return prev;
+}
+
+/* must be called with the queue lock held */
+static void queue_staged_flush_locked(struct k_queue *queue)
+{
+	sys_sfnode_t *node, *next;
+
+	/* The head stack is popped newest first, which already is the order
+	 * the items must have at the head of the queue: prepend them oldest
+	 * first.
+	 */
+	node = atomic_ptr_clear(&queue->staged_head);
+	for (node = staged_reverse(node); node != NULL; node = next) {
+		next = (sys_sfnode_t *)node->next_and_flags;
+		sys_sfnode_init(node, 0x0);
+		sys_sflist_prepend(&queue->data_q, node);
+	}
+
+	/* The tail stack is reversed into a list ordered oldest first, and
+	 * appended as a whole.
+	 */
+	node = atomic_ptr_clear(&queue->staged_tail);
+	if (node != NULL) {
+		sys_sfnode_t *tail = node;
+
+		node = staged_reverse(node);
+		sys_sflist_append_list(&queue->data_q, node, tail);
+	}
+}
+
+void z_queue_staged_flush(struct k_queue *queue)
+{
+	k_spinlock_key_t key;
+
+	if (z_queue_staged_is_empty(queue)) {
+		return;
+	}
+
+	key = k_spin_lock(&queue->lock);
+	queue_staged_flush_locked(queue);
+	k_spin_unlock(&queue->lock, key);
+}
+
+static void queue_stage(atomic_ptr_t *stack, sys_sfnode_t *node)
+{
+	void *top;
+
+	do {
+		top = atomic_ptr_get(stack);
+		node->next_and_flags = (unative_t)top;
+	} while (!atomic_ptr_cas(stack, top, node));
+}
+
+static void queue_put_lockfree(struct k_queue *queue, void *data,
+			       bool is_append)
+{
+	struct k_thread *thread;
+	k_spinlock_key_t key;
+
+	queue_stage(is_append ? &queue->staged_tail : &queue->staged_head,
+		    data);
+
+	if (likely(atomic_get(&queue->waiters) == 0)) {
+		return;
+	}
+
+	/* Someone is, or is about to be, waiting: hand the staged items
+	 * over to pending threads, then notify pollers of what remains.
+	 */
+	key = k_spin_lock(&queue->lock);
+	queue_staged_flush_locked(queue);
+
+	while (!sys_sflist_is_empty(&queue->data_q)) {
+		thread = z_unpend_first_thread(&queue->wait_q);
+		if (thread == NULL) {
+			break;
+		}
+
+		data = z_queue_node_peek(
+			sys_sflist_get_not_empty(&queue->data_q), true);
+		prepare_thread_to_run(thread, data);
+	}
+
+	if (!sys_sflist_is_empty(&queue->data_q)) {
+		handle_poll_events(queue, K_POLL_STATE_DATA_AVAILABLE);
+	}
+
+	z_reschedule(&queue->lock, key);
+}
+#else
+static inline void queue_staged_flush_locked(struct k_queue *queue)
+{
+	ARG_UNUSED(queue);
+}
+#endif /* CONFIG_QUEUE_LOCKFREE_PUT */
+
 void z_impl_k_queue_cancel_wait(struct k_queue *queue)
 {
 	k_spinlock_key_t key = k_spin_lock(&queue->lock);
@@ -139,7 +271,17 @@ static int32_t queue_insert(struct k_queue *queue, void *prev, void *data,
 			    bool alloc, bool is_append)
 {
 	struct k_thread *first_pending_thread;
-	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+	k_spinlock_key_t key;
+
+#ifdef CONFIG_QUEUE_LOCKFREE_PUT
+	if (!alloc && (is_append || (prev == NULL))) {
+		queue_put_lockfree(queue, data, is_append);
+		return 0;
+	}
+#endif
+
+	key = k_spin_lock(&queue->lock);
+	queue_staged_flush_locked(queue);
 
 	if (is_append) {
 		prev = sys_sflist_peek_tail(&queue->data_q);
@@ -230,6 +372,8 @@ int k_queue_append_list(struct k_queue *queue, void *head, void *tail)
 	k_spinlock_key_t key = k_spin_lock(&queue->lock);
 	struct k_thread *thread = NULL;
 
+	queue_staged_flush_locked(queue);
+
 	if (head != NULL) {
 		thread = z_unpend_first_thread(&queue->wait_q);
 	}
@@ -281,6 +425,8 @@ void *z_impl_k_queue_get(struct k_queue *queue, k_timeout_t timeout)
 	k_spinlock_key_t key = k_spin_lock(&queue->lock);
 	void *data;
 
+	queue_staged_flush_locked(queue);
+
 	if (likely(!sys_sflist_is_empty(&queue->data_q))) {
 		sys_sfnode_t *node;
 
@@ -295,8 +441,29 @@ void *z_impl_k_queue_get(struct k_queue *queue, k_timeout_t timeout)
 		return NULL;
 	}
 
+#ifdef CONFIG_QUEUE_LOCKFREE_PUT
+	/* Announce the waiter before the last check of the staged items:
+	 * a producer staging an item after this point takes the lock and
+	 * hands it over.
+	 */
+	atomic_inc(&queue->waiters);
+	queue_staged_flush_locked(queue);
+
+	if (!sys_sflist_is_empty(&queue->data_q)) {
+		atomic_dec(&queue->waiters);
+		data = z_queue_node_peek(
+			sys_sflist_get_not_empty(&queue->data_q), true);
+		k_spin_unlock(&queue->lock, key);
+		return data;
+	}
+#endif
+
 	int ret = z_pend_curr(&queue->lock, key, &queue->wait_q, timeout);
 
+#ifdef CONFIG_QUEUE_LOCKFREE_PUT
+	atomic_dec(&queue->waiters);
+#endif
+
 	return (ret != 0) ? NULL : _current->base.swap_data;
 }
 
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Read-copy-update (RCU) grace period detection
+ *
+ * Readers only maintain a nesting count in their thread structure, readers
+ * in ISRs in the one of the interrupted thread. Grace periods are detected
+ * from two sources:
+ *
+ * - Per-CPU quiescent states. Each time a CPU switches threads or runs its
+ *   idle loop, it calls z_rcu_qs(): no reader can be running on that CPU at
+ *   that point. The timer tick and scheduler IPIs call z_rcu_isr_qs(),
+ *   which reports one when the interrupted thread has no critical section
+ *   in progress, so that a CPU running a single thread does not hold up
+ *   grace periods. The CPU then acknowledges the current grace period
+ *   phase.
+ *
+ * - Blocked readers. A thread switched out while inside a read-side
+ *   critical section is accounted in blocked_readers[] under the phase its
+ *   CPU had last acknowledged, and releases that count when it leaves the
+ *   outermost critical section.
+ *
+ * A grace period flips the global phase, waits until every CPU has reported
+ * a quiescent state since the flip, then waits until no reader remains
+ * blocked in the previous phase. Any reader that started before the flip
+ * has by then either completed or been accounted in the previous phase.
+ *
+ * Quiescent states are only ever reported by the CPU itself: checking
+ * another CPU for an idle thread or a zero nesting count would race with
+ * readers, including ISRs, starting on it without any memory barrier.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <kernel_internal.h>
+#include <spinlock.h>
+#include <rcu.h>
+#include <sys/atomic.h>
+#include <sys/slist.h>
+#include <sys/__assert.h>
+
+/* Current grace period phase, 0 or 1 */
+static atomic_t rcu_phase;
+
+/* Readers preempted inside a read-side critical section, per phase */
+static atomic_t blocked_readers[2];
+
+/* Serializes grace periods */
+static K_MUTEX_DEFINE(gp_lock);
+
+/* Callbacks queued by k_rcu_call(), waiting for the next grace period */
+static struct k_spinlock cb_lock;
+static sys_slist_t cb_list = SYS_SLIST_STATIC_INIT(&cb_list);
+static K_SEM_DEFINE(cb_sem, 0, 1);
+
+static void qs_report(struct _cpu *cpu)
+{
+	/* Count the quiescent state before reading the phase: once the
+	 * writer sees the count change after its flip, the CPU acknowledges
+	 * the new phase and accounts later blocked readers under it.
+	 */
+	(void)atomic_inc(&cpu->rcu_qs);
+	cpu->rcu_phase = (uint8_t)atomic_get(&rcu_phase);
+}
+
+void z_rcu_qs(struct k_thread *outgoing)
+{
+	struct _cpu *cpu = _current_cpu;
+
+	if ((outgoing->base.rcu_nesting != 0U) &&
+	    (outgoing->base.rcu_blocked == 0U)) {
+		outgoing->base.rcu_blocked = 1U;
+		outgoing->base.rcu_phase = cpu->rcu_phase;
+		atomic_inc(&blocked_readers[cpu->rcu_phase]);
+	}
+
+	qs_report(cpu);
+}
+
+void z_rcu_isr_qs(void)
+{
+	struct _cpu *cpu = _current_cpu;
+
+	/* ISRs count their critical sections in the interrupted thread, so
+	 * this also covers an interrupted ISR inside one.
+	 */
+	if (cpu->current->base.rcu_nesting == 0U) {
+		qs_report(cpu);
+	}
+}
+
+void z_rcu_read_unlock_special(struct k_thread *thread)
+{
+	unsigned int key = arch_irq_lock();
+
+	/* The thread may have been switched out again between the end of
+	 * its critical section and here: that does not account it twice,
+	 * as rcu_blocked is still set.
+	 */
+	if (thread->base.rcu_blocked != 0U) {
+		thread->base.rcu_blocked = 0U;
+		atomic_dec(&blocked_readers[thread->base.rcu_phase]);
+	}
+
+	arch_irq_unlock(key);
+}
+
+static bool cpu_passed_qs(struct _cpu *cpu, atomic_val_t snapshot)
+{
+	return atomic_get(&cpu->rcu_qs) != snapshot;
+}
+
+void k_rcu_synchronize(void)
+{
+	atomic_val_t snapshot[CONFIG_MP_NUM_CPUS];
+	atomic_val_t old_phase;
+	unsigned int key;
+
+	__ASSERT(!arch_is_in_isr(), "RCU grace period wait from ISR");
+	__ASSERT(k_current_get()->base.rcu_nesting == 0U,
+		 "RCU grace period wait inside read-side critical section");
+
+	k_mutex_lock(&gp_lock, K_FOREVER);
+
+	old_phase = atomic_get(&rcu_phase);
+	(void)atomic_set(&rcu_phase, !old_phase);
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		snapshot[i] = atomic_get(&_kernel.cpus[i].rcu_qs);
+	}
+
+	/* The calling thread is not a reader: report the quiescent state
+	 * of its own CPU right away instead of waiting for a switch.
+	 */
+	key = arch_irq_lock();
+	z_rcu_qs(_current);
+	arch_irq_unlock(key);
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		while (!cpu_passed_qs(&_kernel.cpus[i], snapshot[i])) {
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_IPI_SUPPORTED)
+			/* Wake up idle CPUs and interrupt busy ones rather
+			 * than wait for their next switch or tick.
+			 */
+			arch_sched_ipi();
+#endif
+			k_sleep(K_TICKS(1));
+		}
+	}
+
+	while (atomic_get(&blocked_readers[old_phase]) != 0) {
+		k_sleep(K_TICKS(1));
+	}
+
+	k_mutex_unlock(&gp_lock);
+}
+
+void k_rcu_call(struct k_rcu_head *head, k_rcu_callback_t func)
+{
+	k_spinlock_key_t key;
+
+	__ASSERT_NO_MSG(func != NULL);
+
+	head->func = func;
+
+	key = k_spin_lock(&cb_lock);
+	sys_slist_append(&cb_list, &head->node);
+	k_spin_unlock(&cb_lock, key);
+
+	k_sem_give(&cb_sem);
+}
+
+struct rcu_barrier {
+	struct k_rcu_head head;
+	struct k_sem done;
+};
+
+static void rcu_barrier_cb(struct k_rcu_head *head)
+{
+	struct rcu_barrier *barrier =
+		CONTAINER_OF(head, struct rcu_barrier, head);
+
+	k_sem_give(&barrier->done);
+}
+
+void k_rcu_barrier(void)
+{
+	struct rcu_barrier barrier;
+
+	/* Callbacks are invoked in the order they were queued, so once the
+	 * barrier's own callback runs all previous ones have run as well.
+	 */
+	k_sem_init(&barrier.done, 0, 1);
+	k_rcu_call(&barrier.head, rcu_barrier_cb);
+	k_sem_take(&barrier.done, K_FOREVER);
+}
+
+static void rcu_cb_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		struct k_rcu_head *head, *next;
+		k_spinlock_key_t key;
+		sys_slist_t batch;
+
+		k_sem_take(&cb_sem, K_FOREVER);
+
+		key = k_spin_lock(&cb_lock);
+		batch = cb_list;
+		sys_slist_init(&cb_list);
+		k_spin_unlock(&cb_lock, key);
+
+		if (sys_slist_is_empty(&batch)) {
+			continue;
+		}
+
+		/* A single grace period covers the whole batch */
+		k_rcu_synchronize();
+
+		SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&batch, head, next, node) {
+			head->func(head);
+		}
+	}
+}
+
+K_THREAD_DEFINE(rcu_thread, CONFIG_RCU_THREAD_STACK_SIZE, rcu_cb_thread,
+		NULL, NULL, NULL, CONFIG_RCU_THREAD_PRIORITY, 0, 0);
@@ -0,0 +1,461 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file @brief reader-writer lock kernel services
+ *
+ * The state of a reader-writer lock is a single atomic word holding the
+ * number of readers and a few flags. As long as the lock is not contended,
+ * readers take and release it with a compare-and-swap and an atomic
+ * decrement, without taking any kernel lock. The slow paths, waiting,
+ * handing the lock over to waiters and priority inheritance, run under a
+ * spinlock shared by all reader-writer locks and set flags in the state
+ * word to force the fast paths of the other threads into the slow path.
+ *
+ * Writers always take the lock under the spinlock, so that the writer is
+ * known to the threads that wait for it and can inherit their priority.
+ * Only the writer inherits priorities: readers are not tracked.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <toolchain.h>
+#include <ksched.h>
+#include <wait_q.h>
+#include <errno.h>
+#include <syscall_handler.h>
+#include <sys/check.h>
+
+/* Number of readers holding the lock */
+#define READERS_MASK ((atomic_val_t)(BIT(29) - 1))
+/* Writers are waiting */
+#define WR_WAITING ((atomic_val_t)BIT(29))
+/* A writer holds the lock */
+#define WRITER ((atomic_val_t)BIT(30))
+/* Readers are waiting */
+#define RD_WAITING ((atomic_val_t)BIT(31))
+
+#define WAITING_MASK (WR_WAITING | RD_WAITING)
+
+static struct k_spinlock lock;
+
+int z_impl_k_rwlock_init(struct k_rwlock *rwlock, unsigned int policy)
+{
+	CHECKIF(policy > K_RWLOCK_PHASE_FAIR) {
+		return -EINVAL;
+	}
+
+	(void)atomic_set(&rwlock->state, 0);
+	z_waitq_init(&rwlock->rd_wait_q);
+	z_waitq_init(&rwlock->wr_wait_q);
+	rwlock->writer = NULL;
+	rwlock->writer_orig_prio = 0;
+	rwlock->policy = policy;
+
+	z_object_init(rwlock);
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_rwlock_init(struct k_rwlock *rwlock,
+				       unsigned int policy)
+{
+	Z_OOPS(Z_SYSCALL_OBJ_INIT(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_init(rwlock, policy);
+}
+#include <syscalls/k_rwlock_init_mrsh.c>
+#endif
+
+static inline bool read_blocked(struct k_rwlock *rwlock, atomic_val_t state)
+{
+	if ((state & WRITER) != 0) {
+		return true;
+	}
+
+	return (rwlock->policy != K_RWLOCK_PREFER_READER) &&
+	       ((state & WR_WAITING) != 0);
+}
+
+static int inherited_prio(struct k_thread *waiter, int prio)
+{
+	if ((waiter != NULL) && z_is_prio_higher(waiter->base.prio, prio)) {
+		prio = waiter->base.prio;
+	}
+
+	return prio;
+}
+
+/*
+ * Set the priority of the writer to the highest of its own and of the
+ * waiters, including @a incoming which is about to wait.
+ */
+static bool adjust_writer_prio(struct k_rwlock *rwlock,
+			       struct k_thread *incoming)
+{
+	struct k_thread *writer = rwlock->writer;
+	int prio;
+
+	/* A writer releasing the lock is not known anymore */
+	if (writer == NULL) {
+		return false;
+	}
+
+	prio = rwlock->writer_orig_prio;
+	prio = inherited_prio(z_waitq_head(&rwlock->wr_wait_q), prio);
+	prio = inherited_prio(z_waitq_head(&rwlock->rd_wait_q), prio);
+	prio = inherited_prio(incoming, prio);
+	if (prio != rwlock->writer_orig_prio) {
+		prio = z_get_new_prio_with_ceiling(prio);
+	}
+
+	if (writer->base.prio != prio) {
+		return z_set_prio(writer, prio);
+	}
+
+	return false;
+}
+
+/* Flags matching the wait queues, the other bits of @a state unchanged */
+static atomic_val_t with_flags(struct k_rwlock *rwlock, atomic_val_t state)
+{
+	state &= ~WAITING_MASK;
+
+	if (z_waitq_head(&rwlock->wr_wait_q) != NULL) {
+		state |= WR_WAITING;
+	}
+
+	if (z_waitq_head(&rwlock->rd_wait_q) != NULL) {
+		state |= RD_WAITING;
+	}
+
+	return state;
+}
+
+/* Update the flags to match the wait queues, called with the spinlock held */
+static void update_flags(struct k_rwlock *rwlock, atomic_val_t force)
+{
+	atomic_val_t state;
+	atomic_val_t new_state;
+
+	do {
+		state = atomic_get(&rwlock->state);
+		new_state = with_flags(rwlock, state) | force;
+	} while ((new_state != state) &&
+		 !atomic_cas(&rwlock->state, state, new_state));
+}
+
+/* Reserve the lock for a writer, unless readers or a writer hold it */
+static bool reserve_writer(struct k_rwlock *rwlock)
+{
+	atomic_val_t state;
+
+	do {
+		state = atomic_get(&rwlock->state);
+		if ((state & (READERS_MASK | WRITER)) != 0) {
+			return false;
+		}
+	} while (!atomic_cas(&rwlock->state, state, state | WRITER));
+
+	return true;
+}
+
+/*
+ * Hand the lock over to the waiters who can take it now, and update the
+ * flags. @a after_writer tells that a writer has just released the lock,
+ * in which case the phase fair policy lets the waiting readers go first.
+ *
+ * A waiter can time out on another CPU at any time, so the waiters are
+ * first removed from the wait queue and the lock is granted only to the
+ * threads that were actually unpended. Only this function and the slow
+ * path of the writers set WRITER, both under the spinlock, so the lock
+ * cannot be taken by a writer while the readers are woken up.
+ *
+ * Called with the spinlock held.
+ */
+static void handoff(struct k_rwlock *rwlock, bool after_writer)
+{
+	struct k_thread *thread;
+
+	for (;;) {
+		bool writers = z_waitq_head(&rwlock->wr_wait_q) != NULL;
+		bool readers = z_waitq_head(&rwlock->rd_wait_q) != NULL;
+		bool to_writer;
+
+		if (!writers) {
+			to_writer = false;
+		} else if (!readers) {
+			to_writer = true;
+		} else if (rwlock->policy == K_RWLOCK_PREFER_WRITER) {
+			to_writer = true;
+		} else if (rwlock->policy == K_RWLOCK_PHASE_FAIR) {
+			to_writer = !after_writer;
+		} else {
+			to_writer = false;
+		}
+
+		if (!to_writer) {
+			break;
+		}
+
+		/* The last reader will hand the lock over to the writer */
+		if (!reserve_writer(rwlock)) {
+			update_flags(rwlock, 0);
+			return;
+		}
+
+		thread = z_unpend_first_thread(&rwlock->wr_wait_q);
+		if (thread == NULL) {
+			/* The writers timed out meanwhile, try again */
+			(void)atomic_and(&rwlock->state, ~WRITER);
+			continue;
+		}
+
+		rwlock->writer = thread;
+		rwlock->writer_orig_prio = thread->base.prio;
+		(void)adjust_writer_prio(rwlock, NULL);
+		arch_thread_return_value_set(thread, 0);
+		z_ready_thread(thread);
+
+		/* The writer's release goes through the slow path to update
+		 * the flags, whether other writers wait or not.
+		 */
+		update_flags(rwlock, WR_WAITING);
+		return;
+	}
+
+	if ((atomic_get(&rwlock->state) & WRITER) == 0) {
+		/* The readers are counted one by one as they are unpended */
+		while ((thread = z_unpend_first_thread(&rwlock->rd_wait_q)) !=
+		       NULL) {
+			(void)atomic_inc(&rwlock->state);
+			arch_thread_return_value_set(thread, 0);
+			z_ready_thread(thread);
+		}
+	}
+
+	update_flags(rwlock, 0);
+}
+
+/* Clean up after a waiter timed out, called with the spinlock held */
+static int wait_timed_out(struct k_rwlock *rwlock, k_spinlock_key_t key)
+{
+	(void)adjust_writer_prio(rwlock, NULL);
+	handoff(rwlock, false);
+	z_reschedule(&lock, key);
+
+	return -EAGAIN;
+}
+
+int z_impl_k_rwlock_read_lock(struct k_rwlock *rwlock, k_timeout_t timeout)
+{
+	k_spinlock_key_t key;
+	atomic_val_t state;
+
+	__ASSERT(!arch_is_in_isr(), "rwlocks cannot be used inside ISRs");
+
+	/* Fast path */
+	do {
+		state = atomic_get(&rwlock->state);
+		if (read_blocked(rwlock, state)) {
+			break;
+		}
+		__ASSERT((state & READERS_MASK) != READERS_MASK,
+			 "too many readers");
+	} while (!atomic_cas(&rwlock->state, state, state + 1));
+
+	if (!read_blocked(rwlock, state)) {
+		return 0;
+	}
+
+	key = k_spin_lock(&lock);
+
+	if (rwlock->writer == _current) {
+		k_spin_unlock(&lock, key);
+		return -EDEADLK;
+	}
+
+	for (;;) {
+		state = atomic_get(&rwlock->state);
+		if (!read_blocked(rwlock, state)) {
+			if (atomic_cas(&rwlock->state, state, state + 1)) {
+				k_spin_unlock(&lock, key);
+				return 0;
+			}
+			continue;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			k_spin_unlock(&lock, key);
+			return -EBUSY;
+		}
+
+		/* From now on, releasing the lock takes the slow path */
+		if (atomic_cas(&rwlock->state, state, state | RD_WAITING)) {
+			break;
+		}
+	}
+
+	(void)adjust_writer_prio(rwlock, _current);
+
+	/* The reader is counted in the state when it is woken up */
+	if (z_pend_curr(&lock, key, &rwlock->rd_wait_q, timeout) == 0) {
+		return 0;
+	}
+
+	key = k_spin_lock(&lock);
+
+	return wait_timed_out(rwlock, key);
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_rwlock_read_lock(struct k_rwlock *rwlock,
+					    k_timeout_t timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_read_lock(rwlock, timeout);
+}
+#include <syscalls/k_rwlock_read_lock_mrsh.c>
+#endif
+
+int z_impl_k_rwlock_read_unlock(struct k_rwlock *rwlock)
+{
+	atomic_val_t state = atomic_get(&rwlock->state);
+	k_spinlock_key_t key;
+
+	__ASSERT(!arch_is_in_isr(), "rwlocks cannot be used inside ISRs");
+
+	CHECKIF(((state & READERS_MASK) == 0) || ((state & WRITER) != 0)) {
+		return -EINVAL;
+	}
+
+	state = atomic_dec(&rwlock->state);
+
+	/* Only writers wait while the lock is held by readers */
+	if (((state & READERS_MASK) != 1) || ((state & WR_WAITING) == 0)) {
+		return 0;
+	}
+
+	key = k_spin_lock(&lock);
+	handoff(rwlock, false);
+	z_reschedule(&lock, key);
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_rwlock_read_unlock(struct k_rwlock *rwlock)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_read_unlock(rwlock);
+}
+#include <syscalls/k_rwlock_read_unlock_mrsh.c>
+#endif
+
+int z_impl_k_rwlock_write_lock(struct k_rwlock *rwlock, k_timeout_t timeout)
+{
+	k_spinlock_key_t key;
+	atomic_val_t state;
+
+	__ASSERT(!arch_is_in_isr(), "rwlocks cannot be used inside ISRs");
+
+	key = k_spin_lock(&lock);
+
+	if (rwlock->writer == _current) {
+		k_spin_unlock(&lock, key);
+		return -EDEADLK;
+	}
+
+	for (;;) {
+		state = atomic_get(&rwlock->state);
+
+		/* Do not overtake the waiting writers, a release in
+		 * progress is about to hand the lock over to them.
+		 */
+		if (((state & (READERS_MASK | WRITER)) == 0) &&
+		    (z_waitq_head(&rwlock->wr_wait_q) == NULL)) {
+			if (atomic_cas(&rwlock->state, state,
+				       state | WRITER)) {
+				rwlock->writer = _current;
+				rwlock->writer_orig_prio = _current->base.prio;
+				k_spin_unlock(&lock, key);
+				return 0;
+			}
+			continue;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			k_spin_unlock(&lock, key);
+			return -EBUSY;
+		}
+
+		/* From now on, releasing the lock takes the slow path */
+		if (atomic_cas(&rwlock->state, state, state | WR_WAITING)) {
+			break;
+		}
+	}
+
+	(void)adjust_writer_prio(rwlock, _current);
+
+	/* The lock is handed over to the writer when it is woken up */
+	if (z_pend_curr(&lock, key, &rwlock->wr_wait_q, timeout) == 0) {
+		return 0;
+	}
+
+	key = k_spin_lock(&lock);
+
+	return wait_timed_out(rwlock, key);
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_rwlock_write_lock(struct k_rwlock *rwlock,
+					     k_timeout_t timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_write_lock(rwlock, timeout);
+}
+#include <syscalls/k_rwlock_write_lock_mrsh.c>
+#endif
+
+int z_impl_k_rwlock_write_unlock(struct k_rwlock *rwlock)
+{
+	k_spinlock_key_t key;
+
+	__ASSERT(!arch_is_in_isr(), "rwlocks cannot be used inside ISRs");
+
+	CHECKIF(rwlock->writer != _current) {
+		return -EPERM;
+	}
+
+	/* Waiters set a flag before inheritance can change the priority of
+	 * the writer, so without flags there is nothing to restore.
+	 */
+	rwlock->writer = NULL;
+	if (atomic_cas(&rwlock->state, WRITER, 0)) {
+		return 0;
+	}
+
+	key = k_spin_lock(&lock);
+
+	if (_current->base.prio != rwlock->writer_orig_prio) {
+		(void)z_set_prio(_current, rwlock->writer_orig_prio);
+	}
+
+	(void)atomic_and(&rwlock->state, ~WRITER);
+	handoff(rwlock, true);
+	z_reschedule(&lock, key);
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_rwlock_write_unlock(struct k_rwlock *rwlock)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_write_unlock(rwlock);
+}
+#include <syscalls/k_rwlock_write_unlock_mrsh.c>
+#endif
@@ -1402,6 +1402,10 @@ void z_sched_ipi(void)
 #ifdef CONFIG_TRACE_SCHED_IPI
 	z_trace_sched_ipi();
 #endif
+
+#ifdef CONFIG_RCU
+	z_rcu_isr_qs();
+#endif
 }
 
 void z_sched_abort(struct k_thread *thread)
@@ -240,6 +240,10 @@ void z_clock_announce(int32_t ticks)
 	z_time_slice(ticks);
 #endif
 
+#ifdef CONFIG_RCU
+	z_rcu_isr_qs();
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&timeout_lock);
 
 	announce_remaining = ticks;
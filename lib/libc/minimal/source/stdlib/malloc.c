@@ -7,6 +7,7 @@
 #include <stdlib.h>
 #include <zephyr.h>
 #include <init.h>
+#include <kernel_structs.h>
 #include <errno.h>
 #include <sys/math_extras.h>
 #include <string.h>
@@ -36,33 +37,370 @@ Z_GENERIC_SECTION(POOL_SECTION) static struct sys_heap z_malloc_heap;
 Z_GENERIC_SECTION(POOL_SECTION) struct sys_mutex z_malloc_heap_mutex;
 Z_GENERIC_SECTION(POOL_SECTION) static char z_malloc_heap_mem[HEAP_BYTES];
 
-void *malloc(size_t size)
+static int malloc_prepare(const struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+	sys_heap_init(&z_malloc_heap, z_malloc_heap_mem, HEAP_BYTES);
+	sys_mutex_init(&z_malloc_heap_mutex);
+
+	return 0;
+}
+
+#ifdef CONFIG_MINIMAL_LIBC_MALLOC_CPU_CACHE
+
+/*
+ * Small blocks are served from per-CPU caches, one list of free blocks per
+ * size class, each cache under a spinlock of its own: neither the heap
+ * mutex nor any lock contended by the CPUs is taken when the cache can
+ * serve the request. A block freed on another CPU than the one it was
+ * allocated on joins the cache of the CPU freeing it.
+ *
+ * Caches are refilled from the heap and flushed back to it by batches of
+ * half their depth, under a single lock of the heap mutex. When the heap
+ * is exhausted, all the caches are flushed back to it before giving up.
+ *
+ * Every block starts with a header holding its size class, or NO_CLASS for
+ * the blocks too large for the caches, allocated from the heap directly.
+ */
+#define CACHE_DEPTH CONFIG_MINIMAL_LIBC_MALLOC_CPU_CACHE_DEPTH
+#define CACHE_BATCH (CACHE_DEPTH / 2)
+#define BLOCK_ALIGN __alignof__(z_max_align_t)
+#define HDR_SIZE BLOCK_ALIGN
+#define NO_CLASS UINT8_MAX
+
+static const uint16_t class_size[] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+struct block_cache {
+	sys_slist_t blocks;
+	size_t count;
+};
+
+static struct cpu_cache {
+	struct k_spinlock lock;
+	struct block_cache classes[ARRAY_SIZE(class_size)];
+} __aligned(64) cpu_caches[CONFIG_MP_NUM_CPUS];
+
+static inline uint8_t *block_hdr(void *ptr)
 {
+	return (uint8_t *)ptr - HDR_SIZE;
+}
+
+static int size_class(size_t size)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(class_size); i++) {
+		if (size <= class_size[i]) {
+			return (int)i;
+		}
+	}
+
+	return -1;
+}
+
+/* Lock the cache of the current CPU. A thread migrated meanwhile locks
+ * the cache of the CPU it was running on, which is only slower.
+ */
+static struct cpu_cache *local_cache_lock(k_spinlock_key_t *key)
+{
+#ifdef CONFIG_SMP
+	struct cpu_cache *cpu = &cpu_caches[arch_curr_cpu()->id];
+#else
+	struct cpu_cache *cpu = &cpu_caches[0];
+#endif
+
+	*key = k_spin_lock(&cpu->lock);
+
+	return cpu;
+}
+
+/* The heap mutex must be held */
+static void *heap_block_alloc(uint8_t cls, size_t size)
+{
+	uint8_t *mem = sys_heap_aligned_alloc(&z_malloc_heap, BLOCK_ALIGN,
+					      HDR_SIZE + size);
+
+	if (mem == NULL) {
+		return NULL;
+	}
+
+	*mem = cls;
+
+	return mem + HDR_SIZE;
+}
+
+/* Give the blocks of all the caches back to the heap. The heap mutex must
+ * be held.
+ */
+static void caches_flush(void)
+{
+	sys_snode_t *node;
+
+	for (int i = 0; i < ARRAY_SIZE(cpu_caches); i++) {
+		struct cpu_cache *cpu = &cpu_caches[i];
+		k_spinlock_key_t key;
+		sys_slist_t blocks;
+
+		sys_slist_init(&blocks);
+
+		key = k_spin_lock(&cpu->lock);
+		for (int cls = 0; cls < ARRAY_SIZE(class_size); cls++) {
+			struct block_cache *cache = &cpu->classes[cls];
+
+			/* Merging an empty list would clear the tail */
+			if (cache->count > 0) {
+				sys_slist_merge_slist(&blocks, &cache->blocks);
+				cache->count = 0;
+			}
+		}
+		k_spin_unlock(&cpu->lock, key);
+
+		while ((node = sys_slist_get(&blocks)) != NULL) {
+			sys_heap_free(&z_malloc_heap, block_hdr(node));
+		}
+	}
+}
+
+/* Allocate a block from the heap, retrying once with the blocks of the
+ * caches given back to it. The heap mutex must be held.
+ */
+static void *heap_block_alloc_retry(uint8_t cls, size_t size)
+{
+	void *ret = heap_block_alloc(cls, size);
+
+	if (ret == NULL) {
+		caches_flush();
+		ret = heap_block_alloc(cls, size);
+	}
+
+	return ret;
+}
+
+/* Give a list of blocks back to the heap */
+static void blocks_release(sys_slist_t *blocks)
+{
+	sys_snode_t *node;
+
+	if (sys_slist_is_empty(blocks)) {
+		return;
+	}
+
+	sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
+	while ((node = sys_slist_get(blocks)) != NULL) {
+		sys_heap_free(&z_malloc_heap, block_hdr(node));
+	}
+	sys_mutex_unlock(&z_malloc_heap_mutex);
+}
+
+/* Allocate a block of class @p cls, and a batch for the local cache */
+static void *cache_refill(int cls)
+{
+	sys_slist_t batch;
+	size_t count = 0;
+	k_spinlock_key_t key;
+	void *ret;
+
+	sys_slist_init(&batch);
+
 	int lock_ret = sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
 
 	CHECKIF(lock_ret != 0) {
 		return NULL;
 	}
 
-	void *ret = sys_heap_aligned_alloc(&z_malloc_heap,
-					   __alignof__(z_max_align_t),
-					   size);
+	ret = heap_block_alloc_retry(cls, class_size[cls]);
+
+	while (ret != NULL && count < CACHE_BATCH - 1) {
+		void *blk = heap_block_alloc(cls, class_size[cls]);
+
+		if (blk == NULL) {
+			break;
+		}
+
+		sys_slist_prepend(&batch, blk);
+		count++;
+	}
+
+	sys_mutex_unlock(&z_malloc_heap_mutex);
+
+	if (count > 0) {
+		/* Possibly another CPU's than the one that missed, which may
+		 * have been filled meanwhile: keep only what fits in it.
+		 */
+		struct cpu_cache *cpu = local_cache_lock(&key);
+		struct block_cache *cache = &cpu->classes[cls];
+		sys_snode_t *node;
+
+		while (cache->count < CACHE_DEPTH &&
+		       (node = sys_slist_get(&batch)) != NULL) {
+			sys_slist_prepend(&cache->blocks, node);
+			cache->count++;
+		}
+		k_spin_unlock(&cpu->lock, key);
+
+		blocks_release(&batch);
+	}
+
+	return ret;
+}
+
+void *malloc(size_t size)
+{
+	int cls = size_class(size);
+	void *ret;
+
+	if (cls >= 0) {
+		k_spinlock_key_t key;
+		struct cpu_cache *cpu = local_cache_lock(&key);
+		struct block_cache *cache = &cpu->classes[cls];
+
+		ret = sys_slist_get(&cache->blocks);
+		if (ret != NULL) {
+			cache->count--;
+		}
+		k_spin_unlock(&cpu->lock, key);
+
+		if (ret == NULL) {
+			ret = cache_refill(cls);
+		}
+	} else if (size > SIZE_MAX - HDR_SIZE) {
+		ret = NULL;
+	} else {
+		int lock_ret = sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
+
+		CHECKIF(lock_ret != 0) {
+			return NULL;
+		}
+
+		ret = heap_block_alloc_retry(NO_CLASS, size);
+		sys_mutex_unlock(&z_malloc_heap_mutex);
+	}
+
 	if (ret == NULL) {
 		errno = ENOMEM;
 	}
 
-	sys_mutex_unlock(&z_malloc_heap_mutex);
 	return ret;
 }
 
-static int malloc_prepare(const struct device *unused)
+void *realloc(void *ptr, size_t requested_size)
 {
-	ARG_UNUSED(unused);
+	uint8_t cls;
+	uint8_t *mem;
 
-	sys_heap_init(&z_malloc_heap, z_malloc_heap_mem, HEAP_BYTES);
-	sys_mutex_init(&z_malloc_heap_mutex);
+	if (ptr == NULL) {
+		return malloc(requested_size);
+	}
 
-	return 0;
+	if (requested_size == 0) {
+		free(ptr);
+		return NULL;
+	}
+
+	cls = *block_hdr(ptr);
+	if (cls != NO_CLASS) {
+		void *ret;
+
+		if (requested_size <= class_size[cls]) {
+			return ptr;
+		}
+
+		ret = malloc(requested_size);
+		if (ret != NULL) {
+			memcpy(ret, ptr, class_size[cls]);
+			free(ptr);
+		}
+
+		return ret;
+	}
+
+	if (requested_size > SIZE_MAX - HDR_SIZE) {
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	int lock_ret = sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
+
+	CHECKIF(lock_ret != 0) {
+		return NULL;
+	}
+
+	/* The header is moved along with the data */
+	mem = sys_heap_aligned_realloc(&z_malloc_heap, block_hdr(ptr),
+				       BLOCK_ALIGN, HDR_SIZE + requested_size);
+	if (mem == NULL) {
+		caches_flush();
+		mem = sys_heap_aligned_realloc(&z_malloc_heap, block_hdr(ptr),
+					       BLOCK_ALIGN,
+					       HDR_SIZE + requested_size);
+	}
+	sys_mutex_unlock(&z_malloc_heap_mutex);
+
+	if (mem == NULL) {
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	return mem + HDR_SIZE;
+}
+
+void free(void *ptr)
+{
+	sys_slist_t batch;
+	k_spinlock_key_t key;
+	uint8_t cls;
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	cls = *block_hdr(ptr);
+	if (cls == NO_CLASS) {
+		sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
+		sys_heap_free(&z_malloc_heap, block_hdr(ptr));
+		sys_mutex_unlock(&z_malloc_heap_mutex);
+		return;
+	}
+
+	sys_slist_init(&batch);
+
+	struct cpu_cache *cpu = local_cache_lock(&key);
+	struct block_cache *cache = &cpu->classes[cls];
+
+	/* A full cache gives a batch back to the heap */
+	if (cache->count >= CACHE_DEPTH) {
+		while (cache->count > CACHE_DEPTH - CACHE_BATCH) {
+			sys_slist_prepend(&batch,
+				sys_slist_get_not_empty(&cache->blocks));
+			cache->count--;
+		}
+	}
+
+	sys_slist_prepend(&cache->blocks, ptr);
+	cache->count++;
+	k_spin_unlock(&cpu->lock, key);
+
+	blocks_release(&batch);
+}
+
+#else /* !CONFIG_MINIMAL_LIBC_MALLOC_CPU_CACHE */
+
+void *malloc(size_t size)
+{
+	int lock_ret = sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
+
+	CHECKIF(lock_ret != 0) {
+		return NULL;
+	}
+
+	void *ret = sys_heap_aligned_alloc(&z_malloc_heap,
+					   __alignof__(z_max_align_t),
+					   size);
+	if (ret == NULL) {
+		errno = ENOMEM;
+	}
+
+	sys_mutex_unlock(&z_malloc_heap_mutex);
+	return ret;
 }
 
 void *realloc(void *ptr, size_t requested_size)
@@ -92,6 +430,8 @@ void free(void *ptr)
 	sys_mutex_unlock(&z_malloc_heap_mutex);
 }
 
+#endif /* CONFIG_MINIMAL_LIBC_MALLOC_CPU_CACHE */
+
 SYS_INIT(malloc_prepare, APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
 #else /* No malloc arena */
 void *malloc(size_t size)
@@ -0,0 +1,389 @@
+/* memops.c - speed optimized memory block routines */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * These replace the memcpy(), memset() and memcmp() of string.c when
+ * CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE is disabled.
+ *
+ * The generic versions handle a word per step after aligning the
+ * destination, four words per loop iteration. A source that stays
+ * misaligned is read one aligned word at a time, each destination word
+ * being built from two consecutive source words, so that no unaligned
+ * access is ever made: not all cores support them.
+ *
+ * Architectures with a faster way to move aligned blocks provide it with
+ * ARCH_COPY_BLOCKS() / ARCH_SET_BLOCKS(); x86 replaces whole functions with
+ * its string instructions.
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define WORD_SIZE	sizeof(mem_word_t)
+#define WORD_MASK	(WORD_SIZE - 1)
+#define BLOCK_SIZE	(4 * WORD_SIZE)
+
+/* Below this size, the setup of the word loops costs more than it saves. */
+#define MIN_WORD_COPY	(2 * WORD_SIZE)
+
+#if defined(CONFIG_ARMV7_M_ARMV8_M_MAINLINE)
+
+/*
+ * Copy @p blocks blocks of 32 bytes with LDM/STM bursts of four registers.
+ * Both pointers must be word aligned. r7 is left alone, it may be the frame
+ * pointer.
+ */
+static inline void arm_copy_blocks(mem_word_t **d, const mem_word_t **s,
+				   size_t blocks)
+{
+	__asm__ volatile(
+		"1:\n\t"
+		"ldmia %[s]!, {r3, r4, r5, r6}\n\t"
+		"stmia %[d]!, {r3, r4, r5, r6}\n\t"
+		"ldmia %[s]!, {r3, r4, r5, r6}\n\t"
+		"stmia %[d]!, {r3, r4, r5, r6}\n\t"
+		"subs %[n], %[n], #1\n\t"
+		"bne 1b\n\t"
+		: [d] "+r" (*d), [s] "+r" (*s), [n] "+r" (blocks)
+		:
+		: "r3", "r4", "r5", "r6", "cc", "memory");
+}
+
+#define ARCH_BLOCK_SIZE 32
+#define ARCH_COPY_BLOCKS(d, s, blocks) arm_copy_blocks(d, s, blocks)
+
+#endif /* CONFIG_ARMV7_M_ARMV8_M_MAINLINE */
+
+#if defined(CONFIG_X86)
+
+/*
+ * rep movs/stos are handled by the microcode of any x86 core, and are the
+ * fastest way to move blocks on the recent ones; only the few unaligned
+ * head bytes of the destination are worth doing separately. SSE is not
+ * used: the kernel does not save the SSE registers of every thread.
+ */
+
+#ifdef CONFIG_X86_64
+#define X86_REP_MOVS_WORD "rep movsq"
+#define X86_REP_STOS_WORD "rep stosq"
+#else
+#define X86_REP_MOVS_WORD "rep movsl"
+#define X86_REP_STOS_WORD "rep stosl"
+#endif
+
+void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
+{
+	void *dst = d;
+	size_t head = (-(uintptr_t)d) & WORD_MASK;
+	size_t words;
+
+	if (n < MIN_WORD_COPY) {
+		head = n;
+	}
+
+	n -= head;
+	words = n / WORD_SIZE;
+	n &= WORD_MASK;
+
+	__asm__ volatile("rep movsb"
+			 : "+D" (dst), "+S" (s), "+c" (head)
+			 :
+			 : "memory");
+	__asm__ volatile(X86_REP_MOVS_WORD
+			 : "+D" (dst), "+S" (s), "+c" (words)
+			 :
+			 : "memory");
+	__asm__ volatile("rep movsb"
+			 : "+D" (dst), "+S" (s), "+c" (n)
+			 :
+			 : "memory");
+
+	return d;
+}
+
+void *memset(void *buf, int c, size_t n)
+{
+	void *dst = buf;
+	size_t head = (-(uintptr_t)buf) & WORD_MASK;
+	mem_word_t c_word = (unsigned char)c;
+	size_t words;
+
+	if (n < MIN_WORD_COPY) {
+		head = n;
+	}
+
+	c_word |= c_word << 8;
+	c_word |= c_word << 16;
+#if Z_MEM_WORD_T_WIDTH > 32
+	c_word |= c_word << 32;
+#endif
+
+	n -= head;
+	words = n / WORD_SIZE;
+	n &= WORD_MASK;
+
+	__asm__ volatile("rep stosb"
+			 : "+D" (dst), "+c" (head)
+			 : "a" (c_word)
+			 : "memory");
+	__asm__ volatile(X86_REP_STOS_WORD
+			 : "+D" (dst), "+c" (words)
+			 : "a" (c_word)
+			 : "memory");
+	__asm__ volatile("rep stosb"
+			 : "+D" (dst), "+c" (n)
+			 : "a" (c_word)
+			 : "memory");
+
+	return buf;
+}
+
+#else /* !CONFIG_X86 */
+
+/* Copy the words of an aligned source, @p n being a multiple of WORD_SIZE. */
+static inline void copy_aligned(mem_word_t *d_word, const mem_word_t *s_word,
+				size_t n)
+{
+#ifdef ARCH_COPY_BLOCKS
+	if (n >= ARCH_BLOCK_SIZE) {
+		ARCH_COPY_BLOCKS(&d_word, &s_word, n / ARCH_BLOCK_SIZE);
+		n %= ARCH_BLOCK_SIZE;
+	}
+#endif
+
+	while (n >= BLOCK_SIZE) {
+		mem_word_t w0 = s_word[0];
+		mem_word_t w1 = s_word[1];
+		mem_word_t w2 = s_word[2];
+		mem_word_t w3 = s_word[3];
+
+		d_word[0] = w0;
+		d_word[1] = w1;
+		d_word[2] = w2;
+		d_word[3] = w3;
+		d_word += 4;
+		s_word += 4;
+		n -= BLOCK_SIZE;
+	}
+
+	while (n > 0) {
+		*(d_word++) = *(s_word++);
+		n -= WORD_SIZE;
+	}
+}
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define MERGE(lo, hi, lshift, hshift) (((lo) >> (lshift)) | ((hi) << (hshift)))
+#else
+#define MERGE(lo, hi, lshift, hshift) (((lo) << (lshift)) | ((hi) >> (hshift)))
+#endif
+
+/*
+ * Copy to an aligned destination from a source that is @p offset bytes past
+ * a word boundary, @p n being a multiple of WORD_SIZE. Every source word
+ * read is aligned and holds at least one byte of the source buffer.
+ */
+static inline void copy_shifted(mem_word_t *d_word, const unsigned char *s,
+				size_t n, unsigned int offset)
+{
+	const mem_word_t *s_word = (const mem_word_t *)(s - offset);
+	unsigned int lshift = offset * 8U;
+	unsigned int hshift = Z_MEM_WORD_T_WIDTH - lshift;
+	mem_word_t prev = *(s_word++);
+
+	while (n >= BLOCK_SIZE) {
+		mem_word_t w0 = s_word[0];
+		mem_word_t w1 = s_word[1];
+		mem_word_t w2 = s_word[2];
+		mem_word_t w3 = s_word[3];
+
+		d_word[0] = MERGE(prev, w0, lshift, hshift);
+		d_word[1] = MERGE(w0, w1, lshift, hshift);
+		d_word[2] = MERGE(w1, w2, lshift, hshift);
+		d_word[3] = MERGE(w2, w3, lshift, hshift);
+		prev = w3;
+		d_word += 4;
+		s_word += 4;
+		n -= BLOCK_SIZE;
+	}
+
+	while (n > 0) {
+		mem_word_t w = *(s_word++);
+
+		*(d_word++) = MERGE(prev, w, lshift, hshift);
+		prev = w;
+		n -= WORD_SIZE;
+	}
+}
+
+/**
+ *
+ * @brief Copy bytes in memory
+ *
+ * @return pointer to start of destination buffer
+ */
+
+void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
+{
+	unsigned char *d_byte = (unsigned char *)d;
+	const unsigned char *s_byte = (const unsigned char *)s;
+
+	if (n >= MIN_WORD_COPY) {
+		size_t words;
+		unsigned int offset;
+
+		/* do byte-sized copying until the destination is aligned */
+
+		while (((uintptr_t)d_byte) & WORD_MASK) {
+			*(d_byte++) = *(s_byte++);
+			n--;
+		}
+
+		words = n & ~WORD_MASK;
+		offset = (uintptr_t)s_byte & WORD_MASK;
+
+		if (offset == 0U) {
+			copy_aligned((mem_word_t *)d_byte,
+				     (const mem_word_t *)s_byte, words);
+		} else {
+			copy_shifted((mem_word_t *)d_byte, s_byte, words,
+				     offset);
+		}
+
+		d_byte += words;
+		s_byte += words;
+		n -= words;
+	}
+
+	/* do byte-sized copying until finished */
+
+	while (n > 0) {
+		*(d_byte++) = *(s_byte++);
+		n--;
+	}
+
+	return d;
+}
+
+/**
+ *
+ * @brief Set bytes in memory
+ *
+ * @return pointer to start of buffer
+ */
+
+void *memset(void *buf, int c, size_t n)
+{
+	unsigned char *d_byte = (unsigned char *)buf;
+	unsigned char c_byte = (unsigned char)c;
+
+	if (n >= MIN_WORD_COPY) {
+		mem_word_t *d_word;
+		mem_word_t c_word = c_byte;
+
+		/* do byte-sized initialization until word-aligned */
+
+		while (((uintptr_t)d_byte) & WORD_MASK) {
+			*(d_byte++) = c_byte;
+			n--;
+		}
+
+		c_word |= c_word << 8;
+		c_word |= c_word << 16;
+#if Z_MEM_WORD_T_WIDTH > 32
+		c_word |= c_word << 32;
+#endif
+
+		d_word = (mem_word_t *)d_byte;
+
+		while (n >= BLOCK_SIZE) {
+			d_word[0] = c_word;
+			d_word[1] = c_word;
+			d_word[2] = c_word;
+			d_word[3] = c_word;
+			d_word += 4;
+			n -= BLOCK_SIZE;
+		}
+
+		while (n >= WORD_SIZE) {
+			*(d_word++) = c_word;
+			n -= WORD_SIZE;
+		}
+
+		d_byte = (unsigned char *)d_word;
+	}
+
+	/* do byte-sized initialization until finished */
+
+	while (n > 0) {
+		*(d_byte++) = c_byte;
+		n--;
+	}
+
+	return buf;
+}
+
+#endif /* CONFIG_X86 */
+
+/**
+ *
+ * @brief Compare two memory areas
+ *
+ * @return negative # if <m1> < <m2>, 0 if <m1> == <m2>, else positive #
+ */
+
+int memcmp(const void *m1, const void *m2, size_t n)
+{
+	const unsigned char *c1 = m1;
+	const unsigned char *c2 = m2;
+
+	/* skip the equal words when both areas share the same alignment */
+
+	if ((n >= MIN_WORD_COPY) &&
+	    ((((uintptr_t)c1 ^ (uintptr_t)c2) & WORD_MASK) == 0)) {
+		const mem_word_t *w1;
+		const mem_word_t *w2;
+
+		while (((uintptr_t)c1) & WORD_MASK) {
+			if (*c1 != *c2) {
+				return *c1 - *c2;
+			}
+			c1++;
+			c2++;
+			n--;
+		}
+
+		w1 = (const mem_word_t *)c1;
+		w2 = (const mem_word_t *)c2;
+
+		while ((n >= WORD_SIZE) && (*w1 == *w2)) {
+			w1++;
+			w2++;
+			n -= WORD_SIZE;
+		}
+
+		/* the bytes of the first different word, if any, are
+		 * compared one at a time below, which finds the first
+		 * different byte whatever the endianness
+		 */
+		c1 = (const unsigned char *)w1;
+		c2 = (const unsigned char *)w2;
+	}
+
+	while (n > 0) {
+		if (*c1 != *c2) {
+			return *c1 - *c2;
+		}
+		c1++;
+		c2++;
+		n--;
+	}
+
+	return 0;
+}
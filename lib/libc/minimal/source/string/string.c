@@ -230,6 +230,8 @@ char *strncat(char *_MLIBC_RESTRICT dest, const char *_MLIBC_RESTRICT src,
 	return orig_dest;
 }
 
+#ifdef CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE
+
 /**
  *
  * @brief Compare two memory areas
@@ -238,8 +240,8 @@ char *strncat(char *_MLIBC_RESTRICT dest, const char *_MLIBC_RESTRICT src,
  */
 int memcmp(const void *m1, const void *m2, size_t n)
 {
-	const char *c1 = m1;
-	const char *c2 = m2;
+	const unsigned char *c1 = m1;
+	const unsigned char *c2 = m2;
 
 	if (!n) {
 		return 0;
@@ -253,6 +255,8 @@ int memcmp(const void *m1, const void *m2, size_t n)
 	return *c1 - *c2;
 }
 
+#endif /* CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE */
+
 /**
  *
  * @brief Copy bytes in memory with overlapping areas
@@ -288,6 +292,8 @@ void *memmove(void *d, const void *s, size_t n)
 	return d;
 }
 
+#ifdef CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE
+
 /**
  *
  * @brief Copy bytes in memory
@@ -389,6 +395,8 @@ void *memset(void *buf, int c, size_t n)
 	return buf;
 }
 
+#endif /* CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE */
+
 /**
  *
  * @brief Scan byte in memory
@@ -0,0 +1,668 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/__assert.h>
+#include <sys/btree.h>
+
+/* Minimum number of keys in a node other than the root */
+#define MIN_KEYS (SYS_BTREE_ORDER / 2)
+
+/* Internal nodes hold keys[i] = smallest key of the subtree children[i + 1],
+ * all the keys of children[i] being less than keys[i].
+ */
+
+/* Index of the first key not less than @p key. The keys of a node fit in
+ * a few cache lines, counting the smaller keys without branches is faster
+ * than a binary search which mispredicts half of its branches.
+ */
+static inline uint16_t lower_bound(const struct sys_btree_node *node,
+				   uintptr_t key)
+{
+	uint16_t n = 0;
+
+	for (uint16_t i = 0; i < node->n_keys; i++) {
+		n += (node->keys[i] < key) ? 1U : 0U;
+	}
+
+	return n;
+}
+
+/* Index of the child of an internal node where @p key belongs */
+static inline uint16_t child_index(const struct sys_btree_node *node,
+				   uintptr_t key)
+{
+	uint16_t n = 0;
+
+	for (uint16_t i = 0; i < node->n_keys; i++) {
+		n += (node->keys[i] <= key) ? 1U : 0U;
+	}
+
+	return n;
+}
+
+static struct sys_btree_node *node_alloc(struct sys_btree *tree, bool leaf)
+{
+	struct sys_btree_node *node;
+
+	node = tree->alloc(NULL, sizeof(*node));
+	if (node != NULL) {
+		node->n_keys = 0;
+		node->leaf = leaf;
+		node->next = NULL;
+	}
+
+	return node;
+}
+
+static void node_free(struct sys_btree *tree, struct sys_btree_node *node)
+{
+	(void)tree->alloc(node, 0);
+}
+
+static void free_subtree(struct sys_btree *tree, struct sys_btree_node *node)
+{
+	if (!node->leaf) {
+		for (int i = 0; i <= node->n_keys; i++) {
+			free_subtree(tree, node->children[i]);
+		}
+	}
+
+	node_free(tree, node);
+}
+
+void sys_btree_init(struct sys_btree *tree, sys_btree_alloc_t alloc)
+{
+	tree->root = NULL;
+	tree->count = 0;
+	tree->height = 0;
+	tree->alloc = alloc;
+}
+
+void sys_btree_clear(struct sys_btree *tree)
+{
+	if (tree->root != NULL) {
+		free_subtree(tree, tree->root);
+	}
+
+	tree->root = NULL;
+	tree->count = 0;
+	tree->height = 0;
+}
+
+void *sys_btree_get(const struct sys_btree *tree, uintptr_t key)
+{
+	const struct sys_btree_node *node = tree->root;
+	uint16_t i;
+
+	if (node == NULL) {
+		return NULL;
+	}
+
+	while (!node->leaf) {
+		node = node->children[child_index(node, key)];
+	}
+
+	i = lower_bound(node, key);
+	if (i < node->n_keys && node->keys[i] == key) {
+		return node->values[i];
+	}
+
+	return NULL;
+}
+
+/* Insert in a node with free space */
+static void leaf_insert_at(struct sys_btree_node *node, uint16_t i,
+			   uintptr_t key, void *value)
+{
+	uint16_t n = node->n_keys - i;
+
+	memmove(&node->keys[i + 1], &node->keys[i], n * sizeof(node->keys[0]));
+	memmove(&node->values[i + 1], &node->values[i],
+		n * sizeof(node->values[0]));
+	node->keys[i] = key;
+	node->values[i] = value;
+	node->n_keys++;
+}
+
+static void inner_insert_at(struct sys_btree_node *node, uint16_t i,
+			    uintptr_t key, struct sys_btree_node *right)
+{
+	uint16_t n = node->n_keys - i;
+
+	memmove(&node->keys[i + 1], &node->keys[i], n * sizeof(node->keys[0]));
+	memmove(&node->children[i + 2], &node->children[i + 1],
+		n * sizeof(node->children[0]));
+	node->keys[i] = key;
+	node->children[i + 1] = right;
+	node->n_keys++;
+}
+
+/* Split a full leaf while inserting an element at index @p i, the upper
+ * half going to @p right. Returns the separator key.
+ */
+static uintptr_t leaf_split(struct sys_btree_node *node,
+			    struct sys_btree_node *right, uint16_t i,
+			    uintptr_t key, void *value)
+{
+	uint16_t split = (SYS_BTREE_ORDER + 1) / 2;
+
+	right->n_keys = SYS_BTREE_ORDER - split;
+	memcpy(right->keys, &node->keys[split],
+	       right->n_keys * sizeof(node->keys[0]));
+	memcpy(right->values, &node->values[split],
+	       right->n_keys * sizeof(node->values[0]));
+	node->n_keys = split;
+
+	if (i <= split) {
+		leaf_insert_at(node, i, key, value);
+	} else {
+		leaf_insert_at(right, i - split, key, value);
+	}
+
+	right->next = node->next;
+	node->next = right;
+
+	return right->keys[0];
+}
+
+/* Split a full internal node while inserting separator @p key and child
+ * @p child at index @p i, the upper half going to @p right. Returns the
+ * separator key moved up.
+ */
+static uintptr_t inner_split(struct sys_btree_node *node,
+			     struct sys_btree_node *right, uint16_t i,
+			     uintptr_t key, struct sys_btree_node *child)
+{
+	uintptr_t keys[SYS_BTREE_ORDER + 1];
+	struct sys_btree_node *children[SYS_BTREE_ORDER + 2];
+	uint16_t split = (SYS_BTREE_ORDER + 1) / 2;
+
+	memcpy(keys, node->keys, i * sizeof(keys[0]));
+	keys[i] = key;
+	memcpy(&keys[i + 1], &node->keys[i],
+	       (SYS_BTREE_ORDER - i) * sizeof(keys[0]));
+
+	memcpy(children, node->children, (i + 1) * sizeof(children[0]));
+	children[i + 1] = child;
+	memcpy(&children[i + 2], &node->children[i + 1],
+	       (SYS_BTREE_ORDER - i) * sizeof(children[0]));
+
+	node->n_keys = split;
+	memcpy(node->keys, keys, split * sizeof(keys[0]));
+	memcpy(node->children, children, (split + 1) * sizeof(children[0]));
+
+	right->n_keys = SYS_BTREE_ORDER - split;
+	memcpy(right->keys, &keys[split + 1],
+	       right->n_keys * sizeof(keys[0]));
+	memcpy(right->children, &children[split + 1],
+	       (right->n_keys + 1) * sizeof(children[0]));
+
+	return keys[split];
+}
+
+int sys_btree_insert(struct sys_btree *tree, uintptr_t key, void *value)
+{
+	struct sys_btree_node *path[SYS_BTREE_MAX_HEIGHT];
+	uint16_t idx[SYS_BTREE_MAX_HEIGHT];
+	struct sys_btree_node *spare[SYS_BTREE_MAX_HEIGHT + 1];
+	struct sys_btree_node *node = tree->root;
+	struct sys_btree_node *right;
+	int n_spare = 0;
+	int depth = 0;
+	uintptr_t sep;
+	uint16_t i;
+
+	__ASSERT(value != NULL, "values cannot be NULL");
+
+	if (node == NULL) {
+		node = node_alloc(tree, true);
+		if (node == NULL) {
+			return -ENOMEM;
+		}
+
+		tree->root = node;
+		tree->height = 1;
+	}
+
+	while (!node->leaf) {
+		path[depth] = node;
+		idx[depth] = child_index(node, key);
+		node = node->children[idx[depth]];
+		depth++;
+	}
+
+	i = lower_bound(node, key);
+	if (i < node->n_keys && node->keys[i] == key) {
+		return -EEXIST;
+	}
+
+	if (node->n_keys < SYS_BTREE_ORDER) {
+		leaf_insert_at(node, i, key, value);
+		tree->count++;
+		return 0;
+	}
+
+	/* Allocate the nodes of all the splits up front, so that the tree
+	 * is left unchanged if it fails: one per full node on the path,
+	 * plus a new root if they are all full.
+	 */
+	for (int d = depth; ; d--) {
+		struct sys_btree_node *n = (d == depth) ? node : path[d];
+		struct sys_btree_node *new_node;
+
+		if (n->n_keys < SYS_BTREE_ORDER) {
+			break;
+		}
+
+		if (d == 0 && tree->height >= SYS_BTREE_MAX_HEIGHT) {
+			goto nomem;
+		}
+
+		new_node = node_alloc(tree, n->leaf);
+		if (new_node == NULL) {
+			goto nomem;
+		}
+		spare[n_spare++] = new_node;
+
+		if (d == 0) {
+			new_node = node_alloc(tree, false);
+			if (new_node == NULL) {
+				goto nomem;
+			}
+			spare[n_spare++] = new_node;
+			break;
+		}
+	}
+
+	n_spare = 0;
+	right = spare[n_spare++];
+	sep = leaf_split(node, right, i, key, value);
+	tree->count++;
+
+	while (depth > 0) {
+		struct sys_btree_node *parent = path[--depth];
+		struct sys_btree_node *new_right;
+
+		if (parent->n_keys < SYS_BTREE_ORDER) {
+			inner_insert_at(parent, idx[depth], sep, right);
+			return 0;
+		}
+
+		new_right = spare[n_spare++];
+		sep = inner_split(parent, new_right, idx[depth], sep, right);
+		right = new_right;
+	}
+
+	/* The root was split, grow the tree */
+	node = spare[n_spare];
+	node->n_keys = 1;
+	node->keys[0] = sep;
+	node->children[0] = tree->root;
+	node->children[1] = right;
+	tree->root = node;
+	tree->height++;
+
+	return 0;
+
+nomem:
+	while (n_spare > 0) {
+		node_free(tree, spare[--n_spare]);
+	}
+
+	return -ENOMEM;
+}
+
+static void leaf_remove_at(struct sys_btree_node *node, uint16_t i)
+{
+	uint16_t n = node->n_keys - i - 1;
+
+	memmove(&node->keys[i], &node->keys[i + 1], n * sizeof(node->keys[0]));
+	memmove(&node->values[i], &node->values[i + 1],
+		n * sizeof(node->values[0]));
+	node->n_keys--;
+}
+
+/* Remove separator @p i and the child on its right from an internal node */
+static void inner_remove_at(struct sys_btree_node *node, uint16_t i)
+{
+	uint16_t n = node->n_keys - i - 1;
+
+	memmove(&node->keys[i], &node->keys[i + 1], n * sizeof(node->keys[0]));
+	memmove(&node->children[i + 1], &node->children[i + 2],
+		n * sizeof(node->children[0]));
+	node->n_keys--;
+}
+
+/* Move the last element of @p left to the front of @p node, @p sep being
+ * the index of their separator in @p parent
+ */
+static void borrow_left(struct sys_btree_node *parent, uint16_t sep,
+			struct sys_btree_node *left,
+			struct sys_btree_node *node)
+{
+	uint16_t n = node->n_keys;
+
+	memmove(&node->keys[1], &node->keys[0], n * sizeof(node->keys[0]));
+
+	if (node->leaf) {
+		memmove(&node->values[1], &node->values[0],
+			n * sizeof(node->values[0]));
+		node->keys[0] = left->keys[left->n_keys - 1];
+		node->values[0] = left->values[left->n_keys - 1];
+		parent->keys[sep] = node->keys[0];
+	} else {
+		memmove(&node->children[1], &node->children[0],
+			(n + 1) * sizeof(node->children[0]));
+		node->keys[0] = parent->keys[sep];
+		node->children[0] = left->children[left->n_keys];
+		parent->keys[sep] = left->keys[left->n_keys - 1];
+	}
+
+	node->n_keys++;
+	left->n_keys--;
+}
+
+/* Move the first element of @p right to the end of @p node */
+static void borrow_right(struct sys_btree_node *parent, uint16_t sep,
+			 struct sys_btree_node *node,
+			 struct sys_btree_node *right)
+{
+	uint16_t n = right->n_keys - 1;
+
+	if (node->leaf) {
+		node->keys[node->n_keys] = right->keys[0];
+		node->values[node->n_keys] = right->values[0];
+		memmove(&right->values[0], &right->values[1],
+			n * sizeof(right->values[0]));
+		memmove(&right->keys[0], &right->keys[1],
+			n * sizeof(right->keys[0]));
+		parent->keys[sep] = right->keys[0];
+	} else {
+		node->keys[node->n_keys] = parent->keys[sep];
+		node->children[node->n_keys + 1] = right->children[0];
+		parent->keys[sep] = right->keys[0];
+		memmove(&right->keys[0], &right->keys[1],
+			n * sizeof(right->keys[0]));
+		memmove(&right->children[0], &right->children[1],
+			(n + 1) * sizeof(right->children[0]));
+	}
+
+	node->n_keys++;
+	right->n_keys--;
+}
+
+/* Merge @p right into @p left and remove it from @p parent */
+static void merge(struct sys_btree *tree, struct sys_btree_node *parent,
+		  uint16_t sep, struct sys_btree_node *left,
+		  struct sys_btree_node *right)
+{
+	uint16_t n = left->n_keys;
+
+	if (left->leaf) {
+		memcpy(&left->keys[n], right->keys,
+		       right->n_keys * sizeof(right->keys[0]));
+		memcpy(&left->values[n], right->values,
+		       right->n_keys * sizeof(right->values[0]));
+		left->n_keys += right->n_keys;
+		left->next = right->next;
+	} else {
+		left->keys[n] = parent->keys[sep];
+		memcpy(&left->keys[n + 1], right->keys,
+		       right->n_keys * sizeof(right->keys[0]));
+		memcpy(&left->children[n + 1], right->children,
+		       (right->n_keys + 1) * sizeof(right->children[0]));
+		left->n_keys += right->n_keys + 1;
+	}
+
+	inner_remove_at(parent, sep);
+	node_free(tree, right);
+}
+
+void *sys_btree_remove(struct sys_btree *tree, uintptr_t key)
+{
+	struct sys_btree_node *path[SYS_BTREE_MAX_HEIGHT];
+	uint16_t idx[SYS_BTREE_MAX_HEIGHT];
+	struct sys_btree_node *node = tree->root;
+	int depth = 0;
+	void *value;
+	uint16_t i;
+
+	if (node == NULL) {
+		return NULL;
+	}
+
+	while (!node->leaf) {
+		path[depth] = node;
+		idx[depth] = child_index(node, key);
+		node = node->children[idx[depth]];
+		depth++;
+	}
+
+	i = lower_bound(node, key);
+	if (i == node->n_keys || node->keys[i] != key) {
+		return NULL;
+	}
+
+	value = node->values[i];
+	leaf_remove_at(node, i);
+	tree->count--;
+
+	/* Rebalance the underflowing nodes from the leaf up */
+	while (depth > 0 && node->n_keys < MIN_KEYS) {
+		struct sys_btree_node *parent = path[--depth];
+		struct sys_btree_node *left = NULL;
+		struct sys_btree_node *right = NULL;
+
+		i = idx[depth];
+		if (i > 0) {
+			left = parent->children[i - 1];
+		}
+		if (i < parent->n_keys) {
+			right = parent->children[i + 1];
+		}
+
+		if (left != NULL && left->n_keys > MIN_KEYS) {
+			borrow_left(parent, i - 1, left, node);
+		} else if (right != NULL && right->n_keys > MIN_KEYS) {
+			borrow_right(parent, i, node, right);
+		} else if (left != NULL) {
+			merge(tree, parent, i - 1, left, node);
+		} else {
+			merge(tree, parent, i, node, right);
+		}
+
+		node = parent;
+	}
+
+	/* Shrink the tree when the root is empty */
+	node = tree->root;
+	if (node->n_keys == 0) {
+		if (node->leaf) {
+			tree->root = NULL;
+			tree->height = 0;
+		} else {
+			tree->root = node->children[0];
+			tree->height--;
+		}
+		node_free(tree, node);
+	}
+
+	return value;
+}
+
+/* Smallest key of a subtree */
+static uintptr_t subtree_min(const struct sys_btree_node *node)
+{
+	while (!node->leaf) {
+		node = node->children[0];
+	}
+
+	return node->keys[0];
+}
+
+/* Free the nodes of a level under construction, linked by their next
+ * fields, and their subtrees
+ */
+static void free_level(struct sys_btree *tree, struct sys_btree_node *node)
+{
+	while (node != NULL) {
+		struct sys_btree_node *next = node->next;
+
+		if (!node->leaf) {
+			node->next = NULL;
+		}
+		free_subtree(tree, node);
+		node = next;
+	}
+}
+
+int sys_btree_load(struct sys_btree *tree, const uintptr_t *keys,
+		   void *const *values, size_t n)
+{
+	struct sys_btree_node *level = NULL;
+	struct sys_btree_node **tail = &level;
+	size_t n_nodes, pos;
+	uint8_t height = 1;
+
+	if (tree->root != NULL) {
+		return -EINVAL;
+	}
+
+	for (pos = 1; pos < n; pos++) {
+		if (keys[pos - 1] >= keys[pos]) {
+			return -EINVAL;
+		}
+	}
+
+	if (n == 0) {
+		return 0;
+	}
+
+	/* Leaves, as full as possible with the elements evenly spread so
+	 * that none has less than MIN_KEYS elements
+	 */
+	n_nodes = (n + SYS_BTREE_ORDER - 1) / SYS_BTREE_ORDER;
+	pos = 0;
+	for (size_t j = 0; j < n_nodes; j++) {
+		struct sys_btree_node *leaf = node_alloc(tree, true);
+		size_t end = n * (j + 1) / n_nodes;
+
+		if (leaf == NULL) {
+			free_level(tree, level);
+			return -ENOMEM;
+		}
+
+		leaf->n_keys = end - pos;
+		memcpy(leaf->keys, &keys[pos], leaf->n_keys * sizeof(keys[0]));
+		memcpy(leaf->values, &values[pos],
+		       leaf->n_keys * sizeof(values[0]));
+		pos = end;
+
+		*tail = leaf;
+		tail = &leaf->next;
+	}
+
+	/* Internal levels, linked temporarily by their next fields */
+	while (n_nodes > 1) {
+		struct sys_btree_node *child = level;
+		struct sys_btree_node *parents = NULL;
+		size_t n_parents;
+
+		if (height >= SYS_BTREE_MAX_HEIGHT) {
+			free_level(tree, level);
+			return -ENOMEM;
+		}
+
+		n_parents = (n_nodes + SYS_BTREE_ORDER) / (SYS_BTREE_ORDER + 1);
+		tail = &parents;
+		pos = 0;
+
+		for (size_t j = 0; j < n_parents; j++) {
+			struct sys_btree_node *parent = node_alloc(tree, false);
+			size_t end = n_nodes * (j + 1) / n_parents;
+			size_t c;
+
+			if (parent == NULL) {
+				free_level(tree, parents);
+				free_level(tree, child);
+				return -ENOMEM;
+			}
+
+			for (c = 0; pos < end; pos++, c++) {
+				struct sys_btree_node *next = child->next;
+
+				if (c > 0) {
+					parent->keys[c - 1] = subtree_min(child);
+				}
+				parent->children[c] = child;
+				if (!child->leaf) {
+					child->next = NULL;
+				}
+				child = next;
+			}
+			parent->n_keys = c - 1;
+
+			*tail = parent;
+			tail = &parent->next;
+		}
+
+		level = parents;
+		n_nodes = n_parents;
+		height++;
+	}
+
+	if (!level->leaf) {
+		level->next = NULL;
+	}
+
+	tree->root = level;
+	tree->height = height;
+	tree->count = n;
+
+	return 0;
+}
+
+void sys_btree_iter_first(const struct sys_btree *tree,
+			  struct sys_btree_iter *it)
+{
+	const struct sys_btree_node *node = tree->root;
+
+	it->idx = 0;
+
+	if (node != NULL) {
+		while (!node->leaf) {
+			node = node->children[0];
+		}
+	}
+
+	it->node = node;
+}
+
+void sys_btree_iter_seek(const struct sys_btree *tree,
+			 struct sys_btree_iter *it, uintptr_t key)
+{
+	const struct sys_btree_node *node = tree->root;
+
+	if (node == NULL) {
+		it->node = NULL;
+		it->idx = 0;
+		return;
+	}
+
+	while (!node->leaf) {
+		node = node->children[child_index(node, key)];
+	}
+
+	it->idx = lower_bound(node, key);
+	if (it->idx == node->n_keys) {
+		it->node = node->next;
+		it->idx = 0;
+	} else {
+		it->node = node;
+	}
+}
@@ -20,6 +20,31 @@ int cbprintf(cbprintf_cb out, void *ctx, const char *format, ...)
 	return rc;
 }
 
+int cbvprintf(cbprintf_cb out, void *ctx, const char *format, va_list ap)
+{
+	return z_cbvprintf_impl(out, ctx, format, ap, NULL);
+}
+
+/* Gives the formatter a valid va_list, which is not used when it renders a
+ * package.
+ */
+static int pkg_render(cbprintf_cb out, void *ctx, const uint8_t *pkg, ...)
+{
+	va_list ap;
+	int rc;
+
+	va_start(ap, pkg);
+	rc = z_cbvprintf_impl(out, ctx, NULL, ap, pkg);
+	va_end(ap);
+
+	return rc;
+}
+
+int cbpprintf(cbprintf_cb out, void *ctx, const void *packaged)
+{
+	return pkg_render(out, ctx, packaged);
+}
+
 #if defined(CONFIG_CBPRINTF_LIBC_SUBSTS)
 
 #include <stdio.h>
@@ -1319,12 +1319,23 @@ static int outs(cbprintf_cb out,
 	return (int)count;
 }
 
-int cbvprintf(cbprintf_cb out, void *ctx, const char *fp, va_list ap)
+int z_cbvprintf_impl(cbprintf_cb out, void *ctx, const char *fp,
+		     va_list ap, const uint8_t *pkg)
 {
 	char buf[CONVERTED_BUFLEN];
 	size_t count = 0;
+	size_t pkg_pos = 0;
 	sint_value_type sint;
 
+/* Fetch the next argument, from the package when rendering one. */
+#define ARG(_type) ((pkg != NULL) ? \
+		    Z_CBPRINTF_PKG_ARG(pkg, pkg_pos, _type) : \
+		    va_arg(ap, _type))
+
+	if (pkg != NULL) {
+		fp = ARG(const char *);
+	}
+
 /* Output character, returning EOF if output failed, otherwise
  * updating count.
  *
@@ -1384,7 +1395,7 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *fp, va_list ap)
 		 * otherwise set with if present.
 		 */
 		if (conv->width_star) {
-			width = va_arg(ap, int);
+			width = ARG(int);
 
 			if (width < 0) {
 				conv->flag_dash = true;
@@ -1399,7 +1410,7 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *fp, va_list ap)
 		 * precision is not present use 6.
 		 */
 		if (conv->prec_star) {
-			int arg = va_arg(ap, int);
+			int arg = ARG(int);
 
 			if (arg < 0) {
 				conv->prec_present = false;
@@ -1449,24 +1460,23 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *fp, va_list ap)
 			case LENGTH_NONE:
 			case LENGTH_HH:
 			case LENGTH_H:
-				value->sint = va_arg(ap, int);
+				value->sint = ARG(int);
 				break;
 			case LENGTH_L:
 				if (WCHAR_IS_SIGNED
 				    && (conv->specifier == 'c')) {
-					value->sint = (wchar_t)va_arg(ap,
-							      WINT_TYPE);
+					value->sint = (wchar_t)ARG(WINT_TYPE);
 				} else {
-					value->sint = va_arg(ap, long);
+					value->sint = ARG(long);
 				}
 				break;
 			case LENGTH_LL:
 				value->sint =
-					(sint_value_type)va_arg(ap, long long);
+					(sint_value_type)ARG(long long);
 				break;
 			case LENGTH_J:
 				value->sint =
-					(sint_value_type)va_arg(ap, intmax_t);
+					(sint_value_type)ARG(intmax_t);
 				break;
 			case LENGTH_Z:		/* size_t */
 			case LENGTH_T:		/* ptrdiff_t */
@@ -1478,7 +1488,7 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *fp, va_list ap)
 				 * test.
 				 */
 				value->sint =
-					(sint_value_type)va_arg(ap, ptrdiff_t);
+					(sint_value_type)ARG(ptrdiff_t);
 				break;
 			}
 			if (length_mod == LENGTH_HH) {
@@ -1492,31 +1502,28 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *fp, va_list ap)
 			case LENGTH_NONE:
 			case LENGTH_HH:
 			case LENGTH_H:
-				value->uint = va_arg(ap, unsigned int);
+				value->uint = ARG(unsigned int);
 				break;
 			case LENGTH_L:
 				if ((!WCHAR_IS_SIGNED)
 				    && (conv->specifier == 'c')) {
-					value->uint = (wchar_t)va_arg(ap,
-							      WINT_TYPE);
+					value->uint = (wchar_t)ARG(WINT_TYPE);
 				} else {
-					value->uint = va_arg(ap, unsigned long);
+					value->uint = ARG(unsigned long);
 				}
 				break;
 			case LENGTH_LL:
 				value->uint =
-					(uint_value_type)va_arg(ap,
-						unsigned long long);
+					(uint_value_type)ARG(unsigned long long);
 				break;
 			case LENGTH_J:
 				value->uint =
-					(uint_value_type)va_arg(ap,
-								uintmax_t);
+					(uint_value_type)ARG(uintmax_t);
 				break;
 			case LENGTH_Z:		/* size_t */
 			case LENGTH_T:		/* ptrdiff_t */
 				value->uint =
-					(uint_value_type)va_arg(ap, size_t);
+					(uint_value_type)ARG(size_t);
 				break;
 			}
 			if (length_mod == LENGTH_HH) {
@@ -1526,12 +1533,12 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *fp, va_list ap)
 			}
 		} else if (specifier_cat == SPECIFIER_FP) {
 			if (length_mod == LENGTH_UPPER_L) {
-				value->ldbl = va_arg(ap, long double);
+				value->ldbl = ARG(long double);
 			} else {
-				value->dbl = va_arg(ap, double);
+				value->dbl = ARG(double);
 			}
 		} else if (specifier_cat == SPECIFIER_PTR) {
-			value->ptr = va_arg(ap, void *);
+			value->ptr = ARG(void *);
 		}
 
 		/* We've now consumed all arguments related to this
@@ -1801,6 +1808,7 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *fp, va_list ap)
 	}
 
 	return count;
+#undef ARG
 #undef OUTS
 #undef OUTC
 }
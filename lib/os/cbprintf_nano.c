@@ -121,17 +121,29 @@ static bool negative(uint_value_type val)
  * See printk() for description.
  * @param fmt Format string
  * @param ap Variable parameters
+ * @param pkg Package holding the format string and parameters, or NULL
  *
  * @return N/A
  */
-int cbvprintf(cbprintf_cb out, void *ctx, const char *fmt, va_list ap)
+int z_cbvprintf_impl(cbprintf_cb out, void *ctx, const char *fmt,
+		     va_list ap, const uint8_t *pkg)
 {
 	size_t count = 0;
+	size_t pkg_pos = 0;
 	int might_format = 0; /* 1 if encountered a '%' */
 	enum pad_type padding = PAD_NONE;
 	int padlen, min_width = -1;
 	char length_mod = 0;
 
+/* Fetch the next argument, from the package when rendering one. */
+#define ARG(_type) ((pkg != NULL) ? \
+		    Z_CBPRINTF_PKG_ARG(pkg, pkg_pos, _type) : \
+		    va_arg(ap, _type))
+
+	if (pkg != NULL) {
+		fmt = ARG(const char *);
+	}
+
 	/* fmt has already been adjusted if needed */
 	while (*fmt) {
 		if (!might_format) {
@@ -193,21 +205,20 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *fmt, va_list ap)
 				uint_value_type d;
 
 				if (length_mod == 'z') {
-					d = va_arg(ap, ssize_t);
+					d = ARG(ssize_t);
 				} else if (length_mod == 'l') {
-					d = va_arg(ap, long);
+					d = ARG(long);
 				} else if (length_mod == 'L') {
 
-					long long lld = va_arg(ap,
-							       long long);
+					long long lld = ARG(long long);
 					if (!ok64(out, ctx, lld, &count)) {
 						break;
 					}
 					d = (uint_value_type) lld;
 				} else if (*fmt == 'u') {
-					d = va_arg(ap, unsigned int);
+					d = ARG(unsigned int);
 				} else {
-					d = va_arg(ap, int);
+					d = ARG(int);
 				}
 
 				if (*fmt != 'u' && negative(d)) {
@@ -227,7 +238,7 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *fmt, va_list ap)
 				if (*fmt == 'p') {
 					const char *cp;
 
-					x = (uintptr_t)va_arg(ap, void *);
+					x = (uintptr_t)ARG(void *);
 					if (x == 0) {
 						cp = "(nil)";
 					} else {
@@ -243,11 +254,11 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *fmt, va_list ap)
 					}
 					min_width -= 2;
 				} else if (length_mod == 'l') {
-					x = va_arg(ap, unsigned long);
+					x = ARG(unsigned long);
 				} else if (length_mod == 'L') {
-					x = va_arg(ap, unsigned long long);
+					x = ARG(unsigned long long);
 				} else {
-					x = va_arg(ap, unsigned int);
+					x = ARG(unsigned int);
 				}
 
 				print_hex(out, ctx, x, padding, min_width,
@@ -255,7 +266,7 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *fmt, va_list ap)
 				break;
 			}
 			case 's': {
-				char *s = va_arg(ap, char *);
+				char *s = ARG(char *);
 				char *start = s;
 
 				while (*s) {
@@ -272,7 +283,7 @@ pad_string:
 				break;
 			}
 			case 'c': {
-				int c = va_arg(ap, int);
+				int c = ARG(int);
 
 				OUTC(c);
 				break;
@@ -293,4 +304,5 @@ still_might_format:
 	}
 
 	return count;
+#undef ARG
 }
@@ -5,6 +5,89 @@
  */
 
 #include <sys/crc.h>
+#include <sys/util.h>
+
+#if defined(CONFIG_CRC16_SLICE_BY_4)
+#define CRC16_SLICES 4
+#elif defined(CONFIG_CRC16_BYTE_TABLE)
+#define CRC16_SLICES 1
+#endif
+
+#ifdef CRC16_SLICES
+#include "crc16_table.h"
+
+/* Process the bits of src most significant first, followed by padding zero
+ * bytes, four at a time. The bits shifted out of the top of the register
+ * select the polynomial multiple from a table of 16 entries, built for the
+ * polynomial of this call.
+ */
+uint16_t crc16(const uint8_t *src, size_t len, uint16_t polynomial,
+	    uint16_t initial_value, bool pad)
+{
+	uint16_t table[16];
+	uint16_t crc = initial_value;
+	size_t padding = pad ? sizeof(crc) : 0;
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(table); i++) {
+		uint16_t entry = i << 12;
+
+		for (int b = 0; b < 4; b++) {
+			entry = (entry & 0x8000U) ?
+				((entry << 1) ^ polynomial) : (entry << 1);
+		}
+		table[i] = entry;
+	}
+
+	for (i = 0; i < len + padding; i++) {
+		uint8_t byte = (i < len) ? src[i] : 0U;
+
+		crc = ((crc << 4) | (byte >> 4)) ^ table[crc >> 12];
+		crc = ((crc << 4) | (byte & 0x0fU)) ^ table[crc >> 12];
+	}
+
+	return crc;
+}
+
+uint16_t crc16_ccitt(uint16_t seed, const uint8_t *src, size_t len)
+{
+	const uint16_t (*table)[256] = crc16_ccitt_table;
+
+#if CRC16_SLICES == 4
+	for (; len >= 4; len -= 4, src += 4) {
+		seed ^= src[0] | (src[1] << 8);
+		seed = table[3][seed & 0xff] ^ table[2][seed >> 8] ^
+		       table[1][src[2]] ^ table[0][src[3]];
+	}
+#endif
+
+	for (; len > 0; len--) {
+		seed = (seed >> 8) ^ table[0][(seed ^ *src++) & 0xff];
+	}
+
+	return seed;
+}
+
+uint16_t crc16_itu_t(uint16_t seed, const uint8_t *src, size_t len)
+{
+	const uint16_t (*table)[256] = crc16_itu_t_table;
+
+#if CRC16_SLICES == 4
+	for (; len >= 4; len -= 4, src += 4) {
+		seed ^= (src[0] << 8) | src[1];
+		seed = table[3][seed >> 8] ^ table[2][seed & 0xff] ^
+		       table[1][src[2]] ^ table[0][src[3]];
+	}
+#endif
+
+	for (; len > 0; len--) {
+		seed = (seed << 8) ^ table[0][(seed >> 8) ^ *src++];
+	}
+
+	return seed;
+}
+
+#else
 
 uint16_t crc16(const uint8_t *src, size_t len, uint16_t polynomial,
 	    uint16_t initial_value, bool pad)
@@ -60,3 +143,5 @@ uint16_t crc16_itu_t(uint16_t seed, const uint8_t *src, size_t len)
 
 	return seed;
 }
+
+#endif /* CRC16_SLICES */
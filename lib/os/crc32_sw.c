@@ -5,12 +5,67 @@
  */
 
 #include <sys/crc.h>
+#include <sys/byteorder.h>
+
+#if defined(CONFIG_CRC32_SLICE_BY_8)
+#define CRC32_SLICES 8
+#elif defined(CONFIG_CRC32_SLICE_BY_4)
+#define CRC32_SLICES 4
+#elif defined(CONFIG_CRC32_BYTE_TABLE)
+#define CRC32_SLICES 1
+#endif
+
+#ifdef CRC32_SLICES
+#include "crc32_table.h"
+#endif
 
 uint32_t crc32_ieee(const uint8_t *data, size_t len)
 {
 	return crc32_ieee_update(0x0, data, len);
 }
 
+#ifdef CRC32_SLICES
+
+uint32_t crc32_ieee_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+	const uint32_t (*table)[256] = crc32_ieee_table;
+
+	crc = ~crc;
+
+#if CRC32_SLICES == 8
+	for (; len >= 8; len -= 8, data += 8) {
+		uint32_t one = crc ^ sys_get_le32(data);
+		uint32_t two = sys_get_le32(data + 4);
+
+		crc = table[7][one & 0xff] ^
+		      table[6][(one >> 8) & 0xff] ^
+		      table[5][(one >> 16) & 0xff] ^
+		      table[4][one >> 24] ^
+		      table[3][two & 0xff] ^
+		      table[2][(two >> 8) & 0xff] ^
+		      table[1][(two >> 16) & 0xff] ^
+		      table[0][two >> 24];
+	}
+#elif CRC32_SLICES == 4
+	for (; len >= 4; len -= 4, data += 4) {
+		uint32_t one = crc ^ sys_get_le32(data);
+
+		crc = table[3][one & 0xff] ^
+		      table[2][(one >> 8) & 0xff] ^
+		      table[1][(one >> 16) & 0xff] ^
+		      table[0][one >> 24];
+	}
+#endif
+
+	for (size_t i = 0; i < len; i++) {
+		crc = (crc >> 8) ^ table[0][(crc ^ data[i]) & 0xff];
+	}
+
+	return (~crc);
+}
+
+#else
+
 uint32_t crc32_ieee_update(uint32_t crc, const uint8_t *data, size_t len)
 {
 	/* crc table generated from polynomial 0xedb88320 */
@@ -32,3 +87,5 @@ uint32_t crc32_ieee_update(uint32_t crc, const uint8_t *data, size_t len)
 
 	return (~crc);
 }
+
+#endif /* CRC32_SLICES */
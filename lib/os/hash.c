@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sys/hash.h>
+#include <sys/byteorder.h>
+
+#define ROTL32(x, r) (((x) << (r)) | ((x) >> (32 - (r))))
+
+#define XXH_PRIME32_1 0x9E3779B1U
+#define XXH_PRIME32_2 0x85EBCA77U
+#define XXH_PRIME32_3 0xC2B2AE3DU
+#define XXH_PRIME32_4 0x27D4EB2FU
+#define XXH_PRIME32_5 0x165667B1U
+
+static inline uint32_t xxh32_round(uint32_t acc, uint32_t input)
+{
+	acc += input * XXH_PRIME32_2;
+	acc = ROTL32(acc, 13);
+
+	return acc * XXH_PRIME32_1;
+}
+
+uint32_t sys_hash32_xxh32(const void *data, size_t len, uint32_t seed)
+{
+	const uint8_t *p = data;
+	const uint8_t *end = p + len;
+	uint32_t h;
+
+	if (len >= 16) {
+		const uint8_t *limit = end - 16;
+		uint32_t v1 = seed + XXH_PRIME32_1 + XXH_PRIME32_2;
+		uint32_t v2 = seed + XXH_PRIME32_2;
+		uint32_t v3 = seed;
+		uint32_t v4 = seed - XXH_PRIME32_1;
+
+		do {
+			v1 = xxh32_round(v1, sys_get_le32(p));
+			v2 = xxh32_round(v2, sys_get_le32(p + 4));
+			v3 = xxh32_round(v3, sys_get_le32(p + 8));
+			v4 = xxh32_round(v4, sys_get_le32(p + 12));
+			p += 16;
+		} while (p <= limit);
+
+		h = ROTL32(v1, 1) + ROTL32(v2, 7) + ROTL32(v3, 12) +
+		    ROTL32(v4, 18);
+	} else {
+		h = seed + XXH_PRIME32_5;
+	}
+
+	h += (uint32_t)len;
+
+	while (p + 4 <= end) {
+		h += sys_get_le32(p) * XXH_PRIME32_3;
+		h = ROTL32(h, 17) * XXH_PRIME32_4;
+		p += 4;
+	}
+
+	while (p < end) {
+		h += *p * XXH_PRIME32_5;
+		h = ROTL32(h, 11) * XXH_PRIME32_1;
+		p++;
+	}
+
+	h ^= h >> 15;
+	h *= XXH_PRIME32_2;
+	h ^= h >> 13;
+	h *= XXH_PRIME32_3;
+	h ^= h >> 16;
+
+	return h;
+}
+
+#define HSIP_ROUND(v0, v1, v2, v3) do { \
+	v0 += v1; \
+	v1 = ROTL32(v1, 5); \
+	v1 ^= v0; \
+	v0 = ROTL32(v0, 16); \
+	v2 += v3; \
+	v3 = ROTL32(v3, 8); \
+	v3 ^= v2; \
+	v0 += v3; \
+	v3 = ROTL32(v3, 7); \
+	v3 ^= v0; \
+	v2 += v1; \
+	v1 = ROTL32(v1, 13); \
+	v1 ^= v2; \
+	v2 = ROTL32(v2, 16); \
+} while (false)
+
+uint32_t sys_hash32_halfsiphash(const void *data, size_t len,
+				const uint8_t key[8])
+{
+	const uint8_t *p = data;
+	const uint8_t *end = p + (len & ~(size_t)3);
+	uint32_t k0 = sys_get_le32(key);
+	uint32_t k1 = sys_get_le32(key + 4);
+	uint32_t v0 = k0;
+	uint32_t v1 = k1;
+	uint32_t v2 = 0x6c796765U ^ k0;
+	uint32_t v3 = 0x74656462U ^ k1;
+	uint32_t b = (uint32_t)len << 24;
+	uint32_t m;
+
+	for (; p != end; p += 4) {
+		m = sys_get_le32(p);
+		v3 ^= m;
+		HSIP_ROUND(v0, v1, v2, v3);
+		HSIP_ROUND(v0, v1, v2, v3);
+		v0 ^= m;
+	}
+
+	switch (len & 3) {
+	case 3:
+		b |= (uint32_t)p[2] << 16;
+		__fallthrough;
+	case 2:
+		b |= (uint32_t)p[1] << 8;
+		__fallthrough;
+	case 1:
+		b |= (uint32_t)p[0];
+		break;
+	default:
+		break;
+	}
+
+	v3 ^= b;
+	HSIP_ROUND(v0, v1, v2, v3);
+	HSIP_ROUND(v0, v1, v2, v3);
+	v0 ^= b;
+
+	v2 ^= 0xff;
+	HSIP_ROUND(v0, v1, v2, v3);
+	HSIP_ROUND(v0, v1, v2, v3);
+	HSIP_ROUND(v0, v1, v2, v3);
+	HSIP_ROUND(v0, v1, v2, v3);
+
+	return v1 ^ v3;
+}
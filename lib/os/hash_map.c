@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/__assert.h>
+#include <sys/hash_map.h>
+
+#define MIN_DYNAMIC_SLOTS 8
+
+/* Distance of the node in slot @p pos from its home slot */
+static inline uint32_t probe_distance(const struct sys_hash_map *map,
+				      uint32_t pos)
+{
+	return (pos - (map->slots[pos]->hash & map->mask)) & map->mask;
+}
+
+void sys_hash_map_init(struct sys_hash_map *map, struct sys_hash_node **slots,
+		       size_t n_slots, sys_hash_map_eq_t eq)
+{
+	__ASSERT((n_slots & (n_slots - 1)) == 0 && n_slots > 0,
+		 "number of slots must be a power of 2");
+
+	map->slots = slots;
+	map->mask = n_slots - 1;
+	map->count = 0;
+	map->eq = eq;
+	map->alloc = NULL;
+	memset(slots, 0, n_slots * sizeof(*slots));
+}
+
+void sys_hash_map_init_dynamic(struct sys_hash_map *map, sys_hash_map_eq_t eq,
+			       sys_hash_map_alloc_t alloc)
+{
+	map->slots = NULL;
+	map->mask = 0;
+	map->count = 0;
+	map->eq = eq;
+	map->alloc = alloc;
+}
+
+void sys_hash_map_clear(struct sys_hash_map *map)
+{
+	if (map->alloc != NULL) {
+		if (map->slots != NULL) {
+			map->alloc(map->slots, 0);
+		}
+		map->slots = NULL;
+		map->mask = 0;
+	} else {
+		memset(map->slots, 0, (map->mask + 1) * sizeof(*map->slots));
+	}
+
+	map->count = 0;
+}
+
+/* Insert a node whose key is known not to be in the map, which has a
+ * free slot.
+ */
+static void place(struct sys_hash_map *map, struct sys_hash_node *node)
+{
+	uint32_t pos = node->hash & map->mask;
+	uint32_t dist = 0;
+
+	while (map->slots[pos] != NULL) {
+		uint32_t slot_dist = probe_distance(map, pos);
+
+		/* Robin Hood: take the slot of a node closer to home, and
+		 * carry on with that node.
+		 */
+		if (slot_dist < dist) {
+			struct sys_hash_node *tmp = map->slots[pos];
+
+			map->slots[pos] = node;
+			node = tmp;
+			dist = slot_dist;
+		}
+
+		pos = (pos + 1) & map->mask;
+		dist++;
+	}
+
+	map->slots[pos] = node;
+}
+
+static int grow(struct sys_hash_map *map)
+{
+	size_t n_slots = (map->slots == NULL) ?
+			 MIN_DYNAMIC_SLOTS : 2 * ((size_t)map->mask + 1);
+	struct sys_hash_node **old = map->slots;
+	size_t old_n_slots = (size_t)map->mask + 1;
+	struct sys_hash_node **slots;
+
+	slots = map->alloc(NULL, n_slots * sizeof(*slots));
+	if (slots == NULL) {
+		return -ENOMEM;
+	}
+
+	memset(slots, 0, n_slots * sizeof(*slots));
+	map->slots = slots;
+	map->mask = n_slots - 1;
+
+	if (old != NULL) {
+		for (size_t i = 0; i < old_n_slots; i++) {
+			if (old[i] != NULL) {
+				place(map, old[i]);
+			}
+		}
+
+		map->alloc(old, 0);
+	}
+
+	return 0;
+}
+
+static bool full(const struct sys_hash_map *map)
+{
+	uint32_t n_slots = map->mask + 1;
+
+	if (map->slots == NULL) {
+		return true;
+	}
+
+	if (map->alloc != NULL) {
+		return map->count + 1 > n_slots - n_slots / 4;
+	}
+
+	return map->count + 1 > n_slots - n_slots / 8;
+}
+
+/* Slot of the key, or -1 */
+static int find(const struct sys_hash_map *map, uint32_t hash,
+		const void *key)
+{
+	uint32_t pos;
+	uint32_t dist = 0;
+
+	if (map->slots == NULL) {
+		return -1;
+	}
+
+	for (pos = hash & map->mask; map->slots[pos] != NULL;
+	     pos = (pos + 1) & map->mask, dist++) {
+		const struct sys_hash_node *node = map->slots[pos];
+
+		/* The key would have displaced this node */
+		if (probe_distance(map, pos) < dist) {
+			break;
+		}
+
+		if (node->hash == hash && map->eq(node, key)) {
+			return pos;
+		}
+	}
+
+	return -1;
+}
+
+/* Remove the node of slot @p pos, shifting the next nodes back */
+static void remove_at(struct sys_hash_map *map, uint32_t pos)
+{
+	uint32_t next = (pos + 1) & map->mask;
+
+	while (map->slots[next] != NULL && probe_distance(map, next) != 0) {
+		map->slots[pos] = map->slots[next];
+		pos = next;
+		next = (next + 1) & map->mask;
+	}
+
+	map->slots[pos] = NULL;
+	map->count--;
+}
+
+int sys_hash_map_insert(struct sys_hash_map *map, struct sys_hash_node *node,
+			uint32_t hash, const void *key)
+{
+	if (find(map, hash, key) >= 0) {
+		return -EEXIST;
+	}
+
+	if (full(map)) {
+		if (map->alloc == NULL || grow(map) < 0) {
+			return -ENOMEM;
+		}
+	}
+
+	node->hash = hash;
+	place(map, node);
+	map->count++;
+
+	return 0;
+}
+
+struct sys_hash_node *sys_hash_map_get(const struct sys_hash_map *map,
+				       uint32_t hash, const void *key)
+{
+	int pos = find(map, hash, key);
+
+	return (pos < 0) ? NULL : map->slots[pos];
+}
+
+struct sys_hash_node *sys_hash_map_remove(struct sys_hash_map *map,
+					  uint32_t hash, const void *key)
+{
+	struct sys_hash_node *node;
+	int pos = find(map, hash, key);
+
+	if (pos < 0) {
+		return NULL;
+	}
+
+	node = map->slots[pos];
+	remove_at(map, pos);
+
+	return node;
+}
+
+bool sys_hash_map_remove_node(struct sys_hash_map *map,
+			      struct sys_hash_node *node)
+{
+	uint32_t pos;
+	uint32_t dist = 0;
+
+	if (map->slots == NULL) {
+		return false;
+	}
+
+	for (pos = node->hash & map->mask; map->slots[pos] != NULL;
+	     pos = (pos + 1) & map->mask, dist++) {
+		if (map->slots[pos] == node) {
+			remove_at(map, pos);
+			return true;
+		}
+
+		if (probe_distance(map, pos) < dist) {
+			break;
+		}
+	}
+
+	return false;
+}
@@ -536,47 +536,122 @@ static int arr_parse(struct json_obj *obj,
 	return -EINVAL;
 }
 
+/*
+ * Objects described by at least DESCR_HASH_MIN_FIELDS descriptors are
+ * parsed with a hash table of the descriptors, built on the stack when the
+ * parsing of the object starts, rather than a linear search of every key.
+ * With at most 31 descriptors, the table is at most half full.
+ */
+#define DESCR_HASH_MIN_FIELDS 8
+#define DESCR_HASH_SLOTS 64
+
+static uint8_t descr_hash(const char *key, size_t len)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261U;
+
+	while (len-- > 0) {
+		hash = (hash ^ (uint8_t)*key++) * 16777619U;
+	}
+
+	return (uint8_t)((hash ^ (hash >> 16)) & (DESCR_HASH_SLOTS - 1));
+}
+
+/* Slots hold the index of a descriptor plus one, 0 for an empty slot */
+static void descr_table_init(uint8_t *table,
+			     const struct json_obj_descr *descr,
+			     size_t descr_len)
+{
+	size_t i;
+
+	memset(table, 0, DESCR_HASH_SLOTS);
+
+	for (i = 0; i < descr_len; i++) {
+		uint8_t slot = descr_hash(descr[i].field_name,
+					  descr[i].field_name_len);
+
+		while (table[slot] != 0U) {
+			slot = (slot + 1U) & (DESCR_HASH_SLOTS - 1);
+		}
+
+		table[slot] = (uint8_t)(i + 1U);
+	}
+}
+
+static bool descr_matches(const struct json_obj_descr *descr,
+			  const struct json_obj_key_value *kv)
+{
+	return kv->key_len == descr->field_name_len &&
+	       !memcmp(kv->key, descr->field_name, descr->field_name_len);
+}
+
+/* Find the first descriptor of the key that has not been decoded yet */
+static int find_descr(const struct json_obj_descr *descr, size_t descr_len,
+		      const uint8_t *table, int32_t decoded_fields,
+		      const struct json_obj_key_value *kv)
+{
+	size_t i;
+
+	if (table == NULL) {
+		for (i = 0; i < descr_len; i++) {
+			if (!(decoded_fields & (1 << i)) &&
+			    descr_matches(&descr[i], kv)) {
+				return i;
+			}
+		}
+
+		return -1;
+	}
+
+	/* Descriptors of the same name were inserted in order, and are
+	 * found in that order.
+	 */
+	for (i = descr_hash(kv->key, kv->key_len); table[i] != 0U;
+	     i = (i + 1U) & (DESCR_HASH_SLOTS - 1)) {
+		int idx = table[i] - 1;
+
+		if (!(decoded_fields & (1 << idx)) &&
+		    descr_matches(&descr[idx], kv)) {
+			return idx;
+		}
+	}
+
+	return -1;
+}
+
 static int obj_parse(struct json_obj *obj, const struct json_obj_descr *descr,
 		     size_t descr_len, void *val)
 {
+	uint8_t table_buf[DESCR_HASH_SLOTS];
+	uint8_t *table = NULL;
 	struct json_obj_key_value kv;
 	int32_t decoded_fields = 0;
-	size_t i;
 	int ret;
+	int i;
+
+	if (descr_len >= DESCR_HASH_MIN_FIELDS) {
+		table = table_buf;
+		descr_table_init(table, descr, descr_len);
+	}
 
 	while (!obj_next(obj, &kv)) {
 		if (kv.value.type == JSON_TOK_OBJECT_END) {
 			return decoded_fields;
 		}
 
-		for (i = 0; i < descr_len; i++) {
-			void *decode_field = (char *)val + descr[i].offset;
-
-			/* Field has been decoded already, skip */
-			if (decoded_fields & (1 << i)) {
-				continue;
-			}
-
-			/* Check if it's the i-th field */
-			if (kv.key_len != descr[i].field_name_len) {
-				continue;
-			}
-
-			if (memcmp(kv.key, descr[i].field_name,
-				   descr[i].field_name_len)) {
-				continue;
-			}
-
-			/* Store the decoded value */
-			ret = decode_value(obj, &descr[i], &kv.value,
-					   decode_field, val);
-			if (ret < 0) {
-				return ret;
-			}
+		i = find_descr(descr, descr_len, table, decoded_fields, &kv);
+		if (i < 0) {
+			continue;
+		}
 
-			decoded_fields |= 1<<i;
-			break;
+		/* Store the decoded value */
+		ret = decode_value(obj, &descr[i], &kv.value,
+				   (char *)val + descr[i].offset, val);
+		if (ret < 0) {
+			return ret;
 		}
+
+		decoded_fields |= 1<<i;
 	}
 
 	return -EINVAL;
@@ -936,3 +1011,683 @@ ssize_t json_calc_encoded_len(const struct json_obj_descr *descr,
 
 	return total;
 }
+
+/* States of the streaming parser, the expected token */
+enum sax_state {
+	SAX_VALUE,
+	SAX_VALUE_OR_END,	/* after '[' */
+	SAX_KEY,
+	SAX_KEY_OR_END,		/* after '{' */
+	SAX_COLON,
+	SAX_NEXT,		/* ',' or end of the current object/array */
+	SAX_DONE,
+};
+
+/* Token being parsed by the streaming parser */
+enum sax_lex {
+	SAX_LEX_NONE,
+	SAX_LEX_STRING,
+	SAX_LEX_ESCAPE,
+	SAX_LEX_UNICODE,
+	SAX_LEX_NUMBER,
+	SAX_LEX_LITERAL,
+};
+
+void json_sax_init(struct json_sax_parser *parser, char *buf, size_t buf_size,
+		   json_sax_cb_t cb, void *user_data)
+{
+	memset(parser, 0, sizeof(*parser));
+	parser->cb = cb;
+	parser->user_data = user_data;
+	parser->buf = buf;
+	parser->buf_size = buf_size;
+	parser->state = SAX_VALUE;
+	parser->lex = SAX_LEX_NONE;
+}
+
+static bool sax_in_object(const struct json_sax_parser *parser)
+{
+	return (parser->object_mask & BIT(parser->depth - 1)) != 0U;
+}
+
+static int sax_push(struct json_sax_parser *parser, char chr)
+{
+	/* Keep room for the terminating NUL */
+	if (parser->len + 1 >= parser->buf_size) {
+		return -ENOMEM;
+	}
+
+	parser->buf[parser->len++] = chr;
+
+	return 0;
+}
+
+static int sax_emit(struct json_sax_parser *parser, enum json_tokens type,
+		    bool key)
+{
+	struct json_sax_event event = {
+		.type = type,
+		.key = key,
+		.depth = parser->depth,
+	};
+
+	if (type == JSON_TOK_STRING || type == JSON_TOK_NUMBER) {
+		parser->buf[parser->len] = '\0';
+		event.value = parser->buf;
+		event.value_len = parser->len;
+	}
+
+	return parser->cb(&event, parser->user_data);
+}
+
+static int sax_value(struct json_sax_parser *parser, enum json_tokens type)
+{
+	parser->state = (parser->depth == 0U) ? SAX_DONE : SAX_NEXT;
+
+	return sax_emit(parser, type, false);
+}
+
+static int sax_open(struct json_sax_parser *parser, enum json_tokens type)
+{
+	int ret;
+
+	if (parser->depth == JSON_STREAM_MAX_DEPTH) {
+		return -E2BIG;
+	}
+
+	ret = sax_emit(parser, type, false);
+
+	WRITE_BIT(parser->object_mask, parser->depth,
+		  type == JSON_TOK_OBJECT_START);
+	parser->depth++;
+	parser->state = (type == JSON_TOK_OBJECT_START) ?
+			SAX_KEY_OR_END : SAX_VALUE_OR_END;
+
+	return ret;
+}
+
+static int sax_close(struct json_sax_parser *parser, enum json_tokens type)
+{
+	parser->depth--;
+
+	return sax_value(parser, type);
+}
+
+/* -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)? */
+static bool sax_valid_number(const char *num, size_t len)
+{
+	const char *end = num + len;
+	const char *digits;
+
+	if (num < end && *num == '-') {
+		num++;
+	}
+
+	if (num < end && *num == '0') {
+		num++;
+	} else {
+		for (digits = num; num < end && isdigit((unsigned char)*num);
+		     num++) {
+		}
+		if (num == digits) {
+			return false;
+		}
+	}
+
+	if (num < end && *num == '.') {
+		for (digits = ++num;
+		     num < end && isdigit((unsigned char)*num); num++) {
+		}
+		if (num == digits) {
+			return false;
+		}
+	}
+
+	if (num < end && (*num == 'e' || *num == 'E')) {
+		num++;
+		if (num < end && (*num == '+' || *num == '-')) {
+			num++;
+		}
+		for (digits = num; num < end && isdigit((unsigned char)*num);
+		     num++) {
+		}
+		if (num == digits) {
+			return false;
+		}
+	}
+
+	return num == end;
+}
+
+static int sax_number_end(struct json_sax_parser *parser)
+{
+	parser->lex = SAX_LEX_NONE;
+
+	if (!sax_valid_number(parser->buf, parser->len)) {
+		return -EINVAL;
+	}
+
+	return sax_value(parser, JSON_TOK_NUMBER);
+}
+
+static int sax_string_end(struct json_sax_parser *parser)
+{
+	parser->lex = SAX_LEX_NONE;
+
+	if (parser->state == SAX_KEY || parser->state == SAX_KEY_OR_END) {
+		parser->state = SAX_COLON;
+		return sax_emit(parser, JSON_TOK_STRING, true);
+	}
+
+	return sax_value(parser, JSON_TOK_STRING);
+}
+
+static int sax_value_start(struct json_sax_parser *parser, char chr)
+{
+	parser->len = 0;
+
+	switch (chr) {
+	case '{':
+		return sax_open(parser, JSON_TOK_OBJECT_START);
+	case '[':
+		return sax_open(parser, JSON_TOK_LIST_START);
+	case '"':
+		parser->lex = SAX_LEX_STRING;
+		return 0;
+	case 't':
+		parser->literal = "rue";
+		break;
+	case 'f':
+		parser->literal = "alse";
+		break;
+	case 'n':
+		parser->literal = "ull";
+		break;
+	default:
+		if (chr == '-' || isdigit((unsigned char)chr)) {
+			parser->lex = SAX_LEX_NUMBER;
+			return sax_push(parser, chr);
+		}
+
+		return -EINVAL;
+	}
+
+	/* The token type is the first character of the literal */
+	parser->lex = SAX_LEX_LITERAL;
+	parser->lex_count = (uint8_t)chr;
+
+	return 0;
+}
+
+/* Handle a character outside of any string, number or literal */
+static int sax_structural(struct json_sax_parser *parser, char chr)
+{
+	if (chr == ' ' || chr == '\t' || chr == '\n' || chr == '\r') {
+		return 0;
+	}
+
+	switch (parser->state) {
+	case SAX_VALUE_OR_END:
+		if (chr == ']') {
+			return sax_close(parser, JSON_TOK_LIST_END);
+		}
+
+		__fallthrough;
+	case SAX_VALUE:
+		return sax_value_start(parser, chr);
+	case SAX_KEY_OR_END:
+		if (chr == '}') {
+			return sax_close(parser, JSON_TOK_OBJECT_END);
+		}
+
+		__fallthrough;
+	case SAX_KEY:
+		if (chr != '"') {
+			return -EINVAL;
+		}
+
+		parser->len = 0;
+		parser->lex = SAX_LEX_STRING;
+		return 0;
+	case SAX_COLON:
+		if (chr != ':') {
+			return -EINVAL;
+		}
+
+		parser->state = SAX_VALUE;
+		return 0;
+	case SAX_NEXT:
+		if (chr == ',') {
+			parser->state = sax_in_object(parser) ? SAX_KEY :
+								 SAX_VALUE;
+			return 0;
+		}
+
+		if (chr == '}' && sax_in_object(parser)) {
+			return sax_close(parser, JSON_TOK_OBJECT_END);
+		}
+
+		if (chr == ']' && !sax_in_object(parser)) {
+			return sax_close(parser, JSON_TOK_LIST_END);
+		}
+
+		return -EINVAL;
+	default:
+		return -EINVAL;
+	}
+}
+
+static int sax_char(struct json_sax_parser *parser, char chr)
+{
+	int ret;
+
+	switch (parser->lex) {
+	case SAX_LEX_STRING:
+		if (chr == '"') {
+			return sax_string_end(parser);
+		}
+
+		if (chr == '\\') {
+			parser->lex = SAX_LEX_ESCAPE;
+		} else if ((uint8_t)chr < 0x20) {
+			return -EINVAL;
+		}
+
+		return sax_push(parser, chr);
+	case SAX_LEX_ESCAPE:
+		if (chr == 'u') {
+			parser->lex = SAX_LEX_UNICODE;
+			parser->lex_count = 4;
+		} else if (chr != '\0' && strchr("\"\\/bfnrt", chr) != NULL) {
+			parser->lex = SAX_LEX_STRING;
+		} else {
+			return -EINVAL;
+		}
+
+		return sax_push(parser, chr);
+	case SAX_LEX_UNICODE:
+		if (!isxdigit((unsigned char)chr)) {
+			return -EINVAL;
+		}
+
+		if (--parser->lex_count == 0U) {
+			parser->lex = SAX_LEX_STRING;
+		}
+
+		return sax_push(parser, chr);
+	case SAX_LEX_LITERAL:
+		if (chr != *parser->literal) {
+			return -EINVAL;
+		}
+
+		if (*++parser->literal == '\0') {
+			parser->lex = SAX_LEX_NONE;
+			return sax_value(parser, parser->lex_count);
+		}
+
+		return 0;
+	case SAX_LEX_NUMBER:
+		if (isdigit((unsigned char)chr) || chr == '-' || chr == '+' ||
+		    chr == '.' || chr == 'e' || chr == 'E') {
+			return sax_push(parser, chr);
+		}
+
+		/* The number ends at the first other character, which is
+		 * then handled as such.
+		 */
+		ret = sax_number_end(parser);
+		if (ret < 0) {
+			return ret;
+		}
+
+		break;
+	default:
+		break;
+	}
+
+	return sax_structural(parser, chr);
+}
+
+/* Length of the run of characters at the start of @p data that do not end
+ * or escape a string, which are buffered at once.
+ */
+static size_t sax_string_run(const char *data, size_t len)
+{
+	size_t run;
+
+	for (run = 0; run < len; run++) {
+		char chr = data[run];
+
+		if (chr == '"' || chr == '\\' || (uint8_t)chr < 0x20) {
+			break;
+		}
+	}
+
+	return run;
+}
+
+int json_sax_feed(struct json_sax_parser *parser, const char *data,
+		  size_t len)
+{
+	size_t pos = 0;
+	int ret = 0;
+
+	if (parser->error < 0) {
+		return parser->error;
+	}
+
+	while (pos < len) {
+		if (parser->lex == SAX_LEX_STRING) {
+			size_t run = sax_string_run(&data[pos], len - pos);
+
+			if (run > 0) {
+				if (parser->len + run >= parser->buf_size) {
+					ret = -ENOMEM;
+					break;
+				}
+
+				memcpy(&parser->buf[parser->len], &data[pos],
+				       run);
+				parser->len += run;
+				pos += run;
+				continue;
+			}
+		}
+
+		ret = sax_char(parser, data[pos++]);
+		if (ret < 0) {
+			break;
+		}
+	}
+
+	parser->error = MIN(ret, 0);
+
+	return parser->error;
+}
+
+int json_sax_finish(struct json_sax_parser *parser)
+{
+	int ret;
+
+	if (parser->error < 0) {
+		return parser->error;
+	}
+
+	if (parser->lex == SAX_LEX_NUMBER) {
+		ret = sax_number_end(parser);
+		if (ret < 0) {
+			parser->error = ret;
+			return ret;
+		}
+	}
+
+	if (parser->lex != SAX_LEX_NONE || parser->state != SAX_DONE) {
+		parser->error = -EINVAL;
+	}
+
+	return parser->error;
+}
+
+void json_writer_init(struct json_writer *writer, char *buf, size_t buf_size,
+		      json_append_bytes_t append_bytes, void *data)
+{
+	memset(writer, 0, sizeof(*writer));
+	writer->append_bytes = append_bytes;
+	writer->data = data;
+	writer->buf = buf;
+	writer->buf_size = (buf != NULL) ? buf_size : 0;
+}
+
+static int writer_fail(struct json_writer *writer, int error)
+{
+	if (writer->error == 0) {
+		writer->error = error;
+	}
+
+	return writer->error;
+}
+
+int json_writer_flush(struct json_writer *writer)
+{
+	int ret;
+
+	if (writer->error < 0 || writer->used == 0U) {
+		return writer->error;
+	}
+
+	ret = writer->append_bytes(writer->buf, writer->used, writer->data);
+	if (ret < 0) {
+		return writer_fail(writer, ret);
+	}
+
+	writer->used = 0;
+
+	return 0;
+}
+
+static int writer_append(const char *bytes, size_t len, void *data)
+{
+	struct json_writer *writer = data;
+	int ret;
+
+	if (writer->error < 0) {
+		return writer->error;
+	}
+
+	if (writer->buf_size == 0U) {
+		ret = writer->append_bytes(bytes, len, writer->data);
+		return (ret < 0) ? writer_fail(writer, ret) : 0;
+	}
+
+	while (len > 0) {
+		size_t chunk;
+
+		if (writer->used == writer->buf_size) {
+			ret = json_writer_flush(writer);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+
+		chunk = MIN(len, writer->buf_size - writer->used);
+		memcpy(&writer->buf[writer->used], bytes, chunk);
+		writer->used += chunk;
+		bytes += chunk;
+		len -= chunk;
+	}
+
+	return 0;
+}
+
+static bool writer_in_object(const struct json_writer *writer)
+{
+	return writer->depth > 0U &&
+	       (writer->object_mask & BIT(writer->depth - 1)) != 0U;
+}
+
+/* Write the separator before a value, if any */
+static int writer_value_start(struct json_writer *writer)
+{
+	uint32_t first;
+
+	if (writer->error < 0) {
+		return writer->error;
+	}
+
+	if (writer->depth == 0U) {
+		return writer->done ? writer_fail(writer, -EINVAL) : 0;
+	}
+
+	if (writer_in_object(writer)) {
+		if (!writer->after_key) {
+			return writer_fail(writer, -EINVAL);
+		}
+
+		writer->after_key = false;
+		return 0;
+	}
+
+	first = writer->first_mask & BIT(writer->depth - 1);
+	writer->first_mask &= ~BIT(writer->depth - 1);
+
+	return first ? 0 : writer_append(",", 1, writer);
+}
+
+static int writer_value_end(struct json_writer *writer)
+{
+	if (writer->depth == 0U) {
+		writer->done = true;
+	}
+
+	return writer->error;
+}
+
+static int writer_open(struct json_writer *writer, bool object)
+{
+	int ret;
+
+	ret = writer_value_start(writer);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (writer->depth == JSON_STREAM_MAX_DEPTH) {
+		return writer_fail(writer, -E2BIG);
+	}
+
+	WRITE_BIT(writer->object_mask, writer->depth, object);
+	writer->first_mask |= BIT(writer->depth);
+	writer->depth++;
+
+	return writer_append(object ? "{" : "[", 1, writer);
+}
+
+static int writer_close(struct json_writer *writer, bool object)
+{
+	if (writer->error < 0) {
+		return writer->error;
+	}
+
+	if (writer->depth == 0U || writer_in_object(writer) != object ||
+	    writer->after_key) {
+		return writer_fail(writer, -EINVAL);
+	}
+
+	writer->depth--;
+	writer_append(object ? "}" : "]", 1, writer);
+
+	return writer_value_end(writer);
+}
+
+int json_writer_object_start(struct json_writer *writer)
+{
+	return writer_open(writer, true);
+}
+
+int json_writer_object_end(struct json_writer *writer)
+{
+	return writer_close(writer, true);
+}
+
+int json_writer_array_start(struct json_writer *writer)
+{
+	return writer_open(writer, false);
+}
+
+int json_writer_array_end(struct json_writer *writer)
+{
+	return writer_close(writer, false);
+}
+
+static int writer_string(struct json_writer *writer, const char *str)
+{
+	writer_append("\"", 1, writer);
+	json_escape_internal(str, writer_append, writer);
+
+	return writer_append("\"", 1, writer);
+}
+
+int json_writer_key(struct json_writer *writer, const char *key)
+{
+	uint32_t first;
+
+	if (writer->error < 0) {
+		return writer->error;
+	}
+
+	if (!writer_in_object(writer) || writer->after_key) {
+		return writer_fail(writer, -EINVAL);
+	}
+
+	first = writer->first_mask & BIT(writer->depth - 1);
+	writer->first_mask &= ~BIT(writer->depth - 1);
+	if (!first) {
+		writer_append(",", 1, writer);
+	}
+
+	writer_string(writer, key);
+	writer->after_key = true;
+
+	return writer_append(":", 1, writer);
+}
+
+int json_writer_string(struct json_writer *writer, const char *str)
+{
+	if (writer_value_start(writer) < 0) {
+		return writer->error;
+	}
+
+	writer_string(writer, str);
+
+	return writer_value_end(writer);
+}
+
+int json_writer_number(struct json_writer *writer, int64_t num)
+{
+	char buf[sizeof("-9223372036854775808")];
+	char *pos = &buf[sizeof(buf)];
+	uint64_t mag = (num < 0) ? -(uint64_t)num : (uint64_t)num;
+
+	if (writer_value_start(writer) < 0) {
+		return writer->error;
+	}
+
+	do {
+		*--pos = '0' + (char)(mag % 10U);
+		mag /= 10U;
+	} while (mag != 0U);
+
+	if (num < 0) {
+		*--pos = '-';
+	}
+
+	writer_append(pos, &buf[sizeof(buf)] - pos, writer);
+
+	return writer_value_end(writer);
+}
+
+int json_writer_bool(struct json_writer *writer, bool value)
+{
+	if (writer_value_start(writer) < 0) {
+		return writer->error;
+	}
+
+	if (value) {
+		writer_append("true", 4, writer);
+	} else {
+		writer_append("false", 5, writer);
+	}
+
+	return writer_value_end(writer);
+}
+
+int json_writer_null(struct json_writer *writer)
+{
+	if (writer_value_start(writer) < 0) {
+		return writer->error;
+	}
+
+	writer_append("null", 4, writer);
+
+	return writer_value_end(writer);
+}
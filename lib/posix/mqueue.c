@@ -10,12 +10,38 @@
 #include <posix/time.h>
 #include <posix/mqueue.h>
 
+/*
+ * Messages are stored in buffers allocated from a slab of the queue, and
+ * the kernel message queue only holds descriptors of these buffers. There
+ * are as many buffers as entries in the kernel message queue, so waiting
+ * for a free buffer is waiting for room in the queue. The buffers can be
+ * loaned to the application with mq_loan_np() and mq_receive_loan_np() to
+ * send and receive messages without copying them.
+ */
+struct mqueue_msg {
+	char *buf;
+	size_t len;
+};
+
+/* Notification states */
+#define NOTIFY_NONE 0
+#define NOTIFY_ARMED 1
+#define NOTIFY_SETUP 2
+
 typedef struct mqueue_object {
 	sys_snode_t snode;
 	char *mem_buffer;
 	char *mem_obj;
 	struct k_msgq queue;
+	struct k_mem_slab buffers;
+	size_t msg_size;
 	atomic_t ref_count;
+	/* Queued messages and waiting receivers, for notifications */
+	atomic_t n_msgs;
+	atomic_t n_receivers;
+	atomic_t notify_state;
+	struct k_poll_signal *notify_signal;
+	int notify_result;
 	char *name;
 } mqueue_object;
 
@@ -36,6 +62,10 @@ static int32_t send_message(mqueue_desc *mqd, const char *msg_ptr, size_t msg_le
 			  k_timeout_t timeout);
 static int receive_message(mqueue_desc *mqd, char *msg_ptr, size_t msg_len,
 			   k_timeout_t timeout);
+static char *alloc_buffer(mqueue_desc *mqd, k_timeout_t timeout);
+static void queue_buffer(mqueue_object *msg_queue, char *buf, size_t len);
+static int dequeue_buffer(mqueue_desc *mqd, struct mqueue_msg *msg,
+			  k_timeout_t timeout);
 static void remove_mq(mqueue_object *msg_queue);
 
 #if defined(__sparc__)
@@ -66,6 +96,7 @@ mqd_t mq_open(const char *name, int oflags, ...)
 	mqueue_object *msg_queue;
 	mqueue_desc *msg_queue_desc = NULL, *mqd = (mqueue_desc *)(-1);
 	char *mq_desc_ptr, *mq_obj_ptr, *mq_buf_ptr, *mq_name_ptr;
+	size_t msgs_size, block_size;
 
 	va_start(va, oflags);
 	if ((oflags & O_CREAT) != 0) {
@@ -147,19 +178,24 @@ mqd_t mq_open(const char *name, int oflags, ...)
 
 		strcpy(msg_queue->name, name);
 
-		mq_buf_ptr = k_malloc(msg_size * max_msgs * sizeof(uint8_t));
+		/* Message descriptors, followed by the message buffers */
+		msgs_size = max_msgs * sizeof(struct mqueue_msg);
+		block_size = WB_UP(msg_size);
+		mq_buf_ptr = k_malloc(msgs_size + max_msgs * block_size);
 		if (mq_buf_ptr != NULL) {
-			(void)memset(mq_buf_ptr, 0,
-				     msg_size * max_msgs * sizeof(uint8_t));
 			msg_queue->mem_buffer = mq_buf_ptr;
 		} else {
 			goto free_mq_buffer;
 		}
 
 		(void)atomic_set(&msg_queue->ref_count, 1);
+		msg_queue->msg_size = msg_size;
 		/* initialize zephyr message queue */
-		k_msgq_init(&msg_queue->queue, msg_queue->mem_buffer, msg_size,
-			    max_msgs);
+		k_msgq_init(&msg_queue->queue, msg_queue->mem_buffer,
+			    sizeof(struct mqueue_msg), max_msgs);
+		k_mem_slab_init(&msg_queue->buffers,
+				msg_queue->mem_buffer + msgs_size, block_size,
+				max_msgs);
 		k_sem_take(&mq_sem, K_FOREVER);
 		sys_slist_append(&mq_list, (sys_snode_t *)&(msg_queue->snode));
 		k_sem_give(&mq_sem);
@@ -314,7 +350,7 @@ int mq_getattr(mqd_t mqdes, struct mq_attr *mqstat)
 	k_msgq_get_attrs(&mqd->mqueue->queue, &attrs);
 	mqstat->mq_flags = mqd->flags;
 	mqstat->mq_maxmsg = attrs.max_msgs;
-	mqstat->mq_msgsize = attrs.msg_size;
+	mqstat->mq_msgsize = mqd->mqueue->msg_size;
 	mqstat->mq_curmsgs = attrs.used_msgs;
 	k_sem_give(&mq_sem);
 	return 0;
@@ -351,6 +387,158 @@ int mq_setattr(mqd_t mqdes, const struct mq_attr *mqstat,
 	return 0;
 }
 
+/**
+ * @brief Register for notification when a message is available.
+ *
+ * Zephyr has no signals: with SIGEV_SIGNAL, sigev_value.sival_ptr must
+ * point to a struct k_poll_signal, which is raised with sigev_signo as
+ * result, so that the notification can be waited for with k_poll(). As
+ * specified, the notification is only delivered when a message arrives on
+ * an empty queue while no thread is blocked receiving from it, and the
+ * registration is then removed. SIGEV_THREAD is not supported.
+ *
+ * See IEEE 1003.1
+ */
+int mq_notify(mqd_t mqdes, const struct sigevent *notification)
+{
+	mqueue_desc *mqd = (mqueue_desc *)mqdes;
+	mqueue_object *msg_queue;
+
+	if (mqd == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	msg_queue = mqd->mqueue;
+
+	if (notification == NULL) {
+		(void)atomic_cas(&msg_queue->notify_state, NOTIFY_ARMED,
+				 NOTIFY_NONE);
+		return 0;
+	}
+
+	if ((notification->sigev_notify != SIGEV_NONE &&
+	     notification->sigev_notify != SIGEV_SIGNAL) ||
+	    (notification->sigev_notify == SIGEV_SIGNAL &&
+	     notification->sigev_value.sival_ptr == NULL)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (!atomic_cas(&msg_queue->notify_state, NOTIFY_NONE,
+			NOTIFY_SETUP)) {
+		errno = EBUSY;
+		return -1;
+	}
+
+	if (notification->sigev_notify == SIGEV_SIGNAL) {
+		msg_queue->notify_signal = notification->sigev_value.sival_ptr;
+		msg_queue->notify_result = notification->sigev_signo;
+	} else {
+		msg_queue->notify_signal = NULL;
+	}
+
+	(void)atomic_set(&msg_queue->notify_state, NOTIFY_ARMED);
+
+	return 0;
+}
+
+/**
+ * @brief Loan a message buffer of a message queue.
+ *
+ * The buffer has room for a message of the maximum size of the queue. It
+ * is sent without copying with mq_send_loan_np(), or given back with
+ * mq_return_np(). Each loaned buffer takes the place of a message in the
+ * queue, so the function waits until abstime if the queue is full, or
+ * forever if abstime is NULL.
+ *
+ * @return Address of the buffer, or NULL with errno set.
+ */
+char *mq_loan_np(mqd_t mqdes, const struct timespec *abstime)
+{
+	mqueue_desc *mqd = (mqueue_desc *)mqdes;
+	k_timeout_t timeout = K_FOREVER;
+
+	if (abstime != NULL) {
+		timeout = K_MSEC((int32_t) timespec_to_timeoutms(abstime));
+	}
+
+	return alloc_buffer(mqd, timeout);
+}
+
+/**
+ * @brief Send a message held in a loaned buffer.
+ *
+ * The buffer, obtained from mq_loan_np() on the same queue, is queued
+ * without copying and must not be accessed anymore. This never blocks.
+ * All messages in message queue are of equal priority.
+ */
+int mq_send_loan_np(mqd_t mqdes, char *buf, size_t msg_len,
+		    unsigned int msg_prio)
+{
+	mqueue_desc *mqd = (mqueue_desc *)mqdes;
+
+	if (mqd == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (msg_len > mqd->mqueue->msg_size) {
+		errno = EMSGSIZE;
+		return -1;
+	}
+
+	queue_buffer(mqd->mqueue, buf, msg_len);
+
+	return 0;
+}
+
+/**
+ * @brief Receive a message without copying it.
+ *
+ * On success, buf points to the buffer holding the message, which is
+ * loaned to the caller until it is given back with mq_return_np(). Waits
+ * until abstime if the queue is empty, or forever if abstime is NULL.
+ *
+ * @return Length of the message, or -1 with errno set.
+ */
+int mq_receive_loan_np(mqd_t mqdes, char **buf, unsigned int *msg_prio,
+		       const struct timespec *abstime)
+{
+	mqueue_desc *mqd = (mqueue_desc *)mqdes;
+	k_timeout_t timeout = K_FOREVER;
+	struct mqueue_msg msg;
+
+	if (abstime != NULL) {
+		timeout = K_MSEC((int32_t) timespec_to_timeoutms(abstime));
+	}
+
+	if (dequeue_buffer(mqd, &msg, timeout) != 0) {
+		return -1;
+	}
+
+	*buf = msg.buf;
+
+	return msg.len;
+}
+
+/**
+ * @brief Give a loaned buffer back to its message queue.
+ */
+int mq_return_np(mqd_t mqdes, char *buf)
+{
+	mqueue_desc *mqd = (mqueue_desc *)mqdes;
+
+	if (mqd == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	k_mem_slab_free(&mqd->mqueue->buffers, (void **)&buf);
+
+	return 0;
+}
+
 /* Internal functions */
 static mqueue_object *find_in_list(const char *name)
 {
@@ -371,59 +559,133 @@ static mqueue_object *find_in_list(const char *name)
 	return NULL;
 }
 
-static int32_t send_message(mqueue_desc *mqd, const char *msg_ptr, size_t msg_len,
+static char *alloc_buffer(mqueue_desc *mqd, k_timeout_t timeout)
+{
+	char *buf;
+
+	if (mqd == NULL) {
+		errno = EBADF;
+		return NULL;
+	}
+
+	if ((mqd->flags & O_NONBLOCK) != 0U) {
+		timeout = K_NO_WAIT;
+	}
+
+	if (k_mem_slab_alloc(&mqd->mqueue->buffers, (void **)&buf,
+			     timeout) != 0) {
+		errno = K_TIMEOUT_EQ(timeout, K_NO_WAIT) ? EAGAIN : ETIMEDOUT;
+		return NULL;
+	}
+
+	return buf;
+}
+
+static void queue_buffer(mqueue_object *msg_queue, char *buf, size_t len)
+{
+	struct mqueue_msg msg = {
+		.buf = buf,
+		.len = len,
+	};
+	bool was_empty = (atomic_inc(&msg_queue->n_msgs) == 0);
+
+	/* Every buffer has its entry, so this never blocks */
+	(void)k_msgq_put(&msg_queue->queue, &msg, K_NO_WAIT);
+
+	if (was_empty && atomic_get(&msg_queue->n_receivers) == 0 &&
+	    atomic_cas(&msg_queue->notify_state, NOTIFY_ARMED,
+		       NOTIFY_NONE) &&
+	    msg_queue->notify_signal != NULL) {
+		k_poll_signal_raise(msg_queue->notify_signal,
+				    msg_queue->notify_result);
+	}
+}
+
+static int dequeue_buffer(mqueue_desc *mqd, struct mqueue_msg *msg,
 			  k_timeout_t timeout)
 {
-	int32_t ret = -1;
+	mqueue_object *msg_queue;
+	int ret;
 
 	if (mqd == NULL) {
 		errno = EBADF;
-		return ret;
+		return -1;
 	}
 
+	msg_queue = mqd->mqueue;
+
 	if ((mqd->flags & O_NONBLOCK) != 0U) {
 		timeout = K_NO_WAIT;
 	}
 
-	if (msg_len >  mqd->mqueue->queue.msg_size) {
-		errno = EMSGSIZE;
-		return ret;
+	/* Blocked receivers take precedence over notifications */
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		ret = k_msgq_get(&msg_queue->queue, msg, timeout);
+	} else {
+		atomic_inc(&msg_queue->n_receivers);
+		ret = k_msgq_get(&msg_queue->queue, msg, timeout);
+		atomic_dec(&msg_queue->n_receivers);
 	}
 
-	if (k_msgq_put(&mqd->mqueue->queue, (void *)msg_ptr, timeout) != 0) {
+	if (ret != 0) {
 		errno = K_TIMEOUT_EQ(timeout, K_NO_WAIT) ? EAGAIN : ETIMEDOUT;
-		return ret;
+		return -1;
 	}
 
+	atomic_dec(&msg_queue->n_msgs);
+
+	return 0;
+}
+
+static int32_t send_message(mqueue_desc *mqd, const char *msg_ptr, size_t msg_len,
+			  k_timeout_t timeout)
+{
+	char *buf;
+
+	if (mqd == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (msg_len > mqd->mqueue->msg_size) {
+		errno = EMSGSIZE;
+		return -1;
+	}
+
+	buf = alloc_buffer(mqd, timeout);
+	if (buf == NULL) {
+		return -1;
+	}
+
+	(void)memcpy(buf, msg_ptr, msg_len);
+	queue_buffer(mqd->mqueue, buf, msg_len);
+
 	return 0;
 }
 
 static int32_t receive_message(mqueue_desc *mqd, char *msg_ptr, size_t msg_len,
 			     k_timeout_t timeout)
 {
-	int ret = -1;
+	struct mqueue_msg msg;
 
 	if (mqd == NULL) {
 		errno = EBADF;
-		return ret;
+		return -1;
 	}
 
-	if (msg_len < mqd->mqueue->queue.msg_size) {
+	if (msg_len < mqd->mqueue->msg_size) {
 		errno = EMSGSIZE;
-		return ret;
+		return -1;
 	}
 
-	if ((mqd->flags & O_NONBLOCK) != 0U) {
-		timeout = K_NO_WAIT;
+	if (dequeue_buffer(mqd, &msg, timeout) != 0) {
+		return -1;
 	}
 
-	if (k_msgq_get(&mqd->mqueue->queue, (void *)msg_ptr, timeout) != 0) {
-		errno = K_TIMEOUT_EQ(timeout, K_NO_WAIT) ? EAGAIN : ETIMEDOUT;
-	} else {
-		ret = mqd->mqueue->queue.msg_size;
-	}
+	(void)memcpy(msg_ptr, msg.buf, msg.len);
+	k_mem_slab_free(&mqd->mqueue->buffers, (void **)&msg.buf);
 
-	return ret;
+	return msg.len;
 }
 
 static void remove_mq(mqueue_object *msg_queue)
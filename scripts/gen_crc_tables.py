@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Generate the lookup tables of the table driven CRC implementations.
+
+Table k of a CRC holds, for each byte value, the CRC of that byte followed
+by k zero bytes. Table 0 is used by the byte-at-a-time implementations,
+tables 0 to N - 1 by the slicing-by-N ones.
+
+    ./scripts/gen_crc_tables.py crc32 > lib/os/crc32_table.h
+    ./scripts/gen_crc_tables.py crc16 > lib/os/crc16_table.h
+"""
+
+import argparse
+
+HEADER = """/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Generated by scripts/gen_crc_tables.py, do not edit. */
+"""
+
+
+def reflected_table(poly, width, slices):
+    mask = (1 << width) - 1
+    t0 = []
+    for i in range(256):
+        c = i
+        for _ in range(8):
+            c = (c >> 1) ^ (poly if c & 1 else 0)
+        t0.append(c)
+
+    tables = [t0]
+    for _ in range(1, slices):
+        prev = tables[-1]
+        tables.append([((c >> 8) ^ t0[c & 0xff]) & mask for c in prev])
+
+    return tables
+
+
+def normal_table(poly, width, slices):
+    mask = (1 << width) - 1
+    top = 1 << (width - 1)
+    t0 = []
+    for i in range(256):
+        c = i << (width - 8)
+        for _ in range(8):
+            c = ((c << 1) ^ (poly if c & top else 0)) & mask
+        t0.append(c)
+
+    tables = [t0]
+    for _ in range(1, slices):
+        prev = tables[-1]
+        tables.append([((c << 8) ^ t0[c >> (width - 8)]) & mask
+                       for c in prev])
+
+    return tables
+
+
+def emit_table(name, ctype, width, slices_macro, tables):
+    digits = width // 4
+    per_line = 4 if width == 32 else 8
+
+    print(f"static const {ctype} {name}[{slices_macro}][256] = {{")
+    for k, table in enumerate(tables):
+        if k == 1:
+            print(f"#if {slices_macro} >= 4")
+        elif k == 4:
+            print(f"#if {slices_macro} >= 8")
+        print("\t{")
+        for i in range(0, 256, per_line):
+            row = ", ".join(f"0x{v:0{digits}x}"
+                            for v in table[i:i + per_line])
+            print(f"\t\t{row},")
+        print("\t},")
+        if k in (3, 7):
+            print("#endif")
+    print("};")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("crc", choices=["crc32", "crc16"])
+    args = parser.parse_args()
+
+    guard = f"ZEPHYR_LIB_OS_{args.crc.upper()}_TABLE_H_"
+
+    print(HEADER)
+    print(f"#ifndef {guard}")
+    print(f"#define {guard}")
+    print()
+    if args.crc == "crc32":
+        print("/* Reflected polynomial 0xedb88320 (CRC-32/IEEE 802.3) */")
+        emit_table("crc32_ieee_table", "uint32_t", 32, "CRC32_SLICES",
+                   reflected_table(0xedb88320, 32, 8))
+    else:
+        print("/* Reflected polynomial 0x8408 (CRC-16/CCITT) */")
+        emit_table("crc16_ccitt_table", "uint16_t", 16, "CRC16_SLICES",
+                   reflected_table(0x8408, 16, 4))
+        print()
+        print("/* Polynomial 0x1021 (CRC-16/XMODEM) */")
+        emit_table("crc16_itu_t_table", "uint16_t", 16, "CRC16_SLICES",
+                   normal_table(0x1021, 16, 4))
+    print()
+    print(f"#endif /* {guard} */")
+
+
+if __name__ == "__main__":
+    main()
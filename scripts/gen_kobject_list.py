@@ -106,7 +106,9 @@ kobjects = OrderedDict([
     ("net_if", (None, False, False)),
     ("sys_mutex", (None, True, False)),
     ("k_futex", (None, True, False)),
-    ("k_condvar", (None, False, True))
+    ("k_condvar", (None, False, True)),
+    ("k_event", (None, False, True)),
+    ("k_rwlock", (None, False, True))
 ])
 
 def kobject_to_enum(kobj):
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Compare two runs of the tests/benchmarks/kernel_perf benchmark.
+
+Each input is either a console log of the benchmark (e.g. twister's
+handler.log, or the output of 'west build -t run') or the JSON document
+extracted from it. Results are matched by primitive, variant and operation,
+and the relative change of the average time per operation is reported.
+
+The exit status is 1 when any result regressed by more than the threshold,
+which allows gating kernel upgrades on performance, e.g.:
+
+    twister -T tests/benchmarks/kernel_perf -p qemu_x86 -p native_posix
+    ./scripts/kernel_perf_compare.py --threshold 10 \\
+        baseline/qemu_x86/handler.log \\
+        twister-out/qemu_x86/tests/benchmarks/kernel_perf/benchmark.kernel.perf/handler.log
+"""
+
+import argparse
+import json
+import sys
+
+BEGIN_MARKER = "KERNEL_PERF_JSON_BEGIN"
+END_MARKER = "KERNEL_PERF_JSON_END"
+
+
+def load_run(path):
+    with open(path, encoding="utf-8", errors="replace") as f:
+        text = f.read()
+
+    if BEGIN_MARKER in text:
+        start = text.rindex(BEGIN_MARKER) + len(BEGIN_MARKER)
+        end = text.find(END_MARKER, start)
+        if end < 0:
+            sys.exit(f"{path}: truncated benchmark output")
+        text = text[start:end]
+
+    try:
+        run = json.loads(text)
+    except json.JSONDecodeError as e:
+        sys.exit(f"{path}: invalid benchmark output: {e}")
+
+    results = {}
+    for r in run["results"]:
+        results[(r["primitive"], r["variant"], r["op"])] = r
+    run["results"] = results
+
+    return run
+
+
+def compare(base, new, metric, threshold):
+    rows = []
+    regressions = 0
+
+    for key in sorted(set(base["results"]) | set(new["results"])):
+        b = base["results"].get(key)
+        n = new["results"].get(key)
+        name = "/".join(key)
+
+        if b is None or n is None:
+            rows.append((name, b[metric] if b else "-",
+                         n[metric] if n else "-", "missing", ""))
+            continue
+
+        if b[metric] == 0:
+            delta = 0.0
+        else:
+            delta = 100.0 * (n[metric] - b[metric]) / b[metric]
+
+        flag = ""
+        if delta > threshold:
+            flag = "REGRESSION"
+            regressions += 1
+        elif delta < -threshold:
+            flag = "improvement"
+
+        rows.append((name, b[metric], n[metric], f"{delta:+.1f}%", flag))
+
+    return rows, regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="baseline run")
+    parser.add_argument("current", help="run to compare to the baseline")
+    parser.add_argument("-t", "--threshold", type=float, default=10.0,
+                        help="regression threshold in percent "
+                             "(default: %(default)s)")
+    parser.add_argument("-m", "--metric", choices=["ns", "cycles"],
+                        default="ns",
+                        help="compared value per operation "
+                             "(default: %(default)s)")
+    parser.add_argument("-r", "--regressions-only", action="store_true",
+                        help="only list regressed results")
+    args = parser.parse_args()
+
+    base = load_run(args.baseline)
+    new = load_run(args.current)
+
+    for field in ("board", "cpus"):
+        if base.get(field) != new.get(field):
+            print(f"warning: {field} differs: {base.get(field)} vs "
+                  f"{new.get(field)}", file=sys.stderr)
+
+    print(f"baseline: {base.get('board')} {base.get('kernel')}")
+    print(f"current:  {new.get('board')} {new.get('kernel')}")
+    print()
+
+    rows, regressions = compare(base, new, args.metric, args.threshold)
+
+    header = ("result", f"base {args.metric}", f"new {args.metric}",
+              "delta", "")
+    width = max([len(header[0])] + [len(r[0]) for r in rows])
+    fmt = f"{{:<{width}}}  {{:>12}}  {{:>12}}  {{:>8}}  {{}}"
+
+    print(fmt.format(*header))
+    for row in rows:
+        if args.regressions_only and row[4] != "REGRESSION":
+            continue
+        print(fmt.format(*row))
+
+    print()
+    print(f"{regressions} regression(s) above {args.threshold}%")
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -4,6 +4,10 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <string.h>
+#include <zephyr/types.h>
+#include <bluetooth/crypto.h>
+
 #define BT_DBG_ENABLED IS_ENABLED(CONFIG_BT_DEBUG_HCI_DRIVER)
 #define LOG_MODULE_NAME bt_ctlr_crypto
 #include "common/log.h"
@@ -43,3 +47,21 @@ int bt_encrypt_be(const uint8_t key[16], const uint8_t plaintext[16],
 
 	return 0;
 }
+
+int bt_aes_setup_be(struct bt_aes_ctx *ctx, const uint8_t key[16])
+{
+	/* The hardware expands the key for each block */
+	memcpy(ctx->rk, key, 16);
+
+	return 0;
+}
+
+int bt_aes_encrypt_be(const struct bt_aes_ctx *ctx, const uint8_t *in,
+		      uint8_t *out, size_t count)
+{
+	for (; count; count--, in += 16, out += 16) {
+		ecb_encrypt_be((const uint8_t *)ctx->rk, in, out);
+	}
+
+	return 0;
+}
@@ -35,154 +35,152 @@ static inline void xor16(uint8_t *dst, const uint8_t *a, const uint8_t *b)
 	dst[15] = a[15] ^ b[15];
 }
 
-/* pmsg is assumed to have the nonce already present in bytes 1-13 */
-static int ccm_calculate_X0(const uint8_t key[16], const uint8_t *aad, uint8_t aad_len,
-			    size_t mic_size, uint8_t msg_len, uint8_t b[16],
-			    uint8_t X0[16])
-{
-	int i, j, err;
-
-	/* X_0 = e(AppKey, flags || nonce || length) */
-	b[0] = (((mic_size - 2) / 2) << 3) | ((!!aad_len) << 6) | 0x01;
-
-	sys_put_be16(msg_len, b + 14);
-
-	err = bt_encrypt_be(key, b, X0);
-	if (err) {
-		return err;
-	}
-
-	/* If AAD is being used to authenticate, include it here */
-	if (aad_len) {
-		sys_put_be16(aad_len, b);
+/* Counter blocks encrypted at a time */
+#define CTR_BATCH 4
 
-		for (i = 0; i < sizeof(uint16_t); i++) {
-			b[i] = X0[i] ^ b[i];
-		}
+/* CBC-MAC state: the current X_i, to which the next block is being added */
+struct ccm_mac {
+	uint8_t X[16];
+	uint8_t pos;
+};
 
-		j = 0;
-		aad_len += sizeof(uint16_t);
-		while (aad_len > 16) {
-			do {
-				b[i] = X0[i] ^ aad[j];
-				i++, j++;
-			} while (i < 16);
+static int ccm_mac_update(const struct bt_aes_ctx *ctx, struct ccm_mac *mac,
+			  const uint8_t *data, size_t len)
+{
+	int err;
 
-			aad_len -= 16;
-			i = 0;
+	while (len) {
+		if (!mac->pos && len >= 16) {
+			xor16(mac->X, mac->X, data);
+			data += 16;
+			len -= 16;
+		} else {
+			mac->X[mac->pos++] ^= *data++;
+			len--;
 
-			err = bt_encrypt_be(key, b, X0);
-			if (err) {
-				return err;
+			if (mac->pos < 16) {
+				continue;
 			}
 		}
 
-		for (; i < aad_len; i++, j++) {
-			b[i] = X0[i] ^ aad[j];
-		}
-
-		for (i = aad_len; i < 16; i++) {
-			b[i] = X0[i];
-		}
-
-		err = bt_encrypt_be(key, b, X0);
+		/* X_i+1 = e(key, X_i ^ B_i) */
+		err = bt_aes_encrypt_be(ctx, mac->X, mac->X, 1);
 		if (err) {
 			return err;
 		}
+
+		mac->pos = 0U;
 	}
 
 	return 0;
 }
 
-static int ccm_auth(const uint8_t key[16], uint8_t nonce[13],
-		    const uint8_t *cleartext_msg, size_t msg_len, const uint8_t *aad,
-		    size_t aad_len, uint8_t *mic, size_t mic_size)
+/* Complete the current block with zeros */
+static int ccm_mac_pad(const struct bt_aes_ctx *ctx, struct ccm_mac *mac)
 {
-	uint8_t b[16], Xn[16], s0[16];
-	uint16_t blk_cnt, last_blk;
-	int err, j, i;
-
-	last_blk = msg_len % 16;
-	blk_cnt = (msg_len + 15) / 16;
-	if (!last_blk) {
-		last_blk = 16U;
+	if (!mac->pos) {
+		return 0;
 	}
 
-	b[0] = 0x01;
-	memcpy(b + 1, nonce, 13);
+	mac->pos = 0U;
+
+	return bt_aes_encrypt_be(ctx, mac->X, mac->X, 1);
+}
 
-	/* S[0] = e(AppKey, 0x01 || nonce || 0x0000) */
-	sys_put_be16(0x0000, &b[14]);
+/* Unencrypted MIC, T = first mic_size bytes of X_n */
+static int ccm_auth(const struct bt_aes_ctx *ctx, const uint8_t nonce[13],
+		    const uint8_t *cleartext_msg, size_t msg_len,
+		    const uint8_t *aad, size_t aad_len, size_t mic_size,
+		    uint8_t T[16])
+{
+	struct ccm_mac mac = { .pos = 0U };
+	uint8_t b[16];
+	int err;
+
+	/* X_1 = e(key, flags || nonce || length) */
+	b[0] = (((mic_size - 2) / 2) << 3) | ((!!aad_len) << 6) | 0x01;
+	memcpy(&b[1], nonce, 13);
+	sys_put_be16(msg_len, &b[14]);
 
-	err = bt_encrypt_be(key, b, s0);
+	err = bt_aes_encrypt_be(ctx, b, mac.X, 1);
 	if (err) {
 		return err;
 	}
 
-	ccm_calculate_X0(key, aad, aad_len, mic_size, msg_len, b, Xn);
+	/* If AAD is being used to authenticate, include it here, after its
+	 * length
+	 */
+	if (aad_len) {
+		sys_put_be16(aad_len, b);
 
-	for (j = 0; j < blk_cnt; j++) {
-		/* X_1 = e(AppKey, X_0 ^ Payload[0-15]) */
-		if (j + 1 == blk_cnt) {
-			for (i = 0; i < last_blk; i++) {
-				b[i] = Xn[i] ^ cleartext_msg[(j * 16) + i];
-			}
+		err = ccm_mac_update(ctx, &mac, b, sizeof(uint16_t));
+		if (!err) {
+			err = ccm_mac_update(ctx, &mac, aad, aad_len);
+		}
 
-			memcpy(&b[i], &Xn[i], 16 - i);
-		} else {
-			xor16(b, Xn, &cleartext_msg[j * 16]);
+		if (!err) {
+			err = ccm_mac_pad(ctx, &mac);
 		}
 
-		err = bt_encrypt_be(key, b, Xn);
 		if (err) {
 			return err;
 		}
 	}
 
-	/* MIC = C_mic ^ X_1 */
-	for (i = 0; i < mic_size; i++) {
-		mic[i] = s0[i] ^ Xn[i];
+	err = ccm_mac_update(ctx, &mac, cleartext_msg, msg_len);
+	if (!err) {
+		err = ccm_mac_pad(ctx, &mac);
 	}
 
-	return 0;
+	memcpy(T, mac.X, 16);
+
+	return err;
 }
 
-static int ccm_crypt(const uint8_t key[16], const uint8_t nonce[13],
-		     const uint8_t *in_msg, uint8_t *out_msg, size_t msg_len)
+/* Encrypt or decrypt with the key stream S_1 ... S_n, and return S_0, which
+ * encrypts the MIC. The counter blocks are encrypted CTR_BATCH at a time.
+ */
+static int ccm_crypt(const struct bt_aes_ctx *ctx, const uint8_t nonce[13],
+		     const uint8_t *in_msg, uint8_t *out_msg, size_t msg_len,
+		     uint8_t s0[16])
 {
-	uint8_t a_i[16], s_i[16];
-	uint16_t last_blk, blk_cnt;
-	size_t i, j;
+	uint8_t s[CTR_BATCH][16];
+	size_t blk_cnt = 1 + (msg_len + 15) / 16;
+	size_t i, j, n;
 	int err;
 
-	last_blk = msg_len % 16;
-	blk_cnt = (msg_len + 15) / 16;
-	if (!last_blk) {
-		last_blk = 16U;
-	}
-
-	a_i[0] = 0x01;
-	memcpy(&a_i[1], nonce, 13);
+	for (j = 0; j < blk_cnt; j += n) {
+		n = MIN(CTR_BATCH, blk_cnt - j);
 
-	for (j = 0; j < blk_cnt; j++) {
-		/* S_1 = e(AppKey, 0x01 || nonce || 0x0001) */
-		sys_put_be16(j + 1, &a_i[14]);
+		/* A_i = 0x01 || nonce || i */
+		for (i = 0; i < n; i++) {
+			s[i][0] = 0x01;
+			memcpy(&s[i][1], nonce, 13);
+			sys_put_be16(j + i, &s[i][14]);
+		}
 
-		err = bt_encrypt_be(key, a_i, s_i);
+		err = bt_aes_encrypt_be(ctx, s[0], s[0], n);
 		if (err) {
 			return err;
 		}
 
-		/* Encrypted = Payload[0-15] ^ C_1 */
-		if (j < blk_cnt - 1) {
-			xor16(&out_msg[j * 16], s_i, &in_msg[j * 16]);
-		} else {
-			for (i = 0; i < last_blk; i++) {
-				out_msg[(j * 16) + i] =
-					in_msg[(j * 16) + i] ^ s_i[i];
+		for (i = 0; i < n; i++) {
+			size_t off = (j + i - 1) * 16;
+
+			if (j + i == 0) {
+				memcpy(s0, s[i], 16);
+			} else if (msg_len - off >= 16) {
+				/* Encrypted = Payload[0-15] ^ S_i */
+				xor16(&out_msg[off], s[i], &in_msg[off]);
+			} else {
+				for (; off < msg_len; off++) {
+					out_msg[off] = in_msg[off] ^
+						       s[i][off % 16];
+				}
 			}
 		}
 	}
+
 	return 0;
 }
 
@@ -190,15 +188,36 @@ int bt_ccm_decrypt(const uint8_t key[16], uint8_t nonce[13], const uint8_t *enc_
 		   size_t msg_len, const uint8_t *aad, size_t aad_len,
 		   uint8_t *out_msg, size_t mic_size)
 {
+	struct bt_aes_ctx ctx;
 	uint8_t mic[16];
+	uint8_t s0[16];
+	size_t i;
+	int err;
 
 	if (aad_len >= 0xff00 || mic_size > sizeof(mic)) {
 		return -EINVAL;
 	}
 
-	ccm_crypt(key, nonce, enc_msg, out_msg, msg_len);
+	err = bt_aes_setup_be(&ctx, key);
+	if (err) {
+		return err;
+	}
+
+	err = ccm_crypt(&ctx, nonce, enc_msg, out_msg, msg_len, s0);
+	if (err) {
+		return err;
+	}
+
+	err = ccm_auth(&ctx, nonce, out_msg, msg_len, aad, aad_len, mic_size,
+		       mic);
+	if (err) {
+		return err;
+	}
 
-	ccm_auth(key, nonce, out_msg, msg_len, aad, aad_len, mic, mic_size);
+	/* MIC = T ^ S_0 */
+	for (i = 0; i < mic_size; i++) {
+		mic[i] ^= s0[i];
+	}
 
 	if (memcmp(mic, enc_msg + msg_len, mic_size)) {
 		return -EBADMSG;
@@ -212,6 +231,11 @@ int bt_ccm_encrypt(const uint8_t key[16], uint8_t nonce[13], const uint8_t *msg,
 		   uint8_t *out_msg, size_t mic_size)
 {
 	uint8_t *mic = out_msg + msg_len;
+	struct bt_aes_ctx ctx;
+	uint8_t s0[16];
+	uint8_t T[16];
+	size_t i;
+	int err;
 
 	BT_DBG("key %s", bt_hex(key, 16));
 	BT_DBG("nonce %s", bt_hex(nonce, 13));
@@ -223,9 +247,24 @@ int bt_ccm_encrypt(const uint8_t key[16], uint8_t nonce[13], const uint8_t *msg,
 		return -EINVAL;
 	}
 
-	ccm_auth(key, nonce, out_msg, msg_len, aad, aad_len, mic, mic_size);
+	err = bt_aes_setup_be(&ctx, key);
+	if (err) {
+		return err;
+	}
 
-	ccm_crypt(key, nonce, msg, out_msg, msg_len);
+	err = ccm_auth(&ctx, nonce, msg, msg_len, aad, aad_len, mic_size, T);
+	if (err) {
+		return err;
+	}
+
+	err = ccm_crypt(&ctx, nonce, msg, out_msg, msg_len, s0);
+	if (err) {
+		return err;
+	}
+
+	for (i = 0; i < mic_size; i++) {
+		mic[i] = T[i] ^ s0[i];
+	}
 
 	return 0;
 }
@@ -310,7 +310,7 @@ struct net_buf *bt_iso_create_pdu_timeout(struct net_buf_pool *pool,
 		pool = &iso_tx_pool;
 	}
 
-	reserve += sizeof(struct bt_hci_iso_data_hdr);
+	reserve += sizeof(struct bt_hci_iso_ts_data_hdr);
 
 #if defined(CONFIG_NET_BUF_LOG)
 	return bt_conn_create_pdu_timeout_debug(pool, reserve, timeout, func,
@@ -330,7 +330,7 @@ struct net_buf *bt_iso_create_frag_timeout(size_t reserve, k_timeout_t timeout)
 {
 	struct net_buf_pool *pool = NULL;
 
-#if CONFIG_BT_L2CAP_TX_FRAG_COUNT > 0
+#if CONFIG_BT_ISO_TX_FRAG_COUNT > 0
 	pool = &iso_frag_pool;
 #endif
 
@@ -943,9 +943,90 @@ int bt_iso_chan_disconnect(struct bt_iso_chan *chan)
 	return bt_conn_disconnect(chan->conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
 }
 
+static uint8_t iso_rx_flags(uint8_t pkt_flags, uint8_t ts)
+{
+	uint8_t flags;
+
+	switch (pkt_flags) {
+	case BT_ISO_DATA_VALID:
+		flags = BT_ISO_FLAGS_VALID;
+		break;
+	case BT_ISO_DATA_INVALID:
+		flags = BT_ISO_FLAGS_ERROR;
+		break;
+	default:
+		flags = BT_ISO_FLAGS_LOST;
+		break;
+	}
+
+	if (ts) {
+		flags |= BT_ISO_FLAGS_TS;
+	}
+
+	return flags;
+}
+
+static void iso_rx_stats_update(struct bt_conn *conn,
+				const struct bt_iso_recv_info *info)
+{
+	struct bt_conn_iso *iso = &conn->iso;
+	uint32_t cyc = k_cycle_get_32();
+	struct bt_iso_chan *chan;
+	int32_t expected, delta;
+	uint16_t sn_delta;
+
+	iso->rx_sdus++;
+
+	if (info->flags & BT_ISO_FLAGS_ERROR) {
+		iso->rx_errors++;
+	} else if (info->flags & BT_ISO_FLAGS_LOST) {
+		iso->rx_lost++;
+	}
+
+	if (!iso->rx_last_valid) {
+		goto done;
+	}
+
+	sn_delta = info->sn - iso->rx_last_sn;
+	if (sn_delta > 1 && sn_delta < 0x8000) {
+		iso->rx_lost += sn_delta - 1;
+	}
+
+	/* Expected spacing from the time stamps, or from the SDU interval */
+	if (info->flags & iso->rx_last_flags & BT_ISO_FLAGS_TS) {
+		expected = info->ts - iso->rx_last_ts;
+	} else {
+		chan = SYS_SLIST_PEEK_HEAD_CONTAINER(&conn->channels, chan,
+						     node);
+		if (!chan || !chan->qos || !chan->qos->interval ||
+		    sn_delta >= 0x8000) {
+			goto done;
+		}
+
+		expected = sn_delta * chan->qos->interval;
+	}
+
+	delta = k_cyc_to_us_floor32(cyc - iso->rx_last_cyc) - expected;
+	if (delta < 0) {
+		delta = -delta;
+	}
+
+	/* J += (|D| - J) / 16, with J kept in 1/16 us (RFC 3550) */
+	iso->rx_jitter += delta - ((iso->rx_jitter + 8) >> 4);
+	iso->rx_jitter_max = MAX(iso->rx_jitter_max, delta);
+
+done:
+	iso->rx_last_valid = true;
+	iso->rx_last_sn = info->sn;
+	iso->rx_last_ts = info->ts;
+	iso->rx_last_flags = info->flags;
+	iso->rx_last_cyc = cyc;
+}
+
 void bt_iso_recv(struct bt_conn *conn, struct net_buf *buf, uint8_t flags)
 {
 	struct bt_hci_iso_data_hdr *hdr;
+	struct bt_iso_recv_info info;
 	struct bt_iso_chan *chan;
 	uint8_t pb, ts;
 	uint16_t len;
@@ -970,24 +1051,27 @@ void bt_iso_recv(struct bt_conn *conn, struct net_buf *buf, uint8_t flags)
 			struct bt_hci_iso_ts_data_hdr *ts_hdr;
 
 			ts_hdr = net_buf_pull_mem(buf, sizeof(*ts_hdr));
-			iso(buf)->ts = sys_le32_to_cpu(ts_hdr->ts);
+			conn->iso.rx_ts = sys_le32_to_cpu(ts_hdr->ts);
 
 			hdr = &ts_hdr->data;
 		} else {
 			hdr = net_buf_pull_mem(buf, sizeof(*hdr));
-			/* TODO: Generate a timestamp? */
-			iso(buf)->ts = 0x00000000;
+			conn->iso.rx_ts = 0x00000000;
 		}
 
+		conn->iso.rx_sn = sys_le16_to_cpu(hdr->sn);
+
 		len = sys_le16_to_cpu(hdr->slen);
 		flags = bt_iso_pkt_flags(len);
 		len = bt_iso_pkt_len(len);
 
+		conn->iso.rx_flags = iso_rx_flags(flags, ts);
+
 		/* TODO: Drop the packet if NOP? */
 
-		BT_DBG("%s, len %u total %u flags 0x%02x timestamp %u",
+		BT_DBG("%s, len %u total %u flags 0x%02x sn %u timestamp %u",
 		       pb == BT_ISO_START ? "Start" : "Single", buf->len, len,
-		       flags, iso(buf)->ts);
+		       flags, conn->iso.rx_sn, conn->iso.rx_ts);
 
 		if (conn->rx) {
 			BT_ERR("Unexpected ISO %s fragment",
@@ -1064,19 +1148,153 @@ void bt_iso_recv(struct bt_conn *conn, struct net_buf *buf, uint8_t flags)
 		return;
 	}
 
+	info.ts = conn->iso.rx_ts;
+	info.sn = conn->iso.rx_sn;
+	info.flags = conn->iso.rx_flags;
+
+	iso_rx_stats_update(conn, &info);
+
 	SYS_SLIST_FOR_EACH_CONTAINER(&conn->channels, chan, node) {
 		if (chan->ops->recv) {
-			chan->ops->recv(chan, conn->rx);
+			chan->ops->recv(chan, &info, conn->rx);
 		}
 	}
 
 	bt_conn_reset_rx_state(conn);
 }
 
+static void iso_hdr_push(struct bt_conn *conn, struct net_buf *buf,
+			 uint8_t pb, uint8_t ts)
+{
+	struct bt_hci_iso_hdr *hdr;
+
+	hdr = net_buf_push(buf, sizeof(*hdr));
+	hdr->handle = sys_cpu_to_le16(bt_iso_handle_pack(conn->handle, pb,
+							 ts));
+	hdr->len = sys_cpu_to_le16(buf->len - sizeof(*hdr));
+}
+
+/* Sequence numbers are given, and SDUs queued, one SDU at a time, so that
+ * the SDUs of concurrent senders get increasing sequence numbers in queue
+ * order, and their fragments don't interleave.
+ */
+static struct k_spinlock iso_tx_lock;
+
+/* Release the fragments of an SDU, but not the SDU buffer itself */
+static void iso_frags_release(sys_slist_t *frags, struct net_buf *buf)
+{
+	struct net_buf *frag;
+
+	while ((frag = (void *)sys_slist_get(frags))) {
+		/* The list node shares its storage with the fragment
+		 * pointer, which still points to the next entry.
+		 */
+		frag->frags = NULL;
+
+		if (frag != buf) {
+			net_buf_unref(frag);
+		}
+	}
+}
+
+/* Fragment and queue an SDU starting with its ISO data header. The SDU
+ * gets the next sequence number of the connection, unless it has a time
+ * stamp, in which case its sequence number is given by the application.
+ * On error, the buffer is left to the caller as it was given.
+ */
+static int iso_send(struct bt_conn *conn, struct net_buf *buf, uint8_t ts)
+{
+	uint16_t mtu = bt_dev.le.iso_mtu ? bt_dev.le.iso_mtu :
+					   bt_dev.le.acl_mtu;
+	uint8_t saved[sizeof(struct bt_hci_iso_hdr)];
+	struct bt_hci_iso_data_hdr *hdr;
+	struct net_buf *frag, *first;
+	k_spinlock_key_t key;
+	sys_slist_t frags;
+	uint16_t copied = 0U;
+	uint16_t saved_len;
+	uint16_t sn;
+	uint8_t pb;
+	int err;
+
+	/* All the fragments are allocated before the first one is queued,
+	 * so that an SDU is either queued whole or not at all. The data is
+	 * copied to the fragments, so the buffer can be restored on error.
+	 */
+	sys_slist_init(&frags);
+	pb = BT_ISO_START;
+
+	while (buf->len > mtu) {
+		uint16_t len;
+
+		frag = bt_iso_create_frag_timeout(0, K_NO_WAIT);
+		if (!frag) {
+			BT_WARN("Unable to allocate ISO fragment");
+			iso_frags_release(&frags, buf);
+			net_buf_push(buf, copied);
+			return -ENOBUFS;
+		}
+
+		len = MIN(mtu, net_buf_tailroom(frag));
+		net_buf_add_mem(frag, buf->data, len);
+		net_buf_pull(buf, len);
+		copied += len;
+
+		iso_hdr_push(conn, frag, pb, pb == BT_ISO_START ? ts : 0);
+		sys_slist_append(&frags, &frag->node);
+
+		pb = BT_ISO_CONT;
+	}
+
+	/* The header of the last packet overwrites the end of the data
+	 * already copied to the fragments, which is restored on error.
+	 */
+	saved_len = MIN(copied, sizeof(saved));
+	memcpy(saved, buf->data - saved_len, saved_len);
+
+	iso_hdr_push(conn, buf, pb == BT_ISO_START ? BT_ISO_SINGLE : BT_ISO_END,
+		     pb == BT_ISO_START ? ts : 0);
+	sys_slist_append(&frags, &buf->node);
+
+	first = SYS_SLIST_PEEK_HEAD_CONTAINER(&frags, first, node);
+	if (ts) {
+		hdr = (void *)(first->data + sizeof(struct bt_hci_iso_hdr) +
+			       offsetof(struct bt_hci_iso_ts_data_hdr, data));
+	} else {
+		hdr = (void *)(first->data + sizeof(struct bt_hci_iso_hdr));
+	}
+
+	key = k_spin_lock(&iso_tx_lock);
+
+	if (ts) {
+		sn = sys_le16_to_cpu(hdr->sn);
+	} else {
+		sn = conn->iso.tx_sn;
+		hdr->sn = sys_cpu_to_le16(sn);
+	}
+
+	err = bt_conn_send_list(conn, &frags);
+	if (!err) {
+		conn->iso.tx_sn = sn + 1;
+		conn->iso.tx_sdus++;
+	}
+
+	k_spin_unlock(&iso_tx_lock, key);
+
+	if (err) {
+		iso_frags_release(&frags, buf);
+		net_buf_pull(buf, sizeof(struct bt_hci_iso_hdr));
+		memcpy(buf->data - saved_len, saved, saved_len);
+		net_buf_push(buf, copied);
+	}
+
+	return err;
+}
+
 int bt_iso_chan_send(struct bt_iso_chan *chan, struct net_buf *buf)
 {
 	struct bt_hci_iso_data_hdr *hdr;
-	static uint16_t sn;
+	int err;
 
 	__ASSERT_NO_MSG(chan);
 	__ASSERT_NO_MSG(buf);
@@ -1088,11 +1306,73 @@ int bt_iso_chan_send(struct bt_iso_chan *chan, struct net_buf *buf)
 		return -ENOTCONN;
 	}
 
+	/* The sequence number is set when the SDU is queued */
 	hdr = net_buf_push(buf, sizeof(*hdr));
-	hdr->sn = sys_cpu_to_le16(sn++);
+	hdr->sn = 0U;
 	hdr->slen = sys_cpu_to_le16(bt_iso_pkt_len_pack(net_buf_frags_len(buf)
 							- sizeof(*hdr),
 							BT_ISO_DATA_VALID));
 
-	return bt_conn_send(chan->conn, buf);
+	err = iso_send(chan->conn, buf, 0);
+	if (err) {
+		net_buf_pull(buf, sizeof(*hdr));
+	}
+
+	return err;
+}
+
+int bt_iso_chan_send_ts(struct bt_iso_chan *chan, struct net_buf *buf,
+			uint16_t seq_num, uint32_t ts)
+{
+	struct bt_hci_iso_ts_data_hdr *hdr;
+	int err;
+
+	__ASSERT_NO_MSG(chan);
+	__ASSERT_NO_MSG(buf);
+
+	BT_DBG("chan %p len %zu sn %u ts %u", chan, net_buf_frags_len(buf),
+	       seq_num, ts);
+
+	if (!chan->conn) {
+		BT_DBG("Not connected");
+		return -ENOTCONN;
+	}
+
+	hdr = net_buf_push(buf, sizeof(*hdr));
+	hdr->ts = sys_cpu_to_le32(ts);
+	hdr->data.sn = sys_cpu_to_le16(seq_num);
+	hdr->data.slen = sys_cpu_to_le16(
+		bt_iso_pkt_len_pack(net_buf_frags_len(buf) - sizeof(*hdr),
+				    BT_ISO_DATA_VALID));
+
+	err = iso_send(chan->conn, buf, 1);
+	if (err) {
+		net_buf_pull(buf, sizeof(*hdr));
+	}
+
+	return err;
+}
+
+int bt_iso_chan_stats_get(struct bt_iso_chan *chan,
+			  struct bt_iso_chan_stats *stats)
+{
+	struct bt_conn_iso *iso;
+
+	__ASSERT_NO_MSG(chan);
+	__ASSERT_NO_MSG(stats);
+
+	if (!chan->conn) {
+		return -ENOTCONN;
+	}
+
+	iso = &chan->conn->iso;
+
+	stats->tx_sdus = iso->tx_sdus;
+	stats->rx_sdus = iso->rx_sdus;
+	stats->rx_errors = iso->rx_errors;
+	stats->rx_lost = iso->rx_lost;
+	stats->rx_jitter = iso->rx_jitter >> 4;
+	stats->rx_jitter_max = iso->rx_jitter_max;
+
+	return 0;
 }
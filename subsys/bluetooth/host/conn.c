@@ -1053,6 +1053,24 @@ int bt_conn_send_cb(struct bt_conn *conn, struct net_buf *buf,
 	return 0;
 }
 
+#if defined(CONFIG_BT_ISO)
+int bt_conn_send_list(struct bt_conn *conn, sys_slist_t *bufs)
+{
+	struct net_buf *buf;
+
+	if (conn->state != BT_CONN_CONNECTED) {
+		BT_ERR("not connected!");
+		return -ENOTCONN;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(bufs, buf, node) {
+		tx_data(buf)->tx = NULL;
+	}
+
+	return k_fifo_put_slist(&conn->tx_queue, bufs);
+}
+#endif /* CONFIG_BT_ISO */
+
 enum {
 	FRAG_START,
 	FRAG_CONT,
@@ -1086,32 +1104,9 @@ static int send_acl(struct bt_conn *conn, struct net_buf *buf, uint8_t flags)
 	return bt_send(buf);
 }
 
-static int send_iso(struct bt_conn *conn, struct net_buf *buf, uint8_t flags)
+/* ISO SDUs are fragmented, and get their HCI headers, in the ISO layer */
+static int send_iso(struct bt_conn *conn, struct net_buf *buf)
 {
-	struct bt_hci_iso_hdr *hdr;
-
-	switch (flags) {
-	case FRAG_START:
-		flags = BT_ISO_START;
-		break;
-	case FRAG_CONT:
-		flags = BT_ISO_CONT;
-		break;
-	case FRAG_SINGLE:
-		flags = BT_ISO_SINGLE;
-		break;
-	case FRAG_END:
-		flags = BT_ISO_END;
-		break;
-	default:
-		return -EINVAL;
-	}
-
-	hdr = net_buf_push(buf, sizeof(*hdr));
-	hdr->handle = sys_cpu_to_le16(bt_iso_handle_pack(conn->handle, flags,
-							 0));
-	hdr->len = sys_cpu_to_le16(buf->len - sizeof(*hdr));
-
 	bt_buf_set_type(buf, BT_BUF_ISO_OUT);
 
 	return bt_send(buf);
@@ -1155,7 +1150,7 @@ static bool send_frag(struct bt_conn *conn, struct net_buf *buf, uint8_t flags,
 	irq_unlock(key);
 
 	if (IS_ENABLED(CONFIG_BT_ISO) && conn->type == BT_CONN_TYPE_ISO) {
-		err = send_iso(conn, buf, flags);
+		err = send_iso(conn, buf);
 	} else {
 		err = send_acl(conn, buf, flags);
 	}
@@ -1195,11 +1190,6 @@ static inline uint16_t conn_mtu(struct bt_conn *conn)
 		return bt_dev.br.mtu;
 	}
 #endif /* CONFIG_BT_BREDR */
-#if defined(CONFIG_BT_ISO)
-	if (conn->type == BT_CONN_TYPE_ISO && bt_dev.le.iso_mtu) {
-		return bt_dev.le.iso_mtu;
-	}
-#endif /* CONFIG_BT_ISO */
 	return bt_dev.le.acl_mtu;
 }
 
@@ -1208,15 +1198,7 @@ static struct net_buf *create_frag(struct bt_conn *conn, struct net_buf *buf)
 	struct net_buf *frag;
 	uint16_t frag_len;
 
-	switch (conn->type) {
-#if defined(CONFIG_BT_ISO)
-	case BT_CONN_TYPE_ISO:
-		frag = bt_iso_create_frag(0);
-		break;
-#endif
-	default:
-		frag = bt_conn_create_frag(0);
-	}
+	frag = bt_conn_create_frag(0);
 
 	if (conn->state != BT_CONN_CONNECTED) {
 		net_buf_unref(frag);
@@ -1240,6 +1222,11 @@ static bool send_buf(struct bt_conn *conn, struct net_buf *buf)
 
 	BT_DBG("conn %p buf %p len %u", conn, buf, buf->len);
 
+	/* ISO packets are queued after fragmentation */
+	if (IS_ENABLED(CONFIG_BT_ISO) && conn->type == BT_CONN_TYPE_ISO) {
+		return send_frag(conn, buf, FRAG_SINGLE, false);
+	}
+
 	/* Send directly if the packet fits the ACL MTU */
 	if (buf->len <= conn_mtu(conn)) {
 		return send_frag(conn, buf, FRAG_SINGLE, false);
@@ -103,6 +103,30 @@ struct bt_conn_iso {
 	uint8_t			cig_id;
 	/* CIS ID */
 	uint8_t			cis_id;
+
+	/* Packet sequence number of the next SDU sent */
+	uint16_t		tx_sn;
+
+	/* Time stamp, sequence number and flags of the SDU being received */
+	uint32_t		rx_ts;
+	uint16_t		rx_sn;
+	uint8_t			rx_flags;
+
+	/* Last received SDU, for the loss and jitter statistics */
+	bool			rx_last_valid;
+	uint16_t		rx_last_sn;
+	uint8_t			rx_last_flags;
+	uint32_t		rx_last_ts;
+	uint32_t		rx_last_cyc;
+
+	/* Interarrival jitter, in 1/16 us */
+	uint32_t		rx_jitter;
+	uint32_t		rx_jitter_max;
+
+	uint32_t		tx_sdus;
+	uint32_t		rx_sdus;
+	uint32_t		rx_errors;
+	uint32_t		rx_lost;
 };
 
 typedef void (*bt_conn_tx_cb_t)(struct bt_conn *conn, void *user_data);
@@ -214,6 +238,11 @@ static inline int bt_conn_send(struct bt_conn *conn, struct net_buf *buf)
 	return bt_conn_send_cb(conn, buf, NULL, NULL);
 }
 
+/* Queue the buffers of a list without any other buffer in between. The
+ * list is emptied on success, and left untouched on error.
+ */
+int bt_conn_send_list(struct bt_conn *conn, sys_slist_t *bufs);
+
 /* Check if a connection object with the peer already exists */
 bool bt_conn_exists_le(uint8_t id, const bt_addr_le_t *peer);
 
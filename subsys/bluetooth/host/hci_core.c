@@ -26,6 +26,7 @@
 #include <bluetooth/l2cap.h>
 #include <bluetooth/hci.h>
 #include <bluetooth/hci_vs.h>
+#include <bluetooth/uuid.h>
 #include <drivers/bluetooth/hci_driver.h>
 
 #define BT_DBG_ENABLED IS_ENABLED(CONFIG_BT_DEBUG_HCI_CORE)
@@ -66,6 +67,10 @@
 static struct k_thread rx_thread_data;
 static K_KERNEL_STACK_DEFINE(rx_thread_stack, CONFIG_BT_RX_STACK_SIZE);
 #endif
+#if defined(CONFIG_BT_RX_ADV_THREAD)
+static struct k_thread rx_adv_thread_data;
+static K_KERNEL_STACK_DEFINE(rx_adv_thread_stack, CONFIG_BT_RX_ADV_STACK_SIZE);
+#endif
 static struct k_thread tx_thread_data;
 static K_KERNEL_STACK_DEFINE(tx_thread_stack, CONFIG_BT_HCI_TX_STACK_SIZE);
 
@@ -86,6 +91,9 @@ struct bt_dev bt_dev = {
 #if !defined(CONFIG_BT_RECV_IS_RX_THREAD)
 	.rx_queue      = Z_FIFO_INITIALIZER(bt_dev.rx_queue),
 #endif
+#if defined(CONFIG_BT_RX_ADV_THREAD)
+	.rx_adv_queue  = Z_FIFO_INITIALIZER(bt_dev.rx_adv_queue),
+#endif
 };
 
 static bt_ready_cb_t ready_cb;
@@ -2421,6 +2429,11 @@ static void le_conn_update_complete(struct net_buf *buf)
 }
 
 #if defined(CONFIG_BT_CENTRAL)
+/* Called from the advertising report thread with CONFIG_BT_RX_ADV_THREAD.
+ * The connection may then be cancelled concurrently from another thread,
+ * as with application threads calling bt_conn_disconnect(): the reference
+ * taken by the lookup keeps it valid meanwhile.
+ */
 static void check_pending_conn(const bt_addr_le_t *id_addr,
 			       const bt_addr_le_t *addr, uint8_t adv_props)
 {
@@ -4303,6 +4316,186 @@ static uint8_t get_adv_props(uint8_t evt_type)
 	}
 }
 
+/* AD structures of the advertising report being processed, parsed once and
+ * shared by the scan listeners.
+ */
+static struct {
+	bool parsed;
+	uint8_t count;
+	uint32_t types[256 / 32];
+	struct bt_data ad[CONFIG_BT_SCAN_AD_INDEX_SIZE];
+} scan_ad;
+
+static void scan_ad_parse(const uint8_t *data, uint8_t len)
+{
+	scan_ad.parsed = true;
+	scan_ad.count = 0U;
+	(void)memset(scan_ad.types, 0, sizeof(scan_ad.types));
+
+	while (len > 1 && scan_ad.count < ARRAY_SIZE(scan_ad.ad)) {
+		struct bt_data *ad;
+		uint8_t field_len;
+
+		field_len = data[0];
+		if (field_len == 0U) {
+			/* Early termination */
+			return;
+		}
+
+		if (field_len >= len) {
+			BT_WARN("Malformed data");
+			return;
+		}
+
+		ad = &scan_ad.ad[scan_ad.count++];
+		ad->type = data[1];
+		ad->data_len = field_len - 1;
+		ad->data = &data[2];
+
+		scan_ad.types[ad->type / 32] |= BIT(ad->type % 32);
+
+		data += field_len + 1;
+		len -= field_len + 1;
+	}
+}
+
+/* Get the 128-bit representation of a UUID, least significant byte first */
+static void scan_uuid_to_128(const struct bt_uuid *uuid, uint8_t *val)
+{
+	static const uint8_t base[] = {
+		BT_UUID_128_ENCODE(0x00000000, 0x0000, 0x1000, 0x8000,
+				   0x00805F9B34FB)
+	};
+
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		memcpy(val, base, sizeof(base));
+		sys_put_le16(BT_UUID_16(uuid)->val, &val[12]);
+		break;
+	case BT_UUID_TYPE_32:
+		memcpy(val, base, sizeof(base));
+		sys_put_le32(BT_UUID_32(uuid)->val, &val[12]);
+		break;
+	default:
+		memcpy(val, BT_UUID_128(uuid)->val, BT_UUID_SIZE_128);
+		break;
+	}
+}
+
+static bool scan_uuid_match(const struct bt_uuid *uuid,
+			    const struct bt_le_scan_filter *filter)
+{
+	uint8_t len = filter->uuid_prefix_len;
+	uint8_t val[BT_UUID_SIZE_128], ref[BT_UUID_SIZE_128];
+
+	if (!len || len >= BT_UUID_SIZE_128) {
+		return !bt_uuid_cmp(uuid, filter->uuid);
+	}
+
+	scan_uuid_to_128(uuid, val);
+	scan_uuid_to_128(filter->uuid, ref);
+
+	/* The prefix is made of the most significant bytes */
+	return !memcmp(&val[BT_UUID_SIZE_128 - len],
+		       &ref[BT_UUID_SIZE_128 - len], len);
+}
+
+static bool scan_ad_uuid_match(const struct bt_data *ad,
+			       const struct bt_le_scan_filter *filter)
+{
+	union {
+		struct bt_uuid uuid;
+		struct bt_uuid_16 u16;
+		struct bt_uuid_32 u32;
+		struct bt_uuid_128 u128;
+	} u;
+	uint8_t uuid_len;
+	bool list = true;
+
+	switch (ad->type) {
+	case BT_DATA_SVC_DATA16:
+		list = false;
+		__fallthrough;
+	case BT_DATA_UUID16_SOME:
+	case BT_DATA_UUID16_ALL:
+	case BT_DATA_SOLICIT16:
+		uuid_len = BT_UUID_SIZE_16;
+		break;
+	case BT_DATA_SVC_DATA32:
+		list = false;
+		__fallthrough;
+	case BT_DATA_UUID32_SOME:
+	case BT_DATA_UUID32_ALL:
+	case BT_DATA_SOLICIT32:
+		uuid_len = BT_UUID_SIZE_32;
+		break;
+	case BT_DATA_SVC_DATA128:
+		list = false;
+		__fallthrough;
+	case BT_DATA_UUID128_SOME:
+	case BT_DATA_UUID128_ALL:
+	case BT_DATA_SOLICIT128:
+		uuid_len = BT_UUID_SIZE_128;
+		break;
+	default:
+		return false;
+	}
+
+	for (uint8_t i = 0U; i + uuid_len <= ad->data_len; i += uuid_len) {
+		if (!bt_uuid_create(&u.uuid, &ad->data[i], uuid_len)) {
+			return false;
+		}
+
+		if (scan_uuid_match(&u.uuid, filter)) {
+			return true;
+		}
+
+		/* Service data starts with a single UUID */
+		if (!list) {
+			return false;
+		}
+	}
+
+	return false;
+}
+
+static bool scan_filter_match(const struct bt_le_scan_filter *filter,
+			      const bt_addr_le_t *id_addr,
+			      struct net_buf_simple *ad)
+{
+	if ((filter->options & BT_LE_SCAN_FILTER_ADDR) &&
+	    bt_addr_le_cmp(filter->addr, id_addr)) {
+		return false;
+	}
+
+	if (!(filter->options & (BT_LE_SCAN_FILTER_AD_TYPE |
+				 BT_LE_SCAN_FILTER_UUID))) {
+		return true;
+	}
+
+	if (!scan_ad.parsed) {
+		scan_ad_parse(ad->data, ad->len);
+	}
+
+	if ((filter->options & BT_LE_SCAN_FILTER_AD_TYPE) &&
+	    !(scan_ad.types[filter->ad_type / 32] &
+	      BIT(filter->ad_type % 32))) {
+		return false;
+	}
+
+	if (filter->options & BT_LE_SCAN_FILTER_UUID) {
+		for (uint8_t i = 0U; i < scan_ad.count; i++) {
+			if (scan_ad_uuid_match(&scan_ad.ad[i], filter)) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	return true;
+}
+
 static void le_adv_recv(bt_addr_le_t *addr, struct bt_le_scan_recv_info *info,
 			struct net_buf *buf, uint8_t len)
 {
@@ -4344,15 +4537,31 @@ static void le_adv_recv(bt_addr_le_t *addr, struct bt_le_scan_recv_info *info,
 		net_buf_simple_restore(&buf->b, &state);
 	}
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&scan_cbs, listener, next, node) {
-		if (listener->recv) {
-			net_buf_simple_save(&buf->b, &state);
+	scan_ad.parsed = false;
 
-			buf->len = len;
-			listener->recv(info, &buf->b);
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&scan_cbs, listener, next, node) {
+		net_buf_simple_save(&buf->b, &state);
+		buf->len = len;
 
+		if (listener->filter &&
+		    !scan_filter_match(listener->filter, &id_addr, &buf->b)) {
 			net_buf_simple_restore(&buf->b, &state);
+			continue;
+		}
+
+		if (listener->recv_ad) {
+			if (!scan_ad.parsed) {
+				scan_ad_parse(buf->data, buf->len);
+			}
+
+			listener->recv_ad(info, scan_ad.ad, scan_ad.count);
+		}
+
+		if (listener->recv) {
+			listener->recv(info, &buf->b);
 		}
+
+		net_buf_simple_restore(&buf->b, &state);
 	}
 
 #if defined(CONFIG_BT_CENTRAL)
@@ -6340,6 +6549,174 @@ void hci_event_prio(struct net_buf *buf)
 	}
 }
 
+#if !defined(CONFIG_BT_RECV_IS_RX_THREAD)
+/* Extends the bt_buf user data of the received buffers until they are
+ * processed. The ACL and ISO user data is only set once processing starts.
+ */
+struct rx_data {
+	struct bt_buf_data buf_data;
+
+	/* Class of the buffer, enum bt_hci_rx_class */
+	uint8_t class;
+
+	/* Lowest bits of the uptime (ms) when the buffer was queued */
+	uint16_t timestamp;
+};
+
+BUILD_ASSERT(sizeof(struct rx_data) <= CONFIG_NET_BUF_USER_DATA_SIZE,
+	     "Received buffers too small for struct rx_data");
+
+#define rx_data(buf) ((struct rx_data *)net_buf_user_data(buf))
+
+#if defined(CONFIG_BT_HCI_RX_STATS)
+static struct {
+	atomic_t count[BT_HCI_RX_CLASSES];
+	atomic_t dropped[BT_HCI_RX_CLASSES];
+	atomic_t delay_total[BT_HCI_RX_CLASSES];
+	atomic_t delay_max[BT_HCI_RX_CLASSES];
+} rx_stats;
+
+void bt_hci_rx_stats_get(struct bt_hci_rx_stats *stats)
+{
+	for (int i = 0; i < BT_HCI_RX_CLASSES; i++) {
+		stats->count[i] = atomic_get(&rx_stats.count[i]);
+		stats->dropped[i] = atomic_get(&rx_stats.dropped[i]);
+		stats->delay_total[i] = atomic_get(&rx_stats.delay_total[i]);
+		stats->delay_max[i] = atomic_get(&rx_stats.delay_max[i]);
+	}
+}
+#endif /* CONFIG_BT_HCI_RX_STATS */
+
+#if defined(CONFIG_BT_RX_ADV_THREAD)
+static atomic_t rx_adv_queued;
+#endif
+
+static uint8_t rx_class(struct net_buf *buf)
+{
+	struct bt_hci_evt_le_meta_event *meta;
+	struct bt_hci_evt_hdr *hdr;
+
+	switch (bt_buf_get_type(buf)) {
+	case BT_BUF_ACL_IN:
+		return BT_HCI_RX_ACL;
+	case BT_BUF_ISO_IN:
+		return BT_HCI_RX_ISO;
+	default:
+		break;
+	}
+
+	hdr = (void *)buf->data;
+	if (hdr->evt != BT_HCI_EVT_LE_META_EVENT ||
+	    buf->len < sizeof(*hdr) + sizeof(*meta)) {
+		return BT_HCI_RX_EVT;
+	}
+
+	meta = (void *)&buf->data[sizeof(*hdr)];
+
+	/* The periodic advertising sync events share the queue of the
+	 * reports, so that the reports of a sync are never processed before
+	 * the sync is established.
+	 *
+	 * Periodic advertising sync transfers are bound to a connection and
+	 * stay ordered with its other events. The receiving thread has the
+	 * higher priority and processes them before the reports of the
+	 * transferred sync.
+	 */
+	switch (meta->subevent) {
+	case BT_HCI_EVT_LE_ADVERTISING_REPORT:
+	case BT_HCI_EVT_LE_EXT_ADVERTISING_REPORT:
+	case BT_HCI_EVT_LE_PER_ADVERTISING_REPORT:
+	case BT_HCI_EVT_LE_SCAN_TIMEOUT:
+	case BT_HCI_EVT_LE_PER_ADV_SYNC_ESTABLISHED:
+	case BT_HCI_EVT_LE_PER_ADV_SYNC_LOST:
+		return BT_HCI_RX_ADV;
+	default:
+		return BT_HCI_RX_EVT;
+	}
+}
+
+#if defined(CONFIG_BT_RX_ADV_THREAD)
+static bool rx_adv_report(struct net_buf *buf)
+{
+	struct bt_hci_evt_le_meta_event *meta;
+
+	meta = (void *)&buf->data[sizeof(struct bt_hci_evt_hdr)];
+
+	return (meta->subevent == BT_HCI_EVT_LE_ADVERTISING_REPORT ||
+		meta->subevent == BT_HCI_EVT_LE_EXT_ADVERTISING_REPORT ||
+		meta->subevent == BT_HCI_EVT_LE_PER_ADVERTISING_REPORT);
+}
+#endif /* CONFIG_BT_RX_ADV_THREAD */
+
+static void rx_queue_put(struct net_buf *buf)
+{
+	if (IS_ENABLED(CONFIG_BT_RX_ADV_THREAD) ||
+	    IS_ENABLED(CONFIG_BT_HCI_RX_STATS)) {
+		rx_data(buf)->class = rx_class(buf);
+	}
+
+	if (IS_ENABLED(CONFIG_BT_HCI_RX_STATS)) {
+		rx_data(buf)->timestamp = k_uptime_get_32();
+	}
+
+#if defined(CONFIG_BT_RX_ADV_THREAD)
+	if (rx_data(buf)->class == BT_HCI_RX_ADV) {
+		if (atomic_get(&rx_adv_queued) >= CONFIG_BT_RX_ADV_QUEUE_LEN &&
+		    rx_adv_report(buf)) {
+			BT_DBG("Advertising report queue full, dropping");
+#if defined(CONFIG_BT_HCI_RX_STATS)
+			atomic_inc(&rx_stats.dropped[BT_HCI_RX_ADV]);
+#endif
+			net_buf_unref(buf);
+			return;
+		}
+
+		atomic_inc(&rx_adv_queued);
+		net_buf_put(&bt_dev.rx_adv_queue, buf);
+		return;
+	}
+#endif /* CONFIG_BT_RX_ADV_THREAD */
+
+	net_buf_put(&bt_dev.rx_queue, buf);
+}
+
+static void rx_process(struct net_buf *buf)
+{
+#if defined(CONFIG_BT_HCI_RX_STATS)
+	uint8_t class = rx_data(buf)->class;
+	uint16_t delay;
+
+	delay = (uint16_t)k_uptime_get_32() - rx_data(buf)->timestamp;
+
+	atomic_inc(&rx_stats.count[class]);
+	atomic_add(&rx_stats.delay_total[class], delay);
+	if (delay > atomic_get(&rx_stats.delay_max[class])) {
+		atomic_set(&rx_stats.delay_max[class], delay);
+	}
+#endif /* CONFIG_BT_HCI_RX_STATS */
+
+	switch (bt_buf_get_type(buf)) {
+#if defined(CONFIG_BT_CONN)
+	case BT_BUF_ACL_IN:
+		hci_acl(buf);
+		break;
+#endif /* CONFIG_BT_CONN */
+#if defined(CONFIG_BT_ISO)
+	case BT_BUF_ISO_IN:
+		hci_iso(buf);
+		break;
+#endif /* CONFIG_BT_ISO */
+	case BT_BUF_EVT:
+		hci_event(buf);
+		break;
+	default:
+		BT_ERR("Unknown buf type %u", bt_buf_get_type(buf));
+		net_buf_unref(buf);
+		break;
+	}
+}
+#endif /* !CONFIG_BT_RECV_IS_RX_THREAD */
+
 int bt_recv(struct net_buf *buf)
 {
 	bt_monitor_send(bt_monitor_opcode(buf), buf->data, buf->len);
@@ -6352,7 +6729,7 @@ int bt_recv(struct net_buf *buf)
 #if defined(CONFIG_BT_RECV_IS_RX_THREAD)
 		hci_acl(buf);
 #else
-		net_buf_put(&bt_dev.rx_queue, buf);
+		rx_queue_put(buf);
 #endif
 		return 0;
 #endif /* BT_CONN */
@@ -6369,7 +6746,7 @@ int bt_recv(struct net_buf *buf)
 		}
 
 		if (evt_flags & BT_HCI_EVT_FLAG_RECV) {
-			net_buf_put(&bt_dev.rx_queue, buf);
+			rx_queue_put(buf);
 		}
 #endif
 		return 0;
@@ -6380,7 +6757,7 @@ int bt_recv(struct net_buf *buf)
 #if defined(CONFIG_BT_RECV_IS_RX_THREAD)
 		hci_iso(buf);
 #else
-		net_buf_put(&bt_dev.rx_queue, buf);
+		rx_queue_put(buf);
 #endif
 		return 0;
 #endif /* CONFIG_BT_ISO */
@@ -6492,25 +6869,7 @@ static void hci_rx_thread(void)
 		BT_DBG("buf %p type %u len %u", buf, bt_buf_get_type(buf),
 		       buf->len);
 
-		switch (bt_buf_get_type(buf)) {
-#if defined(CONFIG_BT_CONN)
-		case BT_BUF_ACL_IN:
-			hci_acl(buf);
-			break;
-#endif /* CONFIG_BT_CONN */
-#if defined(CONFIG_BT_ISO)
-		case BT_BUF_ISO_IN:
-			hci_iso(buf);
-			break;
-#endif /* CONFIG_BT_ISO */
-		case BT_BUF_EVT:
-			hci_event(buf);
-			break;
-		default:
-			BT_ERR("Unknown buf type %u", bt_buf_get_type(buf));
-			net_buf_unref(buf);
-			break;
-		}
+		rx_process(buf);
 
 		/* Make sure we don't hog the CPU if the rx_queue never
 		 * gets empty.
@@ -6520,6 +6879,29 @@ static void hci_rx_thread(void)
 }
 #endif /* !CONFIG_BT_RECV_IS_RX_THREAD */
 
+#if defined(CONFIG_BT_RX_ADV_THREAD)
+static void hci_rx_adv_thread(void)
+{
+	struct net_buf *buf;
+
+	BT_DBG("started");
+
+	while (1) {
+		buf = net_buf_get(&bt_dev.rx_adv_queue, K_FOREVER);
+		atomic_dec(&rx_adv_queued);
+
+		BT_DBG("buf %p len %u", buf, buf->len);
+
+		rx_process(buf);
+
+		/* Let the receiving thread process its queue between the
+		 * advertising reports.
+		 */
+		k_yield();
+	}
+}
+#endif /* CONFIG_BT_RX_ADV_THREAD */
+
 int bt_enable(bt_ready_cb_t cb)
 {
 	int err;
@@ -6562,6 +6944,16 @@ int bt_enable(bt_ready_cb_t cb)
 	k_thread_name_set(&rx_thread_data, "BT RX");
 #endif
 
+#if defined(CONFIG_BT_RX_ADV_THREAD)
+	/* Advertising report thread */
+	k_thread_create(&rx_adv_thread_data, rx_adv_thread_stack,
+			K_KERNEL_STACK_SIZEOF(rx_adv_thread_stack),
+			(k_thread_entry_t)hci_rx_adv_thread, NULL, NULL, NULL,
+			K_PRIO_COOP(CONFIG_BT_RX_ADV_PRIO),
+			0, K_NO_WAIT);
+	k_thread_name_set(&rx_adv_thread_data, "BT RX ADV");
+#endif
+
 	if (IS_ENABLED(CONFIG_BT_TINYCRYPT_ECC)) {
 		bt_hci_ecc_init();
 	}
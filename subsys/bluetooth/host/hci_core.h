@@ -286,6 +286,11 @@ struct bt_dev {
 	struct k_fifo		rx_queue;
 #endif
 
+#if defined(CONFIG_BT_RX_ADV_THREAD)
+	/* Queue for incoming advertising reports */
+	struct k_fifo		rx_adv_queue;
+#endif
+
 	/* Queue for outgoing HCI commands */
 	struct k_fifo		cmd_tx_queue;
 
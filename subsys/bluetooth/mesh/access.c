@@ -9,6 +9,7 @@
 #include <zephyr.h>
 #include <errno.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/util.h>
 #include <sys/byteorder.h>
 
@@ -51,6 +52,18 @@ struct mod_pub_val {
 static const struct bt_mesh_comp *dev_comp;
 static uint16_t dev_primary_addr;
 
+/* OpCode dispatch index, sorted by OpCode and element. Only the first model
+ * of an element with a given OpCode is listed, as it's the only one the
+ * message is delivered to in that element.
+ */
+static struct op_index_entry {
+	uint32_t opcode;
+	struct bt_mesh_model *model;
+	const struct bt_mesh_model_op *op;
+} op_index[CONFIG_BT_MESH_MODEL_OP_INDEX_SIZE];
+static uint16_t op_index_count;
+static bool op_index_valid;
+
 void bt_mesh_model_foreach(void (*func)(struct bt_mesh_model *mod,
 					struct bt_mesh_elem *elem,
 					bool vnd, bool primary,
@@ -320,6 +333,73 @@ static void mod_init(struct bt_mesh_model *mod, struct bt_mesh_elem *elem,
 	}
 }
 
+static int op_index_cmp(uint32_t opcode, uint8_t elem_idx,
+			const struct op_index_entry *entry)
+{
+	if (opcode != entry->opcode) {
+		return opcode < entry->opcode ? -1 : 1;
+	}
+
+	return (int)elem_idx - (int)entry->model->elem_idx;
+}
+
+/* Index of the first entry that doesn't sort before opcode and elem_idx */
+static uint16_t op_index_lower_bound(uint32_t opcode, uint8_t elem_idx)
+{
+	uint16_t lo = 0U, hi = op_index_count;
+
+	while (lo < hi) {
+		uint16_t mid = (lo + hi) / 2U;
+
+		if (op_index_cmp(opcode, elem_idx, &op_index[mid]) > 0) {
+			lo = mid + 1U;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+static void op_index_add(struct bt_mesh_model *mod, struct bt_mesh_elem *elem,
+			 bool vnd, bool primary, void *user_data)
+{
+	const struct bt_mesh_model_op *op;
+	uint16_t i;
+
+	for (op = mod->op; op->func && op_index_valid; op++) {
+		/* Messages are only delivered to vendor models if they have
+		 * a 3-byte (vendor) OpCode, see bt_mesh_model_recv().
+		 */
+		if (vnd != (BT_MESH_MODEL_OP_LEN(op->opcode) == 3)) {
+			continue;
+		}
+
+		i = op_index_lower_bound(op->opcode, mod->elem_idx);
+
+		/* Models are added in order, so an earlier model of the
+		 * element already handles this OpCode.
+		 */
+		if (i < op_index_count &&
+		    !op_index_cmp(op->opcode, mod->elem_idx, &op_index[i])) {
+			continue;
+		}
+
+		if (op_index_count == ARRAY_SIZE(op_index)) {
+			BT_INFO("OpCode index full, searching models linearly");
+			op_index_valid = false;
+			return;
+		}
+
+		memmove(&op_index[i + 1], &op_index[i],
+			(op_index_count - i) * sizeof(op_index[0]));
+		op_index[i].opcode = op->opcode;
+		op_index[i].model = mod;
+		op_index[i].op = op;
+		op_index_count++;
+	}
+}
+
 int bt_mesh_comp_register(const struct bt_mesh_comp *comp)
 {
 	int err;
@@ -333,8 +413,17 @@ int bt_mesh_comp_register(const struct bt_mesh_comp *comp)
 
 	err = 0;
 	bt_mesh_model_foreach(mod_init, &err);
+	if (err) {
+		return err;
+	}
 
-	return err;
+	op_index_count = 0U;
+	op_index_valid = (ARRAY_SIZE(op_index) > 0);
+	bt_mesh_model_foreach(op_index_add, NULL);
+
+	BT_DBG("%u OpCodes indexed", op_index_valid ? op_index_count : 0);
+
+	return 0;
 }
 
 void bt_mesh_comp_provision(uint16_t addr)
@@ -566,6 +655,64 @@ static int get_opcode(struct net_buf_simple *buf, uint32_t *opcode)
 	CODE_UNREACHABLE;
 }
 
+static void model_recv(struct bt_mesh_net_rx *rx, struct net_buf_simple *buf,
+		       struct bt_mesh_model *model,
+		       const struct bt_mesh_model_op *op)
+{
+	struct net_buf_simple_state state;
+
+	if (!model_has_key(model, rx->ctx.app_idx)) {
+		return;
+	}
+
+	if (!model_has_dst(model, rx->ctx.recv_dst)) {
+		return;
+	}
+
+	if (buf->len < op->min_len) {
+		BT_ERR("Too short message for OpCode 0x%08x", op->opcode);
+		return;
+	}
+
+	/* The callback will likely parse the buffer, so
+	 * store the parsing state in case multiple models
+	 * receive the message.
+	 */
+	net_buf_simple_save(buf, &state);
+	op->func(model, &rx->ctx, buf);
+	net_buf_simple_restore(buf, &state);
+}
+
+static void op_index_recv(struct bt_mesh_net_rx *rx,
+			  struct net_buf_simple *buf, uint32_t opcode)
+{
+	uint16_t dst = rx->ctx.recv_dst;
+	uint16_t i;
+
+	/* Only the element with the unicast address can match */
+	if (BT_MESH_ADDR_IS_UNICAST(dst)) {
+		uint16_t elem_idx = dst - dev_comp->elem[0].addr;
+
+		if (elem_idx >= dev_comp->elem_count) {
+			return;
+		}
+
+		i = op_index_lower_bound(opcode, elem_idx);
+		if (i < op_index_count &&
+		    !op_index_cmp(opcode, elem_idx, &op_index[i])) {
+			model_recv(rx, buf, op_index[i].model, op_index[i].op);
+		}
+
+		return;
+	}
+
+	/* Group subscriptions are checked on every element with the OpCode */
+	for (i = op_index_lower_bound(opcode, 0);
+	     i < op_index_count && op_index[i].opcode == opcode; i++) {
+		model_recv(rx, buf, op_index[i].model, op_index[i].op);
+	}
+}
+
 void bt_mesh_model_recv(struct bt_mesh_net_rx *rx, struct net_buf_simple *buf)
 {
 	struct bt_mesh_model *models, *model;
@@ -585,9 +732,13 @@ void bt_mesh_model_recv(struct bt_mesh_net_rx *rx, struct net_buf_simple *buf)
 
 	BT_DBG("OpCode 0x%08x", opcode);
 
+	if (op_index_valid) {
+		op_index_recv(rx, buf, opcode);
+		return;
+	}
+
 	for (i = 0; i < dev_comp->elem_count; i++) {
 		struct bt_mesh_elem *elem = &dev_comp->elem[i];
-		struct net_buf_simple_state state;
 
 		/* SIG models cannot contain 3-byte (vendor) OpCodes, and
 		 * vendor models cannot contain SIG (1- or 2-byte) OpCodes, so
@@ -607,26 +758,7 @@ void bt_mesh_model_recv(struct bt_mesh_net_rx *rx, struct net_buf_simple *buf)
 			continue;
 		}
 
-		if (!model_has_key(model, rx->ctx.app_idx)) {
-			continue;
-		}
-
-		if (!model_has_dst(model, rx->ctx.recv_dst)) {
-			continue;
-		}
-
-		if (buf->len < op->min_len) {
-			BT_ERR("Too short message for OpCode 0x%08x", opcode);
-			continue;
-		}
-
-		/* The callback will likely parse the buffer, so
-		 * store the parsing state in case multiple models
-		 * receive the message.
-		 */
-		net_buf_simple_save(buf, &state);
-		op->func(model, &rx->ctx, buf);
-		net_buf_simple_restore(buf, &state);
+		model_recv(rx, buf, model, op);
 	}
 }
 
@@ -41,11 +41,33 @@ const uint8_t bt_mesh_adv_type[BT_MESH_ADV_TYPES] = {
 
 K_FIFO_DEFINE(bt_mesh_adv_queue);
 
+#if defined(CONFIG_BT_MESH_ADV_EXT)
+/* Relayed messages are only advertised once the local ones have been */
+K_FIFO_DEFINE(bt_mesh_adv_relay_queue);
+#endif
+
 NET_BUF_POOL_DEFINE(adv_buf_pool, CONFIG_BT_MESH_ADV_BUF_COUNT,
 		    BT_MESH_ADV_DATA_SIZE, BT_MESH_ADV_USER_DATA_SIZE, NULL);
 
 static struct bt_mesh_adv adv_pool[CONFIG_BT_MESH_ADV_BUF_COUNT];
 
+#if CONFIG_BT_MESH_RELAY_BUF_COUNT > 0
+NET_BUF_POOL_DEFINE(relay_buf_pool, CONFIG_BT_MESH_RELAY_BUF_COUNT,
+		    BT_MESH_ADV_DATA_SIZE, BT_MESH_ADV_USER_DATA_SIZE, NULL);
+
+static struct bt_mesh_adv relay_adv_pool[CONFIG_BT_MESH_RELAY_BUF_COUNT];
+
+static struct bt_mesh_adv *relay_adv_alloc(int id)
+{
+	return &relay_adv_pool[id];
+}
+#endif
+
+static struct {
+	struct bt_mesh_adv_stats stats;
+	atomic_t queued[BT_MESH_ADV_TAGS];
+} adv_stats;
+
 static struct bt_mesh_adv *adv_alloc(int id)
 {
 	return &adv_pool[id];
@@ -87,6 +109,33 @@ struct net_buf *bt_mesh_adv_create(enum bt_mesh_adv_type type, uint8_t xmit,
 					    xmit, timeout);
 }
 
+struct net_buf *bt_mesh_adv_relay_create(uint8_t xmit, k_timeout_t timeout)
+{
+	struct net_buf *buf;
+
+#if CONFIG_BT_MESH_RELAY_BUF_COUNT > 0
+	buf = bt_mesh_adv_create_from_pool(&relay_buf_pool, relay_adv_alloc,
+					   BT_MESH_ADV_DATA, xmit, timeout);
+#else
+	buf = bt_mesh_adv_create(BT_MESH_ADV_DATA, xmit, timeout);
+#endif
+
+	if (buf) {
+		BT_MESH_ADV(buf)->tag = BT_MESH_RELAY_ADV;
+	}
+
+	return buf;
+}
+
+static void queued_update(enum bt_mesh_adv_tag tag)
+{
+	atomic_val_t queued = atomic_inc(&adv_stats.queued[tag]) + 1;
+
+	if (queued > adv_stats.stats.queued_max[tag]) {
+		adv_stats.stats.queued_max[tag] = MIN(queued, UINT16_MAX);
+	}
+}
+
 void bt_mesh_adv_send(struct net_buf *buf, const struct bt_mesh_send_cb *cb,
 		      void *cb_data)
 {
@@ -97,10 +146,49 @@ void bt_mesh_adv_send(struct net_buf *buf, const struct bt_mesh_send_cb *cb,
 	BT_MESH_ADV(buf)->cb_data = cb_data;
 	BT_MESH_ADV(buf)->busy = 1U;
 
+	queued_update(BT_MESH_ADV(buf)->tag);
+
+#if defined(CONFIG_BT_MESH_ADV_EXT)
+	if (BT_MESH_ADV(buf)->tag == BT_MESH_RELAY_ADV) {
+		net_buf_put(&bt_mesh_adv_relay_queue, net_buf_ref(buf));
+		bt_mesh_adv_relay_buf_ready();
+		return;
+	}
+#endif
+
 	net_buf_put(&bt_mesh_adv_queue, net_buf_ref(buf));
 	bt_mesh_adv_buf_ready();
 }
 
+struct net_buf *bt_mesh_adv_buf_get(struct k_fifo *queue, k_timeout_t timeout)
+{
+	struct net_buf *buf;
+
+	buf = net_buf_get(queue, timeout);
+	if (buf) {
+		atomic_dec(&adv_stats.queued[BT_MESH_ADV(buf)->tag]);
+	}
+
+	return buf;
+}
+
+void bt_mesh_adv_buf_sent(enum bt_mesh_adv_tag tag, uint32_t air_time)
+{
+	adv_stats.stats.sent[tag]++;
+	adv_stats.stats.air_time[tag] += air_time;
+}
+
+void bt_mesh_adv_stats_get(struct bt_mesh_adv_stats *stats)
+{
+	int i;
+
+	*stats = adv_stats.stats;
+
+	for (i = 0; i < BT_MESH_ADV_TAGS; i++) {
+		stats->queued[i] = atomic_get(&adv_stats.queued[i]);
+	}
+}
+
 static void bt_mesh_scan_cb(const bt_addr_le_t *addr, int8_t rssi,
 			    uint8_t adv_type, struct net_buf_simple *buf)
 {
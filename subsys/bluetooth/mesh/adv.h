@@ -27,6 +27,22 @@ enum bt_mesh_adv_type {
 	BT_MESH_ADV_TYPES,
 };
 
+/* Traffic class of an advertising buffer */
+enum bt_mesh_adv_tag {
+	BT_MESH_LOCAL_ADV,
+	BT_MESH_RELAY_ADV,
+
+	BT_MESH_ADV_TAGS,
+};
+
+/* Advertising bearer counters, per traffic class */
+struct bt_mesh_adv_stats {
+	uint32_t sent[BT_MESH_ADV_TAGS];       /* Advertised PDUs */
+	uint32_t air_time[BT_MESH_ADV_TAGS];   /* Time advertising, in ms */
+	uint16_t queued[BT_MESH_ADV_TAGS];     /* PDUs waiting to be sent */
+	uint16_t queued_max[BT_MESH_ADV_TAGS]; /* Most PDUs waiting at once */
+};
+
 typedef void (*bt_mesh_adv_func_t)(struct net_buf *buf, uint16_t duration,
 				   int err, void *user_data);
 
@@ -35,13 +51,15 @@ struct bt_mesh_adv {
 	void *cb_data;
 
 	uint8_t      type:2,
-		  busy:1;
+		  busy:1,
+		  tag:1;
 	uint8_t      xmit;
 };
 
 typedef struct bt_mesh_adv *(*bt_mesh_adv_alloc_t)(int id);
 
 extern struct k_fifo bt_mesh_adv_queue;
+extern struct k_fifo bt_mesh_adv_relay_queue;
 
 /* Lookup table for Advertising data types for bt_mesh_adv_type: */
 extern const uint8_t bt_mesh_adv_type[BT_MESH_ADV_TYPES];
@@ -55,9 +73,19 @@ struct net_buf *bt_mesh_adv_create_from_pool(struct net_buf_pool *pool,
 					     enum bt_mesh_adv_type type,
 					     uint8_t xmit, k_timeout_t timeout);
 
+struct net_buf *bt_mesh_adv_relay_create(uint8_t xmit, k_timeout_t timeout);
+
 void bt_mesh_adv_send(struct net_buf *buf, const struct bt_mesh_send_cb *cb,
 		      void *cb_data);
 
+/* Take the next buffer to advertise from one of the queues */
+struct net_buf *bt_mesh_adv_buf_get(struct k_fifo *queue, k_timeout_t timeout);
+
+/* Account for an advertised buffer of the given class */
+void bt_mesh_adv_buf_sent(enum bt_mesh_adv_tag tag, uint32_t air_time);
+
+void bt_mesh_adv_stats_get(struct bt_mesh_adv_stats *stats);
+
 void bt_mesh_adv_update(void);
 
 void bt_mesh_adv_init(void);
@@ -70,6 +98,8 @@ int bt_mesh_adv_enable(void);
 
 void bt_mesh_adv_buf_ready(void);
 
+void bt_mesh_adv_relay_buf_ready(void);
+
 int bt_mesh_adv_start(const struct bt_le_adv_param *param, int32_t duration,
 		      const struct bt_data *ad, size_t ad_len,
 		      const struct bt_data *sd, size_t sd_len);
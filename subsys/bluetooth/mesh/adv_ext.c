@@ -27,14 +27,19 @@
 /* Convert from ms to 0.625ms units */
 #define ADV_INT_FAST_MS    20
 
-static struct bt_le_adv_param adv_param = {
-	.id = BT_ID_DEFAULT,
-	.interval_min = BT_MESH_ADV_SCAN_UNIT(ADV_INT_FAST_MS),
-	.interval_max = BT_MESH_ADV_SCAN_UNIT(ADV_INT_FAST_MS),
 #if defined(CONFIG_BT_MESH_DEBUG_USE_ID_ADDR)
-	.options = BT_LE_ADV_OPT_USE_IDENTITY,
+#define ADV_OPTIONS BT_LE_ADV_OPT_USE_IDENTITY
+#else
+#define ADV_OPTIONS 0
 #endif
-};
+
+#define ADV_PARAM_INIT                                                         \
+	{                                                                      \
+		.id = BT_ID_DEFAULT,                                           \
+		.interval_min = BT_MESH_ADV_SCAN_UNIT(ADV_INT_FAST_MS),        \
+		.interval_max = BT_MESH_ADV_SCAN_UNIT(ADV_INT_FAST_MS),        \
+		.options = ADV_OPTIONS,                                        \
+	}
 
 enum {
 	/** Controller is currently advertising */
@@ -52,63 +57,96 @@ enum {
 	ADV_FLAGS_NUM
 };
 
-static struct {
+struct ext_adv {
 	ATOMIC_DEFINE(flags, ADV_FLAGS_NUM);
 	struct bt_le_ext_adv *instance;
+	struct bt_le_adv_param adv_param;
 	const struct bt_mesh_send_cb *cb;
 	void *cb_data;
+	enum bt_mesh_adv_tag tag;  /* Class of the advertised buffer */
+	bool relay;                /* Only advertises relayed messages */
 	uint64_t timestamp;
 	struct k_delayed_work work;
-} adv;
+};
+
+/* The local advertising set also does the proxy advertising, and relays
+ * messages when there are no relay advertising sets, or all of them are
+ * busy. Local messages only go through this set, so that they're
+ * advertised in the order they're sent, e.g. the segments of a message and
+ * the Friend Queue.
+ */
+static struct ext_adv local_adv = {
+	.adv_param = ADV_PARAM_INIT,
+};
+
+static struct ext_adv relay_adv[CONFIG_BT_MESH_RELAY_ADV_SETS];
+
+static struct ext_adv *adv_get(struct bt_le_ext_adv *instance)
+{
+	int i;
+
+	if (local_adv.instance == instance) {
+		return &local_adv;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(relay_adv); i++) {
+		if (relay_adv[i].instance == instance) {
+			return &relay_adv[i];
+		}
+	}
+
+	return NULL;
+}
 
-static int adv_start(const struct bt_le_adv_param *param,
+static int adv_start(struct ext_adv *adv,
+		     const struct bt_le_adv_param *param,
 		     struct bt_le_ext_adv_start_param *start,
 		     const struct bt_data *ad, size_t ad_len,
 		     const struct bt_data *sd, size_t sd_len)
 {
 	int err;
 
-	if (!adv.instance) {
+	if (!adv->instance) {
 		BT_ERR("Mesh advertiser not enabled");
 		return -ENODEV;
 	}
 
-	if (atomic_test_and_set_bit(adv.flags, ADV_FLAG_ACTIVE)) {
+	if (atomic_test_and_set_bit(adv->flags, ADV_FLAG_ACTIVE)) {
 		BT_ERR("Advertiser is busy");
 		return -EBUSY;
 	}
 
-	if (atomic_test_bit(adv.flags, ADV_FLAG_UPDATE_PARAMS)) {
-		err = bt_le_ext_adv_update_param(adv.instance, param);
+	if (atomic_test_bit(adv->flags, ADV_FLAG_UPDATE_PARAMS)) {
+		err = bt_le_ext_adv_update_param(adv->instance, param);
 		if (err) {
 			BT_ERR("Failed updating adv params: %d", err);
-			atomic_clear_bit(adv.flags, ADV_FLAG_ACTIVE);
+			atomic_clear_bit(adv->flags, ADV_FLAG_ACTIVE);
 			return err;
 		}
 
-		atomic_set_bit_to(adv.flags, ADV_FLAG_UPDATE_PARAMS,
-				  param != &adv_param);
+		atomic_set_bit_to(adv->flags, ADV_FLAG_UPDATE_PARAMS,
+				  param != &adv->adv_param);
 	}
 
-	err = bt_le_ext_adv_set_data(adv.instance, ad, ad_len, sd, sd_len);
+	err = bt_le_ext_adv_set_data(adv->instance, ad, ad_len, sd, sd_len);
 	if (err) {
 		BT_ERR("Failed setting adv data: %d", err);
-		atomic_clear_bit(adv.flags, ADV_FLAG_ACTIVE);
+		atomic_clear_bit(adv->flags, ADV_FLAG_ACTIVE);
 		return err;
 	}
 
-	adv.timestamp = k_uptime_get();
+	adv->timestamp = k_uptime_get();
 
-	err = bt_le_ext_adv_start(adv.instance, start);
+	err = bt_le_ext_adv_start(adv->instance, start);
 	if (err) {
 		BT_ERR("Advertising failed: err %d", err);
-		atomic_clear_bit(adv.flags, ADV_FLAG_ACTIVE);
+		atomic_clear_bit(adv->flags, ADV_FLAG_ACTIVE);
 	}
 
 	return err;
 }
 
-static int buf_send(struct net_buf *buf)
+static int buf_send(struct ext_adv *adv, struct net_buf *buf)
 {
 	struct bt_le_ext_adv_start_param start = {
 		.num_events =
@@ -134,30 +172,48 @@ static int buf_send(struct net_buf *buf)
 	ad.data = buf->data;
 
 	/* Only update advertising parameters if they're different */
-	if (adv_param.interval_min != BT_MESH_ADV_SCAN_UNIT(adv_int)) {
-		adv_param.interval_min = BT_MESH_ADV_SCAN_UNIT(adv_int);
-		adv_param.interval_max = adv_param.interval_min;
-		atomic_set_bit(adv.flags, ADV_FLAG_UPDATE_PARAMS);
+	if (adv->adv_param.interval_min != BT_MESH_ADV_SCAN_UNIT(adv_int)) {
+		adv->adv_param.interval_min = BT_MESH_ADV_SCAN_UNIT(adv_int);
+		adv->adv_param.interval_max = adv->adv_param.interval_min;
+		atomic_set_bit(adv->flags, ADV_FLAG_UPDATE_PARAMS);
 	}
 
-	adv.cb = BT_MESH_ADV(buf)->cb;
-	adv.cb_data = BT_MESH_ADV(buf)->cb_data;
+	adv->cb = BT_MESH_ADV(buf)->cb;
+	adv->cb_data = BT_MESH_ADV(buf)->cb_data;
+	adv->tag = BT_MESH_ADV(buf)->tag;
 
-	err = adv_start(&adv_param, &start, &ad, 1, NULL, 0);
+	err = adv_start(adv, &adv->adv_param, &start, &ad, 1, NULL, 0);
 	net_buf_unref(buf);
-	bt_mesh_adv_send_start(duration, err, adv.cb, adv.cb_data);
+	bt_mesh_adv_send_start(duration, err, adv->cb, adv->cb_data);
 
 	return err;
 }
 
+static struct net_buf *adv_buf_get(struct ext_adv *adv)
+{
+	struct net_buf *buf = NULL;
+
+	/* Local messages take precedence over relayed ones */
+	if (!adv->relay) {
+		buf = bt_mesh_adv_buf_get(&bt_mesh_adv_queue, K_NO_WAIT);
+	}
+
+	if (!buf) {
+		buf = bt_mesh_adv_buf_get(&bt_mesh_adv_relay_queue, K_NO_WAIT);
+	}
+
+	return buf;
+}
+
 static void send_pending_adv(struct k_work *work)
 {
+	struct ext_adv *adv = CONTAINER_OF(work, struct ext_adv, work);
 	struct net_buf *buf;
 	int err;
 
-	atomic_clear_bit(adv.flags, ADV_FLAG_SCHEDULED);
+	atomic_clear_bit(adv->flags, ADV_FLAG_SCHEDULED);
 
-	while ((buf = net_buf_get(&bt_mesh_adv_queue, K_NO_WAIT))) {
+	while ((buf = adv_buf_get(adv))) {
 		/* busy == 0 means this was canceled */
 		if (!BT_MESH_ADV(buf)->busy) {
 			net_buf_unref(buf);
@@ -165,35 +221,35 @@ static void send_pending_adv(struct k_work *work)
 		}
 
 		BT_MESH_ADV(buf)->busy = 0U;
-		err = buf_send(buf);
+		err = buf_send(adv, buf);
 		if (!err) {
 			return; /* Wait for advertising to finish */
 		}
 	}
 
 	/* No more pending buffers */
-	if (IS_ENABLED(CONFIG_BT_MESH_PROXY)) {
+	if (IS_ENABLED(CONFIG_BT_MESH_PROXY) && !adv->relay) {
 		BT_DBG("Proxy Advertising");
 		err = bt_mesh_proxy_adv_start();
 		if (!err) {
-			atomic_set_bit(adv.flags, ADV_FLAG_PROXY);
+			atomic_set_bit(adv->flags, ADV_FLAG_PROXY);
 		}
 	}
 }
 
-static void schedule_send(void)
+static bool schedule_send(struct ext_adv *adv)
 {
-	uint64_t timestamp = adv.timestamp;
+	uint64_t timestamp = adv->timestamp;
 	int64_t delta;
 
-	if (atomic_test_and_clear_bit(adv.flags, ADV_FLAG_PROXY)) {
-		bt_le_ext_adv_stop(adv.instance);
-		atomic_clear_bit(adv.flags, ADV_FLAG_ACTIVE);
+	if (atomic_test_and_clear_bit(adv->flags, ADV_FLAG_PROXY)) {
+		bt_le_ext_adv_stop(adv->instance);
+		atomic_clear_bit(adv->flags, ADV_FLAG_ACTIVE);
 	}
 
-	if (atomic_test_bit(adv.flags, ADV_FLAG_ACTIVE) ||
-	    atomic_test_and_set_bit(adv.flags, ADV_FLAG_SCHEDULED)) {
-		return;
+	if (atomic_test_bit(adv->flags, ADV_FLAG_ACTIVE) ||
+	    atomic_test_and_set_bit(adv->flags, ADV_FLAG_SCHEDULED)) {
+		return false;
 	}
 
 	/* The controller will send the next advertisement immediately.
@@ -201,52 +257,89 @@ static void schedule_send(void)
 	 * to the previous packet than what's permitted by the specification.
 	 */
 	delta = k_uptime_delta(&timestamp);
-	k_delayed_work_submit(&adv.work, K_MSEC(ADV_INT_FAST_MS - delta));
+	k_delayed_work_submit(&adv->work, K_MSEC(ADV_INT_FAST_MS - delta));
+
+	return true;
 }
 
 void bt_mesh_adv_update(void)
 {
 	BT_DBG("");
 
-	schedule_send();
+	schedule_send(&local_adv);
 }
 
 void bt_mesh_adv_buf_ready(void)
 {
-	schedule_send();
+	schedule_send(&local_adv);
+}
+
+void bt_mesh_adv_relay_buf_ready(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(relay_adv); i++) {
+		if (relay_adv[i].instance && schedule_send(&relay_adv[i])) {
+			return;
+		}
+	}
+
+	/* All relay advertising sets are busy, or there are none. The local
+	 * advertising set still takes local messages first.
+	 */
+	schedule_send(&local_adv);
 }
 
 void bt_mesh_adv_init(void)
 {
-	k_delayed_work_init(&adv.work, send_pending_adv);
+	int i;
+
+	k_delayed_work_init(&local_adv.work, send_pending_adv);
+
+	for (i = 0; i < ARRAY_SIZE(relay_adv); i++) {
+		relay_adv[i].adv_param =
+			(struct bt_le_adv_param)ADV_PARAM_INIT;
+		relay_adv[i].relay = true;
+		k_delayed_work_init(&relay_adv[i].work, send_pending_adv);
+	}
 }
 
 static void adv_sent(struct bt_le_ext_adv *instance,
 		     struct bt_le_ext_adv_sent_info *info)
 {
+	struct ext_adv *adv = adv_get(instance);
+	int64_t duration;
+
+	if (!adv) {
+		return;
+	}
+
 	/* Calling k_uptime_delta on a timestamp moves it to the current time.
 	 * This is essential here, as schedule_send() uses the end of the event
 	 * as a reference to avoid sending the next advertisement too soon.
 	 */
-	int64_t duration = k_uptime_delta(&adv.timestamp);
+	duration = k_uptime_delta(&adv->timestamp);
 
 	BT_DBG("Advertising stopped after %u ms", (uint32_t)duration);
 
-	atomic_clear_bit(adv.flags, ADV_FLAG_ACTIVE);
+	atomic_clear_bit(adv->flags, ADV_FLAG_ACTIVE);
 
-	if (!atomic_test_and_clear_bit(adv.flags, ADV_FLAG_PROXY)) {
-		bt_mesh_adv_send_end(0, adv.cb, adv.cb_data);
+	if (!atomic_test_and_clear_bit(adv->flags, ADV_FLAG_PROXY)) {
+		bt_mesh_adv_buf_sent(adv->tag, duration);
+		bt_mesh_adv_send_end(0, adv->cb, adv->cb_data);
 	}
 
-	schedule_send();
+	schedule_send(adv);
 }
 
 static void connected(struct bt_le_ext_adv *instance,
 		      struct bt_le_ext_adv_connected_info *info)
 {
-	if (atomic_test_and_clear_bit(adv.flags, ADV_FLAG_PROXY)) {
-		atomic_clear_bit(adv.flags, ADV_FLAG_ACTIVE);
-		schedule_send();
+	struct ext_adv *adv = adv_get(instance);
+
+	if (adv && atomic_test_and_clear_bit(adv->flags, ADV_FLAG_PROXY)) {
+		atomic_clear_bit(adv->flags, ADV_FLAG_ACTIVE);
+		schedule_send(adv);
 	}
 }
 
@@ -256,13 +349,33 @@ int bt_mesh_adv_enable(void)
 		.sent = adv_sent,
 		.connected = connected,
 	};
+	int err, i;
 
-	if (adv.instance) {
+	if (local_adv.instance) {
 		/* Already initialized */
 		return 0;
 	}
 
-	return bt_le_ext_adv_create(&adv_param, &adv_cb, &adv.instance);
+	err = bt_le_ext_adv_create(&local_adv.adv_param, &adv_cb,
+				   &local_adv.instance);
+	if (err) {
+		return err;
+	}
+
+	/* Relayed messages go through the local advertising set if the
+	 * controller doesn't have enough of them.
+	 */
+	for (i = 0; i < ARRAY_SIZE(relay_adv); i++) {
+		err = bt_le_ext_adv_create(&relay_adv[i].adv_param, &adv_cb,
+					   &relay_adv[i].instance);
+		if (err) {
+			BT_WARN("Only %d relay advertising sets (err %d)", i,
+				err);
+			break;
+		}
+	}
+
+	return 0;
 }
 
 int bt_mesh_adv_start(const struct bt_le_adv_param *param, int32_t duration,
@@ -276,7 +389,7 @@ int bt_mesh_adv_start(const struct bt_le_adv_param *param, int32_t duration,
 
 	BT_DBG("Start advertising %d ms", duration);
 
-	atomic_set_bit(adv.flags, ADV_FLAG_UPDATE_PARAMS);
+	atomic_set_bit(local_adv.flags, ADV_FLAG_UPDATE_PARAMS);
 
-	return adv_start(param, &start, ad, ad_len, sd, sd_len);
+	return adv_start(&local_adv, param, &start, ad, ad_len, sd, sd_len);
 }
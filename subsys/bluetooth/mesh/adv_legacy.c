@@ -48,8 +48,10 @@ static inline void adv_send(struct net_buf *buf)
 			       ADV_INT_DEFAULT_MS);
 	const struct bt_mesh_send_cb *cb = BT_MESH_ADV(buf)->cb;
 	void *cb_data = BT_MESH_ADV(buf)->cb_data;
+	enum bt_mesh_adv_tag tag = BT_MESH_ADV(buf)->tag;
 	struct bt_le_adv_param param = {};
 	uint16_t duration, adv_int;
+	uint32_t air_time;
 	struct bt_data ad;
 	int err;
 
@@ -100,7 +102,10 @@ static inline void adv_send(struct net_buf *buf)
 		return;
 	}
 
-	BT_DBG("Advertising stopped (%u ms)", (uint32_t) k_uptime_delta(&time));
+	air_time = k_uptime_delta(&time);
+	bt_mesh_adv_buf_sent(tag, air_time);
+
+	BT_DBG("Advertising stopped (%u ms)", air_time);
 }
 
 static void adv_thread(void *p1, void *p2, void *p3)
@@ -111,7 +116,8 @@ static void adv_thread(void *p1, void *p2, void *p3)
 		struct net_buf *buf;
 
 		if (IS_ENABLED(CONFIG_BT_MESH_PROXY)) {
-			buf = net_buf_get(&bt_mesh_adv_queue, K_NO_WAIT);
+			buf = bt_mesh_adv_buf_get(&bt_mesh_adv_queue,
+						  K_NO_WAIT);
 			while (!buf) {
 
 				/* Adv timeout may be set by a call from proxy
@@ -121,12 +127,13 @@ static void adv_thread(void *p1, void *p2, void *p3)
 				bt_mesh_proxy_adv_start();
 				BT_DBG("Proxy Advertising");
 
-				buf = net_buf_get(&bt_mesh_adv_queue,
-						  SYS_TIMEOUT_MS(adv_timeout));
+				buf = bt_mesh_adv_buf_get(&bt_mesh_adv_queue,
+						SYS_TIMEOUT_MS(adv_timeout));
 				bt_le_adv_stop();
 			}
 		} else {
-			buf = net_buf_get(&bt_mesh_adv_queue, K_FOREVER);
+			buf = bt_mesh_adv_buf_get(&bt_mesh_adv_queue,
+						  K_FOREVER);
 		}
 
 		if (!buf) {
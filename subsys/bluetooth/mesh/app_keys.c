@@ -63,6 +63,36 @@ static struct app_key apps[CONFIG_BT_MESH_APP_KEY_COUNT] = {
 	}
 };
 
+/* Credentials of the application keys, indexed by AID. Credential n is
+ * apps[n / 2].keys[n % 2], and the credentials sharing an AID are chained
+ * with the most recently successful one first. The index is rebuilt on the
+ * first lookup following a change of the keys.
+ */
+#define AID_COUNT BIT(6)
+#define CRED_COUNT (2 * CONFIG_BT_MESH_APP_KEY_COUNT)
+#define CRED_NONE 0xffff
+
+static struct {
+	uint16_t head[AID_COUNT];
+	uint16_t next[CRED_COUNT];
+	bool dirty;
+} aid_index = {
+	.dirty = true,
+};
+
+#if CONFIG_BT_MESH_APP_KEY_SRC_CACHE_SIZE > 0
+/* Credential that last decrypted a message from a source address, for the
+ * IV index the message was sent with. Cleared along with the AID index.
+ */
+static struct {
+	uint32_t iv_index;
+	uint16_t src;
+	uint16_t cred;
+} src_cache[CONFIG_BT_MESH_APP_KEY_SRC_CACHE_SIZE];
+#endif
+
+static struct bt_mesh_trial_stats app_trials;
+
 static struct app_key *app_get(uint16_t app_idx)
 {
 	for (int i = 0; i < ARRAY_SIZE(apps); i++) {
@@ -175,6 +205,8 @@ static void update_app_key_settings(uint16_t app_idx, bool store)
 
 static void app_key_evt(struct app_key *app, enum bt_mesh_key_evt evt)
 {
+	aid_index.dirty = true;
+
 	Z_STRUCT_SECTION_FOREACH(bt_mesh_app_key_cb, cb) {
 		cb->evt_handler(app->app_idx, app->net_idx, evt);
 	}
@@ -380,6 +412,8 @@ int bt_mesh_app_key_set(uint16_t app_idx, uint16_t net_idx,
 		return 0;
 	}
 
+	aid_index.dirty = true;
+
 	BT_DBG("AppIdx 0x%04x AID 0x%02x", app_idx, app->keys[0].id);
 
 	memcpy(app->keys[0].val, old_key, 16);
@@ -506,13 +540,106 @@ int bt_mesh_keys_resolve(struct bt_mesh_msg_ctx *ctx,
 	return 0;
 }
 
+static void aid_index_build(void)
+{
+	for (int aid = 0; aid < AID_COUNT; aid++) {
+		aid_index.head[aid] = CRED_NONE;
+	}
+
+	/* Chain in reverse, so that the keys are first tried in order */
+	for (int n = CRED_COUNT - 1; n >= 0; n--) {
+		const struct app_key *app = &apps[n / 2];
+		uint8_t aid = app->keys[n % 2].id;
+
+		if (app->app_idx == BT_MESH_KEY_UNUSED ||
+		    (n % 2 && !app->updated)) {
+			continue;
+		}
+
+		aid_index.next[n] = aid_index.head[aid];
+		aid_index.head[aid] = n;
+	}
+
+#if CONFIG_BT_MESH_APP_KEY_SRC_CACHE_SIZE > 0
+	(void)memset(src_cache, 0, sizeof(src_cache));
+#endif
+
+	aid_index.dirty = false;
+}
+
+static uint16_t src_cache_get(const struct bt_mesh_net_rx *rx)
+{
+#if CONFIG_BT_MESH_APP_KEY_SRC_CACHE_SIZE > 0
+	uint16_t i = rx->ctx.addr % ARRAY_SIZE(src_cache);
+
+	if (src_cache[i].src == rx->ctx.addr &&
+	    src_cache[i].iv_index == BT_MESH_NET_IVI_RX(rx)) {
+		return src_cache[i].cred;
+	}
+#endif
+
+	return CRED_NONE;
+}
+
+static void src_cache_set(const struct bt_mesh_net_rx *rx, uint16_t n)
+{
+#if CONFIG_BT_MESH_APP_KEY_SRC_CACHE_SIZE > 0
+	uint16_t i = rx->ctx.addr % ARRAY_SIZE(src_cache);
+
+	src_cache[i].src = rx->ctx.addr;
+	src_cache[i].iv_index = BT_MESH_NET_IVI_RX(rx);
+	src_cache[i].cred = n;
+#endif
+}
+
+static int trial_decrypt(struct bt_mesh_net_rx *rx, const uint8_t key[16],
+			 int (*cb)(struct bt_mesh_net_rx *rx,
+				   const uint8_t key[16], void *cb_data),
+			 void *cb_data)
+{
+	int err;
+
+	app_trials.attempts++;
+
+	err = cb(rx, key, cb_data);
+	if (!err) {
+		app_trials.hits++;
+	}
+
+	return err;
+}
+
+/* Try a credential of the AID index, if it is the one the message would be
+ * encrypted with.
+ */
+static bool cred_try(uint16_t n, uint8_t aid, struct bt_mesh_net_rx *rx,
+		     int (*cb)(struct bt_mesh_net_rx *rx,
+			       const uint8_t key[16], void *cb_data),
+		     void *cb_data)
+{
+	const struct app_key *app = &apps[n / 2];
+	const struct bt_mesh_app_cred *cred = &app->keys[n % 2];
+
+	if (app->app_idx == BT_MESH_KEY_UNUSED ||
+	    app->net_idx != rx->sub->net_idx) {
+		return false;
+	}
+
+	if ((n % 2) != (rx->new_key && app->updated) || cred->id != aid) {
+		return false;
+	}
+
+	return !trial_decrypt(rx, cred->val, cb, cb_data);
+}
+
 uint16_t bt_mesh_app_key_find(bool dev_key, uint8_t aid,
 			      struct bt_mesh_net_rx *rx,
 			      int (*cb)(struct bt_mesh_net_rx *rx,
 					const uint8_t key[16], void *cb_data),
 			      void *cb_data)
 {
-	int err, i;
+	uint16_t n, prev, cached;
+	int err;
 
 	if (dev_key) {
 		/* Attempt remote dev key first, as that is only available for
@@ -524,7 +651,8 @@ uint16_t bt_mesh_app_key_find(bool dev_key, uint8_t aid,
 			struct bt_mesh_cdb_node *node;
 
 			node = bt_mesh_cdb_node_get(rx->ctx.addr);
-			if (node && !cb(rx, node->dev_key, cb_data)) {
+			if (node &&
+			    !trial_decrypt(rx, node->dev_key, cb, cb_data)) {
 				return BT_MESH_KEY_DEV_REMOTE;
 			}
 		}
@@ -533,7 +661,7 @@ uint16_t bt_mesh_app_key_find(bool dev_key, uint8_t aid,
 		 *  The Device key is only valid for unicast addresses.
 		 */
 		if (BT_MESH_ADDR_IS_UNICAST(rx->ctx.recv_dst)) {
-			err = cb(rx, bt_mesh.dev_key, cb_data);
+			err = trial_decrypt(rx, bt_mesh.dev_key, cb, cb_data);
 			if (!err) {
 				return BT_MESH_KEY_DEV_LOCAL;
 			}
@@ -542,39 +670,42 @@ uint16_t bt_mesh_app_key_find(bool dev_key, uint8_t aid,
 		return BT_MESH_KEY_UNUSED;
 	}
 
-	for (i = 0; i < ARRAY_SIZE(apps); i++) {
-		const struct app_key *app = &apps[i];
-		const struct bt_mesh_app_cred *cred;
+	if (aid_index.dirty) {
+		aid_index_build();
+	}
 
-		if (app->app_idx == BT_MESH_KEY_UNUSED) {
-			continue;
-		}
+	/* Sources tend to keep using the same key */
+	cached = src_cache_get(rx);
+	if (cached != CRED_NONE && cred_try(cached, aid, rx, cb, cb_data)) {
+		return apps[cached / 2].app_idx;
+	}
 
-		if (app->net_idx != rx->sub->net_idx) {
+	for (prev = CRED_NONE, n = aid_index.head[aid]; n != CRED_NONE;
+	     prev = n, n = aid_index.next[n]) {
+		if (n == cached || !cred_try(n, aid, rx, cb, cb_data)) {
 			continue;
 		}
 
-		if (rx->new_key && app->updated) {
-			cred = &app->keys[1];
-		} else {
-			cred = &app->keys[0];
+		/* Move the credential to the front of its chain */
+		if (prev != CRED_NONE) {
+			aid_index.next[prev] = aid_index.next[n];
+			aid_index.next[n] = aid_index.head[aid];
+			aid_index.head[aid] = n;
 		}
 
-		if (cred->id != aid) {
-			continue;
-		}
-
-		err = cb(rx, cred->val, cb_data);
-		if (err) {
-			continue;
-		}
+		src_cache_set(rx, n);
 
-		return app->app_idx;
+		return apps[n / 2].app_idx;
 	}
 
 	return BT_MESH_KEY_UNUSED;
 }
 
+void bt_mesh_app_key_stats_get(struct bt_mesh_trial_stats *stats)
+{
+	*stats = app_trials;
+}
+
 static void subnet_evt(struct bt_mesh_subnet *sub, enum bt_mesh_key_evt evt)
 {
 	if (evt == BT_MESH_KEY_UPDATED || evt == BT_MESH_KEY_ADDED) {
@@ -44,6 +44,10 @@ int bt_mesh_keys_resolve(struct bt_mesh_msg_ctx *ctx,
 			 const uint8_t *app_key[16], uint8_t *aid);
 
 /** @brief Iterate through all matching application keys and call @c cb on each.
+ *
+ *  The key that last decrypted a message from the same source is tried
+ *  first, then the application keys with a matching AID, starting with the
+ *  most recently successful one.
  *
  *  @param dev_key Whether to return device keys.
  *  @param aid     7 bit application ID to match.
@@ -59,6 +63,13 @@ uint16_t bt_mesh_app_key_find(bool dev_key, uint8_t aid,
 					const uint8_t key[16], void *cb_data),
 			      void *cb_data);
 
+/** @brief Get the trial decryption counters of the application and device
+ *         keys.
+ *
+ *  @param stats Counters return parameter.
+ */
+void bt_mesh_app_key_stats_get(struct bt_mesh_trial_stats *stats);
+
 /** @brief Store pending application keys in persistent storage. */
 void bt_mesh_app_key_pending_store(void);
 
@@ -14,12 +14,6 @@
 #include <sys/byteorder.h>
 #include <sys/util.h>
 
-#include <tinycrypt/constants.h>
-#include <tinycrypt/utils.h>
-#include <tinycrypt/aes.h>
-#include <tinycrypt/cmac_mode.h>
-#include <tinycrypt/ccm_mode.h>
-
 #include <bluetooth/mesh.h>
 #include <bluetooth/crypto.h>
 
@@ -33,28 +27,116 @@
 #define NET_MIC_LEN(pdu) (((pdu)[1] & 0x80) ? 8 : 4)
 #define APP_MIC_LEN(aszmic) ((aszmic) ? 8 : 4)
 
-int bt_mesh_aes_cmac(const uint8_t key[16], struct bt_mesh_sg *sg,
-		     size_t sg_len, uint8_t mac[16])
+/* AES-CMAC key with its subkeys K1 and K2 */
+struct cmac_key {
+	struct bt_aes_ctx aes;
+	uint8_t k1[16];
+	uint8_t k2[16];
+};
+
+/* Multiplication by x in GF(2^128) */
+static void cmac_dbl(uint8_t out[16], const uint8_t in[16])
 {
-	struct tc_aes_key_sched_struct sched;
-	struct tc_cmac_struct state;
+	uint8_t msb = in[0] >> 7;
+	int i;
 
-	if (tc_cmac_setup(&state, key, &sched) == TC_CRYPTO_FAIL) {
-		return -EIO;
+	for (i = 0; i < 15; i++) {
+		out[i] = (in[i] << 1) | (in[i + 1] >> 7);
 	}
 
+	out[15] = (in[15] << 1) ^ (msb ? 0x87 : 0x00);
+}
+
+static int cmac_setup(struct cmac_key *key, const uint8_t k[16])
+{
+	uint8_t l[16] = { 0 };
+	int err;
+
+	err = bt_aes_setup_be(&key->aes, k);
+	if (err) {
+		return err;
+	}
+
+	/* L = e(k, 0), K1 = L * x, K2 = K1 * x */
+	err = bt_aes_encrypt_be(&key->aes, l, l, 1);
+	if (err) {
+		return err;
+	}
+
+	cmac_dbl(key->k1, l);
+	cmac_dbl(key->k2, key->k1);
+
+	return 0;
+}
+
+static int cmac(const struct cmac_key *key, struct bt_mesh_sg *sg,
+		size_t sg_len, uint8_t mac[16])
+{
+	uint8_t x[16] = { 0 };
+	uint8_t blk[16];
+	size_t pos = 0;
+	int err, i;
+
+	/* Each block is added once the data is known to go on after it, as
+	 * the last one is handled differently.
+	 */
 	for (; sg_len; sg_len--, sg++) {
-		if (tc_cmac_update(&state, sg->data,
-				   sg->len) == TC_CRYPTO_FAIL) {
-			return -EIO;
+		const uint8_t *data = sg->data;
+		size_t len = sg->len;
+
+		while (len) {
+			size_t n;
+
+			if (pos == sizeof(blk)) {
+				for (i = 0; i < 16; i++) {
+					x[i] ^= blk[i];
+				}
+
+				err = bt_aes_encrypt_be(&key->aes, x, x, 1);
+				if (err) {
+					return err;
+				}
+
+				pos = 0;
+			}
+
+			n = MIN(len, sizeof(blk) - pos);
+			memcpy(&blk[pos], data, n);
+			pos += n;
+			data += n;
+			len -= n;
 		}
 	}
 
-	if (tc_cmac_final(mac, &state) == TC_CRYPTO_FAIL) {
-		return -EIO;
+	if (pos == sizeof(blk)) {
+		for (i = 0; i < 16; i++) {
+			x[i] ^= blk[i] ^ key->k1[i];
+		}
+	} else {
+		/* Padded with 10...0 */
+		blk[pos++] = 0x80;
+		(void)memset(&blk[pos], 0, sizeof(blk) - pos);
+
+		for (i = 0; i < 16; i++) {
+			x[i] ^= blk[i] ^ key->k2[i];
+		}
 	}
 
-	return 0;
+	return bt_aes_encrypt_be(&key->aes, x, mac, 1);
+}
+
+int bt_mesh_aes_cmac(const uint8_t key[16], struct bt_mesh_sg *sg,
+		     size_t sg_len, uint8_t mac[16])
+{
+	struct cmac_key cmac_key;
+	int err;
+
+	err = cmac_setup(&cmac_key, key);
+	if (err) {
+		return err;
+	}
+
+	return cmac(&cmac_key, sg, sg_len, mac);
 }
 
 int bt_mesh_k1(const uint8_t *ikm, size_t ikm_len, const uint8_t salt[16],
@@ -74,6 +156,7 @@ int bt_mesh_k2(const uint8_t n[16], const uint8_t *p, size_t p_len,
 	       uint8_t net_id[1], uint8_t enc_key[16], uint8_t priv_key[16])
 {
 	struct bt_mesh_sg sg[3];
+	struct cmac_key key;
 	uint8_t salt[16];
 	uint8_t out[16];
 	uint8_t t[16];
@@ -93,6 +176,12 @@ int bt_mesh_k2(const uint8_t n[16], const uint8_t *p, size_t p_len,
 		return err;
 	}
 
+	/* T is the key of the three following CMACs */
+	err = cmac_setup(&key, t);
+	if (err) {
+		return err;
+	}
+
 	pad = 0x01;
 
 	sg[0].data = NULL;
@@ -102,7 +191,7 @@ int bt_mesh_k2(const uint8_t n[16], const uint8_t *p, size_t p_len,
 	sg[2].data = &pad;
 	sg[2].len  = sizeof(pad);
 
-	err = bt_mesh_aes_cmac(t, sg, ARRAY_SIZE(sg), out);
+	err = cmac(&key, sg, ARRAY_SIZE(sg), out);
 	if (err) {
 		return err;
 	}
@@ -113,7 +202,7 @@ int bt_mesh_k2(const uint8_t n[16], const uint8_t *p, size_t p_len,
 	sg[0].len  = sizeof(out);
 	pad = 0x02;
 
-	err = bt_mesh_aes_cmac(t, sg, ARRAY_SIZE(sg), out);
+	err = cmac(&key, sg, ARRAY_SIZE(sg), out);
 	if (err) {
 		return err;
 	}
@@ -122,7 +211,7 @@ int bt_mesh_k2(const uint8_t n[16], const uint8_t *p, size_t p_len,
 
 	pad = 0x03;
 
-	err = bt_mesh_aes_cmac(t, sg, ARRAY_SIZE(sg), out);
+	err = cmac(&key, sg, ARRAY_SIZE(sg), out);
 	if (err) {
 		return err;
 	}
@@ -0,0 +1,117 @@
+/*  Bluetooth Mesh */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <sys/hash.h>
+
+#include "msg_cache.h"
+
+#define SLOT_FREE 0U
+
+static inline uint32_t n_slots(const struct bt_mesh_msg_cache *cache)
+{
+	return 2U * cache->size;
+}
+
+/* Slot at which the probe for a key starts */
+static inline uint32_t home(const struct bt_mesh_msg_cache *cache, uint32_t key)
+{
+	/* Maps the hash to [0, n_slots) without a division */
+	return ((uint64_t)sys_hash32_u32(key) * n_slots(cache)) >> 32;
+}
+
+static inline uint32_t next_slot(const struct bt_mesh_msg_cache *cache,
+				 uint32_t i)
+{
+	return (++i == n_slots(cache)) ? 0U : i;
+}
+
+/* Slot indexing the key, or the empty slot where it would be inserted */
+static uint32_t find(const struct bt_mesh_msg_cache *cache, uint32_t key)
+{
+	uint32_t i = home(cache, key);
+
+	while (cache->slots[i] != SLOT_FREE &&
+	       cache->keys[cache->slots[i] - 1] != key) {
+		i = next_slot(cache, i);
+	}
+
+	return i;
+}
+
+/* Empty a slot, moving back the entries of the probe sequence that follows
+ * it so that they can still be found.
+ */
+static void remove_slot(struct bt_mesh_msg_cache *cache, uint32_t i)
+{
+	uint32_t j = i;
+
+	for (;;) {
+		uint32_t k;
+
+		j = next_slot(cache, j);
+		if (cache->slots[j] == SLOT_FREE) {
+			break;
+		}
+
+		/* Entries whose home slot is cyclically in (i, j] stay */
+		k = home(cache, cache->keys[cache->slots[j] - 1]);
+		if ((i <= j) ? (i < k && k <= j) : (i < k || k <= j)) {
+			continue;
+		}
+
+		cache->slots[i] = cache->slots[j];
+		i = j;
+	}
+
+	cache->slots[i] = SLOT_FREE;
+}
+
+/* Remove the key at a position of the ring, if it still holds one */
+static void remove_pos(struct bt_mesh_msg_cache *cache, uint16_t pos)
+{
+	uint32_t i = find(cache, cache->keys[pos]);
+
+	/* A key added again later is indexed at its newest position */
+	if (cache->slots[i] == pos + 1) {
+		remove_slot(cache, i);
+	}
+}
+
+void bt_mesh_msg_cache_clear(struct bt_mesh_msg_cache *cache)
+{
+	(void)memset(cache->slots, 0, n_slots(cache) * sizeof(cache->slots[0]));
+	cache->next = 0U;
+}
+
+bool bt_mesh_msg_cache_has(const struct bt_mesh_msg_cache *cache, uint32_t key)
+{
+	return cache->slots[find(cache, key)] != SLOT_FREE;
+}
+
+uint16_t bt_mesh_msg_cache_add(struct bt_mesh_msg_cache *cache, uint32_t key)
+{
+	uint16_t pos = cache->next;
+	uint32_t i;
+
+	remove_pos(cache, pos);
+
+	cache->keys[pos] = key;
+	i = find(cache, key);
+	cache->slots[i] = pos + 1;
+
+	cache->next = (pos + 1 == cache->size) ? 0U : pos + 1;
+
+	return pos;
+}
+
+void bt_mesh_msg_cache_drop(struct bt_mesh_msg_cache *cache, uint16_t pos)
+{
+	remove_pos(cache, pos);
+	cache->next = pos;
+}
@@ -0,0 +1,51 @@
+/*  Bluetooth Mesh */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Bounded set of 32-bit keys with FIFO eviction.
+ *
+ * The keys are kept in a ring in insertion order, so that adding a key to
+ * a full cache evicts the oldest one, and are indexed by an open addressed
+ * hash table with linear probing, so that lookups take constant time
+ * whatever the size of the cache. The table has twice as many slots as the
+ * ring, each one holding the position of a key in the ring plus one, or 0
+ * if it is empty.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct bt_mesh_msg_cache {
+	uint32_t *keys;
+	uint16_t *slots;
+	uint16_t size;
+	uint16_t next;
+};
+
+/* Define an empty cache holding up to _size keys */
+#define BT_MESH_MSG_CACHE_DEFINE(_name, _size)                                 \
+	static uint32_t _name##_keys[_size];                                   \
+	static uint16_t _name##_slots[2 * (_size)];                            \
+	static struct bt_mesh_msg_cache _name = {                              \
+		.keys = _name##_keys,                                          \
+		.slots = _name##_slots,                                        \
+		.size = (_size),                                               \
+	}
+
+void bt_mesh_msg_cache_clear(struct bt_mesh_msg_cache *cache);
+
+bool bt_mesh_msg_cache_has(const struct bt_mesh_msg_cache *cache, uint32_t key);
+
+/* Add a key, evicting the oldest one if the cache is full, and return its
+ * position in the ring.
+ */
+uint16_t bt_mesh_msg_cache_add(struct bt_mesh_msg_cache *cache, uint32_t key);
+
+/* Remove the key added at the given position, and reuse the position for
+ * the next key added.
+ */
+void bt_mesh_msg_cache_drop(struct bt_mesh_msg_cache *cache, uint16_t pos);
@@ -38,6 +38,7 @@
 #include "settings.h"
 #include "prov.h"
 #include "cfg.h"
+#include "msg_cache.h"
 
 #define LOOPBACK_MAX_PDU_LEN (BT_MESH_NET_HDR_LEN + 16)
 #define LOOPBACK_USER_DATA_SIZE sizeof(struct bt_mesh_subnet *)
@@ -79,11 +80,13 @@ struct iv_val {
 	      iv_duration:7;
 } __packed;
 
-static struct {
-	uint32_t src : 15, /* MSb of source is always 0 */
-	      seq : 17;
-} msg_cache[CONFIG_BT_MESH_MSG_CACHE_SIZE];
-static uint16_t msg_cache_next;
+/* Network Message Cache, of source addresses and 17 LSbs of sequence
+ * numbers. The MSb of the source address is always 0.
+ */
+BT_MESH_MSG_CACHE_DEFINE(msg_cache, CONFIG_BT_MESH_MSG_CACHE_SIZE);
+
+#define MSG_CACHE_KEY(src, seq) (((uint32_t)(src) << 17) | \
+				 ((seq) & BIT_MASK(17)))
 
 /* Singleton network context (the implementation only supports one) */
 struct bt_mesh_net bt_mesh = {
@@ -93,49 +96,36 @@ struct bt_mesh_net bt_mesh = {
 NET_BUF_POOL_DEFINE(loopback_buf_pool, CONFIG_BT_MESH_LOOPBACK_BUFS,
 		    LOOPBACK_MAX_PDU_LEN, LOOPBACK_USER_DATA_SIZE, NULL);
 
-static uint32_t dup_cache[CONFIG_BT_MESH_MSG_CACHE_SIZE];
-static int   dup_cache_next;
+BT_MESH_MSG_CACHE_DEFINE(dup_cache, CONFIG_BT_MESH_MSG_CACHE_SIZE);
 
 static bool check_dup(struct net_buf_simple *data)
 {
 	const uint8_t *tail = net_buf_simple_tail(data);
 	uint32_t val;
-	int i;
 
 	val = sys_get_be32(tail - 4) ^ sys_get_be32(tail - 8);
 
-	for (i = 0; i < ARRAY_SIZE(dup_cache); i++) {
-		if (dup_cache[i] == val) {
-			return true;
-		}
+	if (bt_mesh_msg_cache_has(&dup_cache, val)) {
+		return true;
 	}
 
-	dup_cache[dup_cache_next++] = val;
-	dup_cache_next %= ARRAY_SIZE(dup_cache);
+	bt_mesh_msg_cache_add(&dup_cache, val);
 
 	return false;
 }
 
 static bool msg_cache_match(struct net_buf_simple *pdu)
 {
-	uint16_t i;
-
-	for (i = 0U; i < ARRAY_SIZE(msg_cache); i++) {
-		if (msg_cache[i].src == SRC(pdu->data) &&
-		    msg_cache[i].seq == (SEQ(pdu->data) & BIT_MASK(17))) {
-			return true;
-		}
-	}
+	uint32_t key = MSG_CACHE_KEY(SRC(pdu->data), SEQ(pdu->data));
 
-	return false;
+	return bt_mesh_msg_cache_has(&msg_cache, key);
 }
 
 static void msg_cache_add(struct bt_mesh_net_rx *rx)
 {
-	rx->msg_cache_idx = msg_cache_next++;
-	msg_cache[rx->msg_cache_idx].src = rx->ctx.addr;
-	msg_cache[rx->msg_cache_idx].seq = rx->seq;
-	msg_cache_next %= ARRAY_SIZE(msg_cache);
+	uint32_t key = MSG_CACHE_KEY(rx->ctx.addr, rx->seq);
+
+	rx->msg_cache_idx = bt_mesh_msg_cache_add(&msg_cache, key);
 }
 
 static void store_iv(bool only_duration)
@@ -178,8 +168,7 @@ int bt_mesh_net_create(uint16_t idx, uint8_t flags, const uint8_t key[16],
 		return err;
 	}
 
-	(void)memset(msg_cache, 0, sizeof(msg_cache));
-	msg_cache_next = 0U;
+	bt_mesh_msg_cache_clear(&msg_cache);
 
 	bt_mesh.iv_index = iv_index;
 	atomic_set_bit_to(bt_mesh.flags, BT_MESH_IVU_IN_PROGRESS,
@@ -577,10 +566,6 @@ static bool net_decrypt(struct bt_mesh_net_rx *rx, struct net_buf_simple *in,
 {
 	bool proxy = (rx->net_if == BT_MESH_NET_IF_PROXY_CFG);
 
-	if (NID(in->data) != cred->nid) {
-		return false;
-	}
-
 	BT_DBG("NID 0x%02x", NID(in->data));
 	BT_DBG("IVI %u net->iv_index 0x%08x", IVI(in->data), bt_mesh.iv_index);
 
@@ -664,7 +649,7 @@ static void bt_mesh_net_relay(struct net_buf_simple *sbuf,
 		transmit = bt_mesh_net_transmit_get();
 	}
 
-	buf = bt_mesh_adv_create(BT_MESH_ADV_DATA, transmit, K_NO_WAIT);
+	buf = bt_mesh_adv_relay_create(transmit, K_NO_WAIT);
 	if (!buf) {
 		BT_ERR("Out of relay buffers");
 		return;
@@ -827,9 +812,8 @@ void bt_mesh_net_recv(struct net_buf_simple *data, int8_t rssi,
 	 */
 	if (bt_mesh_trans_recv(&buf, &rx) == -EAGAIN) {
 		BT_WARN("Removing rejected message from Network Message Cache");
-		msg_cache[rx.msg_cache_idx].src = BT_MESH_ADDR_UNASSIGNED;
 		/* Rewind the next index now that we're not using this entry */
-		msg_cache_next = rx.msg_cache_idx;
+		bt_mesh_msg_cache_drop(&msg_cache, rx.msg_cache_idx);
 	}
 
 	/* Relay if this was a group/virtual address, or if the destination
@@ -15,6 +15,7 @@
 #include <sys/atomic.h>
 #include <sys/util.h>
 #include <sys/byteorder.h>
+#include <sys/hash.h>
 
 #include <net/buf.h>
 #include <bluetooth/bluetooth.h>
@@ -37,13 +38,111 @@ struct rpl_val {
 	      old_iv:1;
 };
 
+/* Entry of a storage record, which holds RPL_BLOCK_SIZE consecutive entries
+ * of the list, without the empty ones that end it.
+ */
+struct rpl_rec {
+	uint16_t src;
+	struct rpl_val val;
+} __packed;
+
+#if defined(CONFIG_BT_SETTINGS)
+#define RPL_BLOCK_SIZE CONFIG_BT_MESH_RPL_STORE_BLOCK_SIZE
+#define RPL_STORE_BUDGET CONFIG_BT_MESH_RPL_STORE_BUDGET
+#else
+#define RPL_BLOCK_SIZE CONFIG_BT_MESH_CRPL
+#define RPL_STORE_BUDGET 0
+#endif
+
+#define RPL_BLOCKS ceiling_fraction(CONFIG_BT_MESH_CRPL, RPL_BLOCK_SIZE)
+#define RPL_SLOTS (2 * CONFIG_BT_MESH_CRPL)
+#define RPL_NONE 0xffff
+#define SLOT_FREE 0U
+
 static struct bt_mesh_rpl replay_list[CONFIG_BT_MESH_CRPL];
 
+/* Index of the entries in use by source address: an open addressing hash
+ * table holding the entry index + 1 in each slot. The free entries are
+ * chained through their seq field. Entries keep the position they have in
+ * storage, and the index is rebuilt when entries are loaded or cleared.
+ */
+static struct {
+	uint16_t slots[RPL_SLOTS];
+	uint16_t free;
+	bool dirty;
+} rpl_index = {
+	.dirty = true,
+};
+
+/* Storage records with unsaved changes and records present in storage */
+static ATOMIC_DEFINE(rpl_dirty, RPL_BLOCKS);
+static ATOMIC_DEFINE(rpl_stored, RPL_BLOCKS);
+/* Record from which the next storage round starts */
+static uint16_t rpl_store_next;
+/* Lowest entry known to be in use while loading from storage */
+static uint16_t rpl_load_top = CONFIG_BT_MESH_CRPL;
+
+/* Records being loaded and stored, too large for the stack of the threads
+ * doing it. Loading is serialized by the settings subsystem, and storing
+ * by the settings work.
+ */
+static struct rpl_rec rpl_load_recs[RPL_BLOCK_SIZE];
+static struct rpl_rec rpl_store_recs[RPL_BLOCK_SIZE];
+
+static inline uint32_t rpl_home(uint16_t src)
+{
+	return ((uint64_t)sys_hash32_u32(src) * RPL_SLOTS) >> 32;
+}
+
+static inline uint32_t rpl_next_slot(uint32_t i)
+{
+	return (++i == RPL_SLOTS) ? 0U : i;
+}
+
+/* Slot indexing the address, or the empty slot where it would be inserted */
+static uint32_t rpl_slot_find(uint16_t src)
+{
+	uint32_t i = rpl_home(src);
+
+	while (rpl_index.slots[i] != SLOT_FREE &&
+	       replay_list[rpl_index.slots[i] - 1].src != src) {
+		i = rpl_next_slot(i);
+	}
+
+	return i;
+}
+
+/* Empty a slot, moving back the entries of the probe sequence that follows
+ * it so that they can still be found.
+ */
+static void rpl_slot_remove(uint32_t i)
+{
+	uint32_t j = i;
+
+	for (;;) {
+		uint32_t k;
+
+		j = rpl_next_slot(j);
+		if (rpl_index.slots[j] == SLOT_FREE) {
+			break;
+		}
+
+		/* Entries whose home slot is cyclically in (i, j] stay */
+		k = rpl_home(replay_list[rpl_index.slots[j] - 1].src);
+		if ((i <= j) ? (i < k && k <= j) : (i < k || k <= j)) {
+			continue;
+		}
+
+		rpl_index.slots[i] = rpl_index.slots[j];
+		i = j;
+	}
+
+	rpl_index.slots[i] = SLOT_FREE;
+}
+
 static void schedule_rpl_store(struct bt_mesh_rpl *entry)
 {
-#ifdef CONFIG_BT_SETTINGS
-	entry->store = true;
-#endif
+	atomic_set_bit(rpl_dirty, (entry - replay_list) / RPL_BLOCK_SIZE);
 	bt_mesh_settings_store_schedule(BT_MESH_SETTINGS_RPL_PENDING);
 }
 
@@ -52,10 +151,99 @@ static void schedule_rpl_clear(void)
 	bt_mesh_settings_store_schedule(BT_MESH_SETTINGS_RPL_PENDING);
 }
 
+static void rpl_free(struct bt_mesh_rpl *rpl)
+{
+	(void)memset(rpl, 0, sizeof(*rpl));
+	rpl->seq = rpl_index.free;
+	rpl_index.free = rpl - replay_list;
+}
+
+/* Keep the most recent of two entries for the same address */
+static void rpl_merge(struct bt_mesh_rpl *rpl, const struct bt_mesh_rpl *dup)
+{
+	if ((rpl->old_iv && !dup->old_iv) ||
+	    (rpl->old_iv == dup->old_iv && rpl->seq < dup->seq)) {
+		rpl->seq = dup->seq;
+		rpl->old_iv = dup->old_iv;
+	}
+
+#if defined(CONFIG_BT_SETTINGS)
+	rpl->legacy |= dup->legacy;
+#endif
+}
+
+static void rpl_index_build(void)
+{
+	bool pending = false;
+	int i;
+
+	(void)memset(rpl_index.slots, 0, sizeof(rpl_index.slots));
+	rpl_index.free = RPL_NONE;
+
+	/* Backwards, so that the first free entries get used first */
+	for (i = ARRAY_SIZE(replay_list) - 1; i >= 0; i--) {
+		struct bt_mesh_rpl *rpl = &replay_list[i];
+		uint32_t slot;
+
+		if (!rpl->src) {
+			rpl_free(rpl);
+			continue;
+		}
+
+		slot = rpl_slot_find(rpl->src);
+		if (rpl_index.slots[slot] == SLOT_FREE) {
+			rpl_index.slots[slot] = i + 1;
+			continue;
+		}
+
+		/* Loaded both from a record and in the per-entry format of
+		 * earlier versions.
+		 */
+		rpl_merge(&replay_list[rpl_index.slots[slot] - 1], rpl);
+		rpl_free(rpl);
+		atomic_set_bit(rpl_dirty, i / RPL_BLOCK_SIZE);
+	}
+
+	rpl_index.dirty = false;
+	rpl_load_top = ARRAY_SIZE(replay_list);
+
+	for (i = 0; i < RPL_BLOCKS; i++) {
+		pending |= atomic_test_bit(rpl_dirty, i);
+	}
+
+	if (IS_ENABLED(CONFIG_BT_SETTINGS) && pending) {
+		bt_mesh_settings_store_schedule(BT_MESH_SETTINGS_RPL_PENDING);
+	}
+}
+
+static struct bt_mesh_rpl *bt_mesh_rpl_find(uint16_t src)
+{
+	uint32_t slot;
+
+	if (rpl_index.dirty) {
+		rpl_index_build();
+	}
+
+	slot = rpl_slot_find(src);
+	if (rpl_index.slots[slot] == SLOT_FREE) {
+		return NULL;
+	}
+
+	return &replay_list[rpl_index.slots[slot] - 1];
+}
+
 void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 		struct bt_mesh_net_rx *rx)
 {
-	rpl->src = rx->ctx.addr;
+	/* Free entry, as returned by bt_mesh_rpl_check() */
+	if (!rpl->src) {
+		__ASSERT_NO_MSG(rpl == &replay_list[rpl_index.free]);
+
+		rpl_index.free = rpl->seq;
+		rpl->src = rx->ctx.addr;
+		rpl_index.slots[rpl_slot_find(rpl->src)] = rpl - replay_list + 1;
+	}
+
 	rpl->seq = rx->seq;
 	rpl->old_iv = rx->old_iv;
 
@@ -72,7 +260,7 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		struct bt_mesh_rpl **match)
 {
-	int i;
+	struct bt_mesh_rpl *rpl;
 
 	/* Don't bother checking messages from ourselves */
 	if (rx->net_if == BT_MESH_NET_IF_LOCAL) {
@@ -84,43 +272,30 @@ bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		return false;
 	}
 
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		struct bt_mesh_rpl *rpl = &replay_list[i];
-
-		/* Empty slot */
-		if (!rpl->src) {
-			if (match) {
-				*match = rpl;
-			} else {
-				bt_mesh_rpl_update(rpl, rx);
-			}
-
-			return false;
+	rpl = bt_mesh_rpl_find(rx->ctx.addr);
+	if (rpl) {
+		if (rx->old_iv && !rpl->old_iv) {
+			return true;
 		}
 
-		/* Existing slot for given address */
-		if (rpl->src == rx->ctx.addr) {
-			if (rx->old_iv && !rpl->old_iv) {
-				return true;
-			}
-
-			if ((!rx->old_iv && rpl->old_iv) ||
-			    rpl->seq < rx->seq) {
-				if (match) {
-					*match = rpl;
-				} else {
-					bt_mesh_rpl_update(rpl, rx);
-				}
-
-				return false;
-			} else {
-				return true;
-			}
+		if (!((!rx->old_iv && rpl->old_iv) || rpl->seq < rx->seq)) {
+			return true;
 		}
+	} else if (rpl_index.free != RPL_NONE) {
+		/* Free entry, which gets allocated when it is updated */
+		rpl = &replay_list[rpl_index.free];
+	} else {
+		BT_ERR("RPL is full!");
+		return true;
 	}
 
-	BT_ERR("RPL is full!");
-	return true;
+	if (match) {
+		*match = rpl;
+	} else {
+		bt_mesh_rpl_update(rpl, rx);
+	}
+
+	return false;
 }
 
 void bt_mesh_rpl_clear(void)
@@ -131,93 +306,176 @@ void bt_mesh_rpl_clear(void)
 		schedule_rpl_clear();
 	} else {
 		(void)memset(replay_list, 0, sizeof(replay_list));
+		rpl_index.dirty = true;
 	}
 }
 
-static struct bt_mesh_rpl *bt_mesh_rpl_find(uint16_t src)
+static void clear_legacy_rpl(struct bt_mesh_rpl *rpl)
 {
-	int i;
+#if defined(CONFIG_BT_SETTINGS)
+	char path[18];
+	int err;
 
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		if (replay_list[i].src == src) {
-			return &replay_list[i];
-		}
+	if (!rpl->legacy) {
+		return;
 	}
 
-	return NULL;
-}
+	rpl->legacy = false;
 
-static struct bt_mesh_rpl *bt_mesh_rpl_alloc(uint16_t src)
-{
-	int i;
-
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		if (!replay_list[i].src) {
-			replay_list[i].src = src;
-			return &replay_list[i];
-		}
+	snprintk(path, sizeof(path), "bt/mesh/RPL/%x", rpl->src);
+	err = settings_delete(path);
+	if (err) {
+		BT_ERR("Failed to clear RPL %s", log_strdup(path));
 	}
-
-	return NULL;
+#endif
 }
 
 void bt_mesh_rpl_reset(void)
 {
 	int i;
 
+	if (rpl_index.dirty) {
+		rpl_index_build();
+	}
+
 	/* Discard "old old" IV Index entries from RPL and flag
 	 * any other ones (which are valid) as old.
 	 */
 	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
 		struct bt_mesh_rpl *rpl = &replay_list[i];
 
-		if (rpl->src) {
-			if (rpl->old_iv) {
-				(void)memset(rpl, 0, sizeof(*rpl));
-			} else {
-				rpl->old_iv = true;
-			}
+		if (!rpl->src) {
+			continue;
+		}
 
-			if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
-				schedule_rpl_store(rpl);
-			}
+		if (rpl->old_iv) {
+			/* The per-entry format has no record to drop it */
+			clear_legacy_rpl(rpl);
+			rpl_slot_remove(rpl_slot_find(rpl->src));
+			rpl_free(rpl);
+		} else {
+			rpl->old_iv = true;
+		}
+
+		if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
+			schedule_rpl_store(rpl);
 		}
 	}
 }
 
-static int rpl_set(const char *name, size_t len_rd,
-		   settings_read_cb read_cb, void *cb_arg)
+/* Place an entry loaded from storage at its position, or at the last free
+ * one if that is not possible.
+ */
+static struct bt_mesh_rpl *rpl_load(uint32_t pos, uint16_t src,
+				    struct rpl_val val)
 {
 	struct bt_mesh_rpl *entry;
-	struct rpl_val rpl;
-	int err;
-	uint16_t src;
 
-	if (!name) {
-		BT_ERR("Insufficient number of arguments");
-		return -ENOENT;
+	if (pos >= ARRAY_SIZE(replay_list) || replay_list[pos].src) {
+		while (rpl_load_top > 0 && replay_list[rpl_load_top - 1].src) {
+			rpl_load_top--;
+		}
+
+		if (!rpl_load_top) {
+			BT_ERR("Unable to allocate RPL entry for 0x%04x", src);
+			return NULL;
+		}
+
+		pos = --rpl_load_top;
+		atomic_set_bit(rpl_dirty, pos / RPL_BLOCK_SIZE);
 	}
 
-	src = strtol(name, NULL, 16);
-	entry = bt_mesh_rpl_find(src);
+	entry = &replay_list[pos];
+	entry->src = src;
+	entry->seq = val.seq;
+	entry->old_iv = val.old_iv;
+
+	rpl_index.dirty = true;
+
+	BT_DBG("RPL entry for 0x%04x: Seq 0x%06x old_iv %u", entry->src,
+	       entry->seq, entry->old_iv);
+
+	return entry;
+}
+
+static int rpl_blk_set(uint16_t blk, size_t len_rd,
+		       settings_read_cb read_cb, void *cb_arg)
+{
+	struct rpl_rec *recs = rpl_load_recs;
+	uint32_t start = blk * RPL_BLOCK_SIZE;
+	ssize_t len;
+	int i;
 
 	if (len_rd == 0) {
 		BT_DBG("val (null)");
-		if (entry) {
-			(void)memset(entry, 0, sizeof(*entry));
-		} else {
-			BT_WARN("Unable to find RPL entry for 0x%04x", src);
+
+		for (i = start; i < MIN(start + RPL_BLOCK_SIZE,
+					ARRAY_SIZE(replay_list)); i++) {
+			(void)memset(&replay_list[i], 0, sizeof(replay_list[i]));
+		}
+
+		if (blk < RPL_BLOCKS) {
+			atomic_clear_bit(rpl_stored, blk);
 		}
 
+		rpl_index.dirty = true;
 		return 0;
 	}
 
-	if (!entry) {
-		entry = bt_mesh_rpl_alloc(src);
-		if (!entry) {
-			BT_ERR("Unable to allocate RPL entry for 0x%04x", src);
-			return -ENOMEM;
+	if (len_rd > sizeof(rpl_load_recs)) {
+		BT_ERR("Unexpected value length (%zu)", len_rd);
+		return -EINVAL;
+	}
+
+	len = read_cb(cb_arg, recs, sizeof(rpl_load_recs));
+	if (len < 0) {
+		BT_ERR("Failed to read value (err %zd)", len);
+		return len;
+	}
+
+	if (len % sizeof(recs[0])) {
+		BT_ERR("Unexpected value length (%zd)", len);
+		return -EINVAL;
+	}
+
+	/* Records of a larger list are kept at other positions */
+	if (blk < RPL_BLOCKS) {
+		atomic_set_bit(rpl_stored, blk);
+	} else {
+		BT_WARN("RPL record %u beyond the list size", blk);
+	}
+
+	for (i = 0; i < len / sizeof(recs[0]); i++) {
+		if (recs[i].src) {
+			(void)rpl_load(start + i, recs[i].src, recs[i].val);
+		}
+	}
+
+	return 0;
+}
+
+/* Entry stored by itself, as done by earlier versions */
+static int rpl_legacy_set(uint16_t src, size_t len_rd,
+			  settings_read_cb read_cb, void *cb_arg)
+{
+	struct bt_mesh_rpl *entry;
+	struct rpl_val rpl;
+	int err;
+	int i;
+
+	if (len_rd == 0) {
+		BT_DBG("val (null)");
+
+		/* Not loaded yet or just loaded, at the end of the list */
+		for (i = ARRAY_SIZE(replay_list) - 1; i >= rpl_load_top; i--) {
+			if (replay_list[i].src == src) {
+				(void)memset(&replay_list[i], 0,
+					     sizeof(replay_list[i]));
+				rpl_index.dirty = true;
+			}
 		}
+
+		return 0;
 	}
 
 	err = bt_mesh_settings_set(read_cb, cb_arg, &rpl, sizeof(rpl));
@@ -226,82 +484,160 @@ static int rpl_set(const char *name, size_t len_rd,
 		return err;
 	}
 
-	entry->seq = rpl.seq;
-	entry->old_iv = rpl.old_iv;
+	/* Written as part of a record, after which the entry is cleared */
+	entry = rpl_load(ARRAY_SIZE(replay_list), src, rpl);
+	if (!entry) {
+		return -ENOMEM;
+	}
 
-	BT_DBG("RPL entry for 0x%04x: Seq 0x%06x old_iv %u", entry->src,
-	       entry->seq, entry->old_iv);
+#if defined(CONFIG_BT_SETTINGS)
+	entry->legacy = true;
+#endif
 
 	return 0;
 }
 
+static int rpl_set(const char *name, size_t len_rd,
+		   settings_read_cb read_cb, void *cb_arg)
+{
+	const char *next;
+
+	if (!name) {
+		BT_ERR("Insufficient number of arguments");
+		return -ENOENT;
+	}
+
+	if (settings_name_steq(name, "blk", &next) && next) {
+		return rpl_blk_set(strtol(next, NULL, 16), len_rd, read_cb,
+				   cb_arg);
+	}
+
+	return rpl_legacy_set(strtol(name, NULL, 16), len_rd, read_cb, cb_arg);
+}
+
 BT_MESH_SETTINGS_DEFINE(rpl, "RPL", rpl_set);
 
-static void store_rpl(struct bt_mesh_rpl *entry)
+static void store_rpl_blk(uint16_t blk)
 {
-	struct rpl_val rpl;
-	char path[18];
+	struct rpl_rec *recs = rpl_store_recs;
+	struct bt_mesh_rpl *entries = &replay_list[blk * RPL_BLOCK_SIZE];
+	size_t count = MIN(RPL_BLOCK_SIZE,
+			   ARRAY_SIZE(replay_list) - blk * RPL_BLOCK_SIZE);
+	char path[22];
 	int err;
+	int i;
 
-	BT_DBG("src 0x%04x seq 0x%06x old_iv %u", entry->src, entry->seq,
-	       entry->old_iv);
+	/* Empty entries that end the record are not stored */
+	while (count > 0 && !entries[count - 1].src) {
+		count--;
+	}
 
-	rpl.seq = entry->seq;
-	rpl.old_iv = entry->old_iv;
+	snprintk(path, sizeof(path), "bt/mesh/RPL/blk/%x", blk);
 
-	snprintk(path, sizeof(path), "bt/mesh/RPL/%x", entry->src);
+	if (!count) {
+		if (!atomic_test_and_clear_bit(rpl_stored, blk)) {
+			return;
+		}
 
-	err = settings_save_one(path, &rpl, sizeof(rpl));
+		err = settings_delete(path);
+		if (err) {
+			BT_ERR("Failed to clear RPL %s", log_strdup(path));
+		} else {
+			BT_DBG("Cleared RPL %s", log_strdup(path));
+		}
+
+		return;
+	}
+
+	for (i = 0; i < count; i++) {
+		/* Free entries chain others through the sequence number */
+		if (entries[i].src) {
+			recs[i].src = entries[i].src;
+			recs[i].val.seq = entries[i].seq;
+			recs[i].val.old_iv = entries[i].old_iv;
+		} else {
+			(void)memset(&recs[i], 0, sizeof(recs[i]));
+		}
+	}
+
+	err = settings_save_one(path, recs, count * sizeof(recs[0]));
 	if (err) {
 		BT_ERR("Failed to store RPL %s value", log_strdup(path));
-	} else {
-		BT_DBG("Stored RPL %s value", log_strdup(path));
+		return;
+	}
+
+	BT_DBG("Stored RPL %s value", log_strdup(path));
+
+	atomic_set_bit(rpl_stored, blk);
+
+	for (i = 0; i < count; i++) {
+		clear_legacy_rpl(&entries[i]);
 	}
 }
 
-static void clear_rpl(struct bt_mesh_rpl *rpl)
+static void clear_rpl(void)
 {
+	char path[22];
 	int err;
-	char path[18];
+	int i;
 
-	if (!rpl->src) {
-		return;
-	}
+	BT_DBG("");
 
-	snprintk(path, sizeof(path), "bt/mesh/RPL/%x", rpl->src);
-	err = settings_delete(path);
-	if (err) {
-		BT_ERR("Failed to clear RPL");
-	} else {
-		BT_DBG("Cleared RPL");
+	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
+		if (replay_list[i].src) {
+			clear_legacy_rpl(&replay_list[i]);
+		}
 	}
 
-	(void)memset(rpl, 0, sizeof(*rpl));
-}
+	for (i = 0; i < RPL_BLOCKS; i++) {
+		atomic_clear_bit(rpl_dirty, i);
 
-static void store_pending_rpl(struct bt_mesh_rpl *rpl)
-{
-	BT_DBG("");
+		if (!atomic_test_and_clear_bit(rpl_stored, i)) {
+			continue;
+		}
 
-#ifdef CONFIG_BT_SETTINGS
-	if (!rpl->store) {
-		return;
+		snprintk(path, sizeof(path), "bt/mesh/RPL/blk/%x", i);
+		err = settings_delete(path);
+		if (err) {
+			BT_ERR("Failed to clear RPL");
+		} else {
+			BT_DBG("Cleared RPL");
+		}
 	}
 
-	rpl->store = false;
-#endif
-	store_rpl(rpl);
+	(void)memset(replay_list, 0, sizeof(replay_list));
+	rpl_index.dirty = true;
 }
 
 void bt_mesh_rpl_pending_store(void)
 {
+	uint32_t written = 0U;
 	int i;
 
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		if (atomic_test_bit(bt_mesh.flags, BT_MESH_VALID)) {
-			store_pending_rpl(&replay_list[i]);
-		} else {
-			clear_rpl(&replay_list[i]);
+	if (!atomic_test_bit(bt_mesh.flags, BT_MESH_VALID)) {
+		clear_rpl();
+		return;
+	}
+
+	/* Each record with changes is written once, up to the budget, after
+	 * which the next round continues with the following ones.
+	 */
+	for (i = 0; i < RPL_BLOCKS; i++) {
+		uint16_t blk = (rpl_store_next + i) % RPL_BLOCKS;
+
+		if (!atomic_test_bit(rpl_dirty, blk)) {
+			continue;
 		}
+
+		if (RPL_STORE_BUDGET && written == RPL_STORE_BUDGET) {
+			rpl_store_next = blk;
+			bt_mesh_settings_store_schedule(
+				BT_MESH_SETTINGS_RPL_PENDING);
+			return;
+		}
+
+		atomic_clear_bit(rpl_dirty, blk);
+		store_rpl_blk(blk);
+		written++;
 	}
 }
@@ -11,7 +11,7 @@ struct bt_mesh_rpl {
 	uint16_t src;
 	bool  old_iv;
 #if defined(CONFIG_BT_SETTINGS)
-	bool  store;
+	bool  legacy;
 #endif
 	uint32_t seq;
 };
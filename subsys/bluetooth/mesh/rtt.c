@@ -0,0 +1,43 @@
+/*  Bluetooth Mesh */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <sys/util.h>
+
+#include "rtt.h"
+
+void bt_mesh_rtt_ack(struct bt_mesh_rtt *rtt, uint32_t rtt_ms, bool resent)
+{
+	int32_t sample = MIN(rtt_ms, UINT16_MAX);
+	int32_t delta;
+
+	if (resent) {
+		return;
+	}
+
+	if (!rtt->timed) {
+		rtt->srtt = sample;
+		rtt->rttvar = sample / 2;
+		rtt->timed = true;
+		return;
+	}
+
+	delta = sample - rtt->srtt;
+	rtt->srtt += delta / 8;
+	rtt->rttvar += ((int32_t)abs(delta) - rtt->rttvar) / 4;
+}
+
+int32_t bt_mesh_rtt_timeout(const struct bt_mesh_rtt *rtt, int32_t min,
+			    int32_t max, int32_t def)
+{
+	if (!rtt->timed) {
+		return def;
+	}
+
+	return CLAMP(rtt->srtt + 4 * rtt->rttvar, min, max);
+}
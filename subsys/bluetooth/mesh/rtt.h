@@ -0,0 +1,36 @@
+/*  Bluetooth Mesh */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Acknowledgment round trip time estimate of a destination.
+ *
+ * The estimate follows the retransmission timer of TCP (RFC 6298): a
+ * smoothed round trip time and its variation, updated with gains of 1/8
+ * and 1/4 for every sample, and a timeout of srtt + 4 * rttvar.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct bt_mesh_rtt {
+	uint16_t srtt;   /* Smoothed round trip time, in ms */
+	uint16_t rttvar; /* Round trip time variation, in ms */
+	bool     timed;  /* srtt and rttvar are valid */
+};
+
+/* Account for an ack that arrived rtt_ms after the transmission of the
+ * segments it acks. Following Karn's rule, the sample is ignored if any
+ * of the segments was resent, as it's then unknown which transmission is
+ * acked.
+ */
+void bt_mesh_rtt_ack(struct bt_mesh_rtt *rtt, uint32_t rtt_ms, bool resent);
+
+/* Retransmit timeout in ms derived from the estimate, bounded to
+ * [min, max], or def if no round trip time has been sampled yet.
+ */
+int32_t bt_mesh_rtt_timeout(const struct bt_mesh_rtt *rtt, int32_t min,
+			    int32_t max, int32_t def);
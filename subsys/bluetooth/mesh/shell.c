@@ -23,6 +23,7 @@
 
 /* Private includes for raw Network & Transport layer access */
 #include "mesh.h"
+#include "adv.h"
 #include "net.h"
 #include "rpl.h"
 #include "transport.h"
@@ -771,6 +772,29 @@ static int cmd_rpl_clear(const struct shell *shell, size_t argc, char *argv[])
 	return 0;
 }
 
+static int cmd_adv_stats(const struct shell *shell, size_t argc, char *argv[])
+{
+	static const char * const tag_str[] = {
+		[BT_MESH_LOCAL_ADV] = "local",
+		[BT_MESH_RELAY_ADV] = "relay",
+	};
+	struct bt_mesh_adv_stats stats;
+	int i;
+
+	bt_mesh_adv_stats_get(&stats);
+
+	shell_print(shell, "%-6s %10s %10s %6s %6s", "class", "sent",
+		    "air ms", "queued", "max");
+
+	for (i = 0; i < BT_MESH_ADV_TAGS; i++) {
+		shell_print(shell, "%-6s %10u %10u %6u %6u", tag_str[i],
+			    stats.sent[i], stats.air_time[i], stats.queued[i],
+			    stats.queued_max[i]);
+	}
+
+	return 0;
+}
+
 static int cmd_beacon(const struct shell *shell, size_t argc, char *argv[])
 {
 	uint8_t status;
@@ -2675,6 +2699,7 @@ SHELL_STATIC_SUBCMD_SET_CREATE(mesh_cmds,
 		      cmd_iv_update_test, 2, 0),
 #endif
 	SHELL_CMD_ARG(rpl-clear, NULL, NULL, cmd_rpl_clear, 1, 0),
+	SHELL_CMD_ARG(adv-stats, NULL, NULL, cmd_adv_stats, 1, 0),
 
 	/* Provisioning operations */
 #if defined(CONFIG_BT_MESH_PB_GATT)
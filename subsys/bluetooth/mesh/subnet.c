@@ -64,8 +64,29 @@ static struct bt_mesh_subnet subnets[CONFIG_BT_MESH_SUBNET_COUNT] = {
 	},
 };
 
+/* Network credentials of the subnets, indexed by NID. Credential n is
+ * subnets[n / 2].keys[n % 2].msg, and the credentials sharing a NID are
+ * chained with the most recently successful one first. The index is rebuilt
+ * on the first lookup following a change of the keys.
+ */
+#define NID_COUNT BIT(7)
+#define CRED_COUNT (2 * CONFIG_BT_MESH_SUBNET_COUNT)
+#define CRED_NONE 0xffff
+
+static struct {
+	uint16_t head[NID_COUNT];
+	uint16_t next[CRED_COUNT];
+	bool dirty;
+} nid_index = {
+	.dirty = true,
+};
+
+static struct bt_mesh_trial_stats net_trials;
+
 static void subnet_evt(struct bt_mesh_subnet *sub, enum bt_mesh_key_evt evt)
 {
+	nid_index.dirty = true;
+
 	Z_STRUCT_SECTION_FOREACH(bt_mesh_subnet_cb, cb) {
 		cb->evt_handler(sub, evt);
 	}
@@ -295,6 +316,7 @@ static int net_keys_create(struct bt_mesh_subnet_keys *keys,
 	}
 
 	memcpy(keys->net, key, 16);
+	nid_index.dirty = true;
 
 	BT_DBG("NID 0x%02x EncKey %s", keys->msg.nid,
 	       bt_hex(keys->msg.enc, 16));
@@ -708,6 +730,51 @@ void bt_mesh_net_keys_reset(void)
 	}
 }
 
+static void nid_index_build(void)
+{
+	for (int nid = 0; nid < NID_COUNT; nid++) {
+		nid_index.head[nid] = CRED_NONE;
+	}
+
+	/* Chain in reverse, so that the subnets are first tried in order */
+	for (int n = CRED_COUNT - 1; n >= 0; n--) {
+		const struct bt_mesh_subnet *sub = &subnets[n / 2];
+		const struct bt_mesh_subnet_keys *keys = &sub->keys[n % 2];
+
+		if (sub->net_idx == BT_MESH_KEY_UNUSED || !keys->valid) {
+			continue;
+		}
+
+		nid_index.next[n] = nid_index.head[keys->msg.nid];
+		nid_index.head[keys->msg.nid] = n;
+	}
+
+	nid_index.dirty = false;
+}
+
+static bool cred_try(struct bt_mesh_net_rx *rx, struct net_buf_simple *in,
+		     struct net_buf_simple *out,
+		     bool (*cb)(struct bt_mesh_net_rx *rx,
+				struct net_buf_simple *in,
+				struct net_buf_simple *out,
+				const struct bt_mesh_net_cred *cred),
+		     const struct bt_mesh_net_cred *cred)
+{
+	if ((in->data[0] & 0x7f) != cred->nid) {
+		return false;
+	}
+
+	net_trials.attempts++;
+
+	if (!cb(rx, in, out, cred)) {
+		return false;
+	}
+
+	net_trials.hits++;
+
+	return true;
+}
+
 bool bt_mesh_net_cred_find(struct bt_mesh_net_rx *rx, struct net_buf_simple *in,
 			   struct net_buf_simple *out,
 			   bool (*cb)(struct bt_mesh_net_rx *rx,
@@ -715,7 +782,9 @@ bool bt_mesh_net_cred_find(struct bt_mesh_net_rx *rx, struct net_buf_simple *in,
 				      struct net_buf_simple *out,
 				      const struct bt_mesh_net_cred *cred))
 {
-	int i, j;
+	uint8_t nid = in->data[0] & 0x7f;
+	uint16_t n, prev;
+	int j;
 
 	BT_DBG("");
 
@@ -728,7 +797,7 @@ bool bt_mesh_net_cred_find(struct bt_mesh_net_rx *rx, struct net_buf_simple *in,
 				continue;
 			}
 
-			if (cb(rx, in, out, &bt_mesh.lpn.cred[j])) {
+			if (cred_try(rx, in, out, cb, &bt_mesh.lpn.cred[j])) {
 				rx->new_key = (j > 0);
 				rx->friend_cred = 1U;
 				rx->ctx.net_idx = rx->sub->net_idx;
@@ -745,7 +814,7 @@ bool bt_mesh_net_cred_find(struct bt_mesh_net_rx *rx, struct net_buf_simple *in,
 
 #if defined(CONFIG_BT_MESH_FRIEND)
 	/** Each friendship has unique friendship credentials */
-	for (i = 0; i < ARRAY_SIZE(bt_mesh.frnd); i++) {
+	for (int i = 0; i < ARRAY_SIZE(bt_mesh.frnd); i++) {
 		struct bt_mesh_friend *frnd = &bt_mesh.frnd[i];
 
 		if (!frnd->subnet) {
@@ -759,7 +828,7 @@ bool bt_mesh_net_cred_find(struct bt_mesh_net_rx *rx, struct net_buf_simple *in,
 				continue;
 			}
 
-			if (cb(rx, in, out, &frnd->cred[j])) {
+			if (cred_try(rx, in, out, cb, &frnd->cred[j])) {
 				rx->new_key = (j > 0);
 				rx->friend_cred = 1U;
 				rx->ctx.net_idx = rx->sub->net_idx;
@@ -769,29 +838,42 @@ bool bt_mesh_net_cred_find(struct bt_mesh_net_rx *rx, struct net_buf_simple *in,
 	}
 #endif
 
-	for (i = 0; i < ARRAY_SIZE(subnets); i++) {
-		rx->sub = &subnets[i];
-		if (rx->sub->net_idx == BT_MESH_KEY_UNUSED) {
+	if (nid_index.dirty) {
+		nid_index_build();
+	}
+
+	for (prev = CRED_NONE, n = nid_index.head[nid]; n != CRED_NONE;
+	     prev = n, n = nid_index.next[n]) {
+		rx->sub = &subnets[n / 2];
+		j = n % 2;
+
+		if (!cred_try(rx, in, out, cb, &rx->sub->keys[j].msg)) {
 			continue;
 		}
 
-		for (j = 0; j < ARRAY_SIZE(rx->sub->keys); j++) {
-			if (!rx->sub->keys[j].valid) {
-				continue;
-			}
-
-			if (cb(rx, in, out, &rx->sub->keys[j].msg)) {
-				rx->new_key = (j > 0);
-				rx->friend_cred = 0U;
-				rx->ctx.net_idx = rx->sub->net_idx;
-				return true;
-			}
+		/* Move the credential to the front of its chain, as the
+		 * next messages are likely to come from the same subnet
+		 */
+		if (prev != CRED_NONE) {
+			nid_index.next[prev] = nid_index.next[n];
+			nid_index.next[n] = nid_index.head[nid];
+			nid_index.head[nid] = n;
 		}
+
+		rx->new_key = (j > 0);
+		rx->friend_cred = 0U;
+		rx->ctx.net_idx = rx->sub->net_idx;
+		return true;
 	}
 
 	return false;
 }
 
+void bt_mesh_net_cred_stats_get(struct bt_mesh_trial_stats *stats)
+{
+	*stats = net_trials;
+}
+
 static int net_key_set(const char *name, size_t len_rd,
 		       settings_read_cb read_cb, void *cb_arg)
 {
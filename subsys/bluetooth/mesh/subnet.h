@@ -153,13 +153,24 @@ int bt_mesh_friend_cred_create(struct bt_mesh_net_cred *cred,
 			       uint16_t lpn_counter, uint16_t frnd_counter,
 			       const uint8_t key[16]);
 
+/** Trial decryption counters. */
+struct bt_mesh_trial_stats {
+	uint32_t attempts; /* Decryptions attempted */
+	uint32_t hits;     /* Successful decryptions */
+};
+
 /** @brief Iterate through all valid network credentials to decrypt a message.
+ *
+ *  Only the credentials whose NID matches the message are tried, starting
+ *  with the subnet credential that most recently decrypted a message with
+ *  the same NID.
  *
  *  @param rx Network RX parameters, passed to the callback.
  *  @param in Input message buffer, passed to the callback.
  *  @param out Output message buffer, passed to the callback.
- *  @param cb Callback to call for each known network credential. Iteration
- *            stops when this callback returns @c true.
+ *  @param cb Callback to call for each known network credential with a
+ *            matching NID. Iteration stops when this callback returns
+ *            @c true.
  *
  *  @returns Whether any of the credentials got a @c true return from the
  *           callback.
@@ -171,6 +182,12 @@ bool bt_mesh_net_cred_find(struct bt_mesh_net_rx *rx, struct net_buf_simple *in,
 				      struct net_buf_simple *out,
 				      const struct bt_mesh_net_cred *cred));
 
+/** @brief Get the trial decryption counters of the network credentials.
+ *
+ *  @param stats Counters return parameter.
+ */
+void bt_mesh_net_cred_stats_get(struct bt_mesh_trial_stats *stats);
+
 /** @brief Get the network flags of the given Subnet.
  *
  *  @param sub Subnet to get the network flags of.
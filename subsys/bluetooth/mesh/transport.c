@@ -37,6 +37,7 @@
 #include "foundation.h"
 #include "settings.h"
 #include "heartbeat.h"
+#include "rtt.h"
 #include "transport.h"
 
 #define AID_MASK                    ((uint8_t)(BIT_MASK(6)))
@@ -71,10 +72,9 @@
  */
 #define SEG_RETRANSMIT_TIMEOUT_GROUP CONFIG_BT_MESH_TX_SEG_RETRANS_TIMEOUT_GROUP
 
-#define SEG_RETRANSMIT_TIMEOUT(tx)                                             \
-	(BT_MESH_ADDR_IS_UNICAST(tx->dst) ?                                    \
-		 SEG_RETRANSMIT_TIMEOUT_UNICAST(tx) :                          \
-		 SEG_RETRANSMIT_TIMEOUT_GROUP)
+/* Lowest unicast retransmit interval the specification allows */
+#define SEG_RETRANSMIT_TIMEOUT_MIN(tx) (200 + 50 * (tx)->ttl)
+
 /* How long to wait for available buffers before giving up */
 #define BUF_TIMEOUT                 K_NO_WAIT
 
@@ -112,12 +112,23 @@ static struct seg_tx {
 			      aszmic:1,      /* MIC size */
 			      started:1,     /* Start cb called */
 			      sending:1,     /* Sending is in progress */
-			      friend_cred:1; /* Using Friend credentials */
+			      friend_cred:1, /* Using Friend credentials */
+			      resent:1;      /* Segments were retransmitted */
+	uint32_t              sent;          /* End of last tx round */
 	const struct bt_mesh_send_cb *cb;
 	void                  *cb_data;
 	struct k_delayed_work retransmit;    /* Retransmit timer */
 } seg_tx[CONFIG_BT_MESH_TX_SEG_MSG_COUNT];
 
+#if defined(CONFIG_BT_MESH_TX_SEG_ADAPTIVE_TIMEOUT)
+/* Acknowledgment timing of recent unicast destinations */
+static struct seg_tx_peer {
+	uint16_t addr;
+	struct bt_mesh_rtt rtt;
+} seg_tx_peers[CONFIG_BT_MESH_TX_SEG_PEER_COUNT];
+static uint8_t seg_tx_peer_next;
+#endif
+
 static struct seg_rx {
 	struct bt_mesh_subnet   *sub;
 	void                    *seg[CONFIG_BT_MESH_RX_SEG_MAX];
@@ -298,6 +309,81 @@ static inline void seg_tx_complete(struct seg_tx *tx, int err)
 	}
 }
 
+#if defined(CONFIG_BT_MESH_TX_SEG_ADAPTIVE_TIMEOUT)
+static struct seg_tx_peer *seg_tx_peer_find(uint16_t addr)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(seg_tx_peers); i++) {
+		if (seg_tx_peers[i].addr == addr) {
+			return &seg_tx_peers[i];
+		}
+	}
+
+	return NULL;
+}
+
+static struct seg_tx_peer *seg_tx_peer_get(uint16_t addr)
+{
+	struct seg_tx_peer *peer;
+
+	peer = seg_tx_peer_find(addr);
+	if (peer) {
+		return peer;
+	}
+
+	peer = &seg_tx_peers[seg_tx_peer_next];
+	seg_tx_peer_next = (seg_tx_peer_next + 1) % ARRAY_SIZE(seg_tx_peers);
+
+	(void)memset(peer, 0, sizeof(*peer));
+	peer->addr = addr;
+
+	return peer;
+}
+
+/* Called when an ack from the destination reports new segments. The round
+ * trip time is only sampled if the acked segments haven't been sent more
+ * than once, as it's otherwise unknown which transmission is acked.
+ */
+static void seg_tx_progress(struct seg_tx *tx)
+{
+	struct seg_tx_peer *peer = seg_tx_peer_get(tx->dst);
+
+	/* Only retransmissions without progress are counted */
+	tx->attempts = SEG_RETRANSMIT_ATTEMPTS;
+
+	bt_mesh_rtt_ack(&peer->rtt, k_uptime_get_32() - tx->sent,
+			tx->resent || tx->seg_pending);
+
+	BT_DBG("0x%04x srtt %u rttvar %u", peer->addr, peer->rtt.srtt,
+	       peer->rtt.rttvar);
+}
+#else
+static inline void seg_tx_progress(struct seg_tx *tx)
+{
+}
+#endif /* CONFIG_BT_MESH_TX_SEG_ADAPTIVE_TIMEOUT */
+
+static int32_t seg_retransmit_timeout(struct seg_tx *tx)
+{
+	if (!BT_MESH_ADDR_IS_UNICAST(tx->dst)) {
+		return SEG_RETRANSMIT_TIMEOUT_GROUP;
+	}
+
+#if defined(CONFIG_BT_MESH_TX_SEG_ADAPTIVE_TIMEOUT)
+	struct seg_tx_peer *peer = seg_tx_peer_find(tx->dst);
+
+	if (peer) {
+		return bt_mesh_rtt_timeout(&peer->rtt,
+					   SEG_RETRANSMIT_TIMEOUT_MIN(tx),
+					   2 * SEG_RETRANSMIT_TIMEOUT_UNICAST(tx),
+					   SEG_RETRANSMIT_TIMEOUT_UNICAST(tx));
+	}
+#endif
+
+	return SEG_RETRANSMIT_TIMEOUT_UNICAST(tx);
+}
+
 static void schedule_retransmit(struct seg_tx *tx)
 {
 	if (!tx->nack_count) {
@@ -315,9 +401,14 @@ static void schedule_retransmit(struct seg_tx *tx)
 	 * called this from inside bt_mesh_net_send), we should continue the
 	 * retransmit immediately, as we just freed up a tx buffer.
 	 */
+	if (tx->seg_o) {
+		k_delayed_work_submit(&tx->retransmit, K_NO_WAIT);
+		return;
+	}
+
+	tx->sent = k_uptime_get_32();
 	k_delayed_work_submit(&tx->retransmit,
-			      tx->seg_o ? K_NO_WAIT :
-					  K_MSEC(SEG_RETRANSMIT_TIMEOUT(tx)));
+			      K_MSEC(seg_retransmit_timeout(tx)));
 }
 
 static void seg_send_start(uint16_t duration, int err, void *user_data)
@@ -403,6 +494,11 @@ static void seg_tx_send_unacked(struct seg_tx *tx)
 	BT_DBG("SeqZero: 0x%04x Attempts: %u",
 	       (uint16_t)(tx->seq_auth & TRANS_SEQ_ZERO_MASK), tx->attempts);
 
+	/* Every round after the first one retransmits segments */
+	if (!tx->seg_o && tx->attempts < SEG_RETRANSMIT_ATTEMPTS) {
+		tx->resent = 1U;
+	}
+
 	tx->sending = 1U;
 
 	for (; tx->seg_o <= tx->seg_n; tx->seg_o++) {
@@ -440,8 +536,9 @@ static void seg_tx_send_unacked(struct seg_tx *tx)
 
 end:
 	if (!tx->seg_pending) {
+		tx->sent = k_uptime_get_32();
 		k_delayed_work_submit(&tx->retransmit,
-				      K_MSEC(SEG_RETRANSMIT_TIMEOUT(tx)));
+				      K_MSEC(seg_retransmit_timeout(tx)));
 	}
 
 	tx->sending = 0U;
@@ -506,6 +603,7 @@ static int send_seg(struct bt_mesh_net_tx *net_tx, struct net_buf_simple *sdu,
 	tx->friend_cred = net_tx->friend_cred;
 	tx->blocked = blocked;
 	tx->started = 0;
+	tx->resent = 0;
 	tx->ctl = !!ctl_op;
 	tx->ttl = net_tx->ctx->send_ttl;
 
@@ -813,6 +911,7 @@ static int trans_ack(struct bt_mesh_net_rx *rx, uint8_t hdr,
 	unsigned int bit;
 	uint32_t ack;
 	uint16_t seq_zero;
+	uint8_t nack_count;
 	uint8_t obo;
 
 	if (buf->len < 6) {
@@ -861,6 +960,8 @@ static int trans_ack(struct bt_mesh_net_rx *rx, uint8_t hdr,
 
 	k_delayed_work_cancel(&tx->retransmit);
 
+	nack_count = tx->nack_count;
+
 	while ((bit = find_lsb_set(ack))) {
 		if (tx->seg[bit - 1]) {
 			BT_DBG("seg %u/%u acked", bit - 1, tx->seg_n);
@@ -870,7 +971,12 @@ static int trans_ack(struct bt_mesh_net_rx *rx, uint8_t hdr,
 		ack &= ~BIT(bit - 1);
 	}
 
+	if (tx->nack_count < nack_count) {
+		seg_tx_progress(tx);
+	}
+
 	if (tx->nack_count) {
+		tx->resent = 1U;
 		seg_tx_send_unacked(tx);
 	} else {
 		BT_DBG("SDU TX complete");
@@ -1616,6 +1722,11 @@ void bt_mesh_trans_reset(void)
 
 	bt_mesh_rpl_clear();
 
+#if defined(CONFIG_BT_MESH_TX_SEG_ADAPTIVE_TIMEOUT)
+	(void)memset(seg_tx_peers, 0, sizeof(seg_tx_peers));
+	seg_tx_peer_next = 0U;
+#endif
+
 	if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
 		store_va_label();
 	}
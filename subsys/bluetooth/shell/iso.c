@@ -24,9 +24,11 @@
 
 #include "bt.h"
 
-static void iso_recv(struct bt_iso_chan *chan, struct net_buf *buf)
+static void iso_recv(struct bt_iso_chan *chan,
+		     const struct bt_iso_recv_info *info, struct net_buf *buf)
 {
-	printk("Incoming data channel %p len %u\n", chan, buf->len);
+	printk("Incoming data channel %p len %u sn %u flags 0x%02x\n", chan,
+	       buf->len, info->sn, info->flags);
 }
 
 static void iso_connected(struct bt_iso_chan *chan)
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Idle governor predicting wake-up times
+ *
+ * The residency policy only considers the next kernel timeout. Many
+ * wake-ups are however caused by interrupts recurring at a regular
+ * interval (radio connection events, keyboard scans, sensor data ready).
+ * Going to a deep state right before one of them wastes the energy spent
+ * entering and leaving the state, and adds its exit latency to the
+ * interrupt handling.
+ *
+ * Each wake-up is accounted to a source: explicitly with
+ * pm_governor_wakeup_source() from the waking ISR, or else to the timer
+ * when it happened at the expected timeout, and to a catch-all source
+ * otherwise. The intervals between consecutive wake-ups of each source
+ * are recorded. When they are steady, once outliers are discarded, the
+ * next wake-up of the source is predicted to happen one typical interval
+ * after the previous one. The idle time is the earliest of the next
+ * timeout and of these predictions, and the deepest state whose minimum
+ * residency plus exit latency fits in it is selected.
+ */
+
+#include <zephyr.h>
+#include <kernel.h>
+#include <errno.h>
+#include <spinlock.h>
+#include <string.h>
+#include <sys/util.h>
+#include "pm_policy.h"
+
+#define LOG_LEVEL CONFIG_PM_LOG_LEVEL /* From power module Kconfig */
+#include <logging/log.h>
+LOG_MODULE_DECLARE(power);
+
+#define NUM_SOURCES CONFIG_PM_POLICY_GOVERNOR_SOURCES
+#define HISTORY CONFIG_PM_POLICY_GOVERNOR_HISTORY
+#define NUM_STATES ARRAY_SIZE(pm_states)
+
+/* Longer intervals are clamped, they are never worth predicting */
+#define MAX_INTERVAL_US (1U << 26)
+
+/* Intervals whose standard deviation is within 1/6 of their mean, or
+ * below this absolute bound, are considered steady.
+ */
+#define STEADY_VARIANCE_US2 (400ULL * 400ULL)
+
+static const struct pm_state_info pm_states[] =
+	PM_STATE_INFO_DT_ITEMS_LIST(DT_NODELABEL(cpu0));
+
+/* Time stamp of a wake-up or idle entry. Ticks are too coarse to time
+ * wake-ups on many systems, and the 32-bit cycle counter wraps within
+ * seconds on fast CPUs: intervals are measured in cycles, and in ticks
+ * when they are too long for the cycle counter.
+ */
+struct stamp {
+	int64_t ticks;
+	uint32_t cycles;
+};
+
+struct wakeup_source {
+	struct stamp last_wake;
+	bool seen;
+	uint32_t intervals_us[HISTORY];
+	uint8_t next;
+	uint8_t count;
+};
+
+static struct k_spinlock lock;
+static struct wakeup_source sources[NUM_SOURCES];
+
+/* Statistics, the last entry being plain CPU idle */
+static struct pm_governor_stats stats[NUM_STATES + 1];
+
+/* Current idle period */
+static bool in_idle;
+static uint8_t idle_index;
+static struct stamp idle_entry;
+static int64_t idle_deadline;
+
+/* Wake-up waiting to be accounted at the next idle entry */
+static bool wake_pending;
+static bool wake_attributed;
+static uint8_t wake_source;
+static struct stamp wake_time;
+
+static struct stamp stamp_now(void)
+{
+	return (struct stamp){
+		.ticks = k_uptime_ticks(),
+		.cycles = k_cycle_get_32(),
+	};
+}
+
+/* Microseconds elapsed between two time stamps */
+static uint32_t elapsed_us(const struct stamp *from, const struct stamp *to)
+{
+	int64_t ticks = MAX(to->ticks - from->ticks, 0);
+	uint64_t us = k_ticks_to_us_floor64((uint64_t)ticks);
+
+	/* Within half a wrap of the cycle counter, the cycles are exact */
+	if (us < k_cyc_to_us_floor64(UINT32_MAX / 2U)) {
+		us = k_cyc_to_us_floor64(to->cycles - from->cycles);
+	}
+
+	return (uint32_t)MIN(us, MAX_INTERVAL_US);
+}
+
+static void record_interval(struct wakeup_source *src,
+			    const struct stamp *now)
+{
+	if (src->seen) {
+		src->intervals_us[src->next] =
+			elapsed_us(&src->last_wake, now);
+		src->next = (src->next + 1U) % HISTORY;
+		if (src->count < HISTORY) {
+			src->count++;
+		}
+	}
+
+	src->last_wake = *now;
+	src->seen = true;
+}
+
+/* Returns the typical wake-up interval of the source, or 0 if it is not
+ * steady enough to be predicted.
+ */
+static uint32_t typical_interval(const struct wakeup_source *src)
+{
+	uint32_t threshold = UINT32_MAX;
+
+	if (src->count < (HISTORY / 2U)) {
+		return 0;
+	}
+
+	/* Discard the largest intervals, e.g. a missed event, one at a time
+	 * until the remaining ones are steady, keeping at least 3/4 of them.
+	 */
+	while (true) {
+		uint64_t sum = 0, variance = 0;
+		uint32_t max = 0, avg;
+		unsigned int n = 0;
+
+		for (int i = 0; i < src->count; i++) {
+			uint32_t v = src->intervals_us[i];
+
+			if (v <= threshold) {
+				sum += v;
+				max = MAX(max, v);
+				n++;
+			}
+		}
+
+		avg = (uint32_t)(sum / n);
+
+		for (int i = 0; i < src->count; i++) {
+			int64_t diff = (int64_t)src->intervals_us[i] - avg;
+
+			if (src->intervals_us[i] <= threshold) {
+				variance += (uint64_t)(diff * diff);
+			}
+		}
+		variance /= n;
+
+		if ((variance <= STEADY_VARIANCE_US2) ||
+		    ((uint64_t)avg * avg > 36U * variance)) {
+			return avg;
+		}
+
+		if ((n - 1U) * 4U < (unsigned int)src->count * 3U) {
+			return 0;
+		}
+
+		threshold = max - 1U;
+	}
+}
+
+/* Predicted time in microseconds until the next interrupt-driven wake-up */
+static uint64_t predict_wakeup_us(const struct stamp *now)
+{
+	uint64_t predicted = UINT64_MAX;
+
+	/* The timer needs no prediction: the next timeout is known */
+	for (int i = PM_GOVERNOR_SOURCE_OTHER; i < NUM_SOURCES; i++) {
+		uint32_t typical = typical_interval(&sources[i]);
+		uint32_t elapsed;
+
+		if (typical == 0U) {
+			continue;
+		}
+
+		/* Stop anticipating a source that went quiet */
+		elapsed = elapsed_us(&sources[i].last_wake, now);
+		if (elapsed >= 2U * typical) {
+			continue;
+		}
+
+		predicted = MIN(predicted, typical - (elapsed % typical));
+	}
+
+	return predicted;
+}
+
+static void account_wakeup(void)
+{
+	struct pm_governor_stats *st;
+	uint32_t residency;
+
+	if (!wake_pending) {
+		return;
+	}
+
+	wake_pending = false;
+	record_interval(&sources[wake_source], &wake_time);
+
+	st = &stats[(idle_index == PM_GOVERNOR_STATE_CPU_IDLE) ?
+		    NUM_STATES : idle_index];
+	residency = elapsed_us(&idle_entry, &wake_time);
+	st->entries++;
+	st->residency_us += residency;
+	if ((idle_index != PM_GOVERNOR_STATE_CPU_IDLE) &&
+	    (residency < pm_states[idle_index].min_residency_us)) {
+		st->early_exits++;
+	}
+}
+
+static uint8_t select_state(uint64_t idle_us)
+{
+	for (int i = NUM_STATES - 1; i >= 0; i--) {
+		const struct pm_state_info *info = &pm_states[i];
+
+#ifdef CONFIG_PM_STATE_LOCK
+		if (!pm_ctrl_is_state_enabled(info->state)) {
+			continue;
+		}
+#endif
+		if ((CONFIG_PM_POLICY_GOVERNOR_MAX_LATENCY_US != 0) &&
+		    (info->exit_latency_us >
+		     CONFIG_PM_POLICY_GOVERNOR_MAX_LATENCY_US)) {
+			continue;
+		}
+
+		if (idle_us >= ((uint64_t)info->min_residency_us +
+				info->exit_latency_us)) {
+			return i;
+		}
+	}
+
+	return PM_GOVERNOR_STATE_CPU_IDLE;
+}
+
+struct pm_state_info pm_policy_next_state(int32_t ticks)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	struct stamp now = stamp_now();
+	uint64_t timer_us, predicted_us;
+	uint8_t index;
+
+	account_wakeup();
+
+	timer_us = (ticks == K_TICKS_FOREVER) ?
+		   UINT64_MAX : k_ticks_to_us_floor64(ticks);
+	predicted_us = predict_wakeup_us(&now);
+	index = select_state(MIN(timer_us, predicted_us));
+
+	in_idle = true;
+	idle_index = index;
+	idle_entry = now;
+	idle_deadline = (ticks == K_TICKS_FOREVER) ?
+			INT64_MAX : now.ticks + ticks;
+
+	k_spin_unlock(&lock, key);
+
+	if (index == PM_GOVERNOR_STATE_CPU_IDLE) {
+		LOG_DBG("No suitable power state found!");
+		return (struct pm_state_info){PM_STATE_ACTIVE, 0, 0};
+	}
+
+	LOG_DBG("Selected power state %d (ticks: %d, predicted: %llu us)",
+		pm_states[index].state, ticks, predicted_us);
+	return pm_states[index];
+}
+
+void z_pm_governor_idle_exit(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (in_idle) {
+		in_idle = false;
+		wake_pending = true;
+		wake_attributed = false;
+		wake_time = stamp_now();
+		wake_source = (wake_time.ticks >= idle_deadline) ?
+			      PM_GOVERNOR_SOURCE_TIMER :
+			      PM_GOVERNOR_SOURCE_OTHER;
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+void pm_governor_wakeup_source(uint8_t source)
+{
+	k_spinlock_key_t key;
+
+	__ASSERT(source < NUM_SOURCES, "invalid wake-up source %u", source);
+
+	key = k_spin_lock(&lock);
+	if (wake_pending && !wake_attributed) {
+		wake_attributed = true;
+		wake_source = source;
+	}
+	k_spin_unlock(&lock, key);
+}
+
+int pm_governor_stats_get(uint8_t index, struct pm_governor_stats *st)
+{
+	k_spinlock_key_t key;
+
+	if (index == PM_GOVERNOR_STATE_CPU_IDLE) {
+		index = NUM_STATES;
+	} else if (index >= NUM_STATES) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+	*st = stats[index];
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+void pm_governor_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	(void)memset(sources, 0, sizeof(sources));
+	(void)memset(stats, 0, sizeof(stats));
+	in_idle = false;
+	wake_pending = false;
+
+	k_spin_unlock(&lock, key);
+}
+
+__weak bool pm_policy_low_power_devices(enum pm_state state)
+{
+	return pm_is_sleep_state(state);
+}
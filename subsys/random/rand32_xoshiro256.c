@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* xoshiro256** generator, with one state per CPU.
+ *
+ * The algorithm is xoshiro256** 1.0 by David Blackman and Sebastiano Vigna
+ * (vigna@acm.org), see <http://prng.di.unimi.it/>. It has 256 bits of
+ * state, passes all the known statistical tests and generates 64 bits per
+ * step with a handful of shifts, rotations and additions.
+ *
+ * Each CPU has its own state, so generating numbers takes no lock shared
+ * between CPUs: interrupts are only masked locally while the state of the
+ * current CPU is updated, which also keeps the thread on that CPU. The
+ * states are seeded from the entropy driver at boot, and entropy is mixed
+ * in again every CONFIG_XOSHIRO_RESEED_INTERVAL outputs, when the driver
+ * can provide it without blocking.
+ *
+ * This is not a cryptographically secure generator.
+ */
+
+#include <init.h>
+#include <device.h>
+#include <drivers/entropy.h>
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <string.h>
+
+/* Bytes generated at most with interrupts masked by sys_rand_get() */
+#define FILL_CHUNK 256
+
+/* Outputs before retrying a reseed for which no entropy was available */
+#define RESEED_RETRY 1024
+
+struct rng_state {
+	uint64_t s[4];
+	int32_t budget;
+} __aligned(64);
+
+static struct rng_state states[CONFIG_MP_NUM_CPUS];
+static const struct device *entropy_dev;
+
+static inline uint64_t rotl(const uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t xoshiro256_next(struct rng_state *state)
+{
+	uint64_t *s = state->s;
+	const uint64_t result = rotl(s[1] * 5, 7) * 9;
+	const uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+
+	s[2] ^= t;
+
+	s[3] = rotl(s[3], 45);
+
+	return result;
+}
+
+/* Used to expand seeds, and to avoid an all zero state */
+static uint64_t splitmix64(uint64_t *x)
+{
+	uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+	return z ^ (z >> 31);
+}
+
+static void mix_seed(struct rng_state *state, const uint64_t seed[4],
+		     uint64_t salt)
+{
+	uint64_t x = salt;
+
+	for (int i = 0; i < 4; i++) {
+		state->s[i] ^= seed[i] ^ splitmix64(&x);
+	}
+
+	if ((state->s[0] | state->s[1] | state->s[2] | state->s[3]) == 0U) {
+		state->s[0] = splitmix64(&x);
+	}
+}
+
+/* Called with interrupts masked */
+static void reseed(struct rng_state *state)
+{
+	uint64_t seed[4] = { 0 };
+	int rc = -ENODEV;
+
+	if (CONFIG_XOSHIRO_RESEED_INTERVAL == 0) {
+		state->budget = INT32_MAX;
+		return;
+	}
+
+	if (entropy_dev != NULL) {
+		rc = entropy_get_entropy_isr(entropy_dev, (uint8_t *)seed,
+					     sizeof(seed), 0);
+	}
+
+	if (rc <= 0) {
+		state->budget = RESEED_RETRY;
+		return;
+	}
+
+	mix_seed(state, seed, xoshiro256_next(state));
+	state->budget = CONFIG_XOSHIRO_RESEED_INTERVAL;
+}
+
+static inline struct rng_state *lock_state(unsigned int *key)
+{
+	*key = arch_irq_lock();
+
+	return &states[_current_cpu->id];
+}
+
+static int xoshiro256_initialize(const struct device *dev)
+{
+	uint64_t seed[4];
+	int32_t rc;
+
+	ARG_UNUSED(dev);
+
+	entropy_dev = device_get_binding(DT_CHOSEN_ZEPHYR_ENTROPY_LABEL);
+	if (entropy_dev == NULL) {
+		return -EINVAL;
+	}
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		rc = entropy_get_entropy_isr(entropy_dev, (uint8_t *)seed,
+					     sizeof(seed), ENTROPY_BUSYWAIT);
+		if (rc == -ENOTSUP) {
+			/* Driver does not provide an ISR-specific API,
+			 * assume it can be called from ISR context
+			 */
+			rc = entropy_get_entropy(entropy_dev, (uint8_t *)seed,
+						 sizeof(seed));
+		}
+
+		if (rc < 0) {
+			return -EINVAL;
+		}
+
+		/* The salt keeps the states apart even if the driver
+		 * repeats itself
+		 */
+		mix_seed(&states[i], seed, i);
+		states[i].budget = (CONFIG_XOSHIRO_RESEED_INTERVAL == 0) ?
+				   INT32_MAX : CONFIG_XOSHIRO_RESEED_INTERVAL;
+	}
+
+	return 0;
+}
+
+uint32_t z_impl_sys_rand32_get(void)
+{
+	struct rng_state *state;
+	unsigned int key;
+	uint64_t ret;
+
+	state = lock_state(&key);
+
+	if (--state->budget <= 0) {
+		reseed(state);
+	}
+
+	ret = xoshiro256_next(state);
+
+	arch_irq_unlock(key);
+
+	/* The upper bits are the best ones */
+	return (uint32_t)(ret >> 32);
+}
+
+void z_impl_sys_rand_get(void *dst, size_t outlen)
+{
+	uint8_t *udst = dst;
+
+	while (outlen > 0) {
+		size_t chunk = MIN(outlen, FILL_CHUNK);
+		struct rng_state *state;
+		unsigned int key;
+		uint64_t ret;
+
+		outlen -= chunk;
+
+		state = lock_state(&key);
+
+		state->budget -= DIV_ROUND_UP(chunk, sizeof(ret));
+		if (state->budget <= 0) {
+			reseed(state);
+		}
+
+		for (; chunk >= sizeof(ret); chunk -= sizeof(ret)) {
+			ret = xoshiro256_next(state);
+			(void)memcpy(udst, &ret, sizeof(ret));
+			udst += sizeof(ret);
+		}
+
+		if (chunk > 0) {
+			ret = xoshiro256_next(state);
+			(void)memcpy(udst, &ret, chunk);
+			udst += chunk;
+		}
+
+		arch_irq_unlock(key);
+	}
+}
+
+/* In-tree entropy drivers will initialize in PRE_KERNEL_1; ensure that they're
+ * initialized properly before initializing ourselves.
+ */
+SYS_INIT(xoshiro256_initialize, PRE_KERNEL_2,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -0,0 +1,97 @@
+/* event_b.c */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "master.h"
+
+#ifdef EVENT_BENCH
+
+#define EVENT_ALL_MASK (BIT(0) | BIT(1) | BIT(2) | BIT(3))
+
+/**
+ *
+ * @brief Event object signal speed test
+ *
+ * Compares k_event against the traditional ways of emulating event flags:
+ * a poll signal waited on with k_poll(), and one semaphore per flag.
+ *
+ * @return N/A
+ */
+void event_test(void)
+{
+	uint32_t et; /* elapsed Time */
+	int i;
+	struct k_sem *sems[] = { &SEM1, &SEM2, &SEM3, &SEM4 };
+
+	PRINT_STRING(dashline, output_file);
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_EVENT_RUNS; i++) {
+		k_event_post(&EVENT0, BIT(0));
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT, "post event",
+		SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_EVENT_RUNS));
+
+	k_event_set(&EVENT0, 0);
+	for (i = 0; i < ARRAY_SIZE(sems); i++) {
+		k_sem_reset(sems[i]);
+	}
+	k_sem_give(&STARTRCV);
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_EVENT_RUNS; i++) {
+		k_event_post(&EVENT0, BIT(0));
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT, "post event to waiting high pri task",
+		SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_EVENT_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_EVENT_RUNS; i++) {
+		k_event_post(&EVENT0, BIT(0));
+		k_event_post(&EVENT0, BIT(1));
+		k_event_post(&EVENT0, BIT(2));
+		k_event_post(&EVENT0, BIT(3));
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT,
+		"post 4 events to high pri task waiting for all",
+		SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_EVENT_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_EVENT_RUNS; i++) {
+		k_poll_signal_raise(&EVENT_SIGNAL, 0);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT,
+		"emulation: raise poll signal to polling high pri task",
+		SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_EVENT_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_EVENT_RUNS; i++) {
+		k_sem_give(&SEM1);
+		k_sem_give(&SEM2);
+		k_sem_give(&SEM3);
+		k_sem_give(&SEM4);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT,
+		"emulation: give 4 sems to high pri task waiting for all",
+		SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_EVENT_RUNS));
+}
+
+#endif /* EVENT_BENCH */
@@ -0,0 +1,52 @@
+/* event_r.c */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "receiver.h"
+#include "master.h"
+
+#ifdef EVENT_BENCH
+
+/* event object signal speed test */
+
+/**
+ *
+ * @brief Receive task (Wait for events)
+ *
+ * @return N/A
+ */
+void eventwaittask(void)
+{
+	struct k_poll_event poll_event;
+	int i;
+
+	for (i = 0; i < NR_OF_EVENT_RUNS; i++) {
+		k_event_wait(&EVENT0, BIT(0), true, K_FOREVER);
+	}
+
+	for (i = 0; i < NR_OF_EVENT_RUNS; i++) {
+		k_event_wait_all(&EVENT0, BIT(0) | BIT(1) | BIT(2) | BIT(3),
+				 true, K_FOREVER);
+	}
+
+	k_poll_event_init(&poll_event, K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &EVENT_SIGNAL);
+	for (i = 0; i < NR_OF_EVENT_RUNS; i++) {
+		k_poll(&poll_event, 1, K_FOREVER);
+		poll_event.state = K_POLL_STATE_NOT_READY;
+		k_poll_signal_reset(&EVENT_SIGNAL);
+	}
+
+	for (i = 0; i < NR_OF_EVENT_RUNS; i++) {
+		k_sem_take(&SEM1, K_FOREVER);
+		k_sem_take(&SEM2, K_FOREVER);
+		k_sem_take(&SEM3, K_FOREVER);
+		k_sem_take(&SEM4, K_FOREVER);
+	}
+}
+
+#endif /* EVENT_BENCH */
@@ -57,6 +57,9 @@ K_MBOX_DEFINE(MAILB1);
 
 K_MUTEX_DEFINE(DEMO_MUTEX);
 
+K_EVENT_DEFINE(EVENT0);
+struct k_poll_signal EVENT_SIGNAL = K_POLL_SIGNAL_INITIALIZER(EVENT_SIGNAL);
+
 K_PIPE_DEFINE(PIPE_NOBUFF, 0, 4);
 K_PIPE_DEFINE(PIPE_SMALLBUFF, 256, 4);
 K_PIPE_DEFINE(PIPE_BIGBUFF, 4096, 4);
@@ -134,6 +137,7 @@ void main(void)
 		memorymap_test();
 		mailbox_test();
 		pipe_test();
+		event_test();
 		PRINT_STRING("|         END OF TESTS                     "
 					 "                                   |\n",
 					 output_file);
@@ -122,6 +122,12 @@ extern void pipe_test(void);
 #define pipe_test dummy_test
 #endif
 
+#ifdef EVENT_BENCH
+extern void event_test(void);
+#else
+#define event_test dummy_test
+#endif
+
 /* kernel objects needed for benchmarking */
 extern struct k_mutex DEMO_MUTEX;
 
@@ -139,6 +145,9 @@ extern struct k_msgq CH_COMM;
 
 extern struct k_mbox MAILB1;
 
+extern struct k_event EVENT0;
+extern struct k_poll_signal EVENT_SIGNAL;
+
 
 extern struct k_pipe PIPE_NOBUFF;
 extern struct k_pipe PIPE_SMALLBUFF;
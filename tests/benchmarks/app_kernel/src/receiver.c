@@ -23,6 +23,7 @@ void dequtask(void);
 void waittask(void);
 void mailrecvtask(void);
 void piperecvtask(void);
+void eventwaittask(void);
 
 /**
  *
@@ -49,4 +50,8 @@ void recvtask(void *p1, void *p2, void *p3)
 	k_sem_take(&STARTRCV, K_FOREVER);
 	piperecvtask();
 #endif
+#ifdef EVENT_BENCH
+	k_sem_take(&STARTRCV, K_FOREVER);
+	eventwaittask();
+#endif
 }
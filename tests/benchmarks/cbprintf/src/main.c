@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/cbprintf.h>
+#include <timing/timing.h>
+
+/* Cost per call of common formats, in cycles of the timing functions:
+ *
+ * - direct: cbprintf(), which parses the format and converts the arguments
+ *   at the call site,
+ * - pack: CBPRINTF_STATIC_PACKAGE(), which only copies the arguments at the
+ *   call site, e.g. for deferred logging,
+ * - render: cbpprintf() of that package, done later or elsewhere.
+ *
+ * The output goes to a callback discarding the characters.
+ */
+
+#define ITERATIONS 1000
+
+/* Arguments are read from volatile variables, as they would be computed at
+ * a real call site, so that the compiler can't hoist the packaging out of
+ * the loop.
+ */
+static volatile int v_int = -1234;
+static volatile unsigned int v_uint = 0xdeadbeef;
+static volatile long long v_ll = 123456789012LL;
+static const char *volatile v_str = "sensor";
+static volatile double v_dbl = 3.14159;
+
+static int null_out(int c, void *ctx)
+{
+	ARG_UNUSED(ctx);
+
+	return c;
+}
+
+static void report(const char *fmt, uint64_t direct, uint64_t pack,
+		   uint64_t render)
+{
+	printk("%-24s direct %6u pack %6u render %6u cycles\n", fmt,
+	       (uint32_t)(direct / ITERATIONS), (uint32_t)(pack / ITERATIONS),
+	       (uint32_t)(render / ITERATIONS));
+}
+
+#define BENCH_FORMAT(...) do { \
+	uint8_t pkg[CBPRINTF_STATIC_PACKAGE_SIZE(__VA_ARGS__)]; \
+	uint64_t direct, pack, render; \
+	timing_t start, end; \
+	int len; \
+	\
+	start = timing_counter_get(); \
+	for (int i = 0; i < ITERATIONS; i++) { \
+		(void)cbprintf(null_out, NULL, __VA_ARGS__); \
+	} \
+	end = timing_counter_get(); \
+	direct = timing_cycles_get(&start, &end); \
+	\
+	start = timing_counter_get(); \
+	for (int i = 0; i < ITERATIONS; i++) { \
+		CBPRINTF_STATIC_PACKAGE(pkg, sizeof(pkg), len, __VA_ARGS__); \
+		compiler_barrier(); \
+	} \
+	end = timing_counter_get(); \
+	pack = timing_cycles_get(&start, &end); \
+	\
+	start = timing_counter_get(); \
+	for (int i = 0; i < ITERATIONS; i++) { \
+		(void)cbpprintf(null_out, NULL, pkg); \
+	} \
+	end = timing_counter_get(); \
+	render = timing_cycles_get(&start, &end); \
+	\
+	if (len < 0) { \
+		printk("%s: packaging failed %d\n", GET_ARG_N(1, __VA_ARGS__), \
+		       len); \
+	} else { \
+		report(GET_ARG_N(1, __VA_ARGS__), direct, pack, render); \
+	} \
+} while (false)
+
+void main(void)
+{
+	timing_init();
+	timing_start();
+
+	printk("cbprintf %s, cycles per call at %u MHz\n",
+	       IS_ENABLED(CONFIG_CBPRINTF_NANO) ? "nano" : "complete",
+	       timing_freq_get_mhz());
+
+	BENCH_FORMAT("constant string");
+	BENCH_FORMAT("%d", v_int);
+	BENCH_FORMAT("%u %x", v_uint, v_uint);
+	BENCH_FORMAT("%08x", v_uint);
+	BENCH_FORMAT("%s", v_str);
+	BENCH_FORMAT("%s: %d %d %d", v_str, v_int, v_int, v_int);
+	BENCH_FORMAT("%lld", v_ll);
+	BENCH_FORMAT("%p", (void *)v_str);
+
+	if (IS_ENABLED(CONFIG_CBPRINTF_FP_SUPPORT)) {
+		BENCH_FORMAT("%f", v_dbl);
+		BENCH_FORMAT("%s %.3f", v_str, v_dbl);
+	}
+
+	timing_stop();
+
+	printk("fin\n");
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <device.h>
+#include <sys/crc.h>
+#include <sys/printk.h>
+#include <drivers/crc.h>
+#include <timing/timing.h>
+
+/* Throughput of the CRC implementations selected by Kconfig, on a buffer
+ * large enough to hide the call overhead. The calculation unit is measured
+ * as well when the board has one enabled.
+ */
+
+#define BUF_SIZE 4096
+#define ITERATIONS 16
+
+static uint8_t buf[BUF_SIZE];
+static volatile uint32_t sink;
+
+#define BENCH(name, expr) do { \
+	timing_t start, end; \
+	uint64_t cycles; \
+	\
+	start = timing_counter_get(); \
+	for (int i = 0; i < ITERATIONS; i++) { \
+		sink = (expr); \
+	} \
+	end = timing_counter_get(); \
+	cycles = timing_cycles_get(&start, &end); \
+	report(name, cycles); \
+} while (false)
+
+static void report(const char *name, uint64_t cycles)
+{
+	uint64_t ns = timing_cycles_to_ns(cycles);
+	uint64_t bytes = (uint64_t)BUF_SIZE * ITERATIONS;
+
+	/* bytes per ms is KB/s */
+	printk("%-16s %8u KB/s %6u cycles/KB\n", name,
+	       (uint32_t)((ns != 0U) ? (bytes * 1000000U / ns) : 0U),
+	       (uint32_t)(cycles * 1024U / bytes));
+}
+
+static const char *implementation(void)
+{
+	if (IS_ENABLED(CONFIG_CRC32_SLICE_BY_8)) {
+		return "slice-by-8";
+	} else if (IS_ENABLED(CONFIG_CRC32_SLICE_BY_4)) {
+		return "slice-by-4";
+	} else if (IS_ENABLED(CONFIG_CRC32_BYTE_TABLE)) {
+		return "byte table";
+	}
+
+	return "nibble table";
+}
+
+#if DT_HAS_COMPAT_STATUS_OKAY(st_stm32_crc)
+#define CRC_DEV_LABEL DT_LABEL(DT_INST(0, st_stm32_crc))
+
+static uint32_t crc_dev_compute(const struct device *dev, enum crc_type type)
+{
+	uint32_t result = 0;
+
+	(void)crc_compute(dev, type, 0, buf, sizeof(buf), &result);
+
+	return result;
+}
+#endif
+
+static void bench_device(void)
+{
+#ifdef CRC_DEV_LABEL
+	const struct device *dev = device_get_binding(CRC_DEV_LABEL);
+	uint32_t result;
+
+	if ((dev == NULL) ||
+	    (crc_compute(dev, CRC_TYPE_CRC32_IEEE, 0, buf, sizeof(buf),
+			 &result) != 0)) {
+		printk("%s not available\n", CRC_DEV_LABEL);
+		return;
+	}
+
+	if (result != crc32_ieee(buf, sizeof(buf))) {
+		printk("%s: CRC-32 mismatch\n", CRC_DEV_LABEL);
+		return;
+	}
+
+	BENCH("dev crc32_ieee", crc_dev_compute(dev, CRC_TYPE_CRC32_IEEE));
+	BENCH("dev crc16_ccitt", crc_dev_compute(dev, CRC_TYPE_CRC16_CCITT));
+#endif
+}
+
+void main(void)
+{
+	uint32_t seed = 1;
+
+	for (size_t i = 0; i < sizeof(buf); i++) {
+		seed = seed * 1103515245U + 12345U;
+		buf[i] = seed >> 16;
+	}
+
+	timing_init();
+	timing_start();
+
+	printk("CRC throughput, %s, %u byte buffer\n", implementation(),
+	       BUF_SIZE);
+
+	BENCH("crc32_ieee", crc32_ieee(buf, sizeof(buf)));
+	BENCH("crc16_ccitt", crc16_ccitt(0xffff, buf, sizeof(buf)));
+	BENCH("crc16_itu_t", crc16_itu_t(0, buf, sizeof(buf)));
+	BENCH("crc16", crc16(buf, sizeof(buf), 0x1021, 0, true));
+	BENCH("crc8_ccitt", crc8_ccitt(0xff, buf, sizeof(buf)));
+
+	bench_device();
+
+	timing_stop();
+
+	printk("fin\n");
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief Hash map performance, compared to rbtree and dlist
+ *
+ * @defgroup lib_hash_map_tests Hash map
+ */
+
+#include <ztest.h>
+#include <sys/dlist.h>
+#include <sys/hash.h>
+#include <sys/hash_map.h>
+#include <sys/rb.h>
+#include <timing/timing.h>
+
+#define NUM_NODES 512
+#define NUM_SLOTS 1024
+
+/* The same keys are stored in the three data structures */
+struct item {
+	struct sys_hash_node hnode;
+	struct rbnode rbnode;
+	sys_dnode_t dnode;
+	uint32_t key;
+};
+
+static struct item items[NUM_NODES];
+static uint32_t order[NUM_NODES];
+
+static bool item_eq(const struct sys_hash_node *node, const void *key)
+{
+	return CONTAINER_OF(node, struct item, hnode)->key ==
+	       *(const uint32_t *)key;
+}
+
+SYS_HASH_MAP_DEFINE(map, NUM_SLOTS, item_eq);
+
+static bool item_lessthan(struct rbnode *a, struct rbnode *b)
+{
+	return CONTAINER_OF(a, struct item, rbnode)->key <
+	       CONTAINER_OF(b, struct item, rbnode)->key;
+}
+
+static struct rbtree tree = {
+	.lessthan_fn = item_lessthan,
+};
+
+static sys_dlist_t list = SYS_DLIST_STATIC_INIT(&list);
+
+static struct item *rb_find(uint32_t key)
+{
+	struct rbnode *node = tree.root;
+
+	while (node != NULL) {
+		struct item *item = CONTAINER_OF(node, struct item, rbnode);
+
+		if (item->key == key) {
+			return item;
+		}
+
+		node = z_rb_child(node, item->key < key);
+	}
+
+	return NULL;
+}
+
+static struct item *dlist_find(uint32_t key)
+{
+	struct item *item;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&list, item, dnode) {
+		if (item->key == key) {
+			return item;
+		}
+	}
+
+	return NULL;
+}
+
+static struct item *hash_map_find(uint32_t key)
+{
+	struct sys_hash_node *node;
+
+	node = sys_hash_map_get(&map, sys_hash32_u32(key), &key);
+
+	return (node == NULL) ? NULL : CONTAINER_OF(node, struct item, hnode);
+}
+
+enum ds {
+	DS_HASH_MAP,
+	DS_RBTREE,
+	DS_DLIST,
+	NUM_DS
+};
+
+static const char *const ds_names[NUM_DS] = {
+	"hash_map", "rbtree", "dlist"
+};
+
+static void ds_insert(enum ds ds, struct item *item)
+{
+	switch (ds) {
+	case DS_HASH_MAP:
+		zassert_equal(sys_hash_map_insert(&map, &item->hnode,
+						  sys_hash32_u32(item->key),
+						  &item->key),
+			      0, "hash map insertion failed");
+		break;
+	case DS_RBTREE:
+		rb_insert(&tree, &item->rbnode);
+		break;
+	default:
+		sys_dlist_append(&list, &item->dnode);
+		break;
+	}
+}
+
+static struct item *ds_find(enum ds ds, uint32_t key)
+{
+	switch (ds) {
+	case DS_HASH_MAP:
+		return hash_map_find(key);
+	case DS_RBTREE:
+		return rb_find(key);
+	default:
+		return dlist_find(key);
+	}
+}
+
+static void ds_delete(enum ds ds, struct item *item)
+{
+	switch (ds) {
+	case DS_HASH_MAP:
+		zassert_true(sys_hash_map_remove_node(&map, &item->hnode),
+			     "hash map removal failed");
+		break;
+	case DS_RBTREE:
+		rb_remove(&tree, &item->rbnode);
+		break;
+	default:
+		sys_dlist_remove(&item->dnode);
+		break;
+	}
+}
+
+static void init_items(void)
+{
+	uint32_t seed = 2463534242U;
+
+	for (uint32_t i = 0; i < NUM_NODES; i++) {
+		/* sparse keys, as identifiers or addresses would be */
+		items[i].key = (i * 2654435761U) << 1;
+		order[i] = i;
+	}
+
+	/* Shuffle the access order so that it differs from the insertion
+	 * order
+	 */
+	for (uint32_t i = NUM_NODES - 1; i > 0; i--) {
+		uint32_t j, tmp;
+
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		j = seed % (i + 1);
+		tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+}
+
+/**
+ * @brief Compare the time of insertions, lookups and deletions in a hash
+ * map, a rbtree and a dlist
+ *
+ * @details Insert NUM_NODES items in each data structure, look up each
+ * item and a missing key, then delete the items, in a different order
+ * than they were inserted. The average number of cycles per operation is
+ * printed.
+ *
+ * @ingroup lib_hash_map_tests
+ *
+ * @see sys_hash_map_insert(), sys_hash_map_get(),
+ * sys_hash_map_remove_node()
+ */
+void test_hash_map_perf(void)
+{
+	timing_t start, end;
+
+	init_items();
+
+	timing_init();
+	timing_start();
+
+	TC_PRINT("%-10s %10s %10s %10s %10s\n", "cyc/op", "insert",
+		 "lookup", "miss", "delete");
+
+	for (enum ds ds = DS_HASH_MAP; ds < NUM_DS; ds++) {
+		uint64_t insert_cyc, lookup_cyc, miss_cyc, delete_cyc;
+
+		start = timing_counter_get();
+		for (int i = 0; i < NUM_NODES; i++) {
+			ds_insert(ds, &items[i]);
+		}
+		end = timing_counter_get();
+		insert_cyc = timing_cycles_get(&start, &end);
+
+		start = timing_counter_get();
+		for (int i = 0; i < NUM_NODES; i++) {
+			struct item *item = &items[order[i]];
+
+			zassert_equal(ds_find(ds, item->key), item,
+				      "%s lookup failed", ds_names[ds]);
+		}
+		end = timing_counter_get();
+		lookup_cyc = timing_cycles_get(&start, &end);
+
+		start = timing_counter_get();
+		for (int i = 0; i < NUM_NODES; i++) {
+			/* odd keys are never stored */
+			zassert_is_null(ds_find(ds, 2 * i + 1),
+					"%s found a missing key", ds_names[ds]);
+		}
+		end = timing_counter_get();
+		miss_cyc = timing_cycles_get(&start, &end);
+
+		start = timing_counter_get();
+		for (int i = 0; i < NUM_NODES; i++) {
+			ds_delete(ds, &items[order[i]]);
+		}
+		end = timing_counter_get();
+		delete_cyc = timing_cycles_get(&start, &end);
+
+		TC_PRINT("%-10s %10u %10u %10u %10u\n", ds_names[ds],
+			 (uint32_t)(insert_cyc / NUM_NODES),
+			 (uint32_t)(lookup_cyc / NUM_NODES),
+			 (uint32_t)(miss_cyc / NUM_NODES),
+			 (uint32_t)(delete_cyc / NUM_NODES));
+	}
+
+	timing_stop();
+
+	zassert_equal(sys_hash_map_count(&map), 0, "hash map not empty");
+	zassert_is_null(tree.root, "rbtree not empty");
+	zassert_true(sys_dlist_is_empty(&list), "dlist not empty");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(hash_map,
+			 ztest_unit_test(test_hash_map_perf)
+			 );
+	ztest_run_test_suite(hash_map);
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/btree.h>
+#include <sys/rb.h>
+#include <timing/timing.h>
+
+#define MAX_ELEMS CONFIG_DS_PERF_MAX_ELEMENTS
+
+/* Worst case number of nodes, when they are all half full */
+#define HALF_ORDER (SYS_BTREE_ORDER / 2)
+#define MAX_BTREE_NODES (MAX_ELEMS / HALF_ORDER + \
+			 MAX_ELEMS / (HALF_ORDER * HALF_ORDER) + 16)
+
+struct elem {
+	struct rbnode node;
+	uint32_t key;
+};
+
+static struct elem elems[MAX_ELEMS];
+
+/* Keys in insertion order, and sorted for the bulk load */
+static uint32_t order[MAX_ELEMS];
+static uintptr_t sorted_keys[MAX_ELEMS];
+static void *sorted_values[MAX_ELEMS];
+
+static struct rbtree rb;
+static struct sys_btree bt;
+
+K_MEM_SLAB_DEFINE(btree_slab, sizeof(struct sys_btree_node), MAX_BTREE_NODES,
+		  sizeof(void *));
+
+static void *btree_alloc(void *ptr, size_t size)
+{
+	if (ptr == NULL) {
+		return (k_mem_slab_alloc(&btree_slab, &ptr, K_NO_WAIT) == 0) ?
+		       ptr : NULL;
+	}
+
+	k_mem_slab_free(&btree_slab, &ptr);
+
+	return NULL;
+}
+
+static bool elem_lessthan(struct rbnode *a, struct rbnode *b)
+{
+	return CONTAINER_OF(a, struct elem, node)->key <
+	       CONTAINER_OF(b, struct elem, node)->key;
+}
+
+static struct elem *rb_find(uint32_t key)
+{
+	struct rbnode *node = rb.root;
+
+	while (node != NULL) {
+		struct elem *e = CONTAINER_OF(node, struct elem, node);
+
+		if (e->key == key) {
+			return e;
+		}
+
+		node = z_rb_child(node, e->key < key);
+	}
+
+	return NULL;
+}
+
+static void init_elems(int n)
+{
+	uint32_t seed = 2463534242U;
+
+	for (int i = 0; i < n; i++) {
+		elems[i].key = 3 * i;
+		sorted_keys[i] = elems[i].key;
+		sorted_values[i] = &elems[i];
+		order[i] = i;
+	}
+
+	/* Insert and look up in random order */
+	for (int i = n - 1; i > 0; i--) {
+		uint32_t j, tmp;
+
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		j = seed % (i + 1);
+		tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+}
+
+static uint32_t per_elem(timing_t *start, timing_t *end, int n)
+{
+	return (uint32_t)(timing_cycles_get(start, end) / n);
+}
+
+static void compare(int n)
+{
+	uint32_t rb_insert_cyc, rb_find_cyc, rb_iter_cyc;
+	uint32_t bt_insert_cyc, bt_find_cyc, bt_iter_cyc, bt_load_cyc;
+	struct sys_btree_iter it;
+	struct rbnode *node;
+	timing_t start, end;
+	uintptr_t key;
+	void *value;
+	int count;
+
+	init_elems(n);
+	(void)memset(&rb, 0, sizeof(rb));
+	rb.lessthan_fn = elem_lessthan;
+	sys_btree_init(&bt, btree_alloc);
+
+	/* rbtree */
+	start = timing_counter_get();
+	for (int i = 0; i < n; i++) {
+		rb_insert(&rb, &elems[order[i]].node);
+	}
+	end = timing_counter_get();
+	rb_insert_cyc = per_elem(&start, &end, n);
+
+	start = timing_counter_get();
+	for (int i = 0; i < n; i++) {
+		zassert_equal(rb_find(elems[order[i]].key), &elems[order[i]],
+			      "rbtree lookup failed");
+	}
+	end = timing_counter_get();
+	rb_find_cyc = per_elem(&start, &end, n);
+
+	count = 0;
+	start = timing_counter_get();
+	RB_FOR_EACH(&rb, node) {
+		count++;
+	}
+	end = timing_counter_get();
+	rb_iter_cyc = per_elem(&start, &end, n);
+	zassert_equal(count, n, "rbtree iteration failed");
+
+	/* btree */
+	start = timing_counter_get();
+	for (int i = 0; i < n; i++) {
+		zassert_equal(sys_btree_insert(&bt, elems[order[i]].key,
+					       &elems[order[i]]),
+			      0, "btree insertion failed");
+	}
+	end = timing_counter_get();
+	bt_insert_cyc = per_elem(&start, &end, n);
+
+	start = timing_counter_get();
+	for (int i = 0; i < n; i++) {
+		zassert_equal(sys_btree_get(&bt, elems[order[i]].key),
+			      &elems[order[i]], "btree lookup failed");
+	}
+	end = timing_counter_get();
+	bt_find_cyc = per_elem(&start, &end, n);
+
+	count = 0;
+	start = timing_counter_get();
+	SYS_BTREE_FOR_EACH(&bt, it, key, value) {
+		count++;
+	}
+	end = timing_counter_get();
+	bt_iter_cyc = per_elem(&start, &end, n);
+	zassert_equal(count, n, "btree iteration failed");
+
+	sys_btree_clear(&bt);
+
+	start = timing_counter_get();
+	zassert_equal(sys_btree_load(&bt, sorted_keys, sorted_values, n), 0,
+		      "btree bulk load failed");
+	end = timing_counter_get();
+	bt_load_cyc = per_elem(&start, &end, n);
+
+	sys_btree_clear(&bt);
+
+	TC_PRINT("%6d rbtree %8u %8u %8u %8s\n", n, rb_insert_cyc,
+		 rb_find_cyc, rb_iter_cyc, "-");
+	TC_PRINT("%6d btree  %8u %8u %8u %8u\n", n, bt_insert_cyc,
+		 bt_find_cyc, bt_iter_cyc, bt_load_cyc);
+}
+
+/**
+ * @brief Compare the throughput of rbtree and btree
+ *
+ * @details Insert elements in random order in a rbtree and a btree, look
+ * each of them up, and iterate over the trees, at 100, 1000 and 10000
+ * elements up to CONFIG_DS_PERF_MAX_ELEMENTS. The average number of
+ * cycles per element is printed for each operation, and for the bulk
+ * load of the btree.
+ *
+ * @ingroup lib_rbtree_tests
+ *
+ * @see rb_insert(), sys_btree_insert(), sys_btree_get(), sys_btree_load()
+ */
+void test_rbtree_btree_compare(void)
+{
+	timing_init();
+	timing_start();
+
+	TC_PRINT("%6s %-6s %8s %8s %8s %8s\n", "elems", "cyc", "insert",
+		 "find", "iterate", "load");
+
+	for (int n = 100; n <= MAX_ELEMS; n *= 10) {
+		compare(n);
+	}
+
+	timing_stop();
+}
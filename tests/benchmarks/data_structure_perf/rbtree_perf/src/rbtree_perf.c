@@ -207,11 +207,14 @@ void test_rbtree_perf(void)
 	verify_rbtree_perf(root, test);
 }
 
+extern void test_rbtree_btree_compare(void);
+
 void test_main(void)
 {
 	ztest_test_suite(rbtree,
 			 ztest_unit_test(test_rbtree_container),
-			 ztest_unit_test(test_rbtree_perf)
+			 ztest_unit_test(test_rbtree_perf),
+			 ztest_unit_test(test_rbtree_btree_compare)
 			 );
 	ztest_run_test_suite(rbtree);
 }
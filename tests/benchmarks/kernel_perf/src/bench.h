@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _KERNEL_PERF_BENCH_H
+#define _KERNEL_PERF_BENCH_H
+
+#include <zephyr.h>
+#include <timing/timing.h>
+
+/* Number of measured operations per result */
+#define BENCH_ITERATIONS 1000
+
+/* Number of operations done back to back, for objects of bounded size */
+#define BENCH_BATCH 32
+
+#define BENCH_STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+/* The benchmark runs at BENCH_PRIO. Threads woken by the measured
+ * primitives run at BENCH_PRIO_HIGH to preempt it, or at BENCH_PRIO
+ * to be picked by another CPU in the SMP variant.
+ */
+#define BENCH_PRIO 5
+#define BENCH_PRIO_HIGH 4
+#define BENCH_PRIO_LOW 6
+
+static inline timing_t bench_start(void)
+{
+	return timing_counter_get();
+}
+
+static inline uint64_t bench_stop(timing_t start)
+{
+	timing_t end = timing_counter_get();
+
+	return timing_cycles_get(&start, &end);
+}
+
+/**
+ * @brief Emit one result of the JSON report
+ *
+ * @param primitive Measured kernel primitive, e.g. "sem".
+ * @param variant One of "uncontended", "contended", "isr" or "smp".
+ * @param op Measured operation, e.g. "give".
+ * @param iterations Number of operations measured.
+ * @param cycles Total number of timing cycles for all the operations.
+ */
+void bench_report(const char *primitive, const char *variant, const char *op,
+		  uint32_t iterations, uint64_t cycles);
+
+/**
+ * Wake-up latency measurement of a blocking primitive
+ *
+ * The "contended" variant measures the time from signal(), called by the
+ * benchmark thread, to the return of wait() in a higher priority thread.
+ * The "isr" variant calls signal() from an ISR instead. The "smp" variant
+ * wakes a thread of the benchmark's priority, which thus runs on another
+ * CPU, and measures on the benchmark's CPU the time until the woken thread
+ * reports back.
+ */
+struct bench_wake_ops {
+	/** Blocks the waiter until signal(). NULL if signal() leads to
+	 * bench_wake_mark() in @ref thread without a waiter.
+	 */
+	void (*wait)(void);
+
+	/** Wakes the waiter */
+	void (*signal)(void);
+
+	/** Optional, arms the waiter before each signal() */
+	void (*prepare)(void);
+
+	/** Thread reaching bench_wake_mark(), when wait is NULL */
+	struct k_thread *thread;
+
+	/** signal() may be called from an ISR */
+	bool isr_ok;
+};
+
+/** @brief Run the wake-up variants of a primitive */
+void bench_wake_run(const char *primitive, const char *op,
+		    const struct bench_wake_ops *ops);
+
+/** @brief Record the wake-up time, from the woken context */
+void bench_wake_mark(void);
+
+/** @brief Woken thread when struct bench_wake_ops::wait is used */
+struct k_thread *bench_wake_thread(void);
+
+void bench_sem(void);
+void bench_mutex(void);
+void bench_msgq(void);
+void bench_fifo(void);
+void bench_pipe(void);
+void bench_poll(void);
+void bench_work(void);
+void bench_timer(void);
+void bench_heap(void);
+void bench_slab(void);
+void bench_ctx_switch(void);
+
+#endif /* _KERNEL_PERF_BENCH_H */
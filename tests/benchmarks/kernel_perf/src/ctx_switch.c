@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include "bench.h"
+
+K_THREAD_STACK_DEFINE(yield_stack, BENCH_STACK_SIZE);
+static struct k_thread yield_thread;
+static volatile bool yielding;
+
+static void yield_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (yielding) {
+		k_yield();
+	}
+}
+
+static void suspend_wait(void)
+{
+	k_thread_suspend(k_current_get());
+}
+
+static void resume_signal(void)
+{
+	k_thread_resume(bench_wake_thread());
+}
+
+static const struct bench_wake_ops switch_ops = {
+	.wait = suspend_wait,
+	.signal = resume_signal,
+	.isr_ok = true,
+};
+
+void bench_ctx_switch(void)
+{
+	timing_t start;
+
+	/* No other thread ready at this priority: no switch */
+	start = bench_start();
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		k_yield();
+	}
+	bench_report("ctx_switch", "uncontended", "yield", BENCH_ITERATIONS,
+		     bench_stop(start));
+
+	/* Each yield switches to the other thread and back. On SMP the other
+	 * thread would run on another CPU instead.
+	 */
+	if (!IS_ENABLED(CONFIG_SMP)) {
+		yielding = true;
+		k_thread_create(&yield_thread, yield_stack,
+				K_THREAD_STACK_SIZEOF(yield_stack), yield_fn,
+				NULL, NULL, NULL, BENCH_PRIO, 0, K_NO_WAIT);
+
+		start = bench_start();
+		for (int i = 0; i < BENCH_ITERATIONS; i++) {
+			k_yield();
+		}
+		bench_report("ctx_switch", "contended", "yield",
+			     2 * BENCH_ITERATIONS, bench_stop(start));
+
+		yielding = false;
+		k_thread_join(&yield_thread, K_FOREVER);
+	}
+
+	bench_wake_run("ctx_switch", "resume", &switch_ops);
+}
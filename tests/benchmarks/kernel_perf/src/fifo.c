@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include "bench.h"
+
+struct fifo_item {
+	void *reserved;
+	uint32_t data;
+};
+
+static K_FIFO_DEFINE(test_fifo);
+static K_FIFO_DEFINE(wake_fifo);
+static struct fifo_item items[BENCH_BATCH];
+static struct fifo_item wake_item;
+
+static void fifo_wait(void)
+{
+	(void)k_fifo_get(&wake_fifo, K_FOREVER);
+}
+
+static void fifo_signal(void)
+{
+	k_fifo_put(&wake_fifo, &wake_item);
+}
+
+static const struct bench_wake_ops fifo_ops = {
+	.wait = fifo_wait,
+	.signal = fifo_signal,
+	.isr_ok = true,
+};
+
+void bench_fifo(void)
+{
+	uint64_t put_cycles = 0, get_cycles = 0;
+	timing_t start;
+
+	for (int i = 0; i < BENCH_ITERATIONS / BENCH_BATCH; i++) {
+		start = bench_start();
+		for (int j = 0; j < BENCH_BATCH; j++) {
+			k_fifo_put(&test_fifo, &items[j]);
+		}
+		put_cycles += bench_stop(start);
+
+		start = bench_start();
+		for (int j = 0; j < BENCH_BATCH; j++) {
+			(void)k_fifo_get(&test_fifo, K_NO_WAIT);
+		}
+		get_cycles += bench_stop(start);
+	}
+
+	bench_report("fifo", "uncontended", "put",
+		     BENCH_ITERATIONS / BENCH_BATCH * BENCH_BATCH, put_cycles);
+	bench_report("fifo", "uncontended", "get",
+		     BENCH_ITERATIONS / BENCH_BATCH * BENCH_BATCH, get_cycles);
+
+	bench_wake_run("fifo", "put_to_get", &fifo_ops);
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include "bench.h"
+
+#define BLOCK_SIZE 32
+#define WAKE_BLOCK_SIZE 512
+
+K_HEAP_DEFINE(test_heap, BENCH_BATCH * BLOCK_SIZE * 2);
+
+/* Too small for two wake-up blocks */
+K_HEAP_DEFINE(wake_heap, WAKE_BLOCK_SIZE * 3 / 2);
+
+static K_SEM_DEFINE(go_sem, 0, 1);
+static void *blocks[BENCH_BATCH];
+static void *main_block;
+static void *waiter_block;
+
+static void heap_prepare(void)
+{
+	/* Exhaust the heap, then let the waiter block on it */
+	main_block = k_heap_alloc(&wake_heap, WAKE_BLOCK_SIZE, K_NO_WAIT);
+	k_sem_give(&go_sem);
+}
+
+static void heap_wait(void)
+{
+	k_heap_free(&wake_heap, waiter_block);
+	waiter_block = NULL;
+
+	k_sem_take(&go_sem, K_FOREVER);
+	waiter_block = k_heap_alloc(&wake_heap, WAKE_BLOCK_SIZE, K_FOREVER);
+}
+
+static void heap_signal(void)
+{
+	k_heap_free(&wake_heap, main_block);
+}
+
+static const struct bench_wake_ops heap_ops = {
+	.wait = heap_wait,
+	.signal = heap_signal,
+	.prepare = heap_prepare,
+	.isr_ok = true,
+};
+
+void bench_heap(void)
+{
+	uint64_t alloc_cycles = 0, free_cycles = 0;
+	timing_t start;
+
+	for (int i = 0; i < BENCH_ITERATIONS / BENCH_BATCH; i++) {
+		start = bench_start();
+		for (int j = 0; j < BENCH_BATCH; j++) {
+			blocks[j] = k_heap_alloc(&test_heap, BLOCK_SIZE,
+						 K_NO_WAIT);
+		}
+		alloc_cycles += bench_stop(start);
+
+		start = bench_start();
+		for (int j = 0; j < BENCH_BATCH; j++) {
+			k_heap_free(&test_heap, blocks[j]);
+		}
+		free_cycles += bench_stop(start);
+	}
+
+	bench_report("heap", "uncontended", "alloc",
+		     BENCH_ITERATIONS / BENCH_BATCH * BENCH_BATCH,
+		     alloc_cycles);
+	bench_report("heap", "uncontended", "free",
+		     BENCH_ITERATIONS / BENCH_BATCH * BENCH_BATCH, free_cycles);
+
+	bench_wake_run("heap", "free_to_alloc", &heap_ops);
+}
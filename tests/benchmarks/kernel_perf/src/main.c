@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Runs every kernel primitive benchmark and reports the results as a
+ * single JSON document on the console, between two marker lines, for
+ * scripts/kernel_perf_compare.py.
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <version.h>
+#include "bench.h"
+
+static bool first_result = true;
+
+void bench_report(const char *primitive, const char *variant, const char *op,
+		  uint32_t iterations, uint64_t cycles)
+{
+	uint64_t avg = cycles / iterations;
+
+	printk("%s    {\"primitive\": \"%s\", \"variant\": \"%s\", "
+	       "\"op\": \"%s\", \"iterations\": %u, \"cycles\": %u, "
+	       "\"ns\": %u}",
+	       first_result ? "" : ",\n", primitive, variant, op, iterations,
+	       (uint32_t)avg,
+	       (uint32_t)timing_cycles_to_ns_avg(cycles, iterations));
+	first_result = false;
+}
+
+void main(void)
+{
+	k_thread_priority_set(k_current_get(), BENCH_PRIO);
+
+	timing_init();
+	timing_start();
+
+	printk("KERNEL_PERF_JSON_BEGIN\n");
+	printk("{\n");
+	printk("  \"board\": \"%s\",\n", CONFIG_BOARD);
+	printk("  \"kernel\": \"%s\",\n", KERNEL_VERSION_STRING);
+	printk("  \"cpus\": %d,\n", CONFIG_MP_NUM_CPUS);
+	printk("  \"timing_mhz\": %u,\n", timing_freq_get_mhz());
+	printk("  \"results\": [\n");
+
+	bench_sem();
+	bench_mutex();
+	bench_msgq();
+	bench_fifo();
+	bench_pipe();
+	bench_poll();
+	bench_work();
+	bench_timer();
+	bench_heap();
+	bench_slab();
+	bench_ctx_switch();
+
+	printk("\n  ]\n");
+	printk("}\n");
+	printk("KERNEL_PERF_JSON_END\n");
+
+	timing_stop();
+}
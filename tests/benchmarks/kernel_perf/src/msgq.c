@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include "bench.h"
+
+K_MSGQ_DEFINE(test_msgq, sizeof(uint32_t), BENCH_BATCH, 4);
+K_MSGQ_DEFINE(wake_msgq, sizeof(uint32_t), 1, 4);
+
+static void msgq_wait(void)
+{
+	uint32_t data;
+
+	k_msgq_get(&wake_msgq, &data, K_FOREVER);
+}
+
+static void msgq_signal(void)
+{
+	uint32_t data = 0;
+
+	k_msgq_put(&wake_msgq, &data, K_NO_WAIT);
+}
+
+static const struct bench_wake_ops msgq_ops = {
+	.wait = msgq_wait,
+	.signal = msgq_signal,
+	.isr_ok = true,
+};
+
+void bench_msgq(void)
+{
+	uint64_t put_cycles = 0, get_cycles = 0;
+	uint32_t data = 0;
+	timing_t start;
+
+	for (int i = 0; i < BENCH_ITERATIONS / BENCH_BATCH; i++) {
+		start = bench_start();
+		for (int j = 0; j < BENCH_BATCH; j++) {
+			k_msgq_put(&test_msgq, &data, K_NO_WAIT);
+		}
+		put_cycles += bench_stop(start);
+
+		start = bench_start();
+		for (int j = 0; j < BENCH_BATCH; j++) {
+			k_msgq_get(&test_msgq, &data, K_NO_WAIT);
+		}
+		get_cycles += bench_stop(start);
+	}
+
+	bench_report("msgq", "uncontended", "put",
+		     BENCH_ITERATIONS / BENCH_BATCH * BENCH_BATCH, put_cycles);
+	bench_report("msgq", "uncontended", "get",
+		     BENCH_ITERATIONS / BENCH_BATCH * BENCH_BATCH, get_cycles);
+
+	bench_wake_run("msgq", "put_to_get", &msgq_ops);
+}
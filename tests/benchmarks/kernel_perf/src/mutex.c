@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include "bench.h"
+
+static K_MUTEX_DEFINE(test_mutex);
+static K_MUTEX_DEFINE(wake_mutex);
+static K_SEM_DEFINE(go_sem, 0, 1);
+static bool held;
+
+static void mutex_prepare(void)
+{
+	/* Hold the mutex, then let the waiter block on it */
+	k_mutex_lock(&wake_mutex, K_FOREVER);
+	k_sem_give(&go_sem);
+}
+
+static void mutex_wait(void)
+{
+	if (held) {
+		held = false;
+		k_mutex_unlock(&wake_mutex);
+	}
+
+	k_sem_take(&go_sem, K_FOREVER);
+	k_mutex_lock(&wake_mutex, K_FOREVER);
+	held = true;
+}
+
+static void mutex_signal(void)
+{
+	k_mutex_unlock(&wake_mutex);
+}
+
+static const struct bench_wake_ops mutex_ops = {
+	.wait = mutex_wait,
+	.signal = mutex_signal,
+	.prepare = mutex_prepare,
+};
+
+void bench_mutex(void)
+{
+	timing_t start;
+
+	start = bench_start();
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		k_mutex_lock(&test_mutex, K_FOREVER);
+	}
+	bench_report("mutex", "uncontended", "lock", BENCH_ITERATIONS,
+		     bench_stop(start));
+
+	start = bench_start();
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		k_mutex_unlock(&test_mutex);
+	}
+	bench_report("mutex", "uncontended", "unlock", BENCH_ITERATIONS,
+		     bench_stop(start));
+
+	/* Mutexes cannot be used from ISRs */
+	bench_wake_run("mutex", "unlock_to_lock", &mutex_ops);
+}
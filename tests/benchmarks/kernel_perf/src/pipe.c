@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include "bench.h"
+
+#define MSG_SIZE sizeof(uint32_t)
+
+K_PIPE_DEFINE(test_pipe, BENCH_BATCH * MSG_SIZE, 4);
+K_PIPE_DEFINE(wake_pipe, MSG_SIZE, 4);
+
+static void pipe_wait(void)
+{
+	uint32_t data;
+	size_t read;
+
+	k_pipe_get(&wake_pipe, &data, MSG_SIZE, &read, MSG_SIZE, K_FOREVER);
+}
+
+static void pipe_signal(void)
+{
+	uint32_t data = 0;
+	size_t written;
+
+	k_pipe_put(&wake_pipe, &data, MSG_SIZE, &written, MSG_SIZE,
+		   K_NO_WAIT);
+}
+
+static const struct bench_wake_ops pipe_ops = {
+	.wait = pipe_wait,
+	.signal = pipe_signal,
+};
+
+void bench_pipe(void)
+{
+	uint64_t put_cycles = 0, get_cycles = 0;
+	uint32_t data = 0;
+	size_t bytes;
+	timing_t start;
+
+	for (int i = 0; i < BENCH_ITERATIONS / BENCH_BATCH; i++) {
+		start = bench_start();
+		for (int j = 0; j < BENCH_BATCH; j++) {
+			k_pipe_put(&test_pipe, &data, MSG_SIZE, &bytes,
+				   MSG_SIZE, K_NO_WAIT);
+		}
+		put_cycles += bench_stop(start);
+
+		start = bench_start();
+		for (int j = 0; j < BENCH_BATCH; j++) {
+			k_pipe_get(&test_pipe, &data, MSG_SIZE, &bytes,
+				   MSG_SIZE, K_NO_WAIT);
+		}
+		get_cycles += bench_stop(start);
+	}
+
+	bench_report("pipe", "uncontended", "put",
+		     BENCH_ITERATIONS / BENCH_BATCH * BENCH_BATCH, put_cycles);
+	bench_report("pipe", "uncontended", "get",
+		     BENCH_ITERATIONS / BENCH_BATCH * BENCH_BATCH, get_cycles);
+
+	/* Pipes cannot be written from ISRs */
+	bench_wake_run("pipe", "put_to_get", &pipe_ops);
+}
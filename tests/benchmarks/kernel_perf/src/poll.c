@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include "bench.h"
+
+static struct k_poll_signal bench_signal =
+	K_POLL_SIGNAL_INITIALIZER(bench_signal);
+static struct k_poll_signal wake_signal =
+	K_POLL_SIGNAL_INITIALIZER(wake_signal);
+
+static void poll_wait(void)
+{
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(
+		K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &wake_signal);
+
+	(void)k_poll(&event, 1, K_FOREVER);
+	k_poll_signal_reset(&wake_signal);
+}
+
+static void poll_signal(void)
+{
+	(void)k_poll_signal_raise(&wake_signal, 0);
+}
+
+static const struct bench_wake_ops poll_ops = {
+	.wait = poll_wait,
+	.signal = poll_signal,
+	.isr_ok = true,
+};
+
+void bench_poll(void)
+{
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(
+		K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &bench_signal);
+	uint64_t raise_cycles = 0, poll_cycles = 0;
+	timing_t start;
+
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		start = bench_start();
+		(void)k_poll_signal_raise(&bench_signal, 0);
+		raise_cycles += bench_stop(start);
+
+		/* Already signaled: k_poll() returns without waiting */
+		event.state = K_POLL_STATE_NOT_READY;
+		start = bench_start();
+		(void)k_poll(&event, 1, K_FOREVER);
+		poll_cycles += bench_stop(start);
+
+		k_poll_signal_reset(&bench_signal);
+	}
+
+	bench_report("poll", "uncontended", "raise", BENCH_ITERATIONS,
+		     raise_cycles);
+	bench_report("poll", "uncontended", "poll", BENCH_ITERATIONS,
+		     poll_cycles);
+
+	bench_wake_run("poll", "raise_to_poll", &poll_ops);
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include "bench.h"
+
+static K_SEM_DEFINE(test_sem, 0, BENCH_ITERATIONS);
+static K_SEM_DEFINE(wake_sem, 0, 1);
+
+static void sem_wait(void)
+{
+	k_sem_take(&wake_sem, K_FOREVER);
+}
+
+static void sem_signal(void)
+{
+	k_sem_give(&wake_sem);
+}
+
+static const struct bench_wake_ops sem_ops = {
+	.wait = sem_wait,
+	.signal = sem_signal,
+	.isr_ok = true,
+};
+
+void bench_sem(void)
+{
+	timing_t start;
+
+	start = bench_start();
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		k_sem_give(&test_sem);
+	}
+	bench_report("sem", "uncontended", "give", BENCH_ITERATIONS,
+		     bench_stop(start));
+
+	start = bench_start();
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		k_sem_take(&test_sem, K_NO_WAIT);
+	}
+	bench_report("sem", "uncontended", "take", BENCH_ITERATIONS,
+		     bench_stop(start));
+
+	bench_wake_run("sem", "give_to_take", &sem_ops);
+}
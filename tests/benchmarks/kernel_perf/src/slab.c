@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include "bench.h"
+
+#define BLOCK_SIZE 32
+
+K_MEM_SLAB_DEFINE(test_slab, BLOCK_SIZE, BENCH_BATCH, 4);
+
+/* A single block, held either by the benchmark thread or the waiter */
+K_MEM_SLAB_DEFINE(wake_slab, BLOCK_SIZE, 1, 4);
+
+static K_SEM_DEFINE(go_sem, 0, 1);
+static void *blocks[BENCH_BATCH];
+static void *main_block;
+static void *waiter_block;
+
+static void slab_prepare(void)
+{
+	(void)k_mem_slab_alloc(&wake_slab, &main_block, K_NO_WAIT);
+	k_sem_give(&go_sem);
+}
+
+static void slab_wait(void)
+{
+	if (waiter_block != NULL) {
+		k_mem_slab_free(&wake_slab, &waiter_block);
+		waiter_block = NULL;
+	}
+
+	k_sem_take(&go_sem, K_FOREVER);
+	(void)k_mem_slab_alloc(&wake_slab, &waiter_block, K_FOREVER);
+}
+
+static void slab_signal(void)
+{
+	k_mem_slab_free(&wake_slab, &main_block);
+}
+
+static const struct bench_wake_ops slab_ops = {
+	.wait = slab_wait,
+	.signal = slab_signal,
+	.prepare = slab_prepare,
+	.isr_ok = true,
+};
+
+void bench_slab(void)
+{
+	uint64_t alloc_cycles = 0, free_cycles = 0;
+	timing_t start;
+
+	for (int i = 0; i < BENCH_ITERATIONS / BENCH_BATCH; i++) {
+		start = bench_start();
+		for (int j = 0; j < BENCH_BATCH; j++) {
+			(void)k_mem_slab_alloc(&test_slab, &blocks[j],
+					       K_NO_WAIT);
+		}
+		alloc_cycles += bench_stop(start);
+
+		start = bench_start();
+		for (int j = 0; j < BENCH_BATCH; j++) {
+			k_mem_slab_free(&test_slab, &blocks[j]);
+		}
+		free_cycles += bench_stop(start);
+	}
+
+	bench_report("slab", "uncontended", "alloc",
+		     BENCH_ITERATIONS / BENCH_BATCH * BENCH_BATCH,
+		     alloc_cycles);
+	bench_report("slab", "uncontended", "free",
+		     BENCH_ITERATIONS / BENCH_BATCH * BENCH_BATCH, free_cycles);
+
+	bench_wake_run("slab", "free_to_alloc", &slab_ops);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include "bench.h"
+
+#define NUM_ARMED_TIMERS 32
+
+static struct k_timer test_timer;
+static struct k_timer armed_timers[NUM_ARMED_TIMERS];
+static volatile timing_t expiry_time;
+
+static void expiry_fn(struct k_timer *timer)
+{
+	ARG_UNUSED(timer);
+
+	expiry_time = timing_counter_get();
+}
+
+static void start_stop(const char *variant)
+{
+	uint64_t start_cycles = 0, stop_cycles = 0;
+	timing_t start;
+
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		start = bench_start();
+		k_timer_start(&test_timer, K_SECONDS(10), K_NO_WAIT);
+		start_cycles += bench_stop(start);
+
+		start = bench_start();
+		k_timer_stop(&test_timer);
+		stop_cycles += bench_stop(start);
+	}
+
+	bench_report("timer", variant, "start", BENCH_ITERATIONS,
+		     start_cycles);
+	bench_report("timer", variant, "stop", BENCH_ITERATIONS, stop_cycles);
+}
+
+void bench_timer(void)
+{
+	uint64_t cycles = 0;
+	timing_t end;
+
+	k_timer_init(&test_timer, expiry_fn, NULL);
+
+	start_stop("uncontended");
+
+	/* The timeout list is walked when inserting a timeout: measure with
+	 * other timers armed, expiring before and after the measured one.
+	 */
+	for (int i = 0; i < NUM_ARMED_TIMERS; i++) {
+		k_timer_init(&armed_timers[i], NULL, NULL);
+		k_timer_start(&armed_timers[i], K_SECONDS(1 + i % 20),
+			      K_NO_WAIT);
+	}
+
+	start_stop("contended");
+
+	for (int i = 0; i < NUM_ARMED_TIMERS; i++) {
+		k_timer_stop(&armed_timers[i]);
+	}
+
+	/* Expiry handler, run from the timer ISR, to the thread waiting
+	 * for the expiry.
+	 */
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		k_timer_start(&test_timer, K_TICKS(1), K_NO_WAIT);
+		(void)k_timer_status_sync(&test_timer);
+		end = timing_counter_get();
+		cycles += timing_cycles_get(&expiry_time, &end);
+	}
+
+	bench_report("timer", "isr", "expiry_to_sync", BENCH_ITERATIONS,
+		     cycles);
+}
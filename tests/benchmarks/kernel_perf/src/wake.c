@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <kernel_structs.h>
+#include <irq_offload.h>
+#include "bench.h"
+
+K_THREAD_STACK_DEFINE(waiter_stack, BENCH_STACK_SIZE);
+static struct k_thread waiter_thread;
+
+static const struct bench_wake_ops *wake_ops;
+static volatile timing_t wake_start;
+static volatile timing_t wake_end;
+static volatile bool woken;
+
+void bench_wake_mark(void)
+{
+	wake_end = timing_counter_get();
+	woken = true;
+}
+
+struct k_thread *bench_wake_thread(void)
+{
+	return &waiter_thread;
+}
+
+static void waiter_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		wake_ops->wait();
+		bench_wake_mark();
+	}
+}
+
+static struct k_thread *woken_thread(void)
+{
+	return (wake_ops->wait != NULL) ? &waiter_thread : wake_ops->thread;
+}
+
+static bool woken_thread_blocked(void)
+{
+	uint8_t state = woken_thread()->base.thread_state;
+
+	return (state & (_THREAD_PENDING | _THREAD_SUSPENDED)) != 0U;
+}
+
+static void isr_signal(const void *param)
+{
+	ARG_UNUSED(param);
+
+	wake_start = timing_counter_get();
+	wake_ops->signal();
+}
+
+enum wake_variant {
+	WAKE_CONTENDED,
+	WAKE_ISR,
+	WAKE_SMP,
+};
+
+static void run_variant(const char *primitive, const char *op,
+			enum wake_variant variant)
+{
+	static const char *const names[] = { "contended", "isr", "smp" };
+	int prio = (variant == WAKE_SMP) ? BENCH_PRIO : BENCH_PRIO_HIGH;
+	uint64_t cycles = 0;
+
+	if (wake_ops->wait != NULL) {
+		k_thread_create(&waiter_thread, waiter_stack,
+				K_THREAD_STACK_SIZEOF(waiter_stack),
+				waiter_fn, NULL, NULL, NULL, prio, 0,
+				K_NO_WAIT);
+	} else {
+		k_thread_priority_set(wake_ops->thread, prio);
+	}
+
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		if (wake_ops->prepare != NULL) {
+			wake_ops->prepare();
+		}
+
+		/* The woken thread may still be on its way back to wait() on
+		 * another CPU.
+		 */
+		while (!woken_thread_blocked()) {
+		}
+
+		woken = false;
+
+		if (variant == WAKE_ISR) {
+			irq_offload(isr_signal, NULL);
+		} else {
+			wake_start = timing_counter_get();
+			wake_ops->signal();
+		}
+
+		while (!woken) {
+		}
+
+		if (variant == WAKE_SMP) {
+			/* Both ends measured on this CPU */
+			wake_end = timing_counter_get();
+		}
+
+		cycles += timing_cycles_get(&wake_start, &wake_end);
+	}
+
+	if (wake_ops->wait != NULL) {
+		/* Make sure the waiter released what it acquired */
+		while (!woken_thread_blocked()) {
+		}
+		k_thread_abort(&waiter_thread);
+	}
+
+	bench_report(primitive, names[variant], op, BENCH_ITERATIONS, cycles);
+}
+
+void bench_wake_run(const char *primitive, const char *op,
+		    const struct bench_wake_ops *ops)
+{
+	wake_ops = ops;
+
+	run_variant(primitive, op, WAKE_CONTENDED);
+
+	if (ops->isr_ok) {
+		run_variant(primitive, op, WAKE_ISR);
+	}
+
+	if (IS_ENABLED(CONFIG_SMP) && (CONFIG_MP_NUM_CPUS > 1)) {
+		run_variant(primitive, op, WAKE_SMP);
+	}
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include "bench.h"
+
+K_THREAD_STACK_DEFINE(bench_work_q_stack, BENCH_STACK_SIZE);
+K_THREAD_STACK_DEFINE(wake_work_q_stack, BENCH_STACK_SIZE);
+
+/* Runs after the benchmark thread, so submissions only queue items */
+static struct k_work_q bench_work_q;
+
+/* Runs the wake-up handler */
+static struct k_work_q wake_work_q;
+
+static struct k_work items[BENCH_BATCH];
+static struct k_work wake_work;
+static K_SEM_DEFINE(done_sem, 0, BENCH_BATCH);
+
+static void bench_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	k_sem_give(&done_sem);
+}
+
+static void wake_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	bench_wake_mark();
+}
+
+static void work_signal(void)
+{
+	k_work_submit_to_queue(&wake_work_q, &wake_work);
+}
+
+static struct bench_wake_ops work_ops = {
+	.signal = work_signal,
+	.isr_ok = true,
+};
+
+void bench_work(void)
+{
+	uint64_t cycles = 0;
+	timing_t start;
+
+	k_work_q_start(&bench_work_q, bench_work_q_stack,
+		       K_THREAD_STACK_SIZEOF(bench_work_q_stack),
+		       BENCH_PRIO_LOW);
+	k_work_q_start(&wake_work_q, wake_work_q_stack,
+		       K_THREAD_STACK_SIZEOF(wake_work_q_stack),
+		       BENCH_PRIO_HIGH);
+
+	for (int i = 0; i < BENCH_BATCH; i++) {
+		k_work_init(&items[i], bench_handler);
+	}
+	k_work_init(&wake_work, wake_handler);
+
+	for (int i = 0; i < BENCH_ITERATIONS / BENCH_BATCH; i++) {
+		start = bench_start();
+		for (int j = 0; j < BENCH_BATCH; j++) {
+			k_work_submit_to_queue(&bench_work_q, &items[j]);
+		}
+		cycles += bench_stop(start);
+
+		/* Let the queue drain */
+		for (int j = 0; j < BENCH_BATCH; j++) {
+			k_sem_take(&done_sem, K_FOREVER);
+		}
+	}
+
+	bench_report("work", "uncontended", "submit",
+		     BENCH_ITERATIONS / BENCH_BATCH * BENCH_BATCH, cycles);
+
+	work_ops.thread = &wake_work_q.thread;
+	bench_wake_run("work", "submit_to_handler", &work_ops);
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <timing/timing.h>
+
+/* Cost of memcpy(), memset() and memcmp() for sizes from 4 bytes to 64 KiB,
+ * or a quarter of the SRAM on small boards, and for every combination of
+ * source and destination offsets within a word. For each size, the cost
+ * with both buffers aligned is reported, along with the best and worst
+ * cost over all the offset combinations.
+ */
+
+#define ALIGN_COMBOS	4
+#define MIN_SIZE	4
+#define MAX_SIZE	MIN(KB(64), KB(CONFIG_SRAM_SIZE) / 4)
+
+/* Enough calls per measurement to move about 64 KiB */
+#define ITERATIONS(size) MAX(1U, KB(64) / (size))
+
+static uint8_t src[MAX_SIZE + ALIGN_COMBOS] __aligned(8);
+static uint8_t dst[MAX_SIZE + ALIGN_COMBOS] __aligned(8);
+
+/* Called through pointers so that the compiler does not expand the calls
+ * with its builtins.
+ */
+static void *(*volatile memcpy_fn)(void *, const void *, size_t) = memcpy;
+static void *(*volatile memset_fn)(void *, int, size_t) = memset;
+static int (*volatile memcmp_fn)(const void *, const void *, size_t) = memcmp;
+static volatile int sink;
+
+enum op {
+	OP_MEMCPY,
+	OP_MEMSET,
+	OP_MEMCMP,
+};
+
+static uint32_t measure(enum op op, size_t size, int s_off, int d_off)
+{
+	uint32_t iterations = ITERATIONS(size);
+	timing_t start, end;
+
+	start = timing_counter_get();
+	for (uint32_t i = 0; i < iterations; i++) {
+		switch (op) {
+		case OP_MEMCPY:
+			memcpy_fn(&dst[d_off], &src[s_off], size);
+			break;
+		case OP_MEMSET:
+			memset_fn(&dst[d_off], (int)i, size);
+			break;
+		case OP_MEMCMP:
+			/* equal areas, the worst case */
+			sink = memcmp_fn(&dst[d_off], &src[s_off], size);
+			break;
+		}
+	}
+	end = timing_counter_get();
+
+	return (uint32_t)(timing_cycles_get(&start, &end) / iterations);
+}
+
+static void bench(const char *name, enum op op)
+{
+	printk("%-8s %8s %10s %10s %10s %8s\n", name, "size", "aligned",
+	       "best", "worst", "B/kcyc");
+
+	for (size_t size = MIN_SIZE; size <= MAX_SIZE; size *= 2) {
+		uint32_t aligned = 0;
+		uint32_t best = UINT32_MAX;
+		uint32_t worst = 0;
+
+		for (int s_off = 0; s_off < ALIGN_COMBOS; s_off++) {
+			for (int d_off = 0; d_off < ALIGN_COMBOS; d_off++) {
+				uint32_t cycles;
+
+				/* memset() has no source */
+				if ((op == OP_MEMSET) && (s_off != 0)) {
+					continue;
+				}
+
+				if (op == OP_MEMCMP) {
+					memcpy(&dst[d_off], &src[s_off], size);
+				}
+
+				cycles = measure(op, size, s_off, d_off);
+				if ((s_off == 0) && (d_off == 0)) {
+					aligned = cycles;
+				}
+				best = MIN(best, cycles);
+				worst = MAX(worst, cycles);
+			}
+		}
+
+		printk("%-8s %8u %10u %10u %10u %8u\n", name, (uint32_t)size,
+		       aligned, best, worst,
+		       (uint32_t)((worst != 0U) ? (size * 1000U / worst) : 0U));
+	}
+}
+
+void main(void)
+{
+	for (size_t i = 0; i < sizeof(src); i++) {
+		src[i] = (uint8_t)(i * 7U + 1U);
+	}
+
+	timing_init();
+	timing_start();
+
+	printk("libc string benchmark, %s implementation, cycles per call\n",
+	       IS_ENABLED(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING_FOR_SIZE) ?
+	       "size optimized" : "speed optimized");
+
+	bench("memcpy", OP_MEMCPY);
+	bench("memset", OP_MEMSET);
+	bench("memcmp", OP_MEMCMP);
+
+	timing_stop();
+
+	printk("fin\n");
+}
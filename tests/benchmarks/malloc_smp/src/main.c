@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <stdlib.h>
+#include <sys/printk.h>
+
+#include "smp_bench.h"
+
+/* SMP malloc benchmark: one thread per CPU allocates and frees small blocks
+ * of random sizes, as C++ objects would be, for a fixed time.
+ *
+ * - local: every thread frees its own blocks, by windows of WINDOW blocks.
+ * - remote: every thread hands its blocks to the next thread, which frees
+ *   them, so that every block is freed by another thread than the one that
+ *   allocated it.
+ *
+ * The aggregate number of malloc() and free() calls per second is reported.
+ */
+
+#define NUM_THREADS SMP_BENCH_THREADS
+#define WINDOW 16
+#define MAX_IN_FLIGHT 64
+#define MAX_SIZE 256
+
+enum mode {
+	MODE_LOCAL,
+	MODE_REMOTE,
+	NUM_MODES
+};
+
+static const char *const mode_names[NUM_MODES] = {
+	"local", "remote"
+};
+
+/* Header of the blocks handed to another thread */
+struct remote_block {
+	void *reserved;
+	int owner;
+};
+
+static struct thread_state {
+	struct k_fifo inbox;
+	atomic_t in_flight;
+	uint32_t seed;
+} __aligned(64) states[NUM_THREADS];
+
+static size_t random_size(struct thread_state *state)
+{
+	/* xorshift32 */
+	state->seed ^= state->seed << 13;
+	state->seed ^= state->seed >> 17;
+	state->seed ^= state->seed << 5;
+
+	return sizeof(struct remote_block) + state->seed % MAX_SIZE;
+}
+
+static void run_local(int id)
+{
+	struct thread_state *state = &states[id];
+	void *blocks[WINDOW];
+
+	while (smp_bench_running) {
+		for (int i = 0; i < WINDOW; i++) {
+			blocks[i] = malloc(random_size(state));
+		}
+
+		for (int i = 0; i < WINDOW; i++) {
+			free(blocks[i]);
+		}
+
+		smp_bench_stats[id].ops += 2 * WINDOW;
+	}
+}
+
+static void drain_inbox(int id)
+{
+	struct remote_block *block;
+
+	while ((block = k_fifo_get(&states[id].inbox, K_NO_WAIT)) != NULL) {
+		(void)atomic_dec(&states[block->owner].in_flight);
+		free(block);
+		smp_bench_stats[id].ops++;
+	}
+}
+
+static void run_remote(int id)
+{
+	struct thread_state *state = &states[id];
+	struct thread_state *next = &states[(id + 1) % NUM_THREADS];
+
+	while (smp_bench_running) {
+		while (atomic_get(&state->in_flight) < MAX_IN_FLIGHT) {
+			struct remote_block *block;
+
+			block = malloc(random_size(state));
+			if (block == NULL) {
+				break;
+			}
+
+			block->owner = id;
+			(void)atomic_inc(&state->in_flight);
+			k_fifo_put(&next->inbox, block);
+			smp_bench_stats[id].ops++;
+		}
+
+		drain_inbox(id);
+	}
+}
+
+static const smp_bench_worker_t mode_workers[NUM_MODES] = {
+	run_local, run_remote
+};
+
+static void run(enum mode mode)
+{
+	uint32_t rate;
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_fifo_init(&states[i].inbox);
+		(void)atomic_set(&states[i].in_flight, 0);
+		states[i].seed = 2463534242U + i;
+	}
+
+	rate = smp_bench_run(mode_workers[mode], NULL);
+
+	/* Free the blocks left in transit */
+	for (int i = 0; i < NUM_THREADS; i++) {
+		drain_inbox(i);
+	}
+
+	printk("%-8s ops/s %10u\n", mode_names[mode], rate);
+}
+
+void main(void)
+{
+	printk("malloc SMP benchmark: %d threads, per-CPU caches %s\n",
+	       NUM_THREADS,
+	       IS_ENABLED(CONFIG_MINIMAL_LIBC_MALLOC_CPU_CACHE) ? "on" : "off");
+
+	for (enum mode m = MODE_LOCAL; m < NUM_MODES; m++) {
+		run(m);
+	}
+
+	printk("fin\n");
+}
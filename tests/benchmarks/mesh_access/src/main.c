@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+
+#include "net.h"
+#include "access.h"
+
+#include <time.h>
+
+/* Dispatch of access messages on a node with NUM_ELEMS elements, each with
+ * SIG_MODELS SIG models and VND_MODELS vendor models of OPS_PER_MODEL
+ * OpCodes. Every GROUP_PERIOD-th message is sent to a group address that
+ * the first SIG and vendor models of every element subscribe to, the others
+ * to the unicast address of an element, with an OpCode of one of its models.
+ * The messages are received with bt_mesh_model_recv(), and the dispatch rate
+ * is reported.
+ */
+
+#define NUM_ELEMS 16
+#define SIG_MODELS 8
+#define VND_MODELS 4
+#define OPS_PER_MODEL 4
+#define NUM_OPCODES (NUM_ELEMS * (SIG_MODELS + VND_MODELS) * OPS_PER_MODEL)
+#define NUM_MSGS 4096
+#define ROUNDS 16
+#define GROUP_PERIOD 4
+#define LOCAL_ADDR 0x0001
+#define REMOTE_ADDR 0x0100
+#define GROUP_ADDR 0xc001
+#define CID 0x0059
+#define PAYLOAD_LEN 4
+
+#define SIG_OP(m, k) BT_MESH_MODEL_OP_2(0x82, (m) * OPS_PER_MODEL + (k))
+#define VND_OP(m, k) BT_MESH_MODEL_OP_3((m) * OPS_PER_MODEL + (k), CID)
+
+struct msg {
+	uint16_t dst;
+	uint8_t len;
+	uint8_t data[3 + PAYLOAD_LEN];
+};
+
+static struct msg msgs[NUM_MSGS];
+static uint32_t delivered;
+
+static void handler(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+		    struct net_buf_simple *buf)
+{
+	delivered++;
+}
+
+#define MODEL_OPS(op, m)                                                       \
+	{                                                                      \
+		{ op(m, 0), PAYLOAD_LEN, handler },                            \
+		{ op(m, 1), PAYLOAD_LEN, handler },                            \
+		{ op(m, 2), PAYLOAD_LEN, handler },                            \
+		{ op(m, 3), PAYLOAD_LEN, handler },                            \
+		BT_MESH_MODEL_OP_END,                                          \
+	}
+
+static const struct bt_mesh_model_op sig_ops[SIG_MODELS][OPS_PER_MODEL + 1] = {
+	MODEL_OPS(SIG_OP, 0), MODEL_OPS(SIG_OP, 1), MODEL_OPS(SIG_OP, 2),
+	MODEL_OPS(SIG_OP, 3), MODEL_OPS(SIG_OP, 4), MODEL_OPS(SIG_OP, 5),
+	MODEL_OPS(SIG_OP, 6), MODEL_OPS(SIG_OP, 7),
+};
+
+static const struct bt_mesh_model_op vnd_ops[VND_MODELS][OPS_PER_MODEL + 1] = {
+	MODEL_OPS(VND_OP, 0), MODEL_OPS(VND_OP, 1), MODEL_OPS(VND_OP, 2),
+	MODEL_OPS(VND_OP, 3),
+};
+
+#define SIG_ELEM_MODELS                                                        \
+	{                                                                      \
+		BT_MESH_MODEL(0x1000, sig_ops[0], NULL, NULL),                 \
+		BT_MESH_MODEL(0x1001, sig_ops[1], NULL, NULL),                 \
+		BT_MESH_MODEL(0x1002, sig_ops[2], NULL, NULL),                 \
+		BT_MESH_MODEL(0x1003, sig_ops[3], NULL, NULL),                 \
+		BT_MESH_MODEL(0x1004, sig_ops[4], NULL, NULL),                 \
+		BT_MESH_MODEL(0x1005, sig_ops[5], NULL, NULL),                 \
+		BT_MESH_MODEL(0x1006, sig_ops[6], NULL, NULL),                 \
+		BT_MESH_MODEL(0x1007, sig_ops[7], NULL, NULL),                 \
+	}
+
+#define VND_ELEM_MODELS                                                        \
+	{                                                                      \
+		BT_MESH_MODEL_VND(CID, 0x0000, vnd_ops[0], NULL, NULL),        \
+		BT_MESH_MODEL_VND(CID, 0x0001, vnd_ops[1], NULL, NULL),        \
+		BT_MESH_MODEL_VND(CID, 0x0002, vnd_ops[2], NULL, NULL),        \
+		BT_MESH_MODEL_VND(CID, 0x0003, vnd_ops[3], NULL, NULL),        \
+	}
+
+/* BT_MESH_MODEL() uses UTIL_LISTIFY(), so the elements are listed by hand */
+static struct bt_mesh_model sig_models[NUM_ELEMS][SIG_MODELS] = {
+	SIG_ELEM_MODELS, SIG_ELEM_MODELS, SIG_ELEM_MODELS, SIG_ELEM_MODELS,
+	SIG_ELEM_MODELS, SIG_ELEM_MODELS, SIG_ELEM_MODELS, SIG_ELEM_MODELS,
+	SIG_ELEM_MODELS, SIG_ELEM_MODELS, SIG_ELEM_MODELS, SIG_ELEM_MODELS,
+	SIG_ELEM_MODELS, SIG_ELEM_MODELS, SIG_ELEM_MODELS, SIG_ELEM_MODELS,
+};
+
+static struct bt_mesh_model vnd_models[NUM_ELEMS][VND_MODELS] = {
+	VND_ELEM_MODELS, VND_ELEM_MODELS, VND_ELEM_MODELS, VND_ELEM_MODELS,
+	VND_ELEM_MODELS, VND_ELEM_MODELS, VND_ELEM_MODELS, VND_ELEM_MODELS,
+	VND_ELEM_MODELS, VND_ELEM_MODELS, VND_ELEM_MODELS, VND_ELEM_MODELS,
+	VND_ELEM_MODELS, VND_ELEM_MODELS, VND_ELEM_MODELS, VND_ELEM_MODELS,
+};
+
+#define ELEM(e) BT_MESH_ELEM(0, sig_models[e], vnd_models[e])
+
+static struct bt_mesh_elem elements[NUM_ELEMS] = {
+	ELEM(0), ELEM(1), ELEM(2), ELEM(3), ELEM(4), ELEM(5), ELEM(6), ELEM(7),
+	ELEM(8), ELEM(9), ELEM(10), ELEM(11), ELEM(12), ELEM(13), ELEM(14),
+	ELEM(15),
+};
+
+static const struct bt_mesh_comp comp = {
+	.elem = elements,
+	.elem_count = ARRAY_SIZE(elements),
+};
+
+static uint32_t rand_state = 0x61636365;
+
+static uint32_t rand32(void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+static void models_configure(void)
+{
+	for (int e = 0; e < NUM_ELEMS; e++) {
+		for (int m = 0; m < SIG_MODELS; m++) {
+			sig_models[e][m].keys[0] = 0;
+		}
+
+		for (int m = 0; m < VND_MODELS; m++) {
+			vnd_models[e][m].keys[0] = 0;
+		}
+
+		sig_models[e][0].groups[0] = GROUP_ADDR;
+		vnd_models[e][0].groups[0] = GROUP_ADDR;
+	}
+}
+
+static void msgs_create(void)
+{
+	NET_BUF_SIMPLE_DEFINE(buf, sizeof(msgs[0].data));
+
+	for (int i = 0; i < NUM_MSGS; i++) {
+		uint8_t m = rand32() % (SIG_MODELS + VND_MODELS);
+		uint8_t k = rand32() % OPS_PER_MODEL;
+		uint32_t opcode;
+
+		if (i % GROUP_PERIOD == GROUP_PERIOD - 1) {
+			msgs[i].dst = GROUP_ADDR;
+			m = (m < SIG_MODELS) ? 0 : SIG_MODELS;
+		} else {
+			msgs[i].dst = LOCAL_ADDR + rand32() % NUM_ELEMS;
+		}
+
+		if (m < SIG_MODELS) {
+			opcode = SIG_OP(m, k);
+		} else {
+			opcode = VND_OP(m - SIG_MODELS, k);
+		}
+
+		net_buf_simple_reset(&buf);
+		bt_mesh_model_msg_init(&buf, opcode);
+		(void)memset(net_buf_simple_add(&buf, PAYLOAD_LEN), i,
+			     PAYLOAD_LEN);
+
+		msgs[i].len = buf.len;
+		memcpy(msgs[i].data, buf.data, buf.len);
+	}
+}
+
+/* Simulated time does not advance while native_posix runs code */
+static uint64_t host_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+void main(void)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx = {
+			.app_idx = 0,
+			.addr = REMOTE_ADDR,
+		},
+		.local_match = 1,
+	};
+	struct net_buf_simple buf;
+	uint64_t start, ns;
+	int err;
+
+	err = bt_mesh_comp_register(&comp);
+	if (err) {
+		printk("Registering composition failed (err %d)\n", err);
+		return;
+	}
+
+	bt_mesh_comp_provision(LOCAL_ADDR);
+	models_configure();
+	msgs_create();
+
+	printk("Mesh access benchmark: %d elements, %d OpCodes, %s\n",
+	       NUM_ELEMS, NUM_OPCODES,
+	       CONFIG_BT_MESH_MODEL_OP_INDEX_SIZE >= NUM_OPCODES ?
+		       "OpCode index" : "linear search");
+
+	start = host_ns();
+
+	for (int r = 0; r < ROUNDS; r++) {
+		for (int i = 0; i < NUM_MSGS; i++) {
+			net_buf_simple_init_with_data(&buf, msgs[i].data,
+						      msgs[i].len);
+			rx.ctx.recv_dst = msgs[i].dst;
+
+			bt_mesh_model_recv(&rx, &buf);
+		}
+	}
+
+	ns = MAX(host_ns() - start, 1);
+
+	printk("%u msgs/s %8u delivered\n",
+	       (uint32_t)((uint64_t)ROUNDS * NUM_MSGS * NSEC_PER_SEC / ns),
+	       delivered);
+
+	printk("fin\n");
+}
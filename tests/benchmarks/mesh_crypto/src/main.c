@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+
+#include "crypto.h"
+
+#include <time.h>
+
+/* Cost of the cryptography of each mesh PDU: encryption and obfuscation of
+ * network PDUs, the reverse when they are received, decryption of the
+ * access payload with an application key, and derivation of the network
+ * credentials with k2 when a network key is added.
+ */
+
+#define ITERATIONS 4096
+#define IV_INDEX 0x12345678
+#define NET_HDR_LEN 9
+#define ACCESS_LEN 11
+
+static const uint8_t net_key[16] = {
+	0x7d, 0xd7, 0x36, 0x4c, 0xd8, 0x42, 0xad, 0x18,
+	0xc1, 0x7c, 0x2b, 0x82, 0x0c, 0x84, 0xc3, 0xd6,
+};
+
+static const uint8_t app_key[16] = {
+	0x63, 0x96, 0x47, 0x71, 0x73, 0x4f, 0xbd, 0x76,
+	0xe3, 0xb4, 0x05, 0x19, 0xd1, 0xd9, 0x4a, 0x48,
+};
+
+/* CTL 0, TTL 4, SEQ, SRC, DST, then an unsegmented access PDU with a
+ * 4 byte TransMIC, and the 4 byte NetMIC
+ */
+static const uint8_t clear_pdu[NET_HDR_LEN + 1 + ACCESS_LEN + 4] = {
+	0x68, 0x04, 0x00, 0x00, 0x07, 0x12, 0x01, 0x00, 0x03, 0x66,
+};
+
+static const struct bt_mesh_app_crypto_ctx app_ctx = {
+	.src = 0x1201,
+	.dst = 0x0003,
+	.seq_num = 0x000007,
+	.iv_index = IV_INDEX,
+};
+
+static uint8_t enc_key[16];
+static uint8_t privacy_key[16];
+
+static uint8_t net_pdu[sizeof(clear_pdu) + 4];
+static uint8_t app_payload[ACCESS_LEN + 4];
+
+/* Simulated time does not advance while native_posix runs code */
+static uint64_t host_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static int net_encrypt(void)
+{
+	struct net_buf_simple buf;
+	int err;
+
+	net_buf_simple_init_with_data(&buf, net_pdu, sizeof(net_pdu));
+	net_buf_simple_reset(&buf);
+	net_buf_simple_add_mem(&buf, clear_pdu, sizeof(clear_pdu));
+
+	err = bt_mesh_net_encrypt(enc_key, &buf, IV_INDEX, false);
+	if (!err) {
+		err = bt_mesh_net_obfuscate(buf.data, IV_INDEX, privacy_key);
+	}
+
+	return err;
+}
+
+static int net_decrypt(void)
+{
+	uint8_t data[sizeof(net_pdu)];
+	struct net_buf_simple buf;
+	int err;
+
+	memcpy(data, net_pdu, sizeof(net_pdu));
+	net_buf_simple_init_with_data(&buf, data, sizeof(data));
+
+	err = bt_mesh_net_obfuscate(buf.data, IV_INDEX, privacy_key);
+	if (!err) {
+		err = bt_mesh_net_decrypt(enc_key, &buf, IV_INDEX, false);
+	}
+
+	return err;
+}
+
+static int app_encrypt(void)
+{
+	struct net_buf_simple buf;
+
+	net_buf_simple_init_with_data(&buf, app_payload, sizeof(app_payload));
+	net_buf_simple_reset(&buf);
+	net_buf_simple_add(&buf, ACCESS_LEN);
+
+	return bt_mesh_app_encrypt(app_key, &app_ctx, &buf);
+}
+
+static int app_decrypt(void)
+{
+	NET_BUF_SIMPLE_DEFINE(out, ACCESS_LEN);
+	struct net_buf_simple buf;
+
+	net_buf_simple_init_with_data(&buf, app_payload, sizeof(app_payload));
+	buf.len = ACCESS_LEN;
+
+	return bt_mesh_app_decrypt(app_key, &app_ctx, &buf, &out);
+}
+
+static int k2(void)
+{
+	uint8_t p[] = { 0x00 };
+	uint8_t nid;
+
+	return bt_mesh_k2(net_key, p, sizeof(p), &nid, enc_key, privacy_key);
+}
+
+static void run(const char *name, int (*op)(void), int iterations)
+{
+	uint64_t start, ns;
+	int err = 0;
+
+	start = host_ns();
+
+	for (int i = 0; i < iterations && !err; i++) {
+		err = op();
+	}
+
+	ns = host_ns() - start;
+
+	if (err) {
+		printk("%s failed (err %d)\n", name, err);
+		return;
+	}
+
+	printk("%-12s %8u ns\n", name, (uint32_t)(ns / iterations));
+}
+
+void main(void)
+{
+	printk("Mesh crypto benchmark, AES: %s\n",
+	       IS_ENABLED(CONFIG_BT_HOST_CRYPTO_AES_TABLE) ? "table" :
+							    "TinyCrypt");
+
+	run("k2", k2, ITERATIONS / 16);
+	run("net encrypt", net_encrypt, ITERATIONS);
+	run("net decrypt", net_decrypt, ITERATIONS);
+	run("app encrypt", app_encrypt, ITERATIONS);
+	run("app decrypt", app_decrypt, ITERATIONS);
+
+	printk("fin\n");
+}
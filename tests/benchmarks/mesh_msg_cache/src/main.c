@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <sys/hash.h>
+#include <timing/timing.h>
+
+#include "msg_cache.h"
+
+#if defined(CONFIG_ARCH_POSIX)
+#include <time.h>
+#endif
+
+/* Receive path of a relay node in a dense mesh network: every advertising
+ * PDU goes through the duplicate filter and the Network Message Cache, as in
+ * bt_mesh_net_recv(), with the linear caches used before and with the hashed
+ * ones, for several cache sizes.
+ *
+ * The traffic is a trace of NUM_SOURCES nodes publishing messages, each
+ * heard through COPIES relays which all transmit it TRANSMITS times, with
+ * the receptions of BURST messages interleaved. The trace is replayed
+ * ROUNDS times with new sequence numbers, and the reception rate of the
+ * node is reported.
+ */
+
+#define NUM_SOURCES 128
+#define COPIES 3
+#define TRANSMITS 2
+#define BURST 8
+#define RX_PER_BURST (BURST * COPIES * TRANSMITS)
+#define NUM_BURSTS 256
+#define TRACE_LEN (NUM_BURSTS * RX_PER_BURST)
+#define ROUNDS 16
+#define MAX_CACHE_SIZE 1024
+
+static const uint16_t cache_sizes[] = { 16, 64, 256, MAX_CACHE_SIZE };
+
+struct rx_pdu {
+	uint16_t src;
+	uint32_t seq;
+	/* Last 8 bytes of the PDU, folded as in check_dup() */
+	uint32_t tail;
+};
+
+static struct rx_pdu trace[TRACE_LEN];
+
+/* Caches as implemented before, searched linearly */
+static struct {
+	uint32_t src : 15,
+	      seq : 17;
+} linear_msg_cache[MAX_CACHE_SIZE];
+static uint16_t linear_msg_cache_next;
+static uint32_t linear_dup_cache[MAX_CACHE_SIZE];
+static uint16_t linear_dup_cache_next;
+static uint16_t linear_size;
+
+static uint32_t msg_cache_keys[MAX_CACHE_SIZE];
+static uint16_t msg_cache_slots[2 * MAX_CACHE_SIZE];
+static uint32_t dup_cache_keys[MAX_CACHE_SIZE];
+static uint16_t dup_cache_slots[2 * MAX_CACHE_SIZE];
+static struct bt_mesh_msg_cache msg_cache = {
+	.keys = msg_cache_keys,
+	.slots = msg_cache_slots,
+};
+static struct bt_mesh_msg_cache dup_cache = {
+	.keys = dup_cache_keys,
+	.slots = dup_cache_slots,
+};
+
+static uint32_t rand_state = 0x6d657368;
+
+static uint32_t rand32(void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+static void record_trace(void)
+{
+	static uint32_t seqs[NUM_SOURCES];
+	struct rx_pdu *burst = trace;
+
+	for (int b = 0; b < NUM_BURSTS; b++, burst += RX_PER_BURST) {
+		int n = 0;
+
+		for (int m = 0; m < BURST; m++) {
+			uint16_t src = 1 + rand32() % NUM_SOURCES;
+			uint32_t seq = seqs[src - 1]++;
+
+			/* Relays encrypt the PDU again with their TTL, so
+			 * only the transmissions of one relay are identical
+			 */
+			for (int c = 0; c < COPIES; c++) {
+				for (int t = 0; t < TRANSMITS; t++) {
+					burst[n].src = src;
+					burst[n].seq = seq;
+					burst[n].tail = sys_hash32_u32(
+						(src << 17 | seq) * COPIES + c);
+					n++;
+				}
+			}
+		}
+
+		/* Shuffle the receptions of the burst */
+		for (int i = RX_PER_BURST - 1; i > 0; i--) {
+			int j = rand32() % (i + 1);
+			struct rx_pdu tmp = burst[i];
+
+			burst[i] = burst[j];
+			burst[j] = tmp;
+		}
+	}
+}
+
+static bool linear_recv(uint16_t src, uint32_t seq, uint32_t tail)
+{
+	for (int i = 0; i < linear_size; i++) {
+		if (linear_dup_cache[i] == tail) {
+			return false;
+		}
+	}
+
+	linear_dup_cache[linear_dup_cache_next++] = tail;
+	linear_dup_cache_next %= linear_size;
+
+	for (int i = 0; i < linear_size; i++) {
+		if (linear_msg_cache[i].src == src &&
+		    linear_msg_cache[i].seq == (seq & BIT_MASK(17))) {
+			return false;
+		}
+	}
+
+	linear_msg_cache[linear_msg_cache_next].src = src;
+	linear_msg_cache[linear_msg_cache_next].seq = seq;
+	linear_msg_cache_next = (linear_msg_cache_next + 1) % linear_size;
+
+	return true;
+}
+
+static bool hashed_recv(uint16_t src, uint32_t seq, uint32_t tail)
+{
+	uint32_t key = ((uint32_t)src << 17) | (seq & BIT_MASK(17));
+
+	if (bt_mesh_msg_cache_has(&dup_cache, tail)) {
+		return false;
+	}
+
+	bt_mesh_msg_cache_add(&dup_cache, tail);
+
+	if (bt_mesh_msg_cache_has(&msg_cache, key)) {
+		return false;
+	}
+
+	bt_mesh_msg_cache_add(&msg_cache, key);
+
+	return true;
+}
+
+static void reset(uint16_t size)
+{
+	(void)memset(linear_msg_cache, 0, sizeof(linear_msg_cache));
+	(void)memset(linear_dup_cache, 0, sizeof(linear_dup_cache));
+	linear_msg_cache_next = 0U;
+	linear_dup_cache_next = 0U;
+	linear_size = size;
+
+	msg_cache.size = size;
+	dup_cache.size = size;
+	bt_mesh_msg_cache_clear(&msg_cache);
+	bt_mesh_msg_cache_clear(&dup_cache);
+}
+
+/* Simulated time does not advance while native_posix runs code, so the
+ * host clock is used there.
+ */
+#if defined(CONFIG_ARCH_POSIX)
+static uint64_t start_ns;
+
+static uint64_t host_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static void stopwatch_start(void)
+{
+	start_ns = host_ns();
+}
+
+static uint64_t stopwatch_ns(void)
+{
+	return host_ns() - start_ns;
+}
+#else
+static timing_t start_time;
+
+static void stopwatch_start(void)
+{
+	start_time = timing_counter_get();
+}
+
+static uint64_t stopwatch_ns(void)
+{
+	timing_t end_time = timing_counter_get();
+
+	return timing_cycles_to_ns(timing_cycles_get(&start_time, &end_time));
+}
+#endif
+
+static void run(const char *name, bool (*recv)(uint16_t, uint32_t, uint32_t),
+		uint16_t size)
+{
+	uint32_t accepted = 0;
+	uint64_t ns;
+
+	reset(size);
+
+	stopwatch_start();
+
+	for (uint32_t r = 0; r < ROUNDS; r++) {
+		/* Sequence numbers of a round follow those of the previous
+		 * one, as do the contents of the PDUs
+		 */
+		uint32_t seq_offset = r * TRACE_LEN;
+		uint32_t salt = r * 0x9e3779b9U;
+
+		for (int i = 0; i < TRACE_LEN; i++) {
+			accepted += recv(trace[i].src,
+					 trace[i].seq + seq_offset,
+					 trace[i].tail ^ salt);
+		}
+	}
+
+	ns = MAX(stopwatch_ns(), 1);
+
+	printk("%-7s %5u %10u pkts/s %6u accepted\n", name, size,
+	       (uint32_t)((uint64_t)TRACE_LEN * ROUNDS * NSEC_PER_SEC / ns),
+	       accepted);
+}
+
+void main(void)
+{
+	timing_init();
+	timing_start();
+
+	record_trace();
+
+	printk("Mesh message cache benchmark: %d sources, %d packets\n",
+	       NUM_SOURCES, TRACE_LEN * ROUNDS);
+
+	for (int i = 0; i < ARRAY_SIZE(cache_sizes); i++) {
+		run("linear", linear_recv, cache_sizes[i]);
+		run("hashed", hashed_recv, cache_sizes[i]);
+	}
+
+	timing_stop();
+
+	printk("fin\n");
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+
+#include "net.h"
+#include "rpl.h"
+
+#include <time.h>
+
+/* Replay check of a gateway node receiving messages from as many sources as
+ * its replay protection list holds, in random order. Every REPLAY_PERIOD-th
+ * message is a replay of the previous message of its source. The check is
+ * done with bt_mesh_rpl_check() and with the linear search used before, and
+ * the reception rate of the node is reported.
+ */
+
+#define NUM_SOURCES CONFIG_BT_MESH_CRPL
+#define NUM_MSGS 65536
+#define REPLAY_PERIOD 10
+
+struct msg {
+	uint16_t src;
+	uint32_t seq;
+};
+
+static struct msg trace[NUM_MSGS];
+
+/* List as implemented before, searched linearly */
+static struct {
+	uint16_t src;
+	bool old_iv;
+	uint32_t seq;
+} linear_list[CONFIG_BT_MESH_CRPL];
+
+static uint32_t rand_state = 0x72706c00;
+
+static uint32_t rand32(void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+static void record_trace(void)
+{
+	static uint32_t seqs[NUM_SOURCES];
+
+	for (int i = 0; i < NUM_MSGS; i++) {
+		uint16_t n = rand32() % NUM_SOURCES;
+
+		trace[i].src = 1 + n;
+
+		if (i % REPLAY_PERIOD == REPLAY_PERIOD - 1 && seqs[n]) {
+			trace[i].seq = seqs[n] - 1;
+		} else {
+			trace[i].seq = seqs[n]++;
+		}
+	}
+}
+
+static bool linear_check(struct bt_mesh_net_rx *rx)
+{
+	for (int i = 0; i < ARRAY_SIZE(linear_list); i++) {
+		if (!linear_list[i].src) {
+			linear_list[i].src = rx->ctx.addr;
+			linear_list[i].seq = rx->seq;
+			linear_list[i].old_iv = rx->old_iv;
+			return false;
+		}
+
+		if (linear_list[i].src != rx->ctx.addr) {
+			continue;
+		}
+
+		if (rx->old_iv && !linear_list[i].old_iv) {
+			return true;
+		}
+
+		if ((!rx->old_iv && linear_list[i].old_iv) ||
+		    linear_list[i].seq < rx->seq) {
+			linear_list[i].seq = rx->seq;
+			linear_list[i].old_iv = rx->old_iv;
+			return false;
+		}
+
+		return true;
+	}
+
+	return true;
+}
+
+static bool hashed_check(struct bt_mesh_net_rx *rx)
+{
+	return bt_mesh_rpl_check(rx, NULL);
+}
+
+/* Simulated time does not advance while native_posix runs code */
+static uint64_t host_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static void run(const char *name, bool (*check)(struct bt_mesh_net_rx *rx))
+{
+	struct bt_mesh_net_rx rx = {
+		.net_if = BT_MESH_NET_IF_ADV,
+		.local_match = 1,
+	};
+	uint32_t replays = 0;
+	uint64_t start, ns;
+
+	(void)memset(linear_list, 0, sizeof(linear_list));
+	bt_mesh_rpl_clear();
+
+	start = host_ns();
+
+	for (int i = 0; i < NUM_MSGS; i++) {
+		rx.ctx.addr = trace[i].src;
+		rx.seq = trace[i].seq;
+
+		replays += check(&rx);
+	}
+
+	ns = MAX(host_ns() - start, 1);
+
+	printk("%-7s %10u pkts/s %6u replays\n", name,
+	       (uint32_t)((uint64_t)NUM_MSGS * NSEC_PER_SEC / ns), replays);
+}
+
+void main(void)
+{
+	record_trace();
+
+	printk("Mesh RPL benchmark: %d sources, %d messages\n", NUM_SOURCES,
+	       NUM_MSGS);
+
+	run("linear", linear_check);
+	run("hashed", hashed_check);
+
+	printk("fin\n");
+}
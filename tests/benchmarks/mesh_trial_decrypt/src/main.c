@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+
+#include "mesh.h"
+#include "net.h"
+#include "subnet.h"
+#include "app_keys.h"
+#include "access.h"
+#include "crypto.h"
+#include "foundation.h"
+
+#include <time.h>
+
+/* Receive path of a node with many subnets and application keys: network
+ * PDUs from NUM_SOURCES nodes, each one always using the same application
+ * key, are decrypted with bt_mesh_net_decode() and then with the application
+ * keys, as the transport layer does for unsegmented access messages. The
+ * reception rate and the trial decryption counters are reported.
+ *
+ * The application keys are bound to the first APP_SUBNETS subnets, so that
+ * several of them share each AID.
+ */
+
+#define NUM_SUBNETS CONFIG_BT_MESH_SUBNET_COUNT
+#define NUM_APPS CONFIG_BT_MESH_APP_KEY_COUNT
+#define APP_SUBNETS 2
+#define NUM_SOURCES 64
+#define NUM_PDUS 256
+#define ROUNDS 8
+#define LOCAL_ADDR 0x0001
+#define SOURCE_ADDR 0x0100
+#define PAYLOAD_LEN 8
+
+struct pdu {
+	uint8_t len;
+	uint8_t data[BT_MESH_NET_MAX_PDU_LEN];
+};
+
+static struct pdu pdus[NUM_PDUS];
+
+static struct bt_mesh_model root_models[] = {
+	BT_MESH_MODEL_CFG_SRV,
+};
+
+static struct bt_mesh_elem elements[] = {
+	BT_MESH_ELEM(0, root_models, BT_MESH_MODEL_NONE),
+};
+
+static const struct bt_mesh_comp comp = {
+	.elem = elements,
+	.elem_count = ARRAY_SIZE(elements),
+};
+
+static void key_value(uint8_t key[16], uint16_t idx, uint8_t type)
+{
+	(void)memset(key, type, 16);
+	sys_put_be16(idx, key);
+}
+
+static int keys_create(void)
+{
+	uint8_t key[16];
+
+	for (uint16_t i = 0; i < NUM_SUBNETS; i++) {
+		key_value(key, i, 'N');
+		if (bt_mesh_subnet_add(i, key) != STATUS_SUCCESS) {
+			return -EIO;
+		}
+	}
+
+	for (uint16_t i = 0; i < NUM_APPS; i++) {
+		key_value(key, i, 'A');
+		if (bt_mesh_app_key_add(i, i % APP_SUBNETS, key) !=
+		    STATUS_SUCCESS) {
+			return -EIO;
+		}
+	}
+
+	return 0;
+}
+
+/* Encrypt an unsegmented access message from a source to the local node */
+static int pdu_create(struct pdu *pdu, uint16_t src)
+{
+	uint16_t app_idx = (src - SOURCE_ADDR) % NUM_APPS;
+	NET_BUF_SIMPLE_DEFINE(buf, BT_MESH_NET_MAX_PDU_LEN);
+	struct bt_mesh_msg_ctx ctx = {
+		.net_idx = app_idx % APP_SUBNETS,
+		.app_idx = app_idx,
+		.addr = LOCAL_ADDR,
+		.send_ttl = 3,
+	};
+	struct bt_mesh_net_tx tx = {
+		.sub = bt_mesh_subnet_get(ctx.net_idx),
+		.ctx = &ctx,
+		.src = src,
+	};
+	struct bt_mesh_app_crypto_ctx crypto = {
+		.src = src,
+		.dst = LOCAL_ADDR,
+		.seq_num = bt_mesh.seq,
+		.iv_index = BT_MESH_NET_IVI_TX,
+	};
+	uint8_t key[16];
+	uint8_t aid;
+	int err;
+
+	key_value(key, app_idx, 'A');
+	err = bt_mesh_app_id(key, &aid);
+	if (err) {
+		return err;
+	}
+
+	/* Room for the network header and the transport header, with the
+	 * AKF bit and the AID, which is not encrypted
+	 */
+	net_buf_simple_reserve(&buf, BT_MESH_NET_HDR_LEN + 1);
+	(void)memset(net_buf_simple_add(&buf, PAYLOAD_LEN), src, PAYLOAD_LEN);
+
+	err = bt_mesh_app_encrypt(key, &crypto, &buf);
+	if (err) {
+		return err;
+	}
+
+	net_buf_simple_push_u8(&buf, BIT(6) | aid);
+
+	err = bt_mesh_net_encode(&tx, &buf, false);
+	if (err) {
+		return err;
+	}
+
+	pdu->len = buf.len;
+	memcpy(pdu->data, buf.data, buf.len);
+
+	return 0;
+}
+
+static int app_try_decrypt(struct bt_mesh_net_rx *rx, const uint8_t key[16],
+			   void *cb_data)
+{
+	struct net_buf_simple *buf = cb_data;
+	NET_BUF_SIMPLE_DEFINE(sdu, BT_MESH_NET_MAX_PDU_LEN);
+	struct bt_mesh_app_crypto_ctx crypto = {
+		.src = rx->ctx.addr,
+		.dst = rx->ctx.recv_dst,
+		.seq_num = rx->seq,
+		.iv_index = BT_MESH_NET_IVI_RX(rx),
+	};
+
+	return bt_mesh_app_decrypt(key, &crypto, buf, &sdu);
+}
+
+static bool pdu_recv(const struct pdu *pdu)
+{
+	NET_BUF_SIMPLE_DEFINE(in, BT_MESH_NET_MAX_PDU_LEN);
+	NET_BUF_SIMPLE_DEFINE(out, BT_MESH_NET_MAX_PDU_LEN);
+	struct bt_mesh_net_rx rx = { 0 };
+	uint16_t app_idx;
+	uint8_t hdr;
+
+	net_buf_simple_add_mem(&in, pdu->data, pdu->len);
+
+	/* The proxy interface skips the duplicate and message caches */
+	if (bt_mesh_net_decode(&in, BT_MESH_NET_IF_PROXY, &rx, &out)) {
+		return false;
+	}
+
+	net_buf_simple_pull(&out, BT_MESH_NET_HDR_LEN);
+	hdr = net_buf_simple_pull_u8(&out);
+
+	app_idx = bt_mesh_app_key_find(false, hdr & BIT_MASK(6), &rx,
+				       app_try_decrypt, &out);
+
+	return app_idx != BT_MESH_KEY_UNUSED;
+}
+
+/* Simulated time does not advance while native_posix runs code */
+static uint64_t host_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+void main(void)
+{
+	struct bt_mesh_trial_stats net, app;
+	uint32_t received = 0;
+	uint64_t start, ns;
+	int err;
+
+	err = bt_mesh_comp_register(&comp);
+	if (!err) {
+		bt_mesh_comp_provision(LOCAL_ADDR);
+		err = keys_create();
+	}
+
+	for (int i = 0; !err && i < NUM_PDUS; i++) {
+		err = pdu_create(&pdus[i], SOURCE_ADDR + i % NUM_SOURCES);
+	}
+
+	if (err) {
+		printk("Setup failed (err %d)\n", err);
+		return;
+	}
+
+	printk("Trial decryption benchmark: %d subnets, %d app keys, "
+	       "%d sources, src cache %d\n", NUM_SUBNETS, NUM_APPS,
+	       NUM_SOURCES, CONFIG_BT_MESH_APP_KEY_SRC_CACHE_SIZE);
+
+	start = host_ns();
+
+	for (int r = 0; r < ROUNDS; r++) {
+		for (int i = 0; i < NUM_PDUS; i++) {
+			received += pdu_recv(&pdus[i]);
+		}
+	}
+
+	ns = MAX(host_ns() - start, 1);
+
+	bt_mesh_net_cred_stats_get(&net);
+	bt_mesh_app_key_stats_get(&app);
+
+	printk("%u of %u received, %u pkts/s\n", received, ROUNDS * NUM_PDUS,
+	       (uint32_t)((uint64_t)ROUNDS * NUM_PDUS * NSEC_PER_SEC / ns));
+	printk("net %8u attempts %8u hits\n", net.attempts, net.hits);
+	printk("app %8u attempts %8u hits\n", app.attempts, app.hits);
+
+	printk("fin\n");
+}
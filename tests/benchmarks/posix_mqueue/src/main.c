@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <fcntl.h>
+#include <string.h>
+#include <posix/mqueue.h>
+
+/* A sender thread passes NUM_MSGS messages to the main thread through a
+ * POSIX message queue, either copying them with mq_send()/mq_receive() or
+ * loaning the buffers of the queue, and the message rate is reported for
+ * each payload size.
+ */
+
+#define NUM_MSGS 20000
+#define MAX_MSGS 8
+#define MAX_PAYLOAD 1024
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+static const size_t payload_sizes[] = { 16, 64, 256, 1024 };
+
+K_THREAD_STACK_DEFINE(sender_stack, STACK_SIZE);
+static struct k_thread sender_thread;
+
+static char send_buf[MAX_PAYLOAD];
+static char recv_buf[MAX_PAYLOAD];
+
+static uint32_t checksum(const char *data, size_t len)
+{
+	uint32_t sum = 0;
+
+	for (size_t i = 0; i < len; i++) {
+		sum += data[i];
+	}
+
+	return sum;
+}
+
+static void sender_fn(void *p1, void *p2, void *p3)
+{
+	mqd_t mqd = p1;
+	size_t len = POINTER_TO_UINT(p2);
+	bool loan = POINTER_TO_UINT(p3) != 0U;
+
+	for (int i = 0; i < NUM_MSGS; i++) {
+		if (loan) {
+			char *buf = mq_loan_np(mqd, NULL);
+
+			(void)memset(buf, i, len);
+			mq_send_loan_np(mqd, buf, len, 0);
+		} else {
+			(void)memset(send_buf, i, len);
+			mq_send(mqd, send_buf, len, 0);
+		}
+	}
+}
+
+static void run(mqd_t mqd, size_t len, bool loan)
+{
+	volatile uint32_t sink = 0;
+	int64_t start, elapsed;
+	char *buf;
+	int n;
+
+	start = k_uptime_get();
+
+	k_thread_create(&sender_thread, sender_stack, STACK_SIZE, sender_fn,
+			mqd, UINT_TO_POINTER(len), UINT_TO_POINTER(loan),
+			k_thread_priority_get(k_current_get()), 0, K_NO_WAIT);
+
+	for (int i = 0; i < NUM_MSGS; i++) {
+		if (loan) {
+			n = mq_receive_loan_np(mqd, &buf, NULL, NULL);
+			sink += checksum(buf, n);
+			mq_return_np(mqd, buf);
+		} else {
+			n = mq_receive(mqd, recv_buf, sizeof(recv_buf), NULL);
+			sink += checksum(recv_buf, n);
+		}
+	}
+
+	elapsed = k_uptime_get() - start;
+	k_thread_join(&sender_thread, K_FOREVER);
+
+	printk("%-5s %4u msgs/s %10u\n", loan ? "loan" : "copy", (unsigned int)len,
+	       (uint32_t)(NUM_MSGS * MSEC_PER_SEC / MAX(elapsed, 1)));
+}
+
+void main(void)
+{
+	struct mq_attr attrs = {
+		.mq_maxmsg = MAX_MSGS,
+	};
+	mqd_t mqd;
+
+	printk("POSIX message queue benchmark: %d messages, queue of %d\n",
+	       NUM_MSGS, MAX_MSGS);
+
+	for (int s = 0; s < ARRAY_SIZE(payload_sizes); s++) {
+		attrs.mq_msgsize = payload_sizes[s];
+		mqd = mq_open("bench", O_RDWR | O_CREAT, 0777, &attrs);
+		if (mqd == (mqd_t)-1) {
+			printk("unable to open message queue\n");
+			return;
+		}
+
+		run(mqd, payload_sizes[s], false);
+		run(mqd, payload_sizes[s], true);
+
+		mq_close(mqd);
+		mq_unlink("bench");
+	}
+
+	printk("fin\n");
+}
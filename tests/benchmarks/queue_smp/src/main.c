@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+#include "smp_bench.h"
+
+/* SMP contention benchmark: one producer per CPU puts items from its own
+ * pool in a shared FIFO or LIFO, a single consumer gets them and hands
+ * them back to their pool. The aggregate put and get rates are reported.
+ */
+
+#define NUM_PRODUCERS SMP_BENCH_THREADS
+#define ITEMS_PER_PRODUCER 32
+
+enum kind {
+	KIND_FIFO,
+	KIND_LIFO,
+	NUM_KINDS
+};
+
+static const char *const kind_names[NUM_KINDS] = {
+	"fifo", "lifo"
+};
+
+struct item {
+	void *reserved;
+	atomic_t queued;
+};
+
+static struct item items[NUM_PRODUCERS][ITEMS_PER_PRODUCER];
+
+static K_FIFO_DEFINE(bench_fifo);
+static K_LIFO_DEFINE(bench_lifo);
+
+static uint64_t gets;
+static enum kind active_kind;
+
+static void put(struct item *item)
+{
+	if (active_kind == KIND_FIFO) {
+		k_fifo_put(&bench_fifo, item);
+	} else {
+		k_lifo_put(&bench_lifo, item);
+	}
+}
+
+static struct item *get(k_timeout_t timeout)
+{
+	if (active_kind == KIND_FIFO) {
+		return k_fifo_get(&bench_fifo, timeout);
+	}
+
+	return k_lifo_get(&bench_lifo, timeout);
+}
+
+static void producer(int id)
+{
+	while (smp_bench_running) {
+		for (int i = 0; i < ITEMS_PER_PRODUCER; i++) {
+			struct item *item = &items[id][i];
+
+			if (atomic_cas(&item->queued, 0, 1)) {
+				put(item);
+				smp_bench_stats[id].ops++;
+			}
+		}
+	}
+}
+
+/* Drains the queue before returning */
+static void consumer(void)
+{
+	struct item *item;
+
+	while (true) {
+		item = get(K_MSEC(10));
+		if (item == NULL) {
+			if (!smp_bench_running) {
+				break;
+			}
+			continue;
+		}
+
+		gets++;
+		(void)atomic_clear(&item->queued);
+	}
+}
+
+static void run(enum kind kind)
+{
+	uint32_t puts;
+
+	active_kind = kind;
+	gets = 0;
+	for (int i = 0; i < NUM_PRODUCERS; i++) {
+		for (int j = 0; j < ITEMS_PER_PRODUCER; j++) {
+			(void)atomic_clear(&items[i][j].queued);
+		}
+	}
+
+	puts = smp_bench_run(producer, consumer);
+
+	printk("%-8s puts/s %10u gets/s %10u\n", kind_names[kind], puts,
+	       smp_bench_rate(gets));
+}
+
+void main(void)
+{
+	printk("Queue SMP benchmark: %d producers, %d items each, "
+	       "lock-free put %s\n", NUM_PRODUCERS, ITEMS_PER_PRODUCER,
+	       IS_ENABLED(CONFIG_QUEUE_LOCKFREE_PUT) ? "on" : "off");
+
+	for (enum kind k = KIND_FIFO; k < NUM_KINDS; k++) {
+		run(k);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <random/rand32.h>
+#include <timing/timing.h>
+
+/* Cost of sys_rand32_get() and throughput of sys_rand_get() for the
+ * generator selected by Kconfig.
+ */
+
+#define ITERATIONS 4096
+#define MAX_FILL 1024
+
+static const size_t fill_sizes[] = { 4, 16, 64, 256, MAX_FILL };
+
+static uint8_t buf[MAX_FILL];
+static volatile uint32_t sink;
+
+static const char *generator(void)
+{
+	if (IS_ENABLED(CONFIG_XOSHIRO_RANDOM_GENERATOR)) {
+		return "xoshiro256**";
+	} else if (IS_ENABLED(CONFIG_XOROSHIRO_RANDOM_GENERATOR)) {
+		return "xoroshiro128+";
+	} else if (IS_ENABLED(CONFIG_ENTROPY_DEVICE_RANDOM_GENERATOR)) {
+		return "entropy device";
+	}
+
+	return "other";
+}
+
+static void bench_rand32(void)
+{
+	timing_t start, end;
+	uint64_t cycles;
+
+	start = timing_counter_get();
+	for (int i = 0; i < ITERATIONS; i++) {
+		sink = sys_rand32_get();
+	}
+	end = timing_counter_get();
+	cycles = timing_cycles_get(&start, &end);
+
+	printk("%-20s %6u cycles\n", "sys_rand32_get",
+	       (uint32_t)(cycles / ITERATIONS));
+}
+
+static void bench_fill(size_t size)
+{
+	uint64_t bytes = (uint64_t)size * ITERATIONS;
+	timing_t start, end;
+	uint64_t cycles, ns;
+
+	start = timing_counter_get();
+	for (int i = 0; i < ITERATIONS; i++) {
+		sys_rand_get(buf, size);
+	}
+	end = timing_counter_get();
+	cycles = timing_cycles_get(&start, &end);
+	ns = timing_cycles_to_ns(cycles);
+
+	/* bytes per ms is KB/s */
+	printk("%-14s %5u %8u KB/s %6u cycles/call\n", "sys_rand_get",
+	       (uint32_t)size,
+	       (uint32_t)((ns != 0U) ? (bytes * 1000000U / ns) : 0U),
+	       (uint32_t)(cycles / ITERATIONS));
+}
+
+void main(void)
+{
+	timing_init();
+	timing_start();
+
+	printk("Random number generator: %s\n", generator());
+
+	bench_rand32();
+
+	for (int i = 0; i < ARRAY_SIZE(fill_sizes); i++) {
+		bench_fill(fill_sizes[i]);
+	}
+
+	timing_stop();
+
+	printk("fin\n");
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <rcu.h>
+
+#include "smp_bench.h"
+
+/* Read-mostly table benchmark: one reader per CPU repeatedly scans a
+ * small table while a writer replaces one entry every WRITE_PERIOD_MS.
+ * The same workload is run with the table protected by RCU, by a
+ * spinlock and by a mutex, and the aggregate lookup rate is reported.
+ */
+
+#define NUM_READERS SMP_BENCH_THREADS
+#define TABLE_SIZE 16
+#define WRITE_PERIOD_MS 5
+
+enum scheme {
+	SCHEME_RCU,
+	SCHEME_SPINLOCK,
+	SCHEME_MUTEX,
+	NUM_SCHEMES
+};
+
+static const char *const scheme_names[NUM_SCHEMES] = {
+	"rcu", "spinlock", "mutex"
+};
+
+struct table {
+	uint32_t entries[TABLE_SIZE];
+};
+
+/* Two copies for RCU: readers use the published one while the writer
+ * prepares the other
+ */
+static struct table tables[2];
+static struct table *current_table = &tables[0];
+
+static struct k_spinlock table_spinlock;
+static K_MUTEX_DEFINE(table_mutex);
+
+static volatile uint32_t writes;
+static enum scheme active_scheme;
+
+static uint32_t scan(const struct table *t)
+{
+	uint32_t sum = 0;
+
+	for (int i = 0; i < TABLE_SIZE; i++) {
+		sum += t->entries[i];
+	}
+
+	return sum;
+}
+
+static uint32_t lookup(void)
+{
+	k_spinlock_key_t key;
+	uint32_t sum;
+
+	switch (active_scheme) {
+	case SCHEME_RCU:
+		k_rcu_read_lock();
+		sum = scan(K_RCU_DEREFERENCE(current_table));
+		k_rcu_read_unlock();
+		break;
+	case SCHEME_SPINLOCK:
+		key = k_spin_lock(&table_spinlock);
+		sum = scan(current_table);
+		k_spin_unlock(&table_spinlock, key);
+		break;
+	default:
+		k_mutex_lock(&table_mutex, K_FOREVER);
+		sum = scan(current_table);
+		k_mutex_unlock(&table_mutex);
+		break;
+	}
+
+	return sum;
+}
+
+static void update(uint32_t seq)
+{
+	k_spinlock_key_t key;
+	struct table *old, *new;
+
+	switch (active_scheme) {
+	case SCHEME_RCU:
+		/* Writers are serialized by the single writer thread */
+		old = current_table;
+		new = (old == &tables[0]) ? &tables[1] : &tables[0];
+		*new = *old;
+		new->entries[seq % TABLE_SIZE] = seq;
+		K_RCU_ASSIGN_POINTER(current_table, new);
+		k_rcu_synchronize();
+		break;
+	case SCHEME_SPINLOCK:
+		key = k_spin_lock(&table_spinlock);
+		current_table->entries[seq % TABLE_SIZE] = seq;
+		k_spin_unlock(&table_spinlock, key);
+		break;
+	default:
+		k_mutex_lock(&table_mutex, K_FOREVER);
+		current_table->entries[seq % TABLE_SIZE] = seq;
+		k_mutex_unlock(&table_mutex);
+		break;
+	}
+}
+
+static void reader(int id)
+{
+	volatile uint32_t sink;
+
+	while (smp_bench_running) {
+		sink = lookup();
+		smp_bench_stats[id].ops++;
+	}
+
+	ARG_UNUSED(sink);
+}
+
+static void writer(void)
+{
+	uint32_t seq = 0;
+
+	while (smp_bench_running) {
+		update(++seq);
+		writes++;
+		k_msleep(WRITE_PERIOD_MS);
+	}
+}
+
+static void run(enum scheme scheme)
+{
+	uint32_t rate;
+
+	active_scheme = scheme;
+	writes = 0;
+
+	rate = smp_bench_run(reader, writer);
+
+	printk("%-8s reads/s %10u writes %u\n", scheme_names[scheme], rate,
+	       writes);
+}
+
+void main(void)
+{
+	printk("RCU benchmark: %d readers, table of %d entries, "
+	       "1 write every %d ms\n",
+	       NUM_READERS, TABLE_SIZE, WRITE_PERIOD_MS);
+
+	for (enum scheme s = SCHEME_RCU; s < NUM_SCHEMES; s++) {
+		run(s);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+#include "smp_bench.h"
+
+/* Read-mostly table benchmark: one thread per CPU repeatedly scans a small
+ * table under a read lock, or updates one entry under a write lock, with a
+ * fixed proportion of writes. The aggregate operation rate is reported for
+ * each policy of k_rwlock and for a k_mutex.
+ */
+
+#define TABLE_SIZE 16
+
+enum scheme {
+	SCHEME_PREFER_READER,
+	SCHEME_PREFER_WRITER,
+	SCHEME_PHASE_FAIR,
+	SCHEME_MUTEX,
+	NUM_SCHEMES
+};
+
+static const char *const scheme_names[NUM_SCHEMES] = {
+	"rd-pref", "wr-pref", "fair", "mutex"
+};
+
+static const unsigned int scheme_policies[NUM_SCHEMES] = {
+	K_RWLOCK_PREFER_READER, K_RWLOCK_PREFER_WRITER, K_RWLOCK_PHASE_FAIR
+};
+
+/* Percentage of reads */
+static const int mixes[] = { 100, 99, 90 };
+
+static uint32_t table[TABLE_SIZE];
+
+static struct k_rwlock table_rwlock;
+static K_MUTEX_DEFINE(table_mutex);
+
+static enum scheme active_scheme;
+static uint32_t write_percent;
+
+static uint32_t lookup(void)
+{
+	uint32_t sum = 0;
+
+	if (active_scheme == SCHEME_MUTEX) {
+		k_mutex_lock(&table_mutex, K_FOREVER);
+	} else {
+		k_rwlock_read_lock(&table_rwlock, K_FOREVER);
+	}
+
+	for (int i = 0; i < TABLE_SIZE; i++) {
+		sum += table[i];
+	}
+
+	if (active_scheme == SCHEME_MUTEX) {
+		k_mutex_unlock(&table_mutex);
+	} else {
+		k_rwlock_read_unlock(&table_rwlock);
+	}
+
+	return sum;
+}
+
+static void update(uint32_t seq)
+{
+	if (active_scheme == SCHEME_MUTEX) {
+		k_mutex_lock(&table_mutex, K_FOREVER);
+		table[seq % TABLE_SIZE] = seq;
+		k_mutex_unlock(&table_mutex);
+	} else {
+		k_rwlock_write_lock(&table_rwlock, K_FOREVER);
+		table[seq % TABLE_SIZE] = seq;
+		k_rwlock_write_unlock(&table_rwlock);
+	}
+}
+
+static void worker(int id)
+{
+	volatile uint32_t sink;
+	uint32_t seq = 0;
+
+	while (smp_bench_running) {
+		/* Spread the writes evenly over the operations */
+		if ((seq++ % 100) < write_percent) {
+			update(seq);
+		} else {
+			sink = lookup();
+		}
+		smp_bench_stats[id].ops++;
+	}
+
+	ARG_UNUSED(sink);
+}
+
+static void run(enum scheme scheme, int read_percent)
+{
+	uint32_t rate;
+
+	active_scheme = scheme;
+	write_percent = 100 - read_percent;
+	if (scheme != SCHEME_MUTEX) {
+		k_rwlock_init(&table_rwlock, scheme_policies[scheme]);
+	}
+
+	rate = smp_bench_run(worker, NULL);
+
+	printk("%-8s %3d%% ops/s %10u\n", scheme_names[scheme], read_percent,
+	       rate);
+}
+
+void main(void)
+{
+	printk("rwlock benchmark: %d threads, table of %d entries\n",
+	       SMP_BENCH_THREADS, TABLE_SIZE);
+
+	for (enum scheme s = SCHEME_PREFER_READER; s < NUM_SCHEMES; s++) {
+		for (int m = 0; m < ARRAY_SIZE(mixes); m++) {
+			run(s, mixes[m]);
+		}
+	}
+
+	printk("fin\n");
+}
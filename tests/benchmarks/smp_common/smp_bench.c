@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+
+#include "smp_bench.h"
+
+struct smp_bench_stats smp_bench_stats[SMP_BENCH_THREADS];
+volatile bool smp_bench_running;
+
+static smp_bench_worker_t active_worker;
+static smp_bench_helper_t active_helper;
+
+K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, SMP_BENCH_THREADS,
+			    SMP_BENCH_STACK_SIZE);
+static struct k_thread worker_threads[SMP_BENCH_THREADS];
+K_THREAD_STACK_DEFINE(helper_stack, SMP_BENCH_STACK_SIZE);
+static struct k_thread helper_thread;
+
+static void worker_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	active_worker(POINTER_TO_INT(p1));
+}
+
+static void helper_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	active_helper();
+}
+
+uint32_t smp_bench_run(smp_bench_worker_t worker, smp_bench_helper_t helper)
+{
+	uint64_t total = 0;
+
+	active_worker = worker;
+	active_helper = helper;
+	for (int i = 0; i < SMP_BENCH_THREADS; i++) {
+		smp_bench_stats[i].ops = 0;
+	}
+
+	smp_bench_running = true;
+
+	if (helper != NULL) {
+		k_thread_create(&helper_thread, helper_stack,
+				SMP_BENCH_STACK_SIZE, helper_fn, NULL, NULL,
+				NULL, SMP_BENCH_HELPER_PRIO, 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < SMP_BENCH_THREADS; i++) {
+		k_thread_create(&worker_threads[i], worker_stacks[i],
+				SMP_BENCH_STACK_SIZE, worker_fn,
+				INT_TO_POINTER(i), NULL, NULL,
+				SMP_BENCH_WORKER_PRIO, 0, K_NO_WAIT);
+	}
+
+	k_msleep(SMP_BENCH_RUN_TIME_MS);
+	smp_bench_running = false;
+
+	for (int i = 0; i < SMP_BENCH_THREADS; i++) {
+		k_thread_join(&worker_threads[i], K_FOREVER);
+		total += smp_bench_stats[i].ops;
+	}
+
+	if (helper != NULL) {
+		k_thread_join(&helper_thread, K_FOREVER);
+	}
+
+	return smp_bench_rate(total);
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_TESTS_BENCHMARKS_SMP_COMMON_SMP_BENCH_H_
+#define ZEPHYR_TESTS_BENCHMARKS_SMP_COMMON_SMP_BENCH_H_
+
+#include <zephyr.h>
+
+/* Skeleton shared by the SMP benchmarks: one worker thread per CPU, and
+ * optionally a helper thread, run for SMP_BENCH_RUN_TIME_MS. The workers
+ * count their operations, and the aggregate rate is reported.
+ */
+
+#define SMP_BENCH_THREADS CONFIG_MP_NUM_CPUS
+#define SMP_BENCH_RUN_TIME_MS 2000
+#define SMP_BENCH_STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define SMP_BENCH_WORKER_PRIO 5
+#define SMP_BENCH_HELPER_PRIO 4
+
+/* Keep per-worker counters on separate cache lines */
+struct smp_bench_stats {
+	uint64_t ops;
+} __aligned(64);
+
+extern struct smp_bench_stats smp_bench_stats[SMP_BENCH_THREADS];
+
+/* Set for the duration of a run, the threads return once it is cleared */
+extern volatile bool smp_bench_running;
+
+/* Worker of index @p id, counting its operations in smp_bench_stats */
+typedef void (*smp_bench_worker_t)(int id);
+
+typedef void (*smp_bench_helper_t)(void);
+
+/* Run the workers, and the helper if not NULL, and return the aggregate
+ * number of worker operations per second. The helper is joined after the
+ * workers, so that it can process what they left.
+ */
+uint32_t smp_bench_run(smp_bench_worker_t worker, smp_bench_helper_t helper);
+
+/* Rate per second of a count over a run */
+static inline uint32_t smp_bench_rate(uint64_t count)
+{
+	return (uint32_t)(count * MSEC_PER_SEC / SMP_BENCH_RUN_TIME_MS);
+}
+
+#endif /* ZEPHYR_TESTS_BENCHMARKS_SMP_COMMON_SMP_BENCH_H_ */
@@ -0,0 +1,309 @@
+/* main.c - HCI advertising report thread test */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+
+#include <errno.h>
+#include <ztest.h>
+
+#include <bluetooth/hci.h>
+#include <bluetooth/buf.h>
+#include <bluetooth/bluetooth.h>
+#include <drivers/bluetooth/hci_driver.h>
+#include <sys/byteorder.h>
+
+/* Command handler structure for cmd_handle(). */
+struct cmd_handler {
+	uint16_t opcode; /* HCI command opcode */
+	uint8_t len;     /* HCI command response length */
+	void (*handler)(struct net_buf *buf, struct net_buf **evt,
+			uint8_t len, uint16_t opcode);
+};
+
+/* Add event to net_buf. */
+static void evt_create(struct net_buf *buf, uint8_t evt, uint8_t len)
+{
+	struct bt_hci_evt_hdr *hdr;
+
+	hdr = net_buf_add(buf, sizeof(*hdr));
+	hdr->evt = evt;
+	hdr->len = len;
+}
+
+/* Create a command complete event. */
+static void *cmd_complete(struct net_buf **buf, uint8_t plen, uint16_t opcode)
+{
+	struct bt_hci_evt_cmd_complete *cc;
+
+	*buf = bt_buf_get_evt(BT_HCI_EVT_CMD_COMPLETE, false, K_FOREVER);
+	evt_create(*buf, BT_HCI_EVT_CMD_COMPLETE, sizeof(*cc) + plen);
+	cc = net_buf_add(*buf, sizeof(*cc));
+	cc->ncmd = 1U;
+	cc->opcode = sys_cpu_to_le16(opcode);
+	return net_buf_add(*buf, plen);
+}
+
+/* Generic command complete with success status. */
+static void generic_success(struct net_buf *buf, struct net_buf **evt,
+			    uint8_t len, uint16_t opcode)
+{
+	struct bt_hci_evt_cc_status *ccst;
+
+	ccst = cmd_complete(evt, len, opcode);
+
+	/* Fill any event parameters with zero */
+	(void)memset(ccst, 0, len);
+
+	ccst->status = BT_HCI_ERR_SUCCESS;
+}
+
+/* Command complete with all bits set in the response parameters. */
+static void all_supported(struct net_buf *buf, struct net_buf **evt,
+			  uint8_t len, uint16_t opcode)
+{
+	struct bt_hci_evt_cc_status *ccst;
+
+	ccst = cmd_complete(evt, len, opcode);
+	(void)memset(ccst, 0xFF, len);
+	ccst->status = BT_HCI_ERR_SUCCESS;
+}
+
+/* Setup handlers needed for bt_enable to function. */
+static const struct cmd_handler cmds[] = {
+	{ BT_HCI_OP_READ_LOCAL_VERSION_INFO,
+	  sizeof(struct bt_hci_rp_read_local_version_info),
+	  generic_success },
+	{ BT_HCI_OP_READ_SUPPORTED_COMMANDS,
+	  sizeof(struct bt_hci_rp_read_supported_commands),
+	  all_supported },
+	{ BT_HCI_OP_READ_LOCAL_FEATURES,
+	  sizeof(struct bt_hci_rp_read_local_features),
+	  all_supported },
+	{ BT_HCI_OP_READ_BD_ADDR,
+	  sizeof(struct bt_hci_rp_read_bd_addr),
+	  generic_success },
+	{ BT_HCI_OP_SET_EVENT_MASK,
+	  sizeof(struct bt_hci_evt_cc_status),
+	  generic_success },
+	{ BT_HCI_OP_LE_SET_EVENT_MASK,
+	  sizeof(struct bt_hci_evt_cc_status),
+	  generic_success },
+	{ BT_HCI_OP_LE_READ_LOCAL_FEATURES,
+	  sizeof(struct bt_hci_rp_le_read_local_features),
+	  all_supported },
+	{ BT_HCI_OP_LE_READ_SUPP_STATES,
+	  sizeof(struct bt_hci_rp_le_read_supp_states),
+	  all_supported },
+	{ BT_HCI_OP_LE_RAND,
+	  sizeof(struct bt_hci_rp_le_rand),
+	  generic_success },
+	{ BT_HCI_OP_LE_SET_RANDOM_ADDRESS,
+	  sizeof(struct bt_hci_cp_le_set_random_address),
+	  generic_success },
+};
+
+/* HCI driver open. */
+static int driver_open(void)
+{
+	return 0;
+}
+
+/* HCI driver send, answering the commands issued by bt_enable(). */
+static int driver_send(struct net_buf *buf)
+{
+	struct net_buf *evt = NULL;
+	struct bt_hci_cmd_hdr *chdr;
+	uint16_t opcode;
+
+	chdr = net_buf_pull_mem(buf, sizeof(*chdr));
+	opcode = sys_le16_to_cpu(chdr->opcode);
+
+	for (size_t i = 0; i < ARRAY_SIZE(cmds); i++) {
+		if (cmds[i].opcode == opcode) {
+			cmds[i].handler(buf, &evt, cmds[i].len, opcode);
+			break;
+		}
+	}
+
+	zassert_not_null(evt, "Unknown HCI command 0x%04x", opcode);
+	bt_recv_prio(evt);
+	net_buf_unref(buf);
+
+	return 0;
+}
+
+/* HCI driver structure. */
+static const struct bt_hci_driver drv = {
+	.name         = "test",
+	.bus          = BT_HCI_DRIVER_BUS_VIRTUAL,
+	.open         = driver_open,
+	.send         = driver_send,
+	.quirks       = BT_QUIRK_NO_RESET,
+};
+
+/* Reports seen by the scan listener */
+static K_SEM_DEFINE(report_sem, 0, 16);
+/* Taken by the scan listener for each report while blocking is set */
+static K_SEM_DEFINE(gate_sem, 0, 16);
+static volatile bool blocking;
+static volatile int recv_prio;
+
+static void scan_recv(const struct bt_le_scan_recv_info *info,
+		      struct net_buf_simple *buf)
+{
+	recv_prio = k_thread_priority_get(k_current_get());
+
+	k_sem_give(&report_sem);
+
+	if (blocking) {
+		k_sem_take(&gate_sem, K_FOREVER);
+	}
+}
+
+static struct bt_le_scan_cb scan_cb = {
+	.recv = scan_recv,
+};
+
+static K_SEM_DEFINE(vnd_sem, 0, 1);
+
+static bool vnd_evt(struct net_buf_simple *buf)
+{
+	k_sem_give(&vnd_sem);
+
+	return true;
+}
+
+/* Send a non-connectable advertising report from a fixed address. */
+static void send_adv_report(void)
+{
+	static const bt_addr_le_t addr = {
+		.type = BT_ADDR_LE_RANDOM,
+		.a.val = { 0x01, 0x02, 0x03, 0x04, 0x05, 0xc0 },
+	};
+	static const uint8_t ad[] = { 0x02, BT_DATA_FLAGS, BT_LE_AD_NO_BREDR };
+	struct bt_hci_evt_le_advertising_info *info;
+	struct bt_hci_evt_le_meta_event *meta;
+	struct net_buf *buf;
+
+	buf = bt_buf_get_rx(BT_BUF_EVT, K_FOREVER);
+	evt_create(buf, BT_HCI_EVT_LE_META_EVENT,
+		   sizeof(*meta) + 1 + sizeof(*info) + sizeof(ad) + 1);
+	meta = net_buf_add(buf, sizeof(*meta));
+	meta->subevent = BT_HCI_EVT_LE_ADVERTISING_REPORT;
+	net_buf_add_u8(buf, 1);
+	info = net_buf_add(buf, sizeof(*info));
+	info->evt_type = BT_GAP_ADV_TYPE_ADV_NONCONN_IND;
+	bt_addr_le_copy(&info->addr, &addr);
+	info->length = sizeof(ad);
+	net_buf_add_mem(buf, ad, sizeof(ad));
+	/* RSSI */
+	net_buf_add_u8(buf, (uint8_t)-60);
+
+	zassert_ok(bt_recv(buf), NULL);
+}
+
+/* Send a vendor event, processed by the receiving thread. */
+static void send_vnd_evt(void)
+{
+	struct net_buf *buf;
+
+	buf = bt_buf_get_rx(BT_BUF_EVT, K_FOREVER);
+	evt_create(buf, BT_HCI_EVT_VENDOR, 1);
+	net_buf_add_u8(buf, 0);
+
+	zassert_ok(bt_recv(buf), NULL);
+}
+
+static void test_rx_adv_init(void)
+{
+	bt_hci_driver_register(&drv);
+
+	zassert_ok(bt_enable(NULL), "bt_enable failed");
+
+	bt_hci_register_vnd_evt_cb(vnd_evt);
+	bt_le_scan_cb_register(&scan_cb);
+}
+
+/**
+ * @brief Test that the reports are processed by their own thread
+ */
+static void test_rx_adv_thread(void)
+{
+	blocking = false;
+
+	send_adv_report();
+	zassert_ok(k_sem_take(&report_sem, K_MSEC(100)),
+		   "report not processed");
+	zassert_equal(recv_prio, K_PRIO_COOP(CONFIG_BT_RX_ADV_PRIO),
+		      "report not processed by the report thread");
+}
+
+/**
+ * @brief Test that a blocked scan listener only delays reports, and that
+ * reports beyond the queue length are dropped and accounted
+ */
+static void test_rx_adv_queue(void)
+{
+	const int extra = 3;
+	struct bt_hci_rx_stats before, after;
+
+	bt_hci_rx_stats_get(&before);
+
+	/* The first report blocks the report thread in the listener */
+	blocking = true;
+	send_adv_report();
+	zassert_ok(k_sem_take(&report_sem, K_MSEC(100)),
+		   "report not processed");
+
+	for (int i = 0; i < CONFIG_BT_RX_ADV_QUEUE_LEN + extra; i++) {
+		send_adv_report();
+	}
+
+	/* Other events are still processed meanwhile */
+	send_vnd_evt();
+	zassert_ok(k_sem_take(&vnd_sem, K_MSEC(100)),
+		   "event stuck behind advertising reports");
+
+	k_msleep(20);
+
+	blocking = false;
+	k_sem_give(&gate_sem);
+
+	for (int i = 0; i < CONFIG_BT_RX_ADV_QUEUE_LEN; i++) {
+		zassert_ok(k_sem_take(&report_sem, K_MSEC(100)),
+			   "queued report %d not processed", i);
+	}
+	zassert_equal(k_sem_take(&report_sem, K_MSEC(50)), -EAGAIN,
+		      "dropped report processed");
+
+	bt_hci_rx_stats_get(&after);
+
+	zassert_equal(after.count[BT_HCI_RX_ADV] - before.count[BT_HCI_RX_ADV],
+		      CONFIG_BT_RX_ADV_QUEUE_LEN + 1, NULL);
+	zassert_equal(after.dropped[BT_HCI_RX_ADV] -
+		      before.dropped[BT_HCI_RX_ADV], extra, NULL);
+	zassert_equal(after.count[BT_HCI_RX_EVT] - before.count[BT_HCI_RX_EVT],
+		      1, NULL);
+	zassert_equal(after.dropped[BT_HCI_RX_EVT],
+		      before.dropped[BT_HCI_RX_EVT], NULL);
+	zassert_true(after.delay_max[BT_HCI_RX_ADV] >= 20U,
+		     "queueing delay of the reports not measured");
+	zassert_true(after.delay_total[BT_HCI_RX_ADV] >
+		     before.delay_total[BT_HCI_RX_ADV], NULL);
+}
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(test_hci_rx_adv,
+			 ztest_unit_test(test_rx_adv_init),
+			 ztest_unit_test(test_rx_adv_thread),
+			 ztest_unit_test(test_rx_adv_queue));
+
+	ztest_run_test_suite(test_hci_rx_adv);
+}
@@ -0,0 +1,427 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <sys/byteorder.h>
+#include <bluetooth/hci.h>
+#include <bluetooth/iso.h>
+
+#include "host/hci_core.h"
+#include "host/conn_internal.h"
+#include "iso_internal.h"
+
+/* The ISO connection is made up without a controller, and its TX queue
+ * isn't serviced, so that the test takes the queued packets itself.
+ */
+
+#define ISO_HANDLE 0x0020
+#define ISO_MTU 20
+#define SDU_INTERVAL 10000
+
+/* SDU lengths with 1, 3 and 4 HCI ISO packets, with the ISO data header */
+#define SDU_LEN_SINGLE 10
+#define SDU_LEN_FRAGS 50
+#define SDU_LEN_TOO_MANY_FRAGS 70
+
+static struct bt_conn *acl;
+static struct bt_conn *iso;
+
+static void recv(struct bt_iso_chan *chan, const struct bt_iso_recv_info *info,
+		 struct net_buf *buf)
+{
+}
+
+static struct bt_iso_chan_ops ops = {
+	.recv = recv,
+};
+
+static struct bt_iso_chan_qos qos = {
+	.interval = SDU_INTERVAL,
+};
+
+static struct bt_iso_chan chan = {
+	.ops = &ops,
+	.qos = &qos,
+};
+
+static void iso_setup(void)
+{
+	if (!acl) {
+		acl = bt_conn_add_le(BT_ID_DEFAULT, BT_ADDR_LE_ANY);
+		zassert_not_null(acl, NULL);
+	}
+
+	iso = bt_conn_add_iso(acl);
+	zassert_not_null(iso, NULL);
+
+	iso->handle = ISO_HANDLE;
+	iso->state = BT_CONN_CONNECTED;
+	k_fifo_init(&iso->tx_queue);
+
+	chan.conn = iso;
+	sys_slist_append(&iso->channels, &chan.node);
+
+	bt_dev.le.iso_mtu = ISO_MTU;
+}
+
+static void iso_teardown(void)
+{
+	struct net_buf *buf;
+
+	while ((buf = net_buf_get(&iso->tx_queue, K_NO_WAIT))) {
+		net_buf_unref(buf);
+	}
+
+	chan.conn = NULL;
+	iso->state = BT_CONN_DISCONNECTED;
+	bt_conn_unref(iso->iso.acl);
+	bt_conn_unref(iso);
+}
+
+static struct net_buf *sdu_create(uint16_t len)
+{
+	struct net_buf *buf;
+
+	buf = bt_iso_create_pdu_timeout(NULL, 0, K_NO_WAIT);
+	zassert_not_null(buf, "out of ISO TX buffers");
+
+	for (uint16_t i = 0; i < len; i++) {
+		net_buf_add_u8(buf, i);
+	}
+
+	return buf;
+}
+
+/* Take the next queued HCI ISO packet, and check its header */
+static struct net_buf *pkt_get(uint8_t pb, uint8_t ts)
+{
+	struct bt_hci_iso_hdr *hdr;
+	struct net_buf *buf;
+	uint16_t handle;
+
+	buf = net_buf_get(&iso->tx_queue, K_NO_WAIT);
+	zassert_not_null(buf, "packet not queued");
+
+	hdr = net_buf_pull_mem(buf, sizeof(*hdr));
+	handle = sys_le16_to_cpu(hdr->handle);
+
+	zassert_equal(bt_iso_handle(handle), ISO_HANDLE, NULL);
+	zassert_equal(bt_iso_flags_pb(bt_iso_flags(handle)), pb,
+		      "PB flag %u instead of %u",
+		      bt_iso_flags_pb(bt_iso_flags(handle)), pb);
+	zassert_equal(bt_iso_flags_ts(bt_iso_flags(handle)), ts, NULL);
+	zassert_equal(sys_le16_to_cpu(hdr->len), buf->len, NULL);
+	zassert_true(buf->len <= ISO_MTU, "packet exceeds the MTU");
+
+	return buf;
+}
+
+/* Check the ISO data header at the start of the first packet of an SDU */
+static void data_hdr_check(struct net_buf *buf, uint16_t sn, uint16_t len)
+{
+	struct bt_hci_iso_data_hdr *hdr;
+	uint16_t slen;
+
+	hdr = net_buf_pull_mem(buf, sizeof(*hdr));
+	slen = sys_le16_to_cpu(hdr->slen);
+
+	zassert_equal(sys_le16_to_cpu(hdr->sn), sn, "sn %u instead of %u",
+		      sys_le16_to_cpu(hdr->sn), sn);
+	zassert_equal(bt_iso_pkt_len(slen), len, NULL);
+	zassert_equal(bt_iso_pkt_flags(slen), BT_ISO_DATA_VALID, NULL);
+}
+
+/* Check that the data of a packet continues the SDU at the given offset */
+static uint16_t data_check(struct net_buf *buf, uint16_t offset)
+{
+	for (uint16_t i = 0; i < buf->len; i++) {
+		zassert_equal(buf->data[i], (uint8_t)(offset + i),
+			      "data mismatch at %u", offset + i);
+	}
+
+	return offset + buf->len;
+}
+
+static void sdu_check_unchanged(struct net_buf *buf, uint8_t *data,
+				uint16_t len)
+{
+	zassert_equal_ptr(buf->data, data, "buffer data moved");
+	zassert_equal(buf->len, len, "buffer length changed");
+	zassert_equal(data_check(buf, 0), len, NULL);
+}
+
+/**
+ * @brief Test that an SDU within the MTU is sent in one packet, with
+ * increasing sequence numbers
+ */
+static void test_iso_send_single(void)
+{
+	struct bt_iso_chan_stats stats;
+	struct net_buf *buf;
+
+	for (uint16_t sn = 0; sn < 2; sn++) {
+		buf = sdu_create(SDU_LEN_SINGLE);
+		zassert_ok(bt_iso_chan_send(&chan, buf), NULL);
+
+		buf = pkt_get(BT_ISO_SINGLE, 0);
+		data_hdr_check(buf, sn, SDU_LEN_SINGLE);
+		zassert_equal(data_check(buf, 0), SDU_LEN_SINGLE, NULL);
+		net_buf_unref(buf);
+	}
+
+	zassert_ok(bt_iso_chan_stats_get(&chan, &stats), NULL);
+	zassert_equal(stats.tx_sdus, 2, NULL);
+}
+
+/**
+ * @brief Test that an SDU larger than the MTU is queued as consecutive
+ * fragments, the last one being the SDU buffer
+ */
+static void test_iso_send_frags(void)
+{
+	struct net_buf *sdu, *buf;
+	uint16_t offset;
+
+	sdu = sdu_create(SDU_LEN_FRAGS);
+	zassert_ok(bt_iso_chan_send(&chan, sdu), NULL);
+
+	buf = pkt_get(BT_ISO_START, 0);
+	data_hdr_check(buf, 0, SDU_LEN_FRAGS);
+	offset = data_check(buf, 0);
+	net_buf_unref(buf);
+
+	buf = pkt_get(BT_ISO_CONT, 0);
+	offset = data_check(buf, offset);
+	net_buf_unref(buf);
+
+	buf = pkt_get(BT_ISO_END, 0);
+	zassert_equal_ptr(buf, sdu, "last fragment isn't the SDU buffer");
+	zassert_equal(data_check(buf, offset), SDU_LEN_FRAGS, NULL);
+	net_buf_unref(buf);
+
+	zassert_is_null(net_buf_get(&iso->tx_queue, K_NO_WAIT), NULL);
+}
+
+/**
+ * @brief Test that an SDU needing more fragments than available is
+ * rejected whole, and left unchanged to the caller
+ */
+static void test_iso_send_nobufs(void)
+{
+	struct bt_iso_chan_stats stats;
+	struct net_buf *buf;
+	uint8_t *data;
+
+	buf = sdu_create(SDU_LEN_TOO_MANY_FRAGS);
+	data = buf->data;
+
+	zassert_equal(bt_iso_chan_send(&chan, buf), -ENOBUFS, NULL);
+	sdu_check_unchanged(buf, data, SDU_LEN_TOO_MANY_FRAGS);
+	zassert_is_null(net_buf_get(&iso->tx_queue, K_NO_WAIT),
+			"fragment of a rejected SDU queued");
+	net_buf_unref(buf);
+
+	zassert_ok(bt_iso_chan_stats_get(&chan, &stats), NULL);
+	zassert_equal(stats.tx_sdus, 0, NULL);
+
+	/* The fragments were released, and the sequence number not used */
+	buf = sdu_create(SDU_LEN_FRAGS);
+	zassert_ok(bt_iso_chan_send(&chan, buf), "fragments not released");
+
+	buf = pkt_get(BT_ISO_START, 0);
+	data_hdr_check(buf, 0, SDU_LEN_FRAGS);
+	net_buf_unref(buf);
+}
+
+/**
+ * @brief Test that an SDU sent on a connection that isn't connected is
+ * left unchanged to the caller
+ */
+static void test_iso_send_not_connected(void)
+{
+	struct net_buf *buf;
+	uint8_t *data;
+
+	iso->state = BT_CONN_DISCONNECT;
+
+	buf = sdu_create(SDU_LEN_FRAGS);
+	data = buf->data;
+
+	zassert_equal(bt_iso_chan_send(&chan, buf), -ENOTCONN, NULL);
+	sdu_check_unchanged(buf, data, SDU_LEN_FRAGS);
+	zassert_is_null(net_buf_get(&iso->tx_queue, K_NO_WAIT), NULL);
+
+	/* The fragments were released, and the SDU can be sent again */
+	iso->state = BT_CONN_CONNECTED;
+	zassert_ok(bt_iso_chan_send(&chan, buf), NULL);
+
+	buf = pkt_get(BT_ISO_START, 0);
+	data_hdr_check(buf, 0, SDU_LEN_FRAGS);
+	net_buf_unref(buf);
+}
+
+/**
+ * @brief Test that an SDU with a time stamp carries its sequence number,
+ * which the following SDUs continue
+ */
+static void test_iso_send_ts(void)
+{
+	struct bt_hci_iso_ts_data_hdr *hdr;
+	struct net_buf *buf;
+
+	buf = sdu_create(SDU_LEN_FRAGS);
+	zassert_ok(bt_iso_chan_send_ts(&chan, buf, 0xffff, 123456), NULL);
+
+	buf = pkt_get(BT_ISO_START, 1);
+	hdr = net_buf_pull_mem(buf, sizeof(*hdr));
+	zassert_equal(sys_le32_to_cpu(hdr->ts), 123456, NULL);
+	zassert_equal(sys_le16_to_cpu(hdr->data.sn), 0xffff, NULL);
+	zassert_equal(bt_iso_pkt_len(sys_le16_to_cpu(hdr->data.slen)),
+		      SDU_LEN_FRAGS, NULL);
+	net_buf_unref(buf);
+
+	/* Only the first fragment has the time stamp */
+	net_buf_unref(pkt_get(BT_ISO_CONT, 0));
+	net_buf_unref(pkt_get(BT_ISO_END, 0));
+
+	buf = sdu_create(SDU_LEN_SINGLE);
+	zassert_ok(bt_iso_chan_send(&chan, buf), NULL);
+
+	buf = pkt_get(BT_ISO_SINGLE, 0);
+	data_hdr_check(buf, 0, SDU_LEN_SINGLE);
+	net_buf_unref(buf);
+}
+
+/* Receive an SDU in a single HCI ISO packet */
+static void sdu_recv(uint16_t sn, bool has_ts, uint32_t ts, uint8_t status)
+{
+	struct bt_hci_iso_data_hdr *hdr;
+	struct net_buf *buf;
+
+	buf = bt_iso_get_rx(K_NO_WAIT);
+	zassert_not_null(buf, "out of ISO RX buffers");
+
+	if (has_ts) {
+		net_buf_add_le32(buf, ts);
+	}
+
+	hdr = net_buf_add(buf, sizeof(*hdr));
+	hdr->sn = sys_cpu_to_le16(sn);
+	hdr->slen = sys_cpu_to_le16(bt_iso_pkt_len_pack(4, status));
+	net_buf_add_le32(buf, 0);
+
+	bt_iso_recv(iso, buf, BT_ISO_SINGLE | (has_ts ? BIT(2) : 0));
+}
+
+/**
+ * @brief Test the loss accounting across sequence number wrap-arounds
+ */
+static void test_iso_rx_lost(void)
+{
+	struct bt_iso_chan_stats stats;
+
+	sdu_recv(0xfffe, false, 0, BT_ISO_DATA_VALID);
+	sdu_recv(0xffff, false, 0, BT_ISO_DATA_VALID);
+	/* 0x0000 is missing */
+	sdu_recv(0x0001, false, 0, BT_ISO_DATA_VALID);
+	/* Duplicate, and late SDUs aren't losses */
+	sdu_recv(0x0001, false, 0, BT_ISO_DATA_VALID);
+	sdu_recv(0xfff0, false, 0, BT_ISO_DATA_VALID);
+	/* 0xfff1 and 0xfff2 are missing */
+	sdu_recv(0xfff3, false, 0, BT_ISO_DATA_VALID);
+	sdu_recv(0xfff4, false, 0, BT_ISO_DATA_INVALID);
+	sdu_recv(0xfff5, false, 0, BT_ISO_DATA_NOP);
+
+	zassert_ok(bt_iso_chan_stats_get(&chan, &stats), NULL);
+	zassert_equal(stats.rx_sdus, 8, NULL);
+	zassert_equal(stats.rx_lost, 4, "%u lost SDUs", stats.rx_lost);
+	zassert_equal(stats.rx_errors, 1, NULL);
+}
+
+/**
+ * @brief Test the jitter measured against the SDU interval
+ */
+static void test_iso_rx_jitter_interval(void)
+{
+	struct bt_iso_chan_stats stats;
+
+	sdu_recv(0, false, 0, BT_ISO_DATA_VALID);
+	k_busy_wait(SDU_INTERVAL);
+	sdu_recv(1, false, 0, BT_ISO_DATA_VALID);
+
+	zassert_ok(bt_iso_chan_stats_get(&chan, &stats), NULL);
+	zassert_true(stats.rx_jitter <= 2, "jitter %u", stats.rx_jitter);
+
+	/* 2 ms late, then 2 ms early. The jitter is 2000 / 16 us after the
+	 * first one, and 242 us after the second one.
+	 */
+	k_busy_wait(SDU_INTERVAL + 2000);
+	sdu_recv(2, false, 0, BT_ISO_DATA_VALID);
+	k_busy_wait(SDU_INTERVAL - 2000);
+	sdu_recv(3, false, 0, BT_ISO_DATA_VALID);
+
+	zassert_ok(bt_iso_chan_stats_get(&chan, &stats), NULL);
+	zassert_within(stats.rx_jitter, 242, 2, "jitter %u", stats.rx_jitter);
+	zassert_within(stats.rx_jitter_max, 2000, 2, NULL);
+
+	/* A missing SDU doubles the expected spacing */
+	k_busy_wait(2 * SDU_INTERVAL);
+	sdu_recv(5, false, 0, BT_ISO_DATA_VALID);
+
+	zassert_ok(bt_iso_chan_stats_get(&chan, &stats), NULL);
+	zassert_equal(stats.rx_lost, 1, NULL);
+	zassert_within(stats.rx_jitter, 227, 2, "jitter %u", stats.rx_jitter);
+}
+
+/**
+ * @brief Test the jitter measured against the time stamps, across a
+ * time stamp wrap-around
+ */
+static void test_iso_rx_jitter_ts(void)
+{
+	struct bt_iso_chan_stats stats;
+
+	sdu_recv(0, true, 0xffffe000, BT_ISO_DATA_VALID);
+	/* The time stamps say 2 intervals apart, with 500 us of delay */
+	k_busy_wait(2 * SDU_INTERVAL + 500);
+	sdu_recv(1, true, 0xffffe000 + 2 * SDU_INTERVAL, BT_ISO_DATA_VALID);
+
+	zassert_ok(bt_iso_chan_stats_get(&chan, &stats), NULL);
+	zassert_within(stats.rx_jitter, 500 / 16, 2, "jitter %u",
+		       stats.rx_jitter);
+	zassert_within(stats.rx_jitter_max, 500, 2, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(iso,
+			 ztest_unit_test_setup_teardown(test_iso_send_single,
+							iso_setup,
+							iso_teardown),
+			 ztest_unit_test_setup_teardown(test_iso_send_frags,
+							iso_setup,
+							iso_teardown),
+			 ztest_unit_test_setup_teardown(test_iso_send_nobufs,
+							iso_setup,
+							iso_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_iso_send_not_connected,
+				iso_setup, iso_teardown),
+			 ztest_unit_test_setup_teardown(test_iso_send_ts,
+							iso_setup,
+							iso_teardown),
+			 ztest_unit_test_setup_teardown(test_iso_rx_lost,
+							iso_setup,
+							iso_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_iso_rx_jitter_interval,
+				iso_setup, iso_teardown),
+			 ztest_unit_test_setup_teardown(test_iso_rx_jitter_ts,
+							iso_setup,
+							iso_teardown));
+	ztest_run_test_suite(iso);
+}
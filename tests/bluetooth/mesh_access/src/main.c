@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <bluetooth/mesh.h>
+
+#include "net.h"
+#include "access.h"
+
+/* Access messages are delivered with every combination of destination,
+ * OpCode and application key, once with the composition data dispatched
+ * through the OpCode index, and once with an extra element whose OpCodes
+ * overflow the index, which falls back to the linear search. Both must
+ * deliver every message to the same models, in the same order.
+ */
+
+#define NUM_ELEMS 4
+#define OPS_PER_MODEL 4
+#define EXTRA_OPS 100
+#define LOCAL_ADDR 0x0001
+#define REMOTE_ADDR 0x0100
+#define GROUP_ADDR 0xc001
+#define VIRTUAL_ADDR 0x8123
+#define CID 0x0059
+#define MAX_DELIVERIES (2 * NUM_ELEMS + 1)
+
+/* SIG model 1 shares its first OpCode with SIG model 0, the index only
+ * lists SIG model 0 for it.
+ */
+#define INDEXED_OPS (NUM_ELEMS * (3 * OPS_PER_MODEL - 1))
+
+BUILD_ASSERT(INDEXED_OPS <= CONFIG_BT_MESH_MODEL_OP_INDEX_SIZE,
+	     "composition data does not fit in the OpCode index");
+BUILD_ASSERT(INDEXED_OPS + EXTRA_OPS > CONFIG_BT_MESH_MODEL_OP_INDEX_SIZE,
+	     "extra element does not overflow the OpCode index");
+
+#define SIG_OP(k) BT_MESH_MODEL_OP_2(0x82, (k))
+#define VND_OP(k) BT_MESH_MODEL_OP_3((k), CID)
+
+static struct bt_mesh_model *delivered[MAX_DELIVERIES];
+static int delivered_count;
+
+static void handler(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+		    struct net_buf_simple *buf)
+{
+	zassert_true(delivered_count < MAX_DELIVERIES, NULL);
+	delivered[delivered_count++] = model;
+}
+
+static void extra_handler(struct bt_mesh_model *model,
+			  struct bt_mesh_msg_ctx *ctx,
+			  struct net_buf_simple *buf)
+{
+	zassert_unreachable("message delivered to the extra element");
+}
+
+#define OP(_op) { (_op), 0, handler }
+
+static const struct bt_mesh_model_op sig0_ops[] = {
+	OP(SIG_OP(0)), OP(SIG_OP(1)), OP(SIG_OP(2)), OP(SIG_OP(3)),
+	BT_MESH_MODEL_OP_END,
+};
+
+static const struct bt_mesh_model_op sig1_ops[] = {
+	OP(SIG_OP(0)), OP(SIG_OP(4)), OP(SIG_OP(5)), OP(SIG_OP(6)),
+	BT_MESH_MODEL_OP_END,
+};
+
+static const struct bt_mesh_model_op vnd_ops[] = {
+	OP(VND_OP(0)), OP(VND_OP(1)), OP(VND_OP(2)), OP(VND_OP(3)),
+	BT_MESH_MODEL_OP_END,
+};
+
+#define EXTRA_OP(i, _) { BT_MESH_MODEL_OP_2(0x83, i), 0, extra_handler },
+
+static const struct bt_mesh_model_op extra_ops[] = {
+	UTIL_LISTIFY(EXTRA_OPS, EXTRA_OP)
+	BT_MESH_MODEL_OP_END,
+};
+
+#define SIG_ELEM_MODELS                                                        \
+	{                                                                      \
+		BT_MESH_MODEL(0x1000, sig0_ops, NULL, NULL),                   \
+		BT_MESH_MODEL(0x1001, sig1_ops, NULL, NULL),                   \
+	}
+
+#define VND_ELEM_MODELS                                                        \
+	{                                                                      \
+		BT_MESH_MODEL_VND(CID, 0x0000, vnd_ops, NULL, NULL),           \
+	}
+
+static struct bt_mesh_model sig_models[NUM_ELEMS][2] = {
+	SIG_ELEM_MODELS, SIG_ELEM_MODELS, SIG_ELEM_MODELS, SIG_ELEM_MODELS,
+};
+
+static struct bt_mesh_model vnd_models[NUM_ELEMS][1] = {
+	VND_ELEM_MODELS, VND_ELEM_MODELS, VND_ELEM_MODELS, VND_ELEM_MODELS,
+};
+
+static struct bt_mesh_model extra_models[] = {
+	BT_MESH_MODEL(0x1002, extra_ops, NULL, NULL),
+};
+
+#define ELEM(e) BT_MESH_ELEM(0, sig_models[e], vnd_models[e])
+
+static struct bt_mesh_elem elements[NUM_ELEMS + 1] = {
+	ELEM(0), ELEM(1), ELEM(2), ELEM(3),
+	BT_MESH_ELEM(0, extra_models, BT_MESH_MODEL_NONE),
+};
+
+static const struct bt_mesh_comp comp_indexed = {
+	.elem = elements,
+	.elem_count = NUM_ELEMS,
+};
+
+static const struct bt_mesh_comp comp_linear = {
+	.elem = elements,
+	.elem_count = NUM_ELEMS + 1,
+};
+
+static const uint16_t dsts[] = {
+	LOCAL_ADDR, LOCAL_ADDR + 1, LOCAL_ADDR + 2, LOCAL_ADDR + 3,
+	LOCAL_ADDR + NUM_ELEMS + 1, GROUP_ADDR, VIRTUAL_ADDR,
+	BT_MESH_ADDR_ALL_NODES,
+};
+
+static const uint32_t opcodes[] = {
+	SIG_OP(0), SIG_OP(1), SIG_OP(2), SIG_OP(3), SIG_OP(4), SIG_OP(5),
+	SIG_OP(6), SIG_OP(7), VND_OP(0), VND_OP(1), VND_OP(2), VND_OP(3),
+	VND_OP(4),
+};
+
+#define NUM_MSGS (ARRAY_SIZE(dsts) * ARRAY_SIZE(opcodes) * 2)
+
+struct msg_log {
+	int count;
+	struct bt_mesh_model *models[MAX_DELIVERIES];
+};
+
+static struct msg_log logs[2][NUM_MSGS];
+
+/* Bind the models and subscribe them so that the group and virtual
+ * addresses reach a different subset of the elements, and that the first
+ * model of an element with an OpCode is not always the subscribed one.
+ */
+static void models_configure(void)
+{
+	for (int e = 0; e < NUM_ELEMS; e++) {
+		sig_models[e][0].keys[0] = 0;
+		sig_models[e][1].keys[0] = 0;
+		vnd_models[e][0].keys[0] = (e == 1) ? 1 : 0;
+
+		if (e % 2 == 0) {
+			sig_models[e][0].groups[0] = GROUP_ADDR;
+			vnd_models[e][0].groups[0] = VIRTUAL_ADDR;
+		} else {
+			sig_models[e][1].groups[0] = GROUP_ADDR;
+			vnd_models[e][0].groups[0] = GROUP_ADDR;
+		}
+	}
+
+	sig_models[3][0].groups[0] = VIRTUAL_ADDR;
+	extra_models[0].keys[0] = 0;
+}
+
+static void deliver_all(const struct bt_mesh_comp *comp, struct msg_log *out)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx.addr = REMOTE_ADDR,
+		.local_match = 1,
+	};
+	int n = 0;
+
+	zassert_ok(bt_mesh_comp_register(comp), NULL);
+	bt_mesh_comp_provision(LOCAL_ADDR);
+	models_configure();
+
+	for (int d = 0; d < ARRAY_SIZE(dsts); d++) {
+		for (int o = 0; o < ARRAY_SIZE(opcodes); o++) {
+			for (uint16_t app_idx = 0; app_idx < 2; app_idx++) {
+				NET_BUF_SIMPLE_DEFINE(buf, 8);
+
+				bt_mesh_model_msg_init(&buf, opcodes[o]);
+				net_buf_simple_add_u8(&buf, 0);
+
+				rx.ctx.recv_dst = dsts[d];
+				rx.ctx.app_idx = app_idx;
+
+				delivered_count = 0;
+				bt_mesh_model_recv(&rx, &buf);
+
+				out[n].count = delivered_count;
+				memcpy(out[n].models, delivered,
+				       delivered_count * sizeof(delivered[0]));
+				n++;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Test that the OpCode index delivers access messages to the same
+ * models as the linear search
+ */
+void test_access_dispatch(void)
+{
+	int total = 0;
+
+	deliver_all(&comp_indexed, logs[0]);
+	deliver_all(&comp_linear, logs[1]);
+
+	for (int i = 0; i < NUM_MSGS; i++) {
+		zassert_equal(logs[0][i].count, logs[1][i].count,
+			      "message %d delivered %d times instead of %d",
+			      i, logs[0][i].count, logs[1][i].count);
+		zassert_mem_equal(logs[0][i].models, logs[1][i].models,
+				  logs[0][i].count * sizeof(delivered[0]),
+				  "message %d delivered to other models", i);
+		total += logs[0][i].count;
+	}
+
+	zassert_true(total > 0, "no message delivered");
+}
+
+/**
+ * @brief Test the deliveries of a few messages
+ */
+void test_access_deliveries(void)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx.addr = REMOTE_ADDR,
+		.ctx.app_idx = 0,
+		.local_match = 1,
+	};
+	NET_BUF_SIMPLE_DEFINE(buf, 8);
+
+	zassert_ok(bt_mesh_comp_register(&comp_indexed), NULL);
+	bt_mesh_comp_provision(LOCAL_ADDR);
+	models_configure();
+
+	/* Unicast: the first model of the element with the OpCode */
+	bt_mesh_model_msg_init(&buf, SIG_OP(0));
+	rx.ctx.recv_dst = LOCAL_ADDR + 2;
+	delivered_count = 0;
+	bt_mesh_model_recv(&rx, &buf);
+	zassert_equal(delivered_count, 1, NULL);
+	zassert_equal_ptr(delivered[0], &sig_models[2][0], NULL);
+
+	/* Group: only the elements whose first model with the OpCode is
+	 * subscribed, in element order.
+	 */
+	bt_mesh_model_msg_init(&buf, SIG_OP(0));
+	rx.ctx.recv_dst = GROUP_ADDR;
+	delivered_count = 0;
+	bt_mesh_model_recv(&rx, &buf);
+	zassert_equal(delivered_count, 2, NULL);
+	zassert_equal_ptr(delivered[0], &sig_models[0][0], NULL);
+	zassert_equal_ptr(delivered[1], &sig_models[2][0], NULL);
+
+	bt_mesh_model_msg_init(&buf, SIG_OP(4));
+	delivered_count = 0;
+	bt_mesh_model_recv(&rx, &buf);
+	zassert_equal(delivered_count, 2, NULL);
+	zassert_equal_ptr(delivered[0], &sig_models[1][1], NULL);
+	zassert_equal_ptr(delivered[1], &sig_models[3][1], NULL);
+
+	/* Virtual: vendor models, bound to the application key */
+	bt_mesh_model_msg_init(&buf, VND_OP(1));
+	rx.ctx.recv_dst = VIRTUAL_ADDR;
+	delivered_count = 0;
+	bt_mesh_model_recv(&rx, &buf);
+	zassert_equal(delivered_count, 2, NULL);
+	zassert_equal_ptr(delivered[0], &vnd_models[0][0], NULL);
+	zassert_equal_ptr(delivered[1], &vnd_models[2][0], NULL);
+
+	/* Unknown OpCode */
+	bt_mesh_model_msg_init(&buf, SIG_OP(7));
+	rx.ctx.recv_dst = LOCAL_ADDR;
+	delivered_count = 0;
+	bt_mesh_model_recv(&rx, &buf);
+	zassert_equal(delivered_count, 0, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(mesh_access,
+			 ztest_unit_test(test_access_dispatch),
+			 ztest_unit_test(test_access_deliveries));
+	ztest_run_test_suite(mesh_access);
+}
@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <bluetooth/hci.h>
+#include <bluetooth/buf.h>
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/mesh.h>
+#include <drivers/bluetooth/hci_driver.h>
+#include <sys/byteorder.h>
+
+#include "adv.h"
+
+/* The advertiser runs on a fake controller, which records the buffer each
+ * advertising set advertises. The buffers carry a single byte identifying
+ * them. The local advertising set is created first, and gets the first
+ * handle.
+ */
+
+#define XMIT BT_MESH_TRANSMIT(0, 20)
+#define LOCAL_SET 0
+#define RELAY_SET(i) (1 + (i))
+#define SETS CONFIG_BT_EXT_ADV_MAX_ADV_SET
+
+/* Time for the advertiser to take the next buffer */
+#define ADV_WAIT K_MSEC(100)
+
+/* Identifiers of the buffers, none being 0 */
+#define LOCAL(i) (0x10 + (i))
+#define RELAY(i) (0x20 + (i))
+
+/* Last data set, and buffer advertised, by each advertising set */
+static uint8_t adv_data[SETS];
+static uint8_t advertising[SETS];
+
+/* Command handler structure for cmd_handle(). */
+struct cmd_handler {
+	uint16_t opcode; /* HCI command opcode */
+	uint8_t len;     /* HCI command response length */
+	void (*handler)(struct net_buf *buf, struct net_buf **evt,
+			uint8_t len, uint16_t opcode);
+};
+
+/* Add event to net_buf. */
+static void evt_create(struct net_buf *buf, uint8_t evt, uint8_t len)
+{
+	struct bt_hci_evt_hdr *hdr;
+
+	hdr = net_buf_add(buf, sizeof(*hdr));
+	hdr->evt = evt;
+	hdr->len = len;
+}
+
+/* Create a command complete event. */
+static void *cmd_complete(struct net_buf **buf, uint8_t plen, uint16_t opcode)
+{
+	struct bt_hci_evt_cmd_complete *cc;
+
+	*buf = bt_buf_get_evt(BT_HCI_EVT_CMD_COMPLETE, false, K_FOREVER);
+	evt_create(*buf, BT_HCI_EVT_CMD_COMPLETE, sizeof(*cc) + plen);
+	cc = net_buf_add(*buf, sizeof(*cc));
+	cc->ncmd = 1U;
+	cc->opcode = sys_cpu_to_le16(opcode);
+	return net_buf_add(*buf, plen);
+}
+
+/* Generic command complete with success status. */
+static void generic_success(struct net_buf *buf, struct net_buf **evt,
+			    uint8_t len, uint16_t opcode)
+{
+	struct bt_hci_evt_cc_status *ccst;
+
+	ccst = cmd_complete(evt, len, opcode);
+
+	/* Fill any event parameters with zero */
+	(void)memset(ccst, 0, len);
+
+	ccst->status = BT_HCI_ERR_SUCCESS;
+}
+
+/* Command complete with all bits set in the response parameters. */
+static void all_supported(struct net_buf *buf, struct net_buf **evt,
+			  uint8_t len, uint16_t opcode)
+{
+	struct bt_hci_evt_cc_status *ccst;
+
+	ccst = cmd_complete(evt, len, opcode);
+	(void)memset(ccst, 0xFF, len);
+	ccst->status = BT_HCI_ERR_SUCCESS;
+}
+
+/* Version allowing the fast non-connectable advertising of the mesh. */
+static void version_info(struct net_buf *buf, struct net_buf **evt,
+			 uint8_t len, uint16_t opcode)
+{
+	struct bt_hci_rp_read_local_version_info *rp;
+
+	rp = cmd_complete(evt, len, opcode);
+	(void)memset(rp, 0, len);
+
+	rp->status = BT_HCI_ERR_SUCCESS;
+	rp->hci_version = BT_HCI_VERSION_5_0;
+}
+
+static void set_ext_adv_data(struct net_buf *buf, struct net_buf **evt,
+			     uint8_t len, uint16_t opcode)
+{
+	struct bt_hci_cp_le_set_ext_adv_data *cp = (void *)buf->data;
+
+	zassert_true(cp->handle < SETS, NULL);
+	zassert_equal(cp->len, 3, "unexpected data");
+
+	/* AD structure length and type, then the buffer */
+	adv_data[cp->handle] = cp->data[2];
+
+	generic_success(buf, evt, len, opcode);
+}
+
+static void set_ext_adv_enable(struct net_buf *buf, struct net_buf **evt,
+			       uint8_t len, uint16_t opcode)
+{
+	struct bt_hci_cp_le_set_ext_adv_enable *cp = (void *)buf->data;
+
+	for (int i = 0; i < cp->set_num; i++) {
+		uint8_t handle = cp->s[i].handle;
+
+		zassert_true(handle < SETS, NULL);
+		advertising[handle] = cp->enable ? adv_data[handle] : 0;
+	}
+
+	generic_success(buf, evt, len, opcode);
+}
+
+/* Setup handlers needed for bt_enable and the advertising sets. */
+static const struct cmd_handler cmds[] = {
+	{ BT_HCI_OP_READ_LOCAL_VERSION_INFO,
+	  sizeof(struct bt_hci_rp_read_local_version_info),
+	  version_info },
+	{ BT_HCI_OP_READ_SUPPORTED_COMMANDS,
+	  sizeof(struct bt_hci_rp_read_supported_commands),
+	  all_supported },
+	{ BT_HCI_OP_READ_LOCAL_FEATURES,
+	  sizeof(struct bt_hci_rp_read_local_features),
+	  all_supported },
+	{ BT_HCI_OP_READ_BD_ADDR,
+	  sizeof(struct bt_hci_rp_read_bd_addr),
+	  generic_success },
+	{ BT_HCI_OP_SET_EVENT_MASK,
+	  sizeof(struct bt_hci_evt_cc_status),
+	  generic_success },
+	{ BT_HCI_OP_LE_SET_EVENT_MASK,
+	  sizeof(struct bt_hci_evt_cc_status),
+	  generic_success },
+	{ BT_HCI_OP_LE_READ_LOCAL_FEATURES,
+	  sizeof(struct bt_hci_rp_le_read_local_features),
+	  all_supported },
+	{ BT_HCI_OP_LE_READ_SUPP_STATES,
+	  sizeof(struct bt_hci_rp_le_read_supp_states),
+	  all_supported },
+	{ BT_HCI_OP_LE_RAND,
+	  sizeof(struct bt_hci_rp_le_rand),
+	  generic_success },
+	{ BT_HCI_OP_LE_SET_RANDOM_ADDRESS,
+	  sizeof(struct bt_hci_evt_cc_status),
+	  generic_success },
+	{ BT_HCI_OP_LE_SET_EXT_ADV_PARAM,
+	  sizeof(struct bt_hci_rp_le_set_ext_adv_param),
+	  generic_success },
+	{ BT_HCI_OP_LE_SET_ADV_SET_RANDOM_ADDR,
+	  sizeof(struct bt_hci_evt_cc_status),
+	  generic_success },
+	{ BT_HCI_OP_LE_SET_EXT_ADV_DATA,
+	  sizeof(struct bt_hci_evt_cc_status),
+	  set_ext_adv_data },
+	{ BT_HCI_OP_LE_SET_EXT_ADV_ENABLE,
+	  sizeof(struct bt_hci_evt_cc_status),
+	  set_ext_adv_enable },
+};
+
+/* HCI driver open. */
+static int driver_open(void)
+{
+	return 0;
+}
+
+/* HCI driver send, answering the commands of the host. */
+static int driver_send(struct net_buf *buf)
+{
+	struct net_buf *evt = NULL;
+	struct bt_hci_cmd_hdr *chdr;
+	uint16_t opcode;
+
+	chdr = net_buf_pull_mem(buf, sizeof(*chdr));
+	opcode = sys_le16_to_cpu(chdr->opcode);
+
+	for (size_t i = 0; i < ARRAY_SIZE(cmds); i++) {
+		if (cmds[i].opcode == opcode) {
+			cmds[i].handler(buf, &evt, cmds[i].len, opcode);
+			break;
+		}
+	}
+
+	zassert_not_null(evt, "Unknown HCI command 0x%04x", opcode);
+	bt_recv_prio(evt);
+	net_buf_unref(buf);
+
+	return 0;
+}
+
+/* HCI driver structure. */
+static const struct bt_hci_driver drv = {
+	.name         = "test",
+	.bus          = BT_HCI_DRIVER_BUS_VIRTUAL,
+	.open         = driver_open,
+	.send         = driver_send,
+	.quirks       = BT_QUIRK_NO_RESET,
+};
+
+static void send(enum bt_mesh_adv_tag tag, uint8_t id)
+{
+	struct net_buf *buf;
+
+	if (tag == BT_MESH_RELAY_ADV) {
+		buf = bt_mesh_adv_relay_create(XMIT, K_NO_WAIT);
+	} else {
+		buf = bt_mesh_adv_create(BT_MESH_ADV_DATA, XMIT, K_NO_WAIT);
+	}
+
+	zassert_not_null(buf, "out of advertising buffers");
+
+	net_buf_add_u8(buf, id);
+	bt_mesh_adv_send(buf, NULL, NULL);
+	net_buf_unref(buf);
+
+	k_sleep(ADV_WAIT);
+}
+
+/* Have the controller end the advertising of a set, as after its last
+ * advertising event.
+ */
+static void adv_terminate(uint8_t handle)
+{
+	struct bt_hci_evt_le_adv_set_terminated *evt;
+	struct bt_hci_evt_le_meta_event *meta;
+	struct net_buf *buf;
+
+	zassert_not_equal(advertising[handle], 0, "set %u not advertising",
+			  handle);
+	advertising[handle] = 0;
+
+	buf = bt_buf_get_rx(BT_BUF_EVT, K_FOREVER);
+	evt_create(buf, BT_HCI_EVT_LE_META_EVENT, sizeof(*meta) + sizeof(*evt));
+	meta = net_buf_add(buf, sizeof(*meta));
+	meta->subevent = BT_HCI_EVT_LE_ADV_SET_TERMINATED;
+	evt = net_buf_add(buf, sizeof(*evt));
+	evt->status = BT_HCI_ERR_LIMIT_REACHED;
+	evt->adv_handle = handle;
+	evt->conn_handle = 0;
+	evt->num_completed_ext_adv_evts = 1;
+
+	zassert_ok(bt_recv(buf), NULL);
+
+	k_sleep(ADV_WAIT);
+}
+
+/* End the advertising of all the queued buffers */
+static void adv_drain(void)
+{
+	bool busy;
+
+	do {
+		busy = false;
+
+		for (int i = 0; i < SETS; i++) {
+			if (advertising[i]) {
+				adv_terminate(i);
+				busy = true;
+			}
+		}
+	} while (busy);
+}
+
+/**
+ * @brief Initialize the host and the advertiser
+ */
+void test_adv_ext_init(void)
+{
+	zassert_ok(bt_hci_driver_register(&drv), NULL);
+	zassert_ok(bt_enable(NULL), NULL);
+
+	bt_mesh_adv_init();
+	zassert_ok(bt_mesh_adv_enable(), NULL);
+}
+
+/* Occupy all the advertising sets with relayed messages */
+static void relay_fill(void)
+{
+	send(BT_MESH_RELAY_ADV, RELAY(0));
+	zassert_equal(advertising[RELAY_SET(0)], RELAY(0), NULL);
+
+	send(BT_MESH_RELAY_ADV, RELAY(1));
+	zassert_equal(advertising[RELAY_SET(1)], RELAY(1), NULL);
+
+	/* All the relay advertising sets are busy */
+	send(BT_MESH_RELAY_ADV, RELAY(2));
+	zassert_equal(advertising[LOCAL_SET], RELAY(2),
+		      "local advertising set not kicked");
+}
+
+/**
+ * @brief Test that relayed messages go through the relay advertising sets,
+ * then through the local one when all of them are busy
+ */
+void test_adv_ext_relay_busy(void)
+{
+	relay_fill();
+	adv_drain();
+}
+
+/**
+ * @brief Test that the local advertising set takes local messages before
+ * relayed ones
+ */
+void test_adv_ext_local_first(void)
+{
+	relay_fill();
+
+	send(BT_MESH_RELAY_ADV, RELAY(3));
+	send(BT_MESH_LOCAL_ADV, LOCAL(0));
+
+	for (int i = 0; i < SETS; i++) {
+		zassert_not_equal(advertising[i], RELAY(3), NULL);
+		zassert_not_equal(advertising[i], LOCAL(0), NULL);
+	}
+
+	adv_terminate(LOCAL_SET);
+	zassert_equal(advertising[LOCAL_SET], LOCAL(0),
+		      "0x%02x advertised instead of the local message",
+		      advertising[LOCAL_SET]);
+
+	adv_terminate(RELAY_SET(0));
+	zassert_equal(advertising[RELAY_SET(0)], RELAY(3), NULL);
+
+	adv_drain();
+}
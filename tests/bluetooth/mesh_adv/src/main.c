@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <bluetooth/mesh.h>
+
+#include "adv.h"
+
+/* The mesh stack isn't initialized, so that the legacy advertiser doesn't
+ * run, and the test takes the queued buffers itself. The extended
+ * advertiser is tested on a fake controller, in adv_ext.c.
+ */
+
+#if !defined(CONFIG_BT_MESH_ADV_EXT)
+#define XMIT BT_MESH_TRANSMIT(0, 20)
+
+static void queue(enum bt_mesh_adv_tag tag)
+{
+	struct net_buf *buf;
+
+	if (tag == BT_MESH_RELAY_ADV) {
+		buf = bt_mesh_adv_relay_create(XMIT, K_NO_WAIT);
+	} else {
+		buf = bt_mesh_adv_create(BT_MESH_ADV_DATA, XMIT, K_NO_WAIT);
+	}
+
+	zassert_not_null(buf, "out of advertising buffers");
+	zassert_equal(BT_MESH_ADV(buf)->tag, tag, NULL);
+
+	net_buf_add_u8(buf, 0);
+	bt_mesh_adv_send(buf, NULL, NULL);
+	net_buf_unref(buf);
+}
+
+static struct net_buf *dequeue(void)
+{
+	return bt_mesh_adv_buf_get(&bt_mesh_adv_queue, K_NO_WAIT);
+}
+
+/**
+ * @brief Test that queued buffers are counted per traffic class
+ */
+void test_adv_stats_queued(void)
+{
+	struct bt_mesh_adv_stats before, stats;
+	struct net_buf *buf;
+
+	bt_mesh_adv_stats_get(&before);
+
+	queue(BT_MESH_LOCAL_ADV);
+	queue(BT_MESH_LOCAL_ADV);
+	queue(BT_MESH_LOCAL_ADV);
+	queue(BT_MESH_RELAY_ADV);
+
+	bt_mesh_adv_stats_get(&stats);
+	zassert_equal(stats.queued[BT_MESH_LOCAL_ADV],
+		      before.queued[BT_MESH_LOCAL_ADV] + 3, NULL);
+	zassert_equal(stats.queued[BT_MESH_RELAY_ADV],
+		      before.queued[BT_MESH_RELAY_ADV] + 1, NULL);
+	zassert_true(stats.queued_max[BT_MESH_LOCAL_ADV] >= 3, NULL);
+	zassert_true(stats.queued_max[BT_MESH_RELAY_ADV] >= 1, NULL);
+
+	while ((buf = dequeue())) {
+		net_buf_unref(buf);
+	}
+
+	bt_mesh_adv_stats_get(&stats);
+	zassert_equal(stats.queued[BT_MESH_LOCAL_ADV], 0, NULL);
+	zassert_equal(stats.queued[BT_MESH_RELAY_ADV], 0, NULL);
+	zassert_true(stats.queued_max[BT_MESH_LOCAL_ADV] >= 3,
+		     "queue depth maximum lost");
+}
+#endif /* !CONFIG_BT_MESH_ADV_EXT */
+
+/**
+ * @brief Test that advertised buffers and air time are counted per
+ * traffic class
+ */
+void test_adv_stats_sent(void)
+{
+	struct bt_mesh_adv_stats before, stats;
+
+	bt_mesh_adv_stats_get(&before);
+
+	bt_mesh_adv_buf_sent(BT_MESH_LOCAL_ADV, 30);
+	bt_mesh_adv_buf_sent(BT_MESH_LOCAL_ADV, 40);
+	bt_mesh_adv_buf_sent(BT_MESH_RELAY_ADV, 100);
+
+	bt_mesh_adv_stats_get(&stats);
+	zassert_equal(stats.sent[BT_MESH_LOCAL_ADV],
+		      before.sent[BT_MESH_LOCAL_ADV] + 2, NULL);
+	zassert_equal(stats.air_time[BT_MESH_LOCAL_ADV],
+		      before.air_time[BT_MESH_LOCAL_ADV] + 70, NULL);
+	zassert_equal(stats.sent[BT_MESH_RELAY_ADV],
+		      before.sent[BT_MESH_RELAY_ADV] + 1, NULL);
+	zassert_equal(stats.air_time[BT_MESH_RELAY_ADV],
+		      before.air_time[BT_MESH_RELAY_ADV] + 100, NULL);
+}
+
+#if defined(CONFIG_BT_MESH_ADV_EXT)
+void test_adv_ext_init(void);
+void test_adv_ext_relay_busy(void);
+void test_adv_ext_local_first(void);
+
+void test_main(void)
+{
+	ztest_test_suite(mesh_adv,
+			 ztest_unit_test(test_adv_stats_sent),
+			 ztest_unit_test(test_adv_ext_init),
+			 ztest_unit_test(test_adv_ext_relay_busy),
+			 ztest_unit_test(test_adv_ext_local_first));
+	ztest_run_test_suite(mesh_adv);
+}
+#else
+void test_main(void)
+{
+	ztest_test_suite(mesh_adv,
+			 ztest_unit_test(test_adv_stats_queued),
+			 ztest_unit_test(test_adv_stats_sent));
+	ztest_run_test_suite(mesh_adv);
+}
+#endif
@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <settings/settings.h>
+#include <bluetooth/mesh.h>
+
+#include "mesh.h"
+#include "net.h"
+#include "rpl.h"
+#include "settings.h"
+
+/* The replay protection list is stored in a settings backend kept in RAM,
+ * which the tests inspect and fill directly. The list is stored by calling
+ * bt_mesh_rpl_pending_store() rather than through the settings work, whose
+ * timeouts are too long to expire during the tests.
+ */
+
+#define BLOCK CONFIG_BT_MESH_RPL_STORE_BLOCK_SIZE
+#define SRC(i) (0x0100 + (i))
+#define STORE_MAX 16
+#define NAME_MAX_LEN 24
+
+/* Storage formats of the replay protection list, as in rpl.c */
+struct rpl_val {
+	uint32_t seq:24,
+	      old_iv:1;
+};
+
+struct rpl_rec {
+	uint16_t src;
+	struct rpl_val val;
+} __packed;
+
+static struct ram_entry {
+	char name[NAME_MAX_LEN];
+	uint8_t val[BLOCK * sizeof(struct rpl_rec)];
+	size_t len;
+} store[STORE_MAX], snapshot[STORE_MAX];
+
+/* Values written since the last storage round */
+static char written[STORE_MAX][NAME_MAX_LEN];
+static int writes;
+
+static struct ram_entry *ram_find(const char *name)
+{
+	for (int i = 0; i < ARRAY_SIZE(store); i++) {
+		if (!strcmp(store[i].name, name)) {
+			return &store[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void ram_set(const char *name, const void *val, size_t len)
+{
+	struct ram_entry *entry = ram_find(name);
+
+	if (!len) {
+		if (entry) {
+			(void)memset(entry, 0, sizeof(*entry));
+		}
+
+		return;
+	}
+
+	if (!entry) {
+		entry = ram_find("");
+	}
+
+	zassert_not_null(entry, "RAM storage full");
+	zassert_true(strlen(name) < sizeof(entry->name), "%s too long", name);
+	zassert_true(len <= sizeof(entry->val), "%s too large", name);
+
+	strcpy(entry->name, name);
+	memcpy(entry->val, val, len);
+	entry->len = len;
+}
+
+static ssize_t ram_read(void *cb_arg, void *data, size_t len)
+{
+	struct ram_entry *entry = cb_arg;
+
+	len = MIN(len, entry->len);
+	memcpy(data, entry->val, len);
+
+	return len;
+}
+
+static int ram_load(struct settings_store *cs,
+		    const struct settings_load_arg *arg)
+{
+	for (int i = 0; i < ARRAY_SIZE(store); i++) {
+		if (!store[i].name[0] ||
+		    (arg->subtree &&
+		     !settings_name_steq(store[i].name, arg->subtree, NULL))) {
+			continue;
+		}
+
+		(void)settings_call_set_handler(store[i].name, store[i].len,
+						ram_read, &store[i], arg);
+	}
+
+	return 0;
+}
+
+static int ram_save(struct settings_store *cs, const char *name,
+		    const char *value, size_t val_len)
+{
+	if (val_len && writes < ARRAY_SIZE(written)) {
+		strcpy(written[writes], name);
+	}
+
+	writes += !!val_len;
+	ram_set(name, value, val_len);
+
+	return 0;
+}
+
+static const struct settings_store_itf ram_itf = {
+	.csi_load = ram_load,
+	.csi_save = ram_save,
+};
+
+static struct settings_store ram_store = {
+	.cs_itf = &ram_itf,
+};
+
+int settings_backend_init(void)
+{
+	settings_dst_register(&ram_store);
+	settings_src_register(&ram_store);
+
+	return 0;
+}
+
+static void rpl_recv(uint16_t src, uint32_t seq, bool old_iv)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx.addr = src,
+		.seq = seq,
+		.old_iv = old_iv,
+		.local_match = 1,
+	};
+
+	zassert_false(bt_mesh_rpl_check(&rx, NULL), "0x%04x seq %u rejected",
+		      src, seq);
+}
+
+/* Check the entry of a source, which is returned without being updated by
+ * a message that it doesn't reject.
+ */
+static void rpl_expect(uint16_t src, uint32_t seq, bool old_iv)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx.addr = src,
+		.seq = 0xffffff,
+		.local_match = 1,
+	};
+	struct bt_mesh_rpl *rpl = NULL;
+
+	zassert_false(bt_mesh_rpl_check(&rx, &rpl), NULL);
+	zassert_not_null(rpl, NULL);
+	zassert_equal(rpl->src, src, "no entry for 0x%04x", src);
+	zassert_equal(rpl->seq, seq, "0x%04x seq %u instead of %u", src,
+		      rpl->seq, seq);
+	zassert_equal(rpl->old_iv, old_iv, "0x%04x old_iv %u", src,
+		      rpl->old_iv);
+}
+
+/* Run a storage round, and return the number of records it wrote */
+static int rpl_store(void)
+{
+	writes = 0;
+	bt_mesh_rpl_pending_store();
+
+	return writes;
+}
+
+static int rpl_store_all(void)
+{
+	int total = 0;
+	int n;
+
+	while ((n = rpl_store()) > 0) {
+		total += n;
+	}
+
+	return total;
+}
+
+/* Clear the list and its storage */
+static void rpl_wipe(void)
+{
+	atomic_clear_bit(bt_mesh.flags, BT_MESH_VALID);
+	bt_mesh_rpl_pending_store();
+	atomic_set_bit(bt_mesh.flags, BT_MESH_VALID);
+
+	(void)memset(store, 0, sizeof(store));
+}
+
+/* Load the list from storage, as after a reboot */
+static void rpl_reload(void)
+{
+	memcpy(snapshot, store, sizeof(store));
+	rpl_wipe();
+	memcpy(store, snapshot, sizeof(store));
+
+	zassert_ok(settings_load_subtree("bt/mesh/RPL"), NULL);
+}
+
+/**
+ * @brief Test that the list is stored in records, and loaded back
+ */
+void test_rpl_store_load(void)
+{
+	struct ram_entry *entry, prev;
+	int i;
+
+	/* Two full records, and one holding a single entry */
+	for (i = 0; i < 2 * BLOCK + 1; i++) {
+		rpl_recv(SRC(i), 100 + i, false);
+	}
+
+	bt_mesh_rpl_reset();
+	rpl_recv(SRC(1), 5, false);
+
+	zassert_equal(rpl_store_all(), 3, NULL);
+
+	for (i = 0; i < 3; i++) {
+		char name[NAME_MAX_LEN];
+
+		snprintk(name, sizeof(name), "bt/mesh/RPL/blk/%x", i);
+		entry = ram_find(name);
+		zassert_not_null(entry, "%s not stored", name);
+		zassert_equal(entry->len,
+			      (i < 2 ? BLOCK : 1) * sizeof(struct rpl_rec),
+			      "%s of %zu bytes", name, entry->len);
+	}
+
+	rpl_reload();
+
+	for (i = 0; i < 2 * BLOCK + 1; i++) {
+		if (i == 1) {
+			rpl_expect(SRC(i), 5, false);
+		} else {
+			rpl_expect(SRC(i), 100 + i, true);
+		}
+	}
+
+	/* Entries are loaded at their position: a change rewrites the
+	 * record holding it, with the other entries unchanged.
+	 */
+	entry = ram_find("bt/mesh/RPL/blk/1");
+	zassert_not_null(entry, NULL);
+	memcpy(&prev, entry, sizeof(prev));
+
+	rpl_recv(SRC(BLOCK + 1), 200, false);
+
+	zassert_equal(rpl_store(), 1, NULL);
+	zassert_equal(strcmp(written[0], "bt/mesh/RPL/blk/1"), 0,
+		      "%s written", written[0]);
+	zassert_equal(entry->len, prev.len, NULL);
+
+	for (i = 0; i < BLOCK; i++) {
+		size_t off = i * sizeof(struct rpl_rec);
+
+		if (i == 1) {
+			zassert_true(memcmp(&entry->val[off], &prev.val[off],
+					    sizeof(struct rpl_rec)),
+				     "change not stored");
+		} else {
+			zassert_mem_equal(&entry->val[off], &prev.val[off],
+					  sizeof(struct rpl_rec),
+					  "entry %d changed", i);
+		}
+	}
+}
+
+/**
+ * @brief Test that the entries stored per source by earlier versions are
+ * moved to records
+ */
+void test_rpl_legacy(void)
+{
+	const struct rpl_rec recs[] = {
+		{ SRC(0), { .seq = 10 } },
+		{ SRC(1), { .seq = 20 } },
+	};
+	const struct rpl_val legacy[] = {
+		{ .seq = 30 },
+		{ .seq = 40, .old_iv = 1 },
+	};
+
+	ram_set("bt/mesh/RPL/blk/0", recs, sizeof(recs));
+	ram_set("bt/mesh/RPL/101", &legacy[0], sizeof(legacy[0]));
+	ram_set("bt/mesh/RPL/102", &legacy[1], sizeof(legacy[1]));
+
+	zassert_ok(settings_load_subtree("bt/mesh/RPL"), NULL);
+
+	/* The most recent of the entries stored for the same source */
+	rpl_expect(SRC(0), 10, false);
+	rpl_expect(SRC(1), 30, false);
+	rpl_expect(SRC(2), 40, true);
+
+	zassert_true(rpl_store_all() > 0, NULL);
+
+	for (int i = 0; i < ARRAY_SIZE(store); i++) {
+		zassert_true(!store[i].name[0] ||
+			     !strncmp(store[i].name, "bt/mesh/RPL/blk/", 16),
+			     "%s left in storage", store[i].name);
+	}
+
+	rpl_reload();
+
+	rpl_expect(SRC(0), 10, false);
+	rpl_expect(SRC(1), 30, false);
+	rpl_expect(SRC(2), 40, true);
+}
+
+/**
+ * @brief Test that the records with changes are written once, within the
+ * budget of each storage round
+ */
+void test_rpl_store_budget(void)
+{
+	/* Changes in five records */
+	for (int i = 0; i < 5 * BLOCK; i++) {
+		rpl_recv(SRC(i), 1, false);
+	}
+
+	zassert_equal(rpl_store(), CONFIG_BT_MESH_RPL_STORE_BUDGET, NULL);
+	zassert_equal(rpl_store(), CONFIG_BT_MESH_RPL_STORE_BUDGET, NULL);
+	zassert_equal(rpl_store(), 1, NULL);
+	zassert_equal(rpl_store(), 0, NULL);
+
+	/* All the changes of a record are written at once */
+	rpl_recv(SRC(BLOCK), 2, false);
+	rpl_recv(SRC(BLOCK + 1), 2, false);
+
+	zassert_equal(rpl_store(), 1, NULL);
+	zassert_equal(strcmp(written[0], "bt/mesh/RPL/blk/1"), 0,
+		      "%s written", written[0]);
+	zassert_equal(rpl_store(), 0, NULL);
+}
+
+void test_main(void)
+{
+	zassert_ok(settings_subsys_init(), NULL);
+	bt_mesh_settings_init();
+
+	ztest_test_suite(mesh_rpl,
+			 ztest_unit_test_setup_teardown(test_rpl_store_load,
+							rpl_wipe,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_rpl_legacy,
+							rpl_wipe,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_rpl_store_budget,
+							rpl_wipe,
+							unit_test_noop));
+	ztest_run_test_suite(mesh_rpl);
+}
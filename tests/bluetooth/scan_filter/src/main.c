@@ -0,0 +1,475 @@
+/* main.c - Scan listener filter test */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+
+#include <errno.h>
+#include <ztest.h>
+
+#include <bluetooth/hci.h>
+#include <bluetooth/buf.h>
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/uuid.h>
+#include <drivers/bluetooth/hci_driver.h>
+#include <sys/byteorder.h>
+
+/* Command handler structure for cmd_handle(). */
+struct cmd_handler {
+	uint16_t opcode; /* HCI command opcode */
+	uint8_t len;     /* HCI command response length */
+	void (*handler)(struct net_buf *buf, struct net_buf **evt,
+			uint8_t len, uint16_t opcode);
+};
+
+/* Add event to net_buf. */
+static void evt_create(struct net_buf *buf, uint8_t evt, uint8_t len)
+{
+	struct bt_hci_evt_hdr *hdr;
+
+	hdr = net_buf_add(buf, sizeof(*hdr));
+	hdr->evt = evt;
+	hdr->len = len;
+}
+
+/* Create a command complete event. */
+static void *cmd_complete(struct net_buf **buf, uint8_t plen, uint16_t opcode)
+{
+	struct bt_hci_evt_cmd_complete *cc;
+
+	*buf = bt_buf_get_evt(BT_HCI_EVT_CMD_COMPLETE, false, K_FOREVER);
+	evt_create(*buf, BT_HCI_EVT_CMD_COMPLETE, sizeof(*cc) + plen);
+	cc = net_buf_add(*buf, sizeof(*cc));
+	cc->ncmd = 1U;
+	cc->opcode = sys_cpu_to_le16(opcode);
+	return net_buf_add(*buf, plen);
+}
+
+/* Generic command complete with success status. */
+static void generic_success(struct net_buf *buf, struct net_buf **evt,
+			    uint8_t len, uint16_t opcode)
+{
+	struct bt_hci_evt_cc_status *ccst;
+
+	ccst = cmd_complete(evt, len, opcode);
+
+	/* Fill any event parameters with zero */
+	(void)memset(ccst, 0, len);
+
+	ccst->status = BT_HCI_ERR_SUCCESS;
+}
+
+/* Command complete with all bits set in the response parameters. */
+static void all_supported(struct net_buf *buf, struct net_buf **evt,
+			  uint8_t len, uint16_t opcode)
+{
+	struct bt_hci_evt_cc_status *ccst;
+
+	ccst = cmd_complete(evt, len, opcode);
+	(void)memset(ccst, 0xFF, len);
+	ccst->status = BT_HCI_ERR_SUCCESS;
+}
+
+/* Setup handlers needed for bt_enable to function. */
+static const struct cmd_handler cmds[] = {
+	{ BT_HCI_OP_READ_LOCAL_VERSION_INFO,
+	  sizeof(struct bt_hci_rp_read_local_version_info),
+	  generic_success },
+	{ BT_HCI_OP_READ_SUPPORTED_COMMANDS,
+	  sizeof(struct bt_hci_rp_read_supported_commands),
+	  all_supported },
+	{ BT_HCI_OP_READ_LOCAL_FEATURES,
+	  sizeof(struct bt_hci_rp_read_local_features),
+	  all_supported },
+	{ BT_HCI_OP_READ_BD_ADDR,
+	  sizeof(struct bt_hci_rp_read_bd_addr),
+	  generic_success },
+	{ BT_HCI_OP_SET_EVENT_MASK,
+	  sizeof(struct bt_hci_evt_cc_status),
+	  generic_success },
+	{ BT_HCI_OP_LE_SET_EVENT_MASK,
+	  sizeof(struct bt_hci_evt_cc_status),
+	  generic_success },
+	{ BT_HCI_OP_LE_READ_LOCAL_FEATURES,
+	  sizeof(struct bt_hci_rp_le_read_local_features),
+	  all_supported },
+	{ BT_HCI_OP_LE_READ_SUPP_STATES,
+	  sizeof(struct bt_hci_rp_le_read_supp_states),
+	  all_supported },
+	{ BT_HCI_OP_LE_RAND,
+	  sizeof(struct bt_hci_rp_le_rand),
+	  generic_success },
+	{ BT_HCI_OP_LE_SET_RANDOM_ADDRESS,
+	  sizeof(struct bt_hci_cp_le_set_random_address),
+	  generic_success },
+};
+
+/* HCI driver open. */
+static int driver_open(void)
+{
+	return 0;
+}
+
+/* HCI driver send, answering the commands issued by bt_enable(). */
+static int driver_send(struct net_buf *buf)
+{
+	struct net_buf *evt = NULL;
+	struct bt_hci_cmd_hdr *chdr;
+	uint16_t opcode;
+
+	chdr = net_buf_pull_mem(buf, sizeof(*chdr));
+	opcode = sys_le16_to_cpu(chdr->opcode);
+
+	for (size_t i = 0; i < ARRAY_SIZE(cmds); i++) {
+		if (cmds[i].opcode == opcode) {
+			cmds[i].handler(buf, &evt, cmds[i].len, opcode);
+			break;
+		}
+	}
+
+	zassert_not_null(evt, "Unknown HCI command 0x%04x", opcode);
+	bt_recv_prio(evt);
+	net_buf_unref(buf);
+
+	return 0;
+}
+
+/* HCI driver structure. */
+static const struct bt_hci_driver drv = {
+	.name         = "test",
+	.bus          = BT_HCI_DRIVER_BUS_VIRTUAL,
+	.open         = driver_open,
+	.send         = driver_send,
+	.quirks       = BT_QUIRK_NO_RESET,
+};
+
+static const bt_addr_le_t addr_a = {
+	.type = BT_ADDR_LE_RANDOM,
+	.a.val = { 0x01, 0x02, 0x03, 0x04, 0x05, 0xc0 },
+};
+
+static const bt_addr_le_t addr_b = {
+	.type = BT_ADDR_LE_RANDOM,
+	.a.val = { 0x06, 0x07, 0x08, 0x09, 0x0a, 0xc0 },
+};
+
+/* Vendor specific UUID base, as found in the advertising data */
+#define VND_UUID_VAL(w32) \
+	BT_UUID_128_ENCODE(w32, 0xb5a3, 0xf393, 0xe0a9, 0xe50e24dcca9e)
+
+/* Filter of the filtered listener, changed by each test */
+static struct bt_le_scan_filter filter;
+
+/* Reports and AD structures seen by the filtered listener */
+static int filtered_count;
+static size_t ad_count;
+static uint8_t ad_types[CONFIG_BT_SCAN_AD_INDEX_SIZE];
+static uint8_t ad_lens[CONFIG_BT_SCAN_AD_INDEX_SIZE];
+
+static void filtered_recv(const struct bt_le_scan_recv_info *info,
+			  struct net_buf_simple *buf)
+{
+	filtered_count++;
+}
+
+static void filtered_recv_ad(const struct bt_le_scan_recv_info *info,
+			     const struct bt_data *ad, size_t count)
+{
+	zassert_true(count <= CONFIG_BT_SCAN_AD_INDEX_SIZE, NULL);
+
+	ad_count = count;
+
+	for (size_t i = 0; i < count; i++) {
+		ad_types[i] = ad[i].type;
+		ad_lens[i] = ad[i].data_len;
+	}
+}
+
+static struct bt_le_scan_cb filtered_cb = {
+	.recv = filtered_recv,
+	.recv_ad = filtered_recv_ad,
+	.filter = &filter,
+};
+
+/* Listener without filter, registered last, signalling that a report
+ * has gone through all the listeners.
+ */
+static K_SEM_DEFINE(report_sem, 0, 1);
+
+static void all_recv(const struct bt_le_scan_recv_info *info,
+		     struct net_buf_simple *buf)
+{
+	k_sem_give(&report_sem);
+}
+
+static struct bt_le_scan_cb all_cb = {
+	.recv = all_recv,
+};
+
+/* Send a non-connectable advertising report, and return whether it was
+ * given to the filtered listener.
+ */
+static bool report_send(const bt_addr_le_t *addr, const uint8_t *ad,
+			uint8_t len)
+{
+	struct bt_hci_evt_le_advertising_info *info;
+	struct bt_hci_evt_le_meta_event *meta;
+	struct net_buf *buf;
+
+	filtered_count = 0;
+	ad_count = 0;
+
+	buf = bt_buf_get_rx(BT_BUF_EVT, K_FOREVER);
+	evt_create(buf, BT_HCI_EVT_LE_META_EVENT,
+		   sizeof(*meta) + 1 + sizeof(*info) + len + 1);
+	meta = net_buf_add(buf, sizeof(*meta));
+	meta->subevent = BT_HCI_EVT_LE_ADVERTISING_REPORT;
+	net_buf_add_u8(buf, 1);
+	info = net_buf_add(buf, sizeof(*info));
+	info->evt_type = BT_GAP_ADV_TYPE_ADV_NONCONN_IND;
+	bt_addr_le_copy(&info->addr, addr);
+	info->length = len;
+	net_buf_add_mem(buf, ad, len);
+	/* RSSI */
+	net_buf_add_u8(buf, (uint8_t)-60);
+
+	zassert_ok(bt_recv(buf), NULL);
+	zassert_ok(k_sem_take(&report_sem, K_MSEC(100)),
+		   "report not processed");
+
+	return filtered_count > 0;
+}
+
+static const uint8_t ad_hr[] = {
+	0x02, BT_DATA_FLAGS, BT_LE_AD_NO_BREDR,
+	0x05, BT_DATA_UUID16_ALL, BT_UUID_16_ENCODE(0x180d),
+	BT_UUID_16_ENCODE(0x180f),
+	0x05, BT_DATA_NAME_COMPLETE, 'T', 'e', 's', 't',
+};
+
+static const uint8_t ad_svc_data[] = {
+	0x02, BT_DATA_FLAGS, BT_LE_AD_NO_BREDR,
+	0x05, BT_DATA_SVC_DATA16, BT_UUID_16_ENCODE(0xfeaa), 0x0d, 0x18,
+};
+
+static const uint8_t ad_vnd[] = {
+	0x11, BT_DATA_UUID128_ALL, VND_UUID_VAL(0x6e400001),
+};
+
+static void test_scan_filter_init(void)
+{
+	bt_hci_driver_register(&drv);
+
+	zassert_ok(bt_enable(NULL), "bt_enable failed");
+
+	bt_le_scan_cb_register(&filtered_cb);
+	bt_le_scan_cb_register(&all_cb);
+}
+
+/**
+ * @brief Test the identity address filter
+ */
+static void test_scan_filter_addr(void)
+{
+	filter = (struct bt_le_scan_filter) {
+		.options = BT_LE_SCAN_FILTER_ADDR,
+		.addr = &addr_a,
+	};
+
+	zassert_true(report_send(&addr_a, ad_hr, sizeof(ad_hr)), NULL);
+	zassert_false(report_send(&addr_b, ad_hr, sizeof(ad_hr)), NULL);
+
+	/* The criteria are combined */
+	filter.options |= BT_LE_SCAN_FILTER_AD_TYPE;
+	filter.ad_type = BT_DATA_NAME_COMPLETE;
+
+	zassert_true(report_send(&addr_a, ad_hr, sizeof(ad_hr)), NULL);
+	zassert_false(report_send(&addr_a, ad_svc_data, sizeof(ad_svc_data)),
+		      NULL);
+	zassert_false(report_send(&addr_b, ad_hr, sizeof(ad_hr)), NULL);
+}
+
+/**
+ * @brief Test the AD type filter
+ */
+static void test_scan_filter_ad_type(void)
+{
+	filter = (struct bt_le_scan_filter) {
+		.options = BT_LE_SCAN_FILTER_AD_TYPE,
+		.ad_type = BT_DATA_SVC_DATA16,
+	};
+
+	zassert_true(report_send(&addr_a, ad_svc_data, sizeof(ad_svc_data)),
+		     NULL);
+	zassert_false(report_send(&addr_a, ad_hr, sizeof(ad_hr)), NULL);
+	zassert_false(report_send(&addr_a, NULL, 0), NULL);
+}
+
+/**
+ * @brief Test the UUID filter, on whole UUIDs and on prefixes
+ */
+static void test_scan_filter_uuid(void)
+{
+	filter = (struct bt_le_scan_filter) {
+		.options = BT_LE_SCAN_FILTER_UUID,
+		.uuid = BT_UUID_DECLARE_16(0x180f),
+	};
+
+	/* Any UUID of a list */
+	zassert_true(report_send(&addr_a, ad_hr, sizeof(ad_hr)), NULL);
+
+	/* 16-bit UUIDs also match their 128-bit form */
+	filter.uuid = BT_UUID_DECLARE_128(
+		BT_UUID_128_ENCODE(0x0000180d, 0x0000, 0x1000, 0x8000,
+				   0x00805f9b34fb));
+	zassert_true(report_send(&addr_a, ad_hr, sizeof(ad_hr)), NULL);
+
+	/* Service data only starts with a UUID */
+	filter.uuid = BT_UUID_DECLARE_16(0xfeaa);
+	zassert_true(report_send(&addr_a, ad_svc_data, sizeof(ad_svc_data)),
+		     NULL);
+	filter.uuid = BT_UUID_DECLARE_16(0x180d);
+	zassert_false(report_send(&addr_a, ad_svc_data, sizeof(ad_svc_data)),
+		      NULL);
+
+	/* Whole vendor UUID */
+	filter.uuid = BT_UUID_DECLARE_128(VND_UUID_VAL(0x6e400001));
+	zassert_true(report_send(&addr_a, ad_vnd, sizeof(ad_vnd)), NULL);
+	filter.uuid = BT_UUID_DECLARE_128(VND_UUID_VAL(0x6e400002));
+	zassert_false(report_send(&addr_a, ad_vnd, sizeof(ad_vnd)), NULL);
+
+	/* Prefix of the vendor UUID, 6e40xxxx */
+	filter.uuid_prefix_len = 2;
+	zassert_true(report_send(&addr_a, ad_vnd, sizeof(ad_vnd)), NULL);
+	zassert_false(report_send(&addr_a, ad_hr, sizeof(ad_hr)), NULL);
+
+	filter.uuid_prefix_len = 4;
+	zassert_false(report_send(&addr_a, ad_vnd, sizeof(ad_vnd)), NULL);
+
+	/* Prefix of the Bluetooth Base UUID, 000018xx */
+	filter.uuid = BT_UUID_DECLARE_16(0x1800);
+	filter.uuid_prefix_len = 3;
+	zassert_true(report_send(&addr_a, ad_hr, sizeof(ad_hr)), NULL);
+	zassert_false(report_send(&addr_a, ad_vnd, sizeof(ad_vnd)), NULL);
+
+	/* The whole UUID beyond its size */
+	filter.uuid_prefix_len = 16;
+	zassert_false(report_send(&addr_a, ad_hr, sizeof(ad_hr)), NULL);
+}
+
+/**
+ * @brief Test the parsed AD structures given to the listeners
+ */
+static void test_scan_filter_recv_ad(void)
+{
+	filter = (struct bt_le_scan_filter) { 0 };
+
+	zassert_true(report_send(&addr_a, ad_hr, sizeof(ad_hr)), NULL);
+	zassert_equal(ad_count, 3, NULL);
+	zassert_equal(ad_types[0], BT_DATA_FLAGS, NULL);
+	zassert_equal(ad_lens[0], 1, NULL);
+	zassert_equal(ad_types[1], BT_DATA_UUID16_ALL, NULL);
+	zassert_equal(ad_lens[1], 4, NULL);
+	zassert_equal(ad_types[2], BT_DATA_NAME_COMPLETE, NULL);
+	zassert_equal(ad_lens[2], 4, NULL);
+
+	zassert_true(report_send(&addr_a, NULL, 0), NULL);
+	zassert_equal(ad_count, 0, NULL);
+}
+
+/**
+ * @brief Test that only the first CONFIG_BT_SCAN_AD_INDEX_SIZE AD
+ * structures of a report are parsed
+ */
+static void test_scan_filter_truncated(void)
+{
+	uint8_t ad[2 * (CONFIG_BT_SCAN_AD_INDEX_SIZE + 1)];
+
+	for (int i = 0; i <= CONFIG_BT_SCAN_AD_INDEX_SIZE; i++) {
+		ad[2 * i] = 1;
+		ad[2 * i + 1] = BT_DATA_MANUFACTURER_DATA - i;
+	}
+
+	filter = (struct bt_le_scan_filter) {
+		.options = BT_LE_SCAN_FILTER_AD_TYPE,
+		.ad_type = BT_DATA_MANUFACTURER_DATA -
+			   (CONFIG_BT_SCAN_AD_INDEX_SIZE - 1),
+	};
+
+	zassert_true(report_send(&addr_a, ad, sizeof(ad)), NULL);
+	zassert_equal(ad_count, CONFIG_BT_SCAN_AD_INDEX_SIZE, NULL);
+
+	/* The AD structure beyond the index isn't seen by the filter */
+	filter.ad_type = BT_DATA_MANUFACTURER_DATA -
+			 CONFIG_BT_SCAN_AD_INDEX_SIZE;
+	zassert_false(report_send(&addr_a, ad, sizeof(ad)), NULL);
+}
+
+/**
+ * @brief Test that the AD structures after a malformed or terminating
+ * one are ignored
+ */
+static void test_scan_filter_malformed(void)
+{
+	static const uint8_t ad_overflow[] = {
+		0x02, BT_DATA_FLAGS, BT_LE_AD_NO_BREDR,
+		0x05, BT_DATA_NAME_COMPLETE, 'T', 'e',
+	};
+	static const uint8_t ad_terminated[] = {
+		0x02, BT_DATA_FLAGS, BT_LE_AD_NO_BREDR,
+		0x00, 0x03, BT_DATA_NAME_COMPLETE, 'T', 'e',
+	};
+	static const uint8_t ad_uuid_odd[] = {
+		0x04, BT_DATA_UUID16_ALL, BT_UUID_16_ENCODE(0x180d), 0x18,
+	};
+
+	filter = (struct bt_le_scan_filter) {
+		.options = BT_LE_SCAN_FILTER_AD_TYPE,
+		.ad_type = BT_DATA_NAME_COMPLETE,
+	};
+
+	zassert_false(report_send(&addr_a, ad_overflow, sizeof(ad_overflow)),
+		      NULL);
+	filter.ad_type = BT_DATA_FLAGS;
+	zassert_true(report_send(&addr_a, ad_overflow, sizeof(ad_overflow)),
+		     NULL);
+	zassert_equal(ad_count, 1, NULL);
+
+	filter.ad_type = BT_DATA_NAME_COMPLETE;
+	zassert_false(report_send(&addr_a, ad_terminated,
+				  sizeof(ad_terminated)), NULL);
+	filter.ad_type = BT_DATA_FLAGS;
+	zassert_true(report_send(&addr_a, ad_terminated,
+				 sizeof(ad_terminated)), NULL);
+	zassert_equal(ad_count, 1, NULL);
+
+	/* The trailing byte of a UUID list isn't a UUID */
+	filter = (struct bt_le_scan_filter) {
+		.options = BT_LE_SCAN_FILTER_UUID,
+		.uuid = BT_UUID_DECLARE_16(0x180d),
+	};
+	zassert_true(report_send(&addr_a, ad_uuid_odd, sizeof(ad_uuid_odd)),
+		     NULL);
+	filter.uuid = BT_UUID_DECLARE_16(0x0018);
+	zassert_false(report_send(&addr_a, ad_uuid_odd, sizeof(ad_uuid_odd)),
+		      NULL);
+}
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(test_scan_filter,
+			 ztest_unit_test(test_scan_filter_init),
+			 ztest_unit_test(test_scan_filter_addr),
+			 ztest_unit_test(test_scan_filter_ad_type),
+			 ztest_unit_test(test_scan_filter_uuid),
+			 ztest_unit_test(test_scan_filter_recv_ad),
+			 ztest_unit_test(test_scan_filter_truncated),
+			 ztest_unit_test(test_scan_filter_malformed));
+
+	ztest_run_test_suite(test_scan_filter);
+}
@@ -19,6 +19,17 @@
 
 #define N_VALUES 10
 
+/* Samples of the statistical tests, and their bounds: failing values are
+ * about 4.5 standard deviations away from the expected ones, so the tests
+ * fail spuriously with a probability in the order of 10^-5.
+ */
+#define STAT_BYTES 65536
+#define STAT_CHUNK 1024
+#define MONOBIT_MAX_DEVIATION 1630
+#define CHI2_MAX 357
+#define SERIAL_PAIRS 16384
+#define SERIAL_MAX_DEVIATION 166
+
 
 /**
  *
@@ -113,9 +124,104 @@ void test_rand32(void)
 }
 
 
+static void skip_if_not_random(void)
+{
+	if (IS_ENABLED(CONFIG_TIMER_RANDOM_GENERATOR)) {
+		ztest_test_skip();
+	}
+}
+
+/**
+ * @brief Test the distribution of the bits and bytes of sys_rand_get()
+ *
+ * @details Counts the bits set (monobit test) and the occurrences of each
+ * byte value (chi-square test with 255 degrees of freedom).
+ */
+void test_rand32_distribution(void)
+{
+	static uint8_t buf[STAT_CHUNK];
+	static uint32_t counts[256];
+	uint32_t ones = 0;
+	uint32_t chi2 = 0;
+	const uint32_t expected = STAT_BYTES / 256;
+
+	skip_if_not_random();
+
+	for (int n = 0; n < STAT_BYTES; n += STAT_CHUNK) {
+		sys_rand_get(buf, sizeof(buf));
+		for (int i = 0; i < STAT_CHUNK; i++) {
+			ones += __builtin_popcount(buf[i]);
+			counts[buf[i]]++;
+		}
+	}
+
+	zassert_within(ones, STAT_BYTES * 4, MONOBIT_MAX_DEVIATION,
+		       "%u bits set out of %u", ones, STAT_BYTES * 8);
+
+	for (int i = 0; i < 256; i++) {
+		int32_t diff = counts[i] - expected;
+
+		chi2 += diff * diff;
+	}
+	chi2 /= expected;
+
+	zassert_true(chi2 < CHI2_MAX, "byte chi-square %u", chi2);
+}
+
+/**
+ * @brief Test that successive values of sys_rand32_get() are independent
+ *
+ * @details Each value must be greater than the previous one half of the
+ * time.
+ */
+void test_rand32_serial(void)
+{
+	uint32_t last = sys_rand32_get();
+	uint32_t greater = 0;
+
+	skip_if_not_random();
+
+	for (int i = 0; i < SERIAL_PAIRS; i++) {
+		uint32_t gen = sys_rand32_get();
+
+		greater += (gen > last) ? 1 : 0;
+		last = gen;
+	}
+
+	zassert_within(greater, SERIAL_PAIRS / 2, SERIAL_MAX_DEVIATION,
+		       "%u increasing pairs out of %u", greater, SERIAL_PAIRS);
+}
+
+/**
+ * @brief Test sys_rand_get() with unaligned buffers of any length
+ *
+ * @details The bytes around the buffer must be left untouched.
+ */
+void test_rand32_fill_bounds(void)
+{
+	uint8_t buf[48];
+
+	for (int offset = 0; offset < 8; offset++) {
+		for (int len = 0; len <= 33; len++) {
+			(void)memset(buf, 0x5a, sizeof(buf));
+			sys_rand_get(&buf[offset], len);
+
+			for (int i = 0; i < offset; i++) {
+				zassert_equal(buf[i], 0x5a, "wrote before");
+			}
+			for (int i = offset + len; i < sizeof(buf); i++) {
+				zassert_equal(buf[i], 0x5a, "wrote after");
+			}
+		}
+	}
+}
+
 void test_main(void)
 {
-	ztest_test_suite(common_test, ztest_unit_test(test_rand32));
+	ztest_test_suite(common_test, ztest_unit_test(test_rand32),
+			 ztest_unit_test(test_rand32_distribution),
+			 ztest_unit_test(test_rand32_serial),
+			 ztest_unit_test(test_rand32_fill_bounds));
 
 	ztest_run_test_suite(common_test);
 }
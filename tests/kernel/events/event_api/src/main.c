@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+
+#define STACK_SIZE     (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+#define PRIO_WAIT (CONFIG_ZTEST_THREAD_PRIORITY - 1)
+
+#define NUM_WAITERS 3
+
+K_THREAD_STACK_ARRAY_DEFINE(waiter_stack, NUM_WAITERS, STACK_SIZE);
+static struct k_thread waiter_tid[NUM_WAITERS];
+
+static K_EVENT_DEFINE(test_event);
+static struct k_event init_event;
+
+struct waiter_args {
+	uint32_t events;
+	bool all;
+	bool clear;
+	uint32_t received;
+};
+
+static struct waiter_args waiter[NUM_WAITERS];
+
+static void waiter_entry(void *p1, void *p2, void *p3)
+{
+	struct waiter_args *args = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	if (args->all) {
+		args->received = k_event_wait_all(&test_event, args->events,
+						  args->clear, K_FOREVER);
+	} else {
+		args->received = k_event_wait(&test_event, args->events,
+					      args->clear, K_FOREVER);
+	}
+}
+
+static void start_waiter(int i, uint32_t events, bool all, bool clear)
+{
+	waiter[i].events = events;
+	waiter[i].all = all;
+	waiter[i].clear = clear;
+	waiter[i].received = 0;
+
+	k_thread_create(&waiter_tid[i], waiter_stack[i], STACK_SIZE,
+			waiter_entry, &waiter[i], NULL, NULL,
+			PRIO_WAIT, 0, K_NO_WAIT);
+}
+
+static void isr_post(const void *param)
+{
+	k_event_post(&test_event, POINTER_TO_UINT(param));
+}
+
+/**
+ * @brief Test initialization of event objects
+ */
+void test_event_init(void)
+{
+	k_event_init(&init_event);
+	zassert_equal(k_event_events_get(&init_event), 0, NULL);
+	zassert_equal(k_event_events_get(&test_event), 0, NULL);
+}
+
+/**
+ * @brief Test post, set and clear without waiters
+ */
+void test_event_post_set_clear(void)
+{
+	k_event_set(&test_event, 0);
+
+	k_event_post(&test_event, BIT(0));
+	k_event_post(&test_event, BIT(3));
+	zassert_equal(k_event_events_get(&test_event), BIT(0) | BIT(3), NULL);
+
+	k_event_set(&test_event, BIT(5));
+	zassert_equal(k_event_events_get(&test_event), BIT(5), NULL);
+
+	k_event_clear(&test_event, BIT(5) | BIT(6));
+	zassert_equal(k_event_events_get(&test_event), 0, NULL);
+}
+
+/**
+ * @brief Test waits that are satisfied without pending
+ */
+void test_event_wait_no_wait(void)
+{
+	uint32_t rv;
+
+	k_event_set(&test_event, BIT(1) | BIT(2));
+
+	rv = k_event_wait(&test_event, BIT(2) | BIT(4), false, K_NO_WAIT);
+	zassert_equal(rv, BIT(2), NULL);
+
+	rv = k_event_wait_all(&test_event, BIT(2) | BIT(4), false, K_NO_WAIT);
+	zassert_equal(rv, 0, NULL);
+
+	rv = k_event_wait_all(&test_event, BIT(1) | BIT(2), true, K_NO_WAIT);
+	zassert_equal(rv, BIT(1) | BIT(2), NULL);
+	zassert_equal(k_event_events_get(&test_event), 0, NULL);
+
+	rv = k_event_wait(&test_event, BIT(1), false, K_MSEC(10));
+	zassert_equal(rv, 0, "wait should have timed out");
+}
+
+/**
+ * @brief Test that a single post wakes all eligible waiters
+ */
+void test_event_wake_multiple(void)
+{
+	k_event_set(&test_event, 0);
+
+	start_waiter(0, BIT(0), false, false);
+	start_waiter(1, BIT(0) | BIT(1), true, false);
+	start_waiter(2, BIT(2), false, false);
+
+	k_event_post(&test_event, BIT(0));
+	zassert_equal(waiter[0].received, BIT(0), NULL);
+	zassert_equal(waiter[1].received, 0, NULL);
+	zassert_equal(waiter[2].received, 0, NULL);
+
+	k_event_post(&test_event, BIT(1) | BIT(2));
+	zassert_equal(waiter[1].received, BIT(0) | BIT(1), NULL);
+	zassert_equal(waiter[2].received, BIT(2), NULL);
+
+	for (int i = 0; i < NUM_WAITERS; i++) {
+		k_thread_join(&waiter_tid[i], K_FOREVER);
+	}
+
+	zassert_equal(k_event_events_get(&test_event),
+		      BIT(0) | BIT(1) | BIT(2), NULL);
+}
+
+/**
+ * @brief Test that woken waiters clear the matched events on exit
+ */
+void test_event_wait_clear(void)
+{
+	k_event_set(&test_event, 0);
+
+	start_waiter(0, BIT(0) | BIT(1), false, true);
+	start_waiter(1, BIT(1), false, false);
+
+	k_event_post(&test_event, BIT(1) | BIT(4));
+	zassert_equal(waiter[0].received, BIT(1), NULL);
+	zassert_equal(waiter[1].received, BIT(1), NULL);
+	zassert_equal(k_event_events_get(&test_event), BIT(4), NULL);
+
+	for (int i = 0; i < 2; i++) {
+		k_thread_join(&waiter_tid[i], K_FOREVER);
+	}
+}
+
+/**
+ * @brief Test posting events from an ISR
+ */
+void test_event_post_from_isr(void)
+{
+	k_event_set(&test_event, 0);
+
+	start_waiter(0, BIT(7), false, true);
+
+	irq_offload(isr_post, UINT_TO_POINTER(BIT(7)));
+	k_thread_join(&waiter_tid[0], K_FOREVER);
+
+	zassert_equal(waiter[0].received, BIT(7), NULL);
+	zassert_equal(k_event_events_get(&test_event), 0, NULL);
+}
+
+/**
+ * @brief Test waiting on an event object with k_poll()
+ */
+void test_event_poll(void)
+{
+	struct k_poll_event poll_event;
+	int rc;
+
+	k_event_set(&test_event, 0);
+	k_poll_event_init(&poll_event, K_POLL_TYPE_EVENT,
+			  K_POLL_MODE_NOTIFY_ONLY, &test_event);
+
+	rc = k_poll(&poll_event, 1, K_NO_WAIT);
+	zassert_equal(rc, -EAGAIN, NULL);
+
+	irq_offload(isr_post, UINT_TO_POINTER(BIT(2)));
+
+	poll_event.state = K_POLL_STATE_NOT_READY;
+	rc = k_poll(&poll_event, 1, K_MSEC(100));
+	zassert_equal(rc, 0, NULL);
+	zassert_equal(poll_event.state, K_POLL_STATE_EVENT_POSTED, NULL);
+	zassert_equal(k_event_wait(&test_event, BIT(2), true, K_NO_WAIT),
+		      BIT(2), NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_event,
+			 ztest_unit_test(test_event_init),
+			 ztest_unit_test(test_event_post_set_clear),
+			 ztest_unit_test(test_event_wait_no_wait),
+			 ztest_unit_test(test_event_wake_multiple),
+			 ztest_unit_test(test_event_wait_clear),
+			 ztest_unit_test(test_event_post_from_isr),
+			 ztest_unit_test(test_event_poll)
+			 );
+	ztest_run_test_suite(test_event);
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+#include <rcu.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define READER_PRIO (CONFIG_ZTEST_THREAD_PRIORITY + 1)
+
+K_THREAD_STACK_DEFINE(reader_stack, STACK_SIZE);
+static struct k_thread reader_thread;
+
+static volatile bool in_section;
+static volatile bool release;
+static K_SEM_DEFINE(cb_done, 0, 1);
+
+struct item {
+	struct k_rcu_head rcu;
+	int value;
+};
+
+static struct item items[2] = {
+	{ .value = 1 },
+	{ .value = 2 },
+};
+static struct item *current_item = &items[0];
+
+static void reader_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_rcu_read_lock();
+	zassert_equal(K_RCU_DEREFERENCE(current_item)->value, 1, NULL);
+	in_section = true;
+
+	/* Stay in the critical section, preemptible, until released */
+	while (!release) {
+	}
+
+	zassert_equal(K_RCU_DEREFERENCE(current_item)->value, 2, NULL);
+	k_rcu_read_unlock();
+}
+
+static void item_free(struct k_rcu_head *head)
+{
+	struct item *item = CONTAINER_OF(head, struct item, rcu);
+
+	item->value = 0;
+	k_sem_give(&cb_done);
+}
+
+static void isr_reader(const void *param)
+{
+	int *value = (int *)param;
+
+	k_rcu_read_lock();
+	*value = K_RCU_DEREFERENCE(current_item)->value;
+	k_rcu_read_unlock();
+}
+
+/**
+ * @brief Test grace periods without readers
+ */
+void test_rcu_synchronize_no_readers(void)
+{
+	k_rcu_read_lock();
+	k_rcu_read_lock();
+	zassert_equal(K_RCU_DEREFERENCE(current_item)->value, 1, NULL);
+	k_rcu_read_unlock();
+	k_rcu_read_unlock();
+
+	k_rcu_synchronize();
+	k_rcu_synchronize();
+}
+
+/**
+ * @brief Test read-side critical sections in ISRs
+ */
+void test_rcu_isr_reader(void)
+{
+	int value = 0;
+
+	irq_offload(isr_reader, &value);
+	zassert_equal(value, 1, NULL);
+}
+
+/**
+ * @brief Test that a grace period waits for a preempted reader
+ */
+void test_rcu_preempted_reader(void)
+{
+	struct item *old = current_item;
+
+	in_section = false;
+	release = false;
+	k_sem_reset(&cb_done);
+
+	k_thread_create(&reader_thread, reader_stack, STACK_SIZE,
+			reader_fn, NULL, NULL, NULL, READER_PRIO, 0,
+			K_NO_WAIT);
+
+	/* Let the lower priority reader enter its critical section, it
+	 * is preempted inside of it when this thread wakes up.
+	 */
+	while (!in_section) {
+		k_msleep(1);
+	}
+
+	K_RCU_ASSIGN_POINTER(current_item, &items[1]);
+	k_rcu_call(&old->rcu, item_free);
+
+	/* The callback thread has a higher priority than the reader, so
+	 * only the grace period can hold the callback back.
+	 */
+	zassert_equal(k_sem_take(&cb_done, K_MSEC(50)), -EAGAIN,
+		      "grace period ended with a reader in progress");
+	zassert_equal(old->value, 1, NULL);
+
+	release = true;
+	k_thread_join(&reader_thread, K_FOREVER);
+
+	zassert_equal(k_sem_take(&cb_done, K_MSEC(100)), 0,
+		      "callback not invoked after grace period");
+	zassert_equal(old->value, 0, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(rcu,
+			 ztest_unit_test(test_rcu_synchronize_no_readers),
+			 ztest_unit_test(test_rcu_isr_reader),
+			 ztest_unit_test(test_rcu_preempted_reader)
+			 );
+	ztest_run_test_suite(rcu);
+}
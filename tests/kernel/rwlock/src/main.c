@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_LOCKERS 2
+/* Higher than the priority of the test thread */
+#define LOCKER_PRIO (CONFIG_ZTEST_THREAD_PRIORITY - 1)
+
+K_THREAD_STACK_ARRAY_DEFINE(locker_stacks, NUM_LOCKERS, STACK_SIZE);
+static struct k_thread locker_threads[NUM_LOCKERS];
+
+static struct k_rwlock rwlock;
+
+/* Lock operation run by a locker thread */
+struct lock_op {
+	bool write;
+	k_timeout_t timeout;
+	int ret;
+	/* Rank at which the lock was obtained */
+	int rank;
+};
+
+static struct lock_op ops[NUM_LOCKERS];
+static atomic_t n_acquired;
+
+static void locker_fn(void *p1, void *p2, void *p3)
+{
+	struct lock_op *op = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	if (op->write) {
+		op->ret = k_rwlock_write_lock(&rwlock, op->timeout);
+	} else {
+		op->ret = k_rwlock_read_lock(&rwlock, op->timeout);
+	}
+
+	if (op->ret != 0) {
+		return;
+	}
+
+	op->rank = atomic_inc(&n_acquired) + 1;
+
+	if (op->write) {
+		zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+	} else {
+		zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+	}
+}
+
+/* Start a locker thread, which blocks on the lock if it cannot take it */
+static void start_locker(int id, bool write, k_timeout_t timeout)
+{
+	ops[id].write = write;
+	ops[id].timeout = timeout;
+	ops[id].ret = 1;
+	ops[id].rank = 0;
+
+	k_thread_create(&locker_threads[id], locker_stacks[id], STACK_SIZE,
+			locker_fn, &ops[id], NULL, NULL, LOCKER_PRIO, 0,
+			K_NO_WAIT);
+	k_msleep(10);
+}
+
+static void join_lockers(int n)
+{
+	for (int i = 0; i < n; i++) {
+		k_thread_join(&locker_threads[i], K_FOREVER);
+	}
+	(void)atomic_set(&n_acquired, 0);
+}
+
+/**
+ * @brief Test locking and unlocking without contention
+ */
+void test_rwlock_uncontended(void)
+{
+	zassert_equal(k_rwlock_init(&rwlock, K_RWLOCK_PHASE_FAIR + 1),
+		      -EINVAL, NULL);
+	zassert_equal(k_rwlock_init(&rwlock, K_RWLOCK_PREFER_READER), 0,
+		      NULL);
+
+	/* Readers share the lock */
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+	zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+	zassert_equal(k_rwlock_read_unlock(&rwlock), -EINVAL, NULL);
+	zassert_equal(k_rwlock_write_unlock(&rwlock), -EPERM, NULL);
+
+	/* Writers do not */
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), -EDEADLK,
+		      NULL);
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), -EDEADLK, NULL);
+	zassert_equal(k_rwlock_read_unlock(&rwlock), -EINVAL, NULL);
+	zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+	zassert_equal(k_rwlock_write_unlock(&rwlock), -EPERM, NULL);
+
+	zassert_equal(atomic_get(&rwlock.state), 0, NULL);
+}
+
+/**
+ * @brief Test that a timed out writer does not block readers
+ */
+void test_rwlock_timeout(void)
+{
+	zassert_equal(k_rwlock_init(&rwlock, K_RWLOCK_PREFER_WRITER), 0,
+		      NULL);
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+
+	start_locker(0, true, K_MSEC(50));
+	zassert_equal(ops[0].ret, 1, "writer did not wait");
+
+	/* New readers wait behind the writer */
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), -EBUSY, NULL);
+
+	join_lockers(1);
+	zassert_equal(ops[0].ret, -EAGAIN, NULL);
+
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+	zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+	zassert_equal(atomic_get(&rwlock.state), 0, NULL);
+}
+
+/**
+ * @brief Test that readers are not blocked by waiting writers when they
+ * are preferred
+ */
+void test_rwlock_prefer_reader(void)
+{
+	zassert_equal(k_rwlock_init(&rwlock, K_RWLOCK_PREFER_READER), 0,
+		      NULL);
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+
+	start_locker(0, true, K_FOREVER);
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+	zassert_equal(ops[0].ret, 1, "writer got a read locked lock");
+
+	/* The last reader hands the lock over to the writer */
+	zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+	join_lockers(1);
+	zassert_equal(ops[0].ret, 0, NULL);
+	zassert_equal(atomic_get(&rwlock.state), 0, NULL);
+}
+
+static void check_handoff(unsigned int policy, int reader_rank,
+			  int writer_rank)
+{
+	zassert_equal(k_rwlock_init(&rwlock, policy), 0, NULL);
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), 0, NULL);
+
+	start_locker(0, false, K_FOREVER);
+	start_locker(1, true, K_FOREVER);
+
+	zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+	join_lockers(2);
+
+	zassert_equal(ops[0].ret, 0, NULL);
+	zassert_equal(ops[1].ret, 0, NULL);
+	zassert_equal(ops[0].rank, reader_rank, "wrong reader rank");
+	zassert_equal(ops[1].rank, writer_rank, "wrong writer rank");
+	zassert_equal(atomic_get(&rwlock.state), 0, NULL);
+}
+
+/**
+ * @brief Test the order in which a releasing writer hands the lock over
+ */
+void test_rwlock_handoff(void)
+{
+	check_handoff(K_RWLOCK_PREFER_READER, 1, 2);
+	check_handoff(K_RWLOCK_PREFER_WRITER, 2, 1);
+	check_handoff(K_RWLOCK_PHASE_FAIR, 1, 2);
+}
+
+/**
+ * @brief Test that the writer inherits the priority of the waiters
+ */
+void test_rwlock_priority_inheritance(void)
+{
+	int prio = k_thread_priority_get(k_current_get());
+
+	zassert_equal(k_rwlock_init(&rwlock, K_RWLOCK_PHASE_FAIR), 0, NULL);
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), 0, NULL);
+
+	start_locker(0, false, K_MSEC(50));
+	zassert_equal(k_thread_priority_get(k_current_get()), LOCKER_PRIO,
+		      "writer priority not boosted");
+
+	/* The boost ends when the waiter gives up */
+	k_thread_join(&locker_threads[0], K_FOREVER);
+	zassert_equal(ops[0].ret, -EAGAIN, NULL);
+	zassert_equal(k_thread_priority_get(k_current_get()), prio, NULL);
+
+	start_locker(0, true, K_FOREVER);
+	zassert_equal(k_thread_priority_get(k_current_get()), LOCKER_PRIO,
+		      "writer priority not boosted");
+
+	/* And when the lock is released */
+	zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+	zassert_equal(k_thread_priority_get(k_current_get()), prio, NULL);
+	join_lockers(1);
+	zassert_equal(ops[0].ret, 0, NULL);
+}
+
+#define RACE_ROUNDS 2000
+
+static void racer_fn(void *p1, void *p2, void *p3)
+{
+	int *timeouts = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < RACE_ROUNDS; i++) {
+		bool write = (i & 1) != 0;
+		int ret;
+
+		if (write) {
+			ret = k_rwlock_write_lock(&rwlock, K_TICKS(1));
+		} else {
+			ret = k_rwlock_read_lock(&rwlock, K_TICKS(1));
+		}
+
+		if (ret != 0) {
+			zassert_equal(ret, -EAGAIN, NULL);
+			(*timeouts)++;
+			continue;
+		}
+
+		if (write) {
+			zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+		} else {
+			zassert_equal(k_rwlock_read_unlock(&rwlock), 0, NULL);
+		}
+	}
+}
+
+/**
+ * @brief Test that waiters timing out on one CPU while the lock is released
+ * on another one do not leak the lock
+ */
+void test_rwlock_smp_timeout(void)
+{
+	static int timeouts[NUM_LOCKERS];
+
+	if (!IS_ENABLED(CONFIG_SMP) || (CONFIG_MP_NUM_CPUS < 2)) {
+		ztest_test_skip();
+	}
+
+	for (unsigned int policy = K_RWLOCK_PREFER_READER;
+	     policy <= K_RWLOCK_PHASE_FAIR; policy++) {
+		zassert_equal(k_rwlock_init(&rwlock, policy), 0, NULL);
+
+		for (int i = 0; i < NUM_LOCKERS; i++) {
+			timeouts[i] = 0;
+			k_thread_create(&locker_threads[i], locker_stacks[i],
+					STACK_SIZE, racer_fn, &timeouts[i],
+					NULL, NULL, LOCKER_PRIO, 0,
+					K_NO_WAIT);
+		}
+
+		/* Hold the lock for about the timeout of the waiters, so
+		 * that releases race with their timeouts.
+		 */
+		for (int i = 0; i < RACE_ROUNDS; i++) {
+			zassert_equal(k_rwlock_write_lock(&rwlock, K_FOREVER),
+				      0, NULL);
+			k_busy_wait(k_ticks_to_us_floor32(1) + (i % 7) * 10);
+			zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+			k_busy_wait(10);
+		}
+
+		join_lockers(NUM_LOCKERS);
+
+		zassert_true(timeouts[0] + timeouts[1] > 0,
+			     "no waiter timed out");
+		zassert_equal(atomic_get(&rwlock.state), 0, "lock leaked");
+		zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), 0,
+			      NULL);
+		zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(rwlock,
+			 ztest_unit_test(test_rwlock_uncontended),
+			 ztest_unit_test(test_rwlock_timeout),
+			 ztest_unit_test(test_rwlock_prefer_reader),
+			 ztest_unit_test(test_rwlock_handoff),
+			 ztest_unit_test(test_rwlock_priority_inheritance),
+			 ztest_unit_test(test_rwlock_smp_timeout)
+			 );
+	ztest_run_test_suite(rwlock);
+}
@@ -310,6 +310,82 @@ void test_memcmp(void)
 	zassert_true((ret != 0), "memcmp 5");
 }
 
+/**
+ *
+ * @brief Test memory block functions with every alignment
+ *
+ * Checks memcpy(), memset() and memcmp() against byte loops, for all the
+ * source and destination offsets within a 64 bits word and sizes covering
+ * the head, body and tail parts of the word-wise implementations.
+ */
+
+#define MEMOPS_MAX_SIZE	96
+#define MEMOPS_BUF_SIZE	(MEMOPS_MAX_SIZE + 16)
+
+static unsigned char memops_src[MEMOPS_BUF_SIZE] __aligned(8);
+static unsigned char memops_dst[MEMOPS_BUF_SIZE] __aligned(8);
+
+static void memops_fill(void)
+{
+	for (int i = 0; i < MEMOPS_BUF_SIZE; i++) {
+		memops_src[i] = (unsigned char)(i * 7 + 1);
+		memops_dst[i] = 0x5a;
+	}
+}
+
+/* Check that the bytes around the @p n bytes at @p off were not modified */
+static void memops_check_guard(int off, size_t n)
+{
+	for (int i = 0; i < MEMOPS_BUF_SIZE; i++) {
+		if ((i < off) || (i >= off + n)) {
+			zassert_equal(memops_dst[i], 0x5a,
+				      "byte %d off %d size %zu", i, off, n);
+		}
+	}
+}
+
+void test_memops_alignment(void)
+{
+	for (int s_off = 0; s_off < 8; s_off++) {
+		for (int d_off = 0; d_off < 8; d_off++) {
+			for (size_t n = 0; n <= MEMOPS_MAX_SIZE; n++) {
+				memops_fill();
+				memcpy(&memops_dst[d_off], &memops_src[s_off],
+				       n);
+				for (size_t i = 0; i < n; i++) {
+					zassert_equal(memops_dst[d_off + i],
+						      memops_src[s_off + i],
+						      "memcpy %d %d %zu",
+						      s_off, d_off, n);
+				}
+				memops_check_guard(d_off, n);
+
+				zassert_equal(memcmp(&memops_dst[d_off],
+						     &memops_src[s_off], n), 0,
+					      "memcmp %d %d %zu",
+					      s_off, d_off, n);
+				if (n > 0) {
+					memops_dst[d_off + n - 1] = 0xff;
+					zassert_true(memcmp(&memops_dst[d_off],
+							    &memops_src[s_off],
+							    n) > 0,
+						     "memcmp sign %zu", n);
+				}
+			}
+		}
+
+		for (size_t n = 0; n <= MEMOPS_MAX_SIZE; n++) {
+			memops_fill();
+			memset(&memops_dst[s_off], 0xa5, n);
+			for (size_t i = 0; i < n; i++) {
+				zassert_equal(memops_dst[s_off + i], 0xa5,
+					      "memset %d %zu", s_off, n);
+			}
+			memops_check_guard(s_off, n);
+		}
+	}
+}
+
 /**
  *
  * @brief Test binary search function
@@ -621,6 +697,7 @@ void test_main(void)
 			 ztest_unit_test(test_stddef),
 			 ztest_unit_test(test_stdint),
 			 ztest_unit_test(test_memcmp),
+			 ztest_unit_test(test_memops_alignment),
 			 ztest_unit_test(test_strchr),
 			 ztest_unit_test(test_strcpy),
 			 ztest_unit_test(test_strncpy),
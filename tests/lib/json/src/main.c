@@ -539,6 +539,249 @@ static void test_json_encode_bounds_check(void)
 	zassert_equal(ret, -ENOMEM, "Bounds check rejected");
 }
 
+/* Log of the events of the streaming parser, one character per structural
+ * event, keys and strings quoted, numbers prefixed with '#'.
+ */
+struct sax_log {
+	char text[256];
+	size_t len;
+	int abort_at;
+	int events;
+};
+
+static int sax_log_cb(const struct json_sax_event *event, void *user_data)
+{
+	struct sax_log *log = user_data;
+	int ret;
+
+	if (++log->events == log->abort_at) {
+		return -ECANCELED;
+	}
+
+	switch (event->type) {
+	case JSON_TOK_STRING:
+		ret = snprintk(&log->text[log->len],
+			       sizeof(log->text) - log->len,
+			       event->key ? "%s:" : "'%s'", event->value);
+		break;
+	case JSON_TOK_NUMBER:
+		ret = snprintk(&log->text[log->len],
+			       sizeof(log->text) - log->len, "#%s",
+			       event->value);
+		break;
+	default:
+		ret = snprintk(&log->text[log->len],
+			       sizeof(log->text) - log->len, "%c",
+			       (char)event->type);
+		break;
+	}
+
+	log->len += ret;
+
+	return 0;
+}
+
+static int sax_parse(const char *doc, size_t chunk, char *buf,
+		     size_t buf_size, struct sax_log *log)
+{
+	struct json_sax_parser parser;
+	size_t len = strlen(doc);
+	size_t pos;
+	int ret;
+
+	memset(log->text, 0, sizeof(log->text));
+	log->len = 0;
+	log->events = 0;
+
+	json_sax_init(&parser, buf, buf_size, sax_log_cb, log);
+
+	for (pos = 0; pos < len; pos += chunk) {
+		ret = json_sax_feed(&parser, &doc[pos], MIN(chunk, len - pos));
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return json_sax_finish(&parser);
+}
+
+static void test_json_sax(void)
+{
+	const char doc[] = " {\"a\":[1,-2.5e+3, true ,false,null, \"x\\\"y\\u00e9\"],"
+			   "\"long key\":{\"b\":{}, \"c\":[]},\"d\":0}\r\n";
+	const char expected[] = "{a:[#1#-2.5e+3tfn'x\\\"y\\u00e9']"
+				"long key:{b:{}c:[]}d:#0}";
+	struct sax_log log = { 0 };
+	char buf[16];
+	size_t chunk;
+	int ret;
+
+	/* Every split of the document gives the same events */
+	for (chunk = 1; chunk <= sizeof(doc); chunk++) {
+		ret = sax_parse(doc, chunk, buf, sizeof(buf), &log);
+		zassert_equal(ret, 0, "parsing failed, chunk %zu", chunk);
+		zassert_true(!strcmp(log.text, expected),
+			     "chunk %zu: %s", chunk, log.text);
+	}
+
+	/* Top-level scalars, a number being terminated by the end only */
+	ret = sax_parse("-12", 1, buf, sizeof(buf), &log);
+	zassert_equal(ret, 0, "top-level number");
+	zassert_true(!strcmp(log.text, "#-12"), "got %s", log.text);
+
+	ret = sax_parse("\"s\"", 1, buf, sizeof(buf), &log);
+	zassert_equal(ret, 0, "top-level string");
+	zassert_true(!strcmp(log.text, "'s'"), "got %s", log.text);
+}
+
+static void test_json_sax_errors(void)
+{
+	const char *const malformed[] = {
+		"", "{", "[1,]", "{\"a\"}", "{\"a\":1,}", "{1:2}", "[1 2]",
+		"01", "1.", "-", "1e", "tru", "nul", "[}", "{]", "\"\\x\"",
+		"\"\\u12g4\"", "\"a\nb\"", "1 2", "{} {}", "[\"a\":1]",
+	};
+	char deep[JSON_STREAM_MAX_DEPTH + 2];
+	struct sax_log log = { 0 };
+	char buf[8];
+	size_t i;
+	int ret;
+
+	for (i = 0; i < ARRAY_SIZE(malformed); i++) {
+		ret = sax_parse(malformed[i], 1, buf, sizeof(buf), &log);
+		zassert_equal(ret, -EINVAL, "'%s' accepted", malformed[i]);
+	}
+
+	/* Strings and numbers must fit in the buffer with a NUL */
+	ret = sax_parse("[\"12345678\"]", 3, buf, sizeof(buf), &log);
+	zassert_equal(ret, -ENOMEM, "long string accepted");
+	ret = sax_parse("[\"1234567\"]", 3, buf, sizeof(buf), &log);
+	zassert_equal(ret, 0, "string filling the buffer rejected");
+	ret = sax_parse("12345678", 3, buf, sizeof(buf), &log);
+	zassert_equal(ret, -ENOMEM, "long number accepted");
+
+	memset(deep, '[', sizeof(deep) - 1);
+	deep[sizeof(deep) - 1] = '\0';
+	ret = sax_parse(deep, 1, buf, sizeof(buf), &log);
+	zassert_equal(ret, -E2BIG, "nesting too deep accepted");
+
+	/* The error of the callback stops the parser */
+	log.abort_at = 3;
+	ret = sax_parse("[1,2,3]", 1, buf, sizeof(buf), &log);
+	zassert_equal(ret, -ECANCELED, "callback error ignored");
+	zassert_true(!strcmp(log.text, "[#1"), "got %s", log.text);
+}
+
+struct chunk_sink {
+	char text[128];
+	size_t len;
+	size_t max_chunk;
+};
+
+static int chunk_sink_append(const char *bytes, size_t len, void *data)
+{
+	struct chunk_sink *sink = data;
+
+	if (sink->len + len >= sizeof(sink->text)) {
+		return -ENOMEM;
+	}
+
+	memcpy(&sink->text[sink->len], bytes, len);
+	sink->len += len;
+	sink->max_chunk = MAX(sink->max_chunk, len);
+
+	return 0;
+}
+
+static void test_json_writer(void)
+{
+	const char expected[] = "{\"a\":[1,-9223372036854775808,true,false,"
+				"null,\"t\\\"ab\"],\"o\":{\"b\":{},\"c\":[]},"
+				"\"d\":0}";
+	struct chunk_sink sink = { 0 };
+	struct json_writer writer;
+	char buf[8];
+	int ret;
+
+	json_writer_init(&writer, buf, sizeof(buf), chunk_sink_append, &sink);
+	json_writer_object_start(&writer);
+	json_writer_key(&writer, "a");
+	json_writer_array_start(&writer);
+	json_writer_number(&writer, 1);
+	json_writer_number(&writer, INT64_MIN);
+	json_writer_bool(&writer, true);
+	json_writer_bool(&writer, false);
+	json_writer_null(&writer);
+	json_writer_string(&writer, "t\"ab");
+	json_writer_array_end(&writer);
+	json_writer_key(&writer, "o");
+	json_writer_object_start(&writer);
+	json_writer_key(&writer, "b");
+	json_writer_object_start(&writer);
+	json_writer_object_end(&writer);
+	json_writer_key(&writer, "c");
+	json_writer_array_start(&writer);
+	json_writer_array_end(&writer);
+	json_writer_object_end(&writer);
+	json_writer_key(&writer, "d");
+	json_writer_number(&writer, 0);
+	ret = json_writer_object_end(&writer);
+	zassert_equal(ret, 0, "writing failed");
+	zassert_equal(json_writer_flush(&writer), 0, "flush failed");
+
+	zassert_equal(sink.len, strlen(expected), "length mismatch");
+	zassert_true(!memcmp(sink.text, expected, sink.len), "got %s",
+		     sink.text);
+	zassert_true(sink.max_chunk <= sizeof(buf), "chunk too large");
+
+	/* The output is valid for the streaming parser */
+	struct sax_log log = { 0 };
+	char token[24];
+
+	sink.text[sink.len] = '\0';
+	ret = sax_parse(sink.text, 5, token, sizeof(token), &log);
+	zassert_equal(ret, 0, "parsing the output failed");
+}
+
+static void test_json_writer_errors(void)
+{
+	struct chunk_sink sink = { 0 };
+	struct json_writer writer;
+	int i;
+
+	/* Value without a key */
+	json_writer_init(&writer, NULL, 0, chunk_sink_append, &sink);
+	json_writer_object_start(&writer);
+	zassert_equal(json_writer_number(&writer, 1), -EINVAL, NULL);
+	/* The first error is kept */
+	zassert_equal(json_writer_object_end(&writer), -EINVAL, NULL);
+	zassert_equal(json_writer_flush(&writer), -EINVAL, NULL);
+
+	/* Key in an array, mismatched end, two top-level values */
+	json_writer_init(&writer, NULL, 0, chunk_sink_append, &sink);
+	json_writer_array_start(&writer);
+	zassert_equal(json_writer_key(&writer, "a"), -EINVAL, NULL);
+
+	json_writer_init(&writer, NULL, 0, chunk_sink_append, &sink);
+	json_writer_array_start(&writer);
+	zassert_equal(json_writer_object_end(&writer), -EINVAL, NULL);
+
+	json_writer_init(&writer, NULL, 0, chunk_sink_append, &sink);
+	json_writer_null(&writer);
+	zassert_equal(json_writer_null(&writer), -EINVAL, NULL);
+
+	json_writer_init(&writer, NULL, 0, chunk_sink_append, &sink);
+	for (i = 0; i < JSON_STREAM_MAX_DEPTH; i++) {
+		zassert_equal(json_writer_array_start(&writer), 0, NULL);
+	}
+	zassert_equal(json_writer_array_start(&writer), -E2BIG, NULL);
+
+	/* Errors of the output function */
+	sink.len = sizeof(sink.text) - 1;
+	json_writer_init(&writer, NULL, 0, chunk_sink_append, &sink);
+	zassert_equal(json_writer_bool(&writer, true), -ENOMEM, NULL);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_json_test,
@@ -560,7 +803,11 @@ void test_main(void)
 			 ztest_unit_test(test_json_escape_empty),
 			 ztest_unit_test(test_json_escape_no_op),
 			 ztest_unit_test(test_json_escape_bounds_check),
-			 ztest_unit_test(test_json_encode_bounds_check)
+			 ztest_unit_test(test_json_encode_bounds_check),
+			 ztest_unit_test(test_json_sax),
+			 ztest_unit_test(test_json_sax_errors),
+			 ztest_unit_test(test_json_writer),
+			 ztest_unit_test(test_json_writer_errors)
 			 );
 
 	ztest_run_test_suite(lib_json_test);
@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <time.h>
+#include <sys/mutex.h>
 
 #define BUF_LEN 10
 
@@ -291,6 +292,117 @@ __no_optimization void test_memalloc_max(void)
 	ptr = NULL;
 }
 
+/**
+ * @brief Test that the per-CPU caches of malloc stay bounded
+ *
+ * The cache is refilled while it is filled by frees, then more blocks
+ * than it holds are freed. The blocks it holds are counted by allocating
+ * them from another thread with the heap mutex held, which blocks it as
+ * soon as the cache is empty.
+ *
+ * @see malloc(), free()
+ */
+#ifdef CONFIG_MINIMAL_LIBC_MALLOC_CPU_CACHE
+#define CACHE_DEPTH CONFIG_MINIMAL_LIBC_MALLOC_CPU_CACHE_DEPTH
+#define CACHED_SIZE 192
+#define MAX_DRAINED (4 * CACHE_DEPTH)
+
+extern struct sys_mutex z_malloc_heap_mutex;
+
+static K_THREAD_STACK_DEFINE(drain_stack, 1024 + CONFIG_TEST_EXTRA_STACKSIZE);
+static struct k_thread drain_thread;
+static void *drained[MAX_DRAINED];
+static int drained_count;
+static volatile bool drain_stop;
+
+static void drain(void *p1, void *p2, void *p3)
+{
+	while (drained_count < MAX_DRAINED) {
+		drained[drained_count++] = malloc(CACHED_SIZE);
+
+		if (drain_stop) {
+			break;
+		}
+	}
+}
+
+/* Empty the cache from a lower priority thread, left blocked on the heap
+ * mutex, and return the number of blocks the cache served.
+ */
+static int drain_start(void)
+{
+	drained_count = 0;
+	drain_stop = false;
+
+	sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
+	k_thread_create(&drain_thread, drain_stack,
+			K_THREAD_STACK_SIZEOF(drain_stack), drain,
+			NULL, NULL, NULL,
+			k_thread_priority_get(k_current_get()) + 1, 0,
+			K_NO_WAIT);
+	k_msleep(10);
+
+	return drained_count;
+}
+
+/* Hand the heap mutex over to the draining thread, which allocates one
+ * more block from the heap once it runs.
+ */
+static void drain_release(void)
+{
+	drain_stop = true;
+	sys_mutex_unlock(&z_malloc_heap_mutex);
+}
+
+static void drain_finish(void)
+{
+	k_thread_join(&drain_thread, K_FOREVER);
+
+	for (int i = 0; i < drained_count; i++) {
+		zassert_not_null(drained[i], "malloc failed, errno: %d", errno);
+		free(drained[i]);
+	}
+}
+
+void test_malloc_cache_bound(void)
+{
+	void *blocks[2 * CACHE_DEPTH];
+	int cached;
+
+	if (IS_ENABLED(CONFIG_SMP)) {
+		ztest_test_skip();
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(blocks); i++) {
+		blocks[i] = malloc(CACHED_SIZE);
+		zassert_not_null(blocks[i], "malloc failed, errno: %d", errno);
+	}
+
+	/* Fill the empty cache while the draining thread refills it */
+	drain_start();
+	drain_release();
+	for (int i = 0; i < CACHE_DEPTH; i++) {
+		free(blocks[i]);
+	}
+	drain_finish();
+
+	for (int i = CACHE_DEPTH; i < ARRAY_SIZE(blocks); i++) {
+		free(blocks[i]);
+	}
+
+	cached = drain_start();
+	drain_release();
+	drain_finish();
+
+	zassert_true(cached <= CACHE_DEPTH, "%d blocks cached", cached);
+}
+#else
+void test_malloc_cache_bound(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 void test_main(void)
 {
 	ztest_test_suite(test_c_lib_dynamic_memalloc,
@@ -301,7 +413,8 @@ void test_main(void)
 			 ztest_user_unit_test(test_realloc),
 			 ztest_user_unit_test(test_reallocarray),
 			 ztest_user_unit_test(test_memalloc_all),
-			 ztest_user_unit_test(test_memalloc_max)
+			 ztest_user_unit_test(test_memalloc_max),
+			 ztest_unit_test(test_malloc_cache_bound)
 			 );
 	ztest_run_test_suite(test_c_lib_dynamic_memalloc);
 }
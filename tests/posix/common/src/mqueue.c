@@ -107,3 +107,120 @@ void test_posix_mqueue(void)
 		      "unable to close message queue descriptor.");
 	zassert_false(mq_unlink(queue), "Not able to unlink Queue");
 }
+
+void test_posix_mqueue_loan(void)
+{
+	mqd_t mqd;
+	struct mq_attr attrs;
+	int32_t mode = 0777, flags = O_RDWR | O_CREAT | O_NONBLOCK;
+	char *bufs[MESG_COUNT_PERMQ];
+	char rec_data[MESSAGE_SIZE];
+	char *buf;
+	int i;
+
+	attrs.mq_msgsize = MESSAGE_SIZE;
+	attrs.mq_maxmsg = MESG_COUNT_PERMQ;
+
+	mqd = mq_open(queue, flags, mode, &attrs);
+	zassert_not_equal(mqd, (mqd_t)-1, "unable to open message queue");
+
+	/* Loaned buffers take the place of messages */
+	for (i = 0; i < MESG_COUNT_PERMQ; i++) {
+		bufs[i] = mq_loan_np(mqd, NULL);
+		zassert_not_null(bufs[i], "unable to loan buffer");
+	}
+	zassert_is_null(mq_loan_np(mqd, NULL), "loaned too many buffers");
+	zassert_equal(errno, EAGAIN, NULL);
+	zassert_equal(mq_send(mqd, send_data, MESSAGE_SIZE, 0), -1, NULL);
+	zassert_equal(errno, EAGAIN, NULL);
+
+	/* Loaned messages are received in order, with their length */
+	for (i = 0; i < MESG_COUNT_PERMQ - 1; i++) {
+		bufs[i][0] = 'a' + i;
+		zassert_false(mq_send_loan_np(mqd, bufs[i], i + 1, 0),
+			      "unable to send loaned buffer");
+	}
+	zassert_equal(mq_send_loan_np(mqd, bufs[i], MESSAGE_SIZE + 1, 0), -1,
+		      NULL);
+	zassert_equal(errno, EMSGSIZE, NULL);
+	zassert_false(mq_return_np(mqd, bufs[i]), NULL);
+
+	zassert_false(mq_send(mqd, send_data, 3, 0), NULL);
+
+	for (i = 0; i < MESG_COUNT_PERMQ - 1; i++) {
+		zassert_equal(mq_receive_loan_np(mqd, &buf, NULL, NULL), i + 1,
+			      "wrong message length");
+		zassert_equal(buf, bufs[i], "message copied");
+		zassert_equal(buf[0], 'a' + i, NULL);
+		zassert_false(mq_return_np(mqd, buf), NULL);
+	}
+
+	/* Copied messages are received with their length too */
+	zassert_equal(mq_receive(mqd, rec_data, MESSAGE_SIZE, 0), 3, NULL);
+	zassert_false(strncmp(rec_data, send_data, 3), NULL);
+	zassert_equal(mq_receive_loan_np(mqd, &buf, NULL, NULL), -1, NULL);
+	zassert_equal(errno, EAGAIN, NULL);
+
+	zassert_false(mq_close(mqd),
+		      "unable to close message queue descriptor.");
+	zassert_false(mq_unlink(queue), "Not able to unlink Queue");
+}
+
+void test_posix_mqueue_notify(void)
+{
+	mqd_t mqd;
+	struct mq_attr attrs;
+	struct sigevent notification = { 0 };
+	struct k_poll_signal sig;
+	char rec_data[MESSAGE_SIZE];
+	int32_t mode = 0777, flags = O_RDWR | O_CREAT | O_NONBLOCK;
+	unsigned int signaled;
+	int result;
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(
+		K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &sig);
+
+	attrs.mq_msgsize = MESSAGE_SIZE;
+	attrs.mq_maxmsg = MESG_COUNT_PERMQ;
+
+	mqd = mq_open(queue, flags, mode, &attrs);
+	zassert_not_equal(mqd, (mqd_t)-1, "unable to open message queue");
+
+	k_poll_signal_init(&sig);
+	notification.sigev_notify = SIGEV_THREAD;
+	zassert_equal(mq_notify(mqd, &notification), -1, NULL);
+	zassert_equal(errno, EINVAL, NULL);
+
+	notification.sigev_notify = SIGEV_SIGNAL;
+	notification.sigev_signo = 42;
+	notification.sigev_value.sival_ptr = &sig;
+	zassert_false(mq_notify(mqd, &notification), "unable to register");
+	zassert_equal(mq_notify(mqd, &notification), -1, NULL);
+	zassert_equal(errno, EBUSY, NULL);
+
+	/* Only the transition from empty notifies, and only once */
+	zassert_false(mq_send(mqd, send_data, MESSAGE_SIZE, 0), NULL);
+	zassert_false(k_poll(&event, 1, K_MSEC(100)), "not notified");
+	k_poll_signal_check(&sig, &signaled, &result);
+	zassert_true(signaled, NULL);
+	zassert_equal(result, 42, NULL);
+
+	k_poll_signal_reset(&sig);
+	event.state = K_POLL_STATE_NOT_READY;
+	zassert_false(mq_send(mqd, send_data, MESSAGE_SIZE, 0), NULL);
+	zassert_equal(mq_receive(mqd, rec_data, MESSAGE_SIZE, 0),
+		      MESSAGE_SIZE, NULL);
+	zassert_equal(mq_receive(mqd, rec_data, MESSAGE_SIZE, 0),
+		      MESSAGE_SIZE, NULL);
+	zassert_false(mq_send(mqd, send_data, MESSAGE_SIZE, 0), NULL);
+	zassert_equal(k_poll(&event, 1, K_MSEC(10)), -EAGAIN,
+		      "notified after the registration was removed");
+
+	/* Registrations can be removed */
+	zassert_false(mq_notify(mqd, &notification), "unable to register");
+	zassert_false(mq_notify(mqd, NULL), "unable to unregister");
+	zassert_false(mq_notify(mqd, &notification), "unable to register");
+
+	zassert_false(mq_close(mqd),
+		      "unable to close message queue descriptor.");
+	zassert_false(mq_unlink(queue), "Not able to unlink Queue");
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <power/power.h>
+
+/* Indexes of the states in the cpu-power-states property of cpu0 */
+#define STATE_IDLE 0
+#define STATE_STANDBY 1
+#define STATE_RAM 2
+
+#define TEST_SOURCE 2
+
+/* The timeouts below are given in ticks, which must resolve the 100 us
+ * difference between the residencies of the states.
+ */
+BUILD_ASSERT(CONFIG_SYS_CLOCK_TICKS_PER_SEC >= 10000,
+	     "ticks too long to tell the states apart");
+
+static enum pm_state last_state;
+
+void pm_power_state_set(struct pm_state_info info)
+{
+	last_state = info.state;
+
+	/* native_posix only advances time while the CPU idles */
+	k_cpu_idle();
+}
+
+void pm_power_state_exit_post_ops(struct pm_state_info info)
+{
+	/* pm_system_suspend is entered with irq locked
+	 * unlock irq before leave pm_system_suspend
+	 */
+	irq_unlock(0);
+}
+
+/* Emulate idle periods ended by an interrupt of the test source, in
+ * the absence of kernel timeouts.
+ */
+static void periodic_wakeups(uint32_t period_us, int count)
+{
+	for (int i = 0; i < count; i++) {
+		(void)pm_policy_next_state(K_TICKS_FOREVER);
+		k_busy_wait(period_us);
+		z_pm_governor_idle_exit();
+		pm_governor_wakeup_source(TEST_SOURCE);
+	}
+}
+
+/**
+ * @brief Test that the next timeout alone selects the deepest state
+ */
+void test_governor_timeout(void)
+{
+	struct pm_state_info info;
+
+	pm_governor_reset();
+
+	info = pm_policy_next_state(K_TICKS_FOREVER);
+	zassert_equal(info.state, PM_STATE_SUSPEND_TO_RAM, NULL);
+
+	info = pm_policy_next_state(k_us_to_ticks_ceil32(2000));
+	zassert_equal(info.state, PM_STATE_STANDBY, NULL);
+
+	info = pm_policy_next_state(k_us_to_ticks_ceil32(500));
+	zassert_equal(info.state, PM_STATE_SUSPEND_TO_IDLE, NULL);
+
+	/* Not enough time to amortize the exit latency */
+	info = pm_policy_next_state(k_us_to_ticks_floor32(100));
+	zassert_equal(info.state, PM_STATE_ACTIVE, NULL);
+}
+
+/**
+ * @brief Test that regular interrupt wake-ups are anticipated
+ */
+void test_governor_predicted_wakeup(void)
+{
+	struct pm_state_info info;
+
+	pm_governor_reset();
+	periodic_wakeups(3000, CONFIG_PM_POLICY_GOVERNOR_HISTORY);
+
+	info = pm_policy_next_state(K_TICKS_FOREVER);
+	zassert_equal(info.state, PM_STATE_STANDBY,
+		      "wake-up in 3 ms not anticipated");
+
+	pm_governor_reset();
+	periodic_wakeups(600, CONFIG_PM_POLICY_GOVERNOR_HISTORY);
+
+	info = pm_policy_next_state(K_TICKS_FOREVER);
+	zassert_equal(info.state, PM_STATE_SUSPEND_TO_IDLE,
+		      "wake-up in 600 us not anticipated");
+
+	/* A source that went quiet is not anticipated anymore */
+	k_busy_wait(2000);
+	info = pm_policy_next_state(K_TICKS_FOREVER);
+	zassert_equal(info.state, PM_STATE_SUSPEND_TO_RAM, NULL);
+}
+
+/**
+ * @brief Test that irregular wake-ups are not anticipated
+ */
+void test_governor_irregular_wakeup(void)
+{
+	static const uint32_t periods[] = {
+		500, 4000, 1500, 9000, 700, 3000, 200, 6000
+	};
+	struct pm_state_info info;
+
+	pm_governor_reset();
+
+	for (int i = 0; i < ARRAY_SIZE(periods); i++) {
+		periodic_wakeups(periods[i], 1);
+	}
+
+	info = pm_policy_next_state(K_TICKS_FOREVER);
+	zassert_equal(info.state, PM_STATE_SUSPEND_TO_RAM, NULL);
+}
+
+/**
+ * @brief Test per-state residency statistics
+ */
+void test_governor_stats(void)
+{
+	struct pm_governor_stats stats;
+
+	pm_governor_reset();
+
+	/* The first wake-ups find the governor without history, in the
+	 * deepest state: they leave it before its minimum residency.
+	 */
+	periodic_wakeups(3000, CONFIG_PM_POLICY_GOVERNOR_HISTORY + 1);
+	(void)pm_policy_next_state(K_TICKS_FOREVER);
+
+	zassert_ok(pm_governor_stats_get(STATE_RAM, &stats), NULL);
+	zassert_true(stats.entries > 0, NULL);
+	zassert_equal(stats.entries, stats.early_exits, NULL);
+
+	zassert_ok(pm_governor_stats_get(STATE_STANDBY, &stats), NULL);
+	zassert_true(stats.entries > 0, NULL);
+	zassert_equal(stats.early_exits, 0, NULL);
+	zassert_true(stats.residency_us >= stats.entries * 2900ULL, NULL);
+
+	zassert_ok(pm_governor_stats_get(STATE_IDLE, &stats), NULL);
+	zassert_equal(stats.entries, 0, NULL);
+
+	zassert_ok(pm_governor_stats_get(PM_GOVERNOR_STATE_CPU_IDLE, &stats),
+		   NULL);
+	zassert_equal(pm_governor_stats_get(3, &stats), -EINVAL, NULL);
+}
+
+/**
+ * @brief Test the governor from the idle thread
+ */
+void test_governor_idle_thread(void)
+{
+	struct pm_governor_stats stats;
+
+	pm_governor_reset();
+
+	k_msleep(20);
+	k_msleep(20);
+
+	zassert_equal(last_state, PM_STATE_SUSPEND_TO_RAM, NULL);
+	zassert_ok(pm_governor_stats_get(STATE_RAM, &stats), NULL);
+	zassert_true(stats.entries > 0, NULL);
+	zassert_true(stats.residency_us >= 15000U, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(power_governor_test,
+			 ztest_1cpu_unit_test(test_governor_timeout),
+			 ztest_1cpu_unit_test(test_governor_predicted_wakeup),
+			 ztest_1cpu_unit_test(test_governor_irregular_wakeup),
+			 ztest_1cpu_unit_test(test_governor_stats),
+			 ztest_1cpu_unit_test(test_governor_idle_thread));
+	ztest_run_test_suite(power_governor_test);
+}
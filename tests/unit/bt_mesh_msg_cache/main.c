@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <ztest.h>
+#include <stdlib.h>
+
+#include "../../../subsys/bluetooth/mesh/msg_cache.c"
+
+#define CACHE_SIZE 37
+
+BT_MESH_MSG_CACHE_DEFINE(cache, CACHE_SIZE);
+
+/* Reference FIFO cache, searched linearly */
+static struct {
+	uint32_t key;
+	bool valid;
+} ref[CACHE_SIZE];
+static uint16_t ref_next;
+
+static bool ref_has(uint32_t key)
+{
+	for (int i = 0; i < CACHE_SIZE; i++) {
+		if (ref[i].valid && ref[i].key == key) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static uint16_t ref_add(uint32_t key)
+{
+	uint16_t pos = ref_next;
+
+	/* A key added again is only kept at its newest position */
+	for (int i = 0; i < CACHE_SIZE; i++) {
+		if (ref[i].key == key) {
+			ref[i].valid = false;
+		}
+	}
+
+	ref[pos].key = key;
+	ref[pos].valid = true;
+	ref_next = (pos + 1) % CACHE_SIZE;
+
+	return pos;
+}
+
+static void ref_drop(uint16_t pos)
+{
+	ref[pos].valid = false;
+	ref_next = pos;
+}
+
+static void reset(void)
+{
+	bt_mesh_msg_cache_clear(&cache);
+	(void)memset(ref, 0, sizeof(ref));
+	ref_next = 0U;
+}
+
+/**
+ * @brief Test that the oldest keys are evicted first
+ */
+void test_cache_fifo(void)
+{
+	reset();
+
+	zassert_false(bt_mesh_msg_cache_has(&cache, 0), NULL);
+
+	for (uint32_t key = 0; key < CACHE_SIZE; key++) {
+		zassert_equal(bt_mesh_msg_cache_add(&cache, key), key, NULL);
+	}
+
+	for (uint32_t key = 0; key < CACHE_SIZE; key++) {
+		zassert_true(bt_mesh_msg_cache_has(&cache, key), NULL);
+	}
+
+	zassert_equal(bt_mesh_msg_cache_add(&cache, CACHE_SIZE), 0, NULL);
+	zassert_false(bt_mesh_msg_cache_has(&cache, 0), NULL);
+	zassert_true(bt_mesh_msg_cache_has(&cache, 1), NULL);
+	zassert_true(bt_mesh_msg_cache_has(&cache, CACHE_SIZE), NULL);
+
+	bt_mesh_msg_cache_clear(&cache);
+	zassert_false(bt_mesh_msg_cache_has(&cache, 1), NULL);
+	zassert_false(bt_mesh_msg_cache_has(&cache, CACHE_SIZE), NULL);
+}
+
+/**
+ * @brief Test that a dropped key is forgotten and its position reused
+ */
+void test_cache_drop(void)
+{
+	uint16_t pos;
+
+	reset();
+
+	bt_mesh_msg_cache_add(&cache, 1);
+	pos = bt_mesh_msg_cache_add(&cache, 2);
+	bt_mesh_msg_cache_drop(&cache, pos);
+
+	zassert_true(bt_mesh_msg_cache_has(&cache, 1), NULL);
+	zassert_false(bt_mesh_msg_cache_has(&cache, 2), NULL);
+	zassert_equal(bt_mesh_msg_cache_add(&cache, 3), pos, NULL);
+	zassert_true(bt_mesh_msg_cache_has(&cache, 3), NULL);
+}
+
+/**
+ * @brief Test random operations against a linearly searched cache
+ */
+void test_cache_random(void)
+{
+	uint16_t last = 0;
+
+	reset();
+	srand(0x6d657368);
+
+	for (int i = 0; i < 200000; i++) {
+		/* Few distinct keys, to have keys added again */
+		uint32_t key = rand() % (4 * CACHE_SIZE);
+		int op = rand() % 16;
+
+		if (op == 0) {
+			bt_mesh_msg_cache_drop(&cache, last);
+			ref_drop(last);
+		} else if (op < 8) {
+			last = bt_mesh_msg_cache_add(&cache, key);
+			zassert_equal(last, ref_add(key), NULL);
+		} else {
+			zassert_equal(bt_mesh_msg_cache_has(&cache, key),
+				      ref_has(key), "mismatch for %u", key);
+		}
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(bt_mesh_msg_cache,
+			 ztest_unit_test(test_cache_fifo),
+			 ztest_unit_test(test_cache_drop),
+			 ztest_unit_test(test_cache_random)
+			 );
+	ztest_run_test_suite(bt_mesh_msg_cache);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <ztest.h>
+
+#include "../../../subsys/bluetooth/mesh/rtt.c"
+
+/* Bounds of the retransmit timeout for TTL 7 and the default interval */
+#define TO_MIN 550
+#define TO_MAX 1500
+#define TO_DEF 750
+
+/**
+ * @brief Test that the first sample initializes the estimate
+ */
+void test_rtt_first_sample(void)
+{
+	struct bt_mesh_rtt rtt = { 0 };
+
+	zassert_equal(bt_mesh_rtt_timeout(&rtt, TO_MIN, TO_MAX, TO_DEF),
+		      TO_DEF, "untimed destination not using the default");
+
+	bt_mesh_rtt_ack(&rtt, 200, false);
+
+	zassert_true(rtt.timed, NULL);
+	zassert_equal(rtt.srtt, 200, NULL);
+	zassert_equal(rtt.rttvar, 100, NULL);
+	/* 200 + 4 * 100 */
+	zassert_equal(bt_mesh_rtt_timeout(&rtt, TO_MIN, TO_MAX, TO_DEF), 600,
+		      NULL);
+}
+
+/**
+ * @brief Test the smoothing of further samples
+ */
+void test_rtt_smoothing(void)
+{
+	struct bt_mesh_rtt rtt = { 0 };
+
+	bt_mesh_rtt_ack(&rtt, 200, false);
+
+	/* delta 80: srtt += 80 / 8, rttvar += (80 - 100) / 4 */
+	bt_mesh_rtt_ack(&rtt, 280, false);
+	zassert_equal(rtt.srtt, 210, NULL);
+	zassert_equal(rtt.rttvar, 95, NULL);
+
+	/* delta -170: srtt -= 170 / 8, rttvar += (170 - 95) / 4 */
+	bt_mesh_rtt_ack(&rtt, 40, false);
+	zassert_equal(rtt.srtt, 189, NULL);
+	zassert_equal(rtt.rttvar, 113, NULL);
+
+	/* A steady round trip time converges, within the truncation of the
+	 * gains: srtt stops moving less than 8 ms away, and rttvar 3 ms above
+	 * that.
+	 */
+	for (int i = 0; i < 100; i++) {
+		bt_mesh_rtt_ack(&rtt, 100, false);
+	}
+
+	zassert_within(rtt.srtt, 100, 8, "srtt %u", rtt.srtt);
+	zassert_true(rtt.rttvar <= 10, "rttvar %u", rtt.rttvar);
+}
+
+/**
+ * @brief Test that acks of resent segments are not sampled
+ */
+void test_rtt_karn(void)
+{
+	struct bt_mesh_rtt rtt = { 0 };
+
+	bt_mesh_rtt_ack(&rtt, 3000, true);
+	zassert_false(rtt.timed, "resent segments sampled");
+
+	bt_mesh_rtt_ack(&rtt, 200, false);
+	bt_mesh_rtt_ack(&rtt, 3000, true);
+	zassert_equal(rtt.srtt, 200, NULL);
+	zassert_equal(rtt.rttvar, 100, NULL);
+}
+
+/**
+ * @brief Test that the timeout is bounded
+ */
+void test_rtt_bounds(void)
+{
+	struct bt_mesh_rtt rtt = { 0 };
+
+	/* Fast destination: the estimate is below the minimum */
+	bt_mesh_rtt_ack(&rtt, 20, false);
+	zassert_equal(bt_mesh_rtt_timeout(&rtt, TO_MIN, TO_MAX, TO_DEF),
+		      TO_MIN, NULL);
+
+	/* Slow destination: the estimate is above the maximum */
+	rtt.timed = false;
+	bt_mesh_rtt_ack(&rtt, 1000, false);
+	zassert_equal(bt_mesh_rtt_timeout(&rtt, TO_MIN, TO_MAX, TO_DEF),
+		      TO_MAX, NULL);
+
+	/* Samples beyond the range of the estimate are saturated */
+	rtt.timed = false;
+	bt_mesh_rtt_ack(&rtt, 100000, false);
+	zassert_equal(rtt.srtt, UINT16_MAX, NULL);
+	zassert_equal(bt_mesh_rtt_timeout(&rtt, TO_MIN, TO_MAX, TO_DEF),
+		      TO_MAX, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(bt_mesh_rtt,
+			 ztest_unit_test(test_rtt_first_sample),
+			 ztest_unit_test(test_rtt_smoothing),
+			 ztest_unit_test(test_rtt_karn),
+			 ztest_unit_test(test_rtt_bounds)
+			 );
+	ztest_run_test_suite(bt_mesh_rtt);
+}
@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <ztest.h>
+#include <stdlib.h>
+#include <sys/btree.h>
+
+#include "../../../lib/os/btree.c"
+
+#define _CHECK(n) \
+	zassert_true(!!(n), "Tree check failed: [ " #n " ] @%d", __LINE__)
+
+#define MAX_ELEMS 2048
+
+static struct sys_btree tree;
+
+/* Values are the addresses of the array entries, keys their index times 2
+ * so that odd keys are never in the tree
+ */
+static char elems[MAX_ELEMS];
+static bool in_tree[MAX_ELEMS];
+
+static uintptr_t load_keys[MAX_ELEMS];
+static void *load_values[MAX_ELEMS];
+
+static int n_nodes;
+static int alloc_budget = -1;
+
+static void *test_alloc(void *ptr, size_t size)
+{
+	if (ptr == NULL) {
+		if (alloc_budget == 0) {
+			return NULL;
+		}
+		if (alloc_budget > 0) {
+			alloc_budget--;
+		}
+		n_nodes++;
+		return malloc(size);
+	}
+
+	n_nodes--;
+	free(ptr);
+
+	return NULL;
+}
+
+static uintptr_t key_of(int i)
+{
+	return 2 * i;
+}
+
+/* Simple LCRNG, see tests/unit/rbtree */
+static unsigned int next_rand_mod(unsigned int mod)
+{
+	static unsigned long long state = 123456789; /* seed */
+
+	state = state * 2862933555777941757ul + 3037000493ul;
+
+	return ((unsigned int)(state >> 32)) % mod;
+}
+
+static const struct sys_btree_node *last_leaf;
+static size_t n_counted;
+static int n_walked_nodes;
+
+/* Checks the node invariants, returns the height of the subtree */
+static int check_node(const struct sys_btree_node *node, bool root,
+		      uintptr_t lo, uintptr_t hi, bool has_hi)
+{
+	int height = -1;
+
+	n_walked_nodes++;
+
+	_CHECK(node->n_keys <= SYS_BTREE_ORDER);
+	if (!root) {
+		_CHECK(node->n_keys >= MIN_KEYS);
+	}
+	_CHECK(node->n_keys > 0);
+
+	for (int i = 0; i < node->n_keys; i++) {
+		_CHECK(node->keys[i] >= lo);
+		if (has_hi) {
+			_CHECK(node->keys[i] < hi);
+		}
+		if (i > 0) {
+			_CHECK(node->keys[i - 1] < node->keys[i]);
+		}
+	}
+
+	if (node->leaf) {
+		/* Leaves are chained in order */
+		if (last_leaf != NULL) {
+			_CHECK(last_leaf->next == node);
+		}
+		last_leaf = node;
+		n_counted += node->n_keys;
+		return 1;
+	}
+
+	for (int i = 0; i <= node->n_keys; i++) {
+		uintptr_t c_lo = (i == 0) ? lo : node->keys[i - 1];
+		uintptr_t c_hi = (i == node->n_keys) ? hi : node->keys[i];
+		bool c_has_hi = (i == node->n_keys) ? has_hi : true;
+		int h = check_node(node->children[i], false, c_lo, c_hi,
+				   c_has_hi);
+
+		if (height >= 0) {
+			_CHECK(h == height);
+		}
+		height = h;
+	}
+
+	return height + 1;
+}
+
+static void check_tree(int size)
+{
+	struct sys_btree_iter it;
+	uintptr_t key, last_key = 0;
+	void *value;
+	int n = 0;
+
+	last_leaf = NULL;
+	n_counted = 0;
+	n_walked_nodes = 0;
+
+	if (tree.root == NULL) {
+		_CHECK(tree.count == 0);
+		_CHECK(tree.height == 0);
+	} else {
+		_CHECK(check_node(tree.root, true, 0, 0, false) == tree.height);
+		_CHECK(last_leaf->next == NULL);
+		_CHECK(n_counted == tree.count);
+	}
+	_CHECK(n_walked_nodes == n_nodes);
+
+	SYS_BTREE_FOR_EACH(&tree, it, key, value) {
+		int i = (char *)value - elems;
+
+		_CHECK(key == key_of(i));
+		_CHECK(in_tree[i]);
+		if (n > 0) {
+			_CHECK(key > last_key);
+		}
+		last_key = key;
+		n++;
+	}
+	_CHECK(n == sys_btree_count(&tree));
+
+	for (int i = 0; i < size; i++) {
+		_CHECK(sys_btree_get(&tree, key_of(i)) ==
+		       (in_tree[i] ? &elems[i] : NULL));
+		_CHECK(sys_btree_get(&tree, key_of(i) + 1) == NULL);
+	}
+}
+
+static void spam_tree(int size)
+{
+	for (int j = 0; j < 10; j++) {
+		for (int i = 0; i < size; i++) {
+			int e = next_rand_mod(size);
+
+			if (!in_tree[e]) {
+				_CHECK(sys_btree_insert(&tree, key_of(e),
+							&elems[e]) == 0);
+			} else {
+				_CHECK(sys_btree_remove(&tree, key_of(e)) ==
+				       &elems[e]);
+			}
+			in_tree[e] = !in_tree[e];
+
+			if (size <= 64) {
+				check_tree(size);
+			}
+		}
+
+		check_tree(size);
+	}
+}
+
+static void reset_tree(void)
+{
+	sys_btree_clear(&tree);
+	zassert_equal(n_nodes, 0, "nodes leaked");
+	(void)memset(in_tree, 0, sizeof(in_tree));
+}
+
+static void test_btree_spam(void)
+{
+	int size = 1;
+
+	sys_btree_init(&tree, test_alloc);
+
+	do {
+		size += next_rand_mod(size) + 1;
+
+		if (size > MAX_ELEMS) {
+			size = MAX_ELEMS;
+		}
+
+		TC_PRINT("Checking trees built from %d elements...\n", size);
+
+		spam_tree(size);
+
+		/* Remove everything to check the tree shrinks to nothing */
+		for (int i = 0; i < size; i++) {
+			if (in_tree[i]) {
+				_CHECK(sys_btree_remove(&tree, key_of(i)) ==
+				       &elems[i]);
+				in_tree[i] = false;
+			}
+		}
+		check_tree(size);
+		zassert_equal(n_nodes, 0, "nodes leaked");
+	} while (size < MAX_ELEMS);
+}
+
+static void test_btree_sequential(void)
+{
+	sys_btree_init(&tree, test_alloc);
+
+	/* Ascending then descending insertions and removals, which always
+	 * split and merge at the edges of the tree
+	 */
+	for (int i = 0; i < MAX_ELEMS; i++) {
+		_CHECK(sys_btree_insert(&tree, key_of(i), &elems[i]) == 0);
+		in_tree[i] = true;
+	}
+	check_tree(MAX_ELEMS);
+
+	for (int i = 0; i < MAX_ELEMS; i++) {
+		_CHECK(sys_btree_remove(&tree, key_of(i)) == &elems[i]);
+		in_tree[i] = false;
+	}
+	check_tree(MAX_ELEMS);
+
+	for (int i = MAX_ELEMS - 1; i >= 0; i--) {
+		_CHECK(sys_btree_insert(&tree, key_of(i), &elems[i]) == 0);
+		in_tree[i] = true;
+	}
+	check_tree(MAX_ELEMS);
+
+	for (int i = MAX_ELEMS - 1; i >= 0; i--) {
+		_CHECK(sys_btree_remove(&tree, key_of(i)) == &elems[i]);
+		in_tree[i] = false;
+	}
+	check_tree(MAX_ELEMS);
+
+	reset_tree();
+}
+
+static void test_btree_load(void)
+{
+	static const int sizes[] = { 0, 1, 16, 17, 33, 100, 272, 289, 1000,
+				     MAX_ELEMS };
+
+	sys_btree_init(&tree, test_alloc);
+
+	for (int i = 0; i < MAX_ELEMS; i++) {
+		load_keys[i] = key_of(i);
+		load_values[i] = &elems[i];
+	}
+
+	for (int s = 0; s < ARRAY_SIZE(sizes); s++) {
+		int size = sizes[s];
+
+		_CHECK(sys_btree_load(&tree, load_keys, load_values, size) == 0);
+		for (int i = 0; i < size; i++) {
+			in_tree[i] = true;
+		}
+		check_tree(size);
+
+		/* The loaded tree must support updates */
+		spam_tree(size);
+
+		reset_tree();
+	}
+
+	/* Unsorted keys and non empty trees are rejected */
+	load_keys[1] = load_keys[0];
+	_CHECK(sys_btree_load(&tree, load_keys, load_values, 10) == -EINVAL);
+	load_keys[1] = key_of(1);
+
+	_CHECK(sys_btree_insert(&tree, key_of(0), &elems[0]) == 0);
+	_CHECK(sys_btree_load(&tree, load_keys, load_values, 10) == -EINVAL);
+	reset_tree();
+
+	/* Allocation failures leave the tree empty */
+	for (int budget = 0; budget < 100; budget += 7) {
+		alloc_budget = budget;
+		_CHECK(sys_btree_load(&tree, load_keys, load_values,
+				      MAX_ELEMS) == -ENOMEM);
+		alloc_budget = -1;
+		check_tree(MAX_ELEMS);
+	}
+}
+
+static void test_btree_errors(void)
+{
+	int i;
+
+	sys_btree_init(&tree, test_alloc);
+
+	alloc_budget = 0;
+	_CHECK(sys_btree_insert(&tree, key_of(0), &elems[0]) == -ENOMEM);
+	alloc_budget = -1;
+	check_tree(MAX_ELEMS);
+
+	_CHECK(sys_btree_insert(&tree, key_of(0), &elems[0]) == 0);
+	in_tree[0] = true;
+	_CHECK(sys_btree_insert(&tree, key_of(0), &elems[1]) == -EEXIST);
+	_CHECK(sys_btree_remove(&tree, key_of(1)) == NULL);
+
+	/* Insert with tiny allocation budgets, so that some splits fail:
+	 * failed insertions must leave the tree unchanged
+	 */
+	for (i = 1; i < MAX_ELEMS; i++) {
+		alloc_budget = next_rand_mod(3);
+		if (sys_btree_insert(&tree, key_of(i), &elems[i]) == 0) {
+			in_tree[i] = true;
+		}
+		alloc_budget = -1;
+	}
+	check_tree(MAX_ELEMS);
+
+	reset_tree();
+}
+
+static void test_btree_seek(void)
+{
+	struct sys_btree_iter it;
+	uintptr_t key;
+
+	sys_btree_init(&tree, test_alloc);
+
+	sys_btree_iter_seek(&tree, &it, 0);
+	_CHECK(sys_btree_iter_next(&it, &key) == NULL);
+
+	for (int i = 0; i < 500; i++) {
+		_CHECK(sys_btree_insert(&tree, key_of(i), &elems[i]) == 0);
+	}
+
+	for (int k = 0; k < 999; k++) {
+		void *value;
+
+		sys_btree_iter_seek(&tree, &it, k);
+		value = sys_btree_iter_next(&it, &key);
+		_CHECK(value == &elems[(k + 1) / 2]);
+		_CHECK(key == key_of((k + 1) / 2));
+	}
+
+	sys_btree_iter_seek(&tree, &it, 999);
+	_CHECK(sys_btree_iter_next(&it, &key) == NULL);
+
+	reset_tree();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_btree,
+			 ztest_unit_test(test_btree_spam),
+			 ztest_unit_test(test_btree_sequential),
+			 ztest_unit_test(test_btree_load),
+			 ztest_unit_test(test_btree_errors),
+			 ztest_unit_test(test_btree_seek));
+	ztest_run_test_suite(test_btree);
+}
@@ -1090,6 +1090,125 @@ static void test_libc_substs(void)
 	}
 }
 
+static char pkg_expected[sizeof(buf)];
+
+/* Check the rendering of a package against the direct output of the same
+ * conversions.
+ */
+static void pkg_check(const uint8_t *pkg, int len, size_t room,
+		      const char *expected, unsigned int line)
+{
+	int rc;
+
+	zassert_true(len > 0, "line %u: len %d", line, len);
+	zassert_true((size_t)len <= room, "line %u: len %d > %zu", line, len,
+		     room);
+
+	reset_out();
+	rc = cbpprintf(out, NULL, pkg);
+	*bp = 0;
+
+	zassert_equal(strcmp(buf, expected), 0,
+		      "line %u: '%s' != '%s'", line, buf, expected);
+	if (!IS_ENABLED(CONFIG_CBPRINTF_NANO)
+	    || IS_ENABLED(CONFIG_CBPRINTF_LIBC_SUBSTS)) {
+		zassert_equal(rc, (int)strlen(expected), "line %u: rc %d",
+			      line, rc);
+	}
+}
+
+#define PKG_CHECK(...) do { \
+	uint8_t pkg[CBPRINTF_STATIC_PACKAGE_SIZE(__VA_ARGS__)]; \
+	int len; \
+	\
+	reset_out(); \
+	(void)cbprintf(out, NULL, __VA_ARGS__); \
+	*bp = 0; \
+	strcpy(pkg_expected, buf); \
+	CBPRINTF_STATIC_PACKAGE(pkg, sizeof(pkg), len, __VA_ARGS__); \
+	pkg_check(pkg, len, sizeof(pkg), pkg_expected, __LINE__); \
+} while (false)
+
+static void test_package(void)
+{
+	char str[] = "str";
+	const char *cstr = "cstr";
+	char c = 'c';
+	unsigned char uc = 200;
+	short s = -3;
+	unsigned short us = 60000;
+	long l = -123456L;
+	long long ll = -5LL;
+	unsigned long long ull = 6ULL;
+	size_t sz = 7;
+	void *ptr = (void *)0x1234;
+
+	PKG_CHECK("no argument");
+	PKG_CHECK("%d %u %x", -1, 2U, 0x1234);
+	PKG_CHECK("%c %u %d %u", c, uc, s, us);
+	PKG_CHECK("%ld %lld %llu %zu", l, ll, ull, sz);
+	PKG_CHECK("%s %s %s", str, cstr, "lit");
+	PKG_CHECK("%p %d", ptr, 8);
+	PKG_CHECK("%c%lld%c%lld%c", c, ll, c, ll, c);
+
+	if (IS_ENABLED(CONFIG_CBPRINTF_FULL_INTEGRAL)) {
+		PKG_CHECK("%llx %lld", 0x123456789abcULL, ll);
+	}
+
+	if (IS_ENABLED(CONFIG_CBPRINTF_COMPLETE)) {
+		PKG_CHECK("%*d|%-*s|%.*s", 5, 1, 4, "ab", 2, "xyz");
+		PKG_CHECK("%hhd %hd %jd %td", (char)-1, s, (intmax_t)9,
+			  (ptrdiff_t)-10);
+	}
+
+	if (IS_ENABLED(CONFIG_CBPRINTF_FP_SUPPORT)) {
+		float f = 1.5f;
+		long double ld = 2.5L;
+
+		PKG_CHECK("%g %f %c %.3e", f, 2.25, c, 1e10);
+		PKG_CHECK("%d %Lg %d", 1, ld, 2);
+	}
+}
+
+static void test_package_length(void)
+{
+	uint8_t pkg[64];
+	uint8_t *upkg = &pkg[1];
+	int len;
+	int len2;
+	int i = 0;
+
+	/* Only the length is computed without a buffer */
+	CBPRINTF_STATIC_PACKAGE(NULL, 0, len, "%d %s %lld", i++, "s", 3LL);
+	zassert_true(len >= (int)(sizeof(char *) * 2 + sizeof(int) +
+				  sizeof(long long)), "len %d", len);
+	zassert_equal(i, 1, "argument evaluated %d times", i);
+
+	CBPRINTF_STATIC_PACKAGE(pkg, sizeof(pkg), len2, "%d %s %lld", i++,
+				"s", 3LL);
+	zassert_equal(len, len2, NULL);
+	zassert_equal(i, 2, "argument evaluated %d times", i);
+
+	CBPRINTF_STATIC_PACKAGE(pkg, len - 1, len2, "%d %s %lld", 1, "s",
+				3LL);
+	zassert_equal(len2, -ENOSPC, NULL);
+
+	/* The room of the format string is only accounted once */
+	zassert_equal(CBPRINTF_STATIC_PACKAGE_SIZE("no argument"),
+		      sizeof(char *), NULL);
+	zassert_equal(CBPRINTF_STATIC_PACKAGE_SIZE("%d", 1),
+		      sizeof(char *) + 2 * sizeof(int) - 1, NULL);
+
+	/* Slots are aligned from the start of the package, not in memory */
+	CBPRINTF_STATIC_PACKAGE(upkg, sizeof(pkg) - 1, len, "%d %p %s", 3,
+				(void *)0x10, "s");
+	zassert_true(len > 0, NULL);
+	reset_out();
+	(void)cbpprintf(out, NULL, upkg);
+	*bp = 0;
+	zassert_equal(strcmp(buf, "3 0x10 s"), 0, "got '%s'", buf);
+}
+
 static void test_nop(void)
 {
 }
@@ -1153,6 +1272,8 @@ void test_main(void)
 			 ztest_unit_test(test_n),
 			 ztest_unit_test(test_p),
 			 ztest_unit_test(test_libc_substs),
+			 ztest_unit_test(test_package),
+			 ztest_unit_test(test_package_length),
 			 ztest_unit_test(test_nop)
 			 );
 	ztest_run_test_suite(test_prf);
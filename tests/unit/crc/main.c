@@ -4,6 +4,18 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+/* Table driven implementations, selected with EXTRA_CPPFLAGS by twister */
+#if defined(CRC_VARIANT) && (CRC_VARIANT == 1)
+#define CONFIG_CRC32_BYTE_TABLE 1
+#define CONFIG_CRC16_BYTE_TABLE 1
+#elif defined(CRC_VARIANT) && (CRC_VARIANT == 4)
+#define CONFIG_CRC32_SLICE_BY_4 1
+#define CONFIG_CRC16_SLICE_BY_4 1
+#elif defined(CRC_VARIANT) && (CRC_VARIANT == 8)
+#define CONFIG_CRC32_SLICE_BY_8 1
+#define CONFIG_CRC16_SLICE_BY_4 1
+#endif
+
 #include <ztest.h>
 #include <sys/crc.h>
 #include "../../../lib/os/crc8_sw.c"
@@ -202,6 +214,121 @@ void test_crc8(void)
 	zassert_equal(fcs, expected, "0x%02x vs 0x%02x", fcs, expected);
 }
 
+/* Bit by bit references of the table driven implementations */
+static uint32_t ref_crc32_ieee_update(uint32_t crc, const uint8_t *data,
+				      size_t len)
+{
+	crc = ~crc;
+	for (size_t i = 0; i < len; i++) {
+		crc ^= data[i];
+		for (int b = 0; b < 8; b++) {
+			crc = (crc >> 1) ^ ((crc & 1) ? 0xedb88320 : 0);
+		}
+	}
+
+	return ~crc;
+}
+
+static uint16_t ref_crc16_reflected(uint16_t seed, uint16_t poly,
+				    const uint8_t *src, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		seed ^= src[i];
+		for (int b = 0; b < 8; b++) {
+			seed = (seed >> 1) ^ ((seed & 1) ? poly : 0);
+		}
+	}
+
+	return seed;
+}
+
+static uint16_t ref_crc16_normal(uint16_t seed, uint16_t poly,
+				 const uint8_t *src, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		seed ^= src[i] << 8;
+		for (int b = 0; b < 8; b++) {
+			seed = (seed & 0x8000) ? ((seed << 1) ^ poly) :
+				(seed << 1);
+		}
+	}
+
+	return seed;
+}
+
+static uint16_t ref_crc16(const uint8_t *src, size_t len, uint16_t poly,
+			  uint16_t initial_value, bool pad)
+{
+	uint16_t crc = initial_value;
+
+	for (size_t i = 0; i < len + (pad ? 2 : 0); i++) {
+		for (int b = 0; b < 8; b++) {
+			bool divide = (crc & 0x8000) != 0;
+
+			crc <<= 1;
+			if ((i < len) && (src[i] & (0x80 >> b))) {
+				crc |= 1;
+			}
+			if (divide) {
+				crc ^= poly;
+			}
+		}
+	}
+
+	return crc;
+}
+
+void test_crc_lengths(void)
+{
+	static uint8_t data[256];
+	uint32_t seed = 0x12345678;
+
+	for (size_t i = 0; i < sizeof(data); i++) {
+		seed = seed * 1103515245 + 12345;
+		data[i] = seed >> 16;
+	}
+
+	/* Every length and alignment around the slicing width */
+	for (size_t off = 0; off < 8; off++) {
+		for (size_t len = 0; len < 40; len++) {
+			const uint8_t *p = &data[off];
+
+			zassert_equal(crc32_ieee(p, len),
+				      ref_crc32_ieee_update(0, p, len),
+				      "off %zu len %zu", off, len);
+			zassert_equal(crc32_ieee_update(0xa5a5a5a5, p, len),
+				      ref_crc32_ieee_update(0xa5a5a5a5, p,
+							    len),
+				      "off %zu len %zu", off, len);
+			zassert_equal(crc16_ccitt(0xffff, p, len),
+				      ref_crc16_reflected(0xffff, 0x8408, p,
+							  len),
+				      "off %zu len %zu", off, len);
+			zassert_equal(crc16_itu_t(0x1d0f, p, len),
+				      ref_crc16_normal(0x1d0f, 0x1021, p,
+						       len),
+				      "off %zu len %zu", off, len);
+			zassert_equal(crc16(p, len, 0x8005, 0xffff, true),
+				      ref_crc16(p, len, 0x8005, 0xffff, true),
+				      "off %zu len %zu", off, len);
+			zassert_equal(crc16(p, len, 0x1021, 0x1234, false),
+				      ref_crc16(p, len, 0x1021, 0x1234, false),
+				      "off %zu len %zu", off, len);
+		}
+	}
+
+	/* Chained updates match a single pass */
+	zassert_equal(crc32_ieee_update(crc32_ieee(data, 13), &data[13],
+					sizeof(data) - 13),
+		      crc32_ieee(data, sizeof(data)), NULL);
+	zassert_equal(crc16_ccitt(crc16_ccitt(0, data, 7), &data[7],
+				  sizeof(data) - 7),
+		      crc16_ccitt(0, data, sizeof(data)), NULL);
+	zassert_equal(crc16_itu_t(crc16_itu_t(0, data, 7), &data[7],
+				  sizeof(data) - 7),
+		      crc16_itu_t(0, data, sizeof(data)), NULL);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_crc,
@@ -213,6 +340,7 @@ void test_main(void)
 			 ztest_unit_test(test_crc16_itu_t),
 			 ztest_unit_test(test_crc8_ccitt),
 			 ztest_unit_test(test_crc7_be),
-			 ztest_unit_test(test_crc8));
+			 ztest_unit_test(test_crc8),
+			 ztest_unit_test(test_crc_lengths));
 	ztest_run_test_suite(test_crc);
 }
@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <ztest.h>
+#include <stdlib.h>
+#include <sys/hash.h>
+#include <sys/hash_map.h>
+
+#include "../../../lib/os/hash.c"
+#include "../../../lib/os/hash_map.c"
+
+#define MAX_NODES 256
+#define STATIC_SLOTS 512
+
+struct item {
+	struct sys_hash_node node;
+	uint32_t key;
+	bool in_map;
+};
+
+static struct item items[MAX_NODES];
+static struct sys_hash_node *slots[STATIC_SLOTS];
+static struct sys_hash_map map;
+
+/* Hash of the keys, poor on purpose in some tests to exercise probing */
+static uint32_t (*key_hash)(uint32_t key);
+
+static uint32_t good_hash(uint32_t key)
+{
+	return sys_hash32_u32(key);
+}
+
+static uint32_t bad_hash(uint32_t key)
+{
+	return key % 7;
+}
+
+static bool item_eq(const struct sys_hash_node *node, const void *key)
+{
+	return CONTAINER_OF(node, struct item, node)->key ==
+	       *(const uint32_t *)key;
+}
+
+static int n_allocs;
+
+static void *test_alloc(void *ptr, size_t size)
+{
+	if (ptr == NULL) {
+		n_allocs++;
+		return malloc(size);
+	}
+
+	n_allocs--;
+	free(ptr);
+
+	return NULL;
+}
+
+/* Simple LCRNG, see tests/unit/rbtree */
+static unsigned int next_rand_mod(unsigned int mod)
+{
+	static unsigned long long state = 123456789; /* seed */
+
+	state = state * 2862933555777941757ul + 3037000493ul;
+
+	return ((unsigned int)(state >> 32)) % mod;
+}
+
+static void init_items(void)
+{
+	for (int i = 0; i < MAX_NODES; i++) {
+		items[i].key = 1000 + 3 * i;
+		items[i].in_map = false;
+	}
+}
+
+static void check_map(int size)
+{
+	size_t it;
+	struct sys_hash_node *node;
+	int count = 0;
+
+	for (int i = 0; i < size; i++) {
+		node = sys_hash_map_get(&map, key_hash(items[i].key),
+					&items[i].key);
+		zassert_equal(node, items[i].in_map ? &items[i].node : NULL,
+			      "wrong lookup result for item %d", i);
+		count += items[i].in_map;
+	}
+
+	zassert_equal(sys_hash_map_count(&map), count, "wrong count");
+
+	SYS_HASH_MAP_FOR_EACH(&map, it, node) {
+		struct item *item = CONTAINER_OF(node, struct item, node);
+
+		zassert_true(item->in_map, "removed item iterated");
+		count--;
+	}
+
+	zassert_equal(count, 0, "not all items iterated");
+}
+
+/* Random insertions and removals checked against the in_map flags */
+static void spam_map(int size)
+{
+	for (int j = 0; j < 10; j++) {
+		for (int i = 0; i < size; i++) {
+			struct item *item = &items[next_rand_mod(size)];
+			uint32_t hash = key_hash(item->key);
+
+			if (!item->in_map) {
+				zassert_equal(sys_hash_map_insert(&map,
+								  &item->node,
+								  hash,
+								  &item->key),
+					      0, "insert failed");
+			} else if (next_rand_mod(2)) {
+				zassert_equal(sys_hash_map_remove(&map, hash,
+								  &item->key),
+					      &item->node, "remove failed");
+			} else {
+				zassert_true(sys_hash_map_remove_node(&map,
+								      &item->node),
+					     "remove_node failed");
+			}
+
+			item->in_map = !item->in_map;
+
+			if (size <= 32) {
+				check_map(size);
+			}
+		}
+
+		check_map(size);
+	}
+}
+
+static void test_hash_vectors(void)
+{
+	static const uint8_t key[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+	static const char str[] = "Nobody inspects the spammish repetition";
+	uint8_t msg[1] = { 0 };
+
+	zassert_equal(sys_hash32_xxh32("", 0, 0), 0x02cc5d05, NULL);
+	zassert_equal(sys_hash32_xxh32("a", 1, 0), 0x550d7456, NULL);
+	zassert_equal(sys_hash32_xxh32("abc", 3, 0), 0x32d153ff, NULL);
+	zassert_equal(sys_hash32(str, sizeof(str) - 1), 0xe2293b2f, NULL);
+
+	zassert_equal(sys_hash32_halfsiphash(msg, 0, key), 0x5b9f35a9, NULL);
+	zassert_equal(sys_hash32_halfsiphash(msg, 1, key), 0xb85a4727, NULL);
+}
+
+static void test_static_map(void)
+{
+	key_hash = good_hash;
+
+	for (int size = 1; size <= MAX_NODES; size *= 2) {
+		sys_hash_map_init(&map, slots, STATIC_SLOTS, item_eq);
+		init_items();
+		spam_map(size);
+	}
+}
+
+static void test_static_map_collisions(void)
+{
+	key_hash = bad_hash;
+
+	for (int size = 1; size <= MAX_NODES; size *= 2) {
+		sys_hash_map_init(&map, slots, STATIC_SLOTS, item_eq);
+		init_items();
+		spam_map(size);
+	}
+}
+
+static void test_static_map_full(void)
+{
+	struct sys_hash_node *small_slots[16];
+	uint32_t key = items[14].key;
+
+	key_hash = good_hash;
+	init_items();
+	sys_hash_map_init(&map, small_slots, ARRAY_SIZE(small_slots), item_eq);
+
+	for (int i = 0; i < 14; i++) {
+		zassert_equal(sys_hash_map_insert(&map, &items[i].node,
+						  key_hash(items[i].key),
+						  &items[i].key),
+			      0, "insert %d failed", i);
+		items[i].in_map = true;
+	}
+
+	zassert_equal(sys_hash_map_insert(&map, &items[14].node,
+					  key_hash(key), &key),
+		      -ENOMEM, "full map accepted a node");
+	zassert_equal(sys_hash_map_insert(&map, &items[15].node,
+					  key_hash(items[0].key),
+					  &items[0].key),
+		      -EEXIST, "duplicate key accepted");
+
+	check_map(16);
+
+	sys_hash_map_clear(&map);
+	zassert_equal(sys_hash_map_count(&map), 0, NULL);
+	zassert_is_null(sys_hash_map_get(&map, key_hash(items[0].key),
+					 &items[0].key), NULL);
+}
+
+static void test_dynamic_map(void)
+{
+	key_hash = good_hash;
+	init_items();
+	sys_hash_map_init_dynamic(&map, item_eq, test_alloc);
+
+	zassert_is_null(sys_hash_map_get(&map, 0, &items[0].key), NULL);
+	zassert_false(sys_hash_map_remove_node(&map, &items[0].node), NULL);
+	zassert_equal(n_allocs, 0, "empty map allocated");
+
+	/* Fill the whole map to make it grow several times */
+	for (int i = 0; i < MAX_NODES; i++) {
+		zassert_equal(sys_hash_map_insert(&map, &items[i].node,
+						  key_hash(items[i].key),
+						  &items[i].key),
+			      0, "insert %d failed", i);
+		items[i].in_map = true;
+	}
+
+	zassert_equal(n_allocs, 1, "old slot arrays not freed");
+	check_map(MAX_NODES);
+
+	spam_map(MAX_NODES);
+
+	sys_hash_map_clear(&map);
+	zassert_equal(n_allocs, 0, "slot array not freed");
+	zassert_equal(sys_hash_map_count(&map), 0, NULL);
+}
+
+static void test_dynamic_map_collisions(void)
+{
+	key_hash = bad_hash;
+	init_items();
+	sys_hash_map_init_dynamic(&map, item_eq, test_alloc);
+
+	spam_map(MAX_NODES);
+
+	sys_hash_map_clear(&map);
+	zassert_equal(n_allocs, 0, "slot array not freed");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_hash_map,
+			 ztest_unit_test(test_hash_vectors),
+			 ztest_unit_test(test_static_map),
+			 ztest_unit_test(test_static_map_collisions),
+			 ztest_unit_test(test_static_map_full),
+			 ztest_unit_test(test_dynamic_map),
+			 ztest_unit_test(test_dynamic_map_collisions));
+	ztest_run_test_suite(test_hash_map);
+}